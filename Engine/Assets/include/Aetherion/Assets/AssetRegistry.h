@@ -2,22 +2,45 @@
 
 #include <array>
 #include <cstdint>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
+#include "Aetherion/Assets/DerivedDataCache.h"
+
 namespace Aetherion::Assets
 {
+class VirtualFileSystem;
+
+// Threading: Scan, Rescan, ApplyFileChanges, ImportGltf and the import-settings setters belong to
+// one owning thread (the UI thread in the editor), as do the references and pointers handed out by
+// GetEntries, FindEntry, GetMesh, GetTexture and GetMaterial. Any thread may call GetSnapshot,
+// the mesh data functions and GetMeshImportSettings.
 class AssetRegistry
 {
 public:
     AssetRegistry() = default;
-    ~AssetRegistry() = default;
+    // Waits for background loads that already started; queued ones resolve to null.
+    ~AssetRegistry();
+
+    AssetRegistry(const AssetRegistry&) = delete;
+    AssetRegistry& operator=(const AssetRegistry&) = delete;
 
     void Scan(const std::string& rootPath);
     void Rescan();
+    // Re-reads only the given files (as reported by an AssetWatcher) instead of walking the tree.
+    // Sidecars map to their asset, directories are read whole, and paths that no longer exist
+    // drop every asset at or below them. Records the same changes a Scan would.
+    void ApplyFileChanges(const std::vector<std::filesystem::path>& paths);
     [[nodiscard]] bool HasAsset(const std::string& assetId) const;
     enum class AssetType
     {
@@ -39,8 +62,37 @@ public:
         AssetType type{AssetType::Other};
     };
 
+    // Immutable view of the scanned assets. Every scan or applied file change publishes a new one
+    // (read-copy-update); a reader keeps its snapshot valid for as long as it holds it, and never
+    // waits for or races with a scan.
+    struct Snapshot
+    {
+        std::filesystem::path rootPath;
+        std::vector<AssetEntry> entries;
+        std::unordered_map<std::string, std::size_t> idLookup;
+        std::unordered_map<std::string, std::size_t> pathLookup;
+        std::shared_ptr<const VirtualFileSystem> fileSystem;
+
+        // By id, or by a path relative to the root (or absolute).
+        [[nodiscard]] const AssetEntry* Find(const std::string& assetId) const noexcept;
+    };
+
+    [[nodiscard]] std::shared_ptr<const Snapshot> GetSnapshot() const;
+
     [[nodiscard]] const std::vector<AssetEntry>& GetEntries() const noexcept;
     [[nodiscard]] const std::filesystem::path& GetRootPath() const noexcept;
+    // Directory for derived data (cooked textures, ...). Empty disables disk caching.
+    void SetCacheRoot(const std::filesystem::path& cacheRoot);
+    [[nodiscard]] const std::filesystem::path& GetCacheRoot() const noexcept;
+    // Cooked meshes, textures and glTF import results, keyed by source contents, in
+    // `<cache root>/ddc`. Closed while there is no cache root.
+    [[nodiscard]] DerivedDataCache* GetDerivedDataCache() noexcept;
+    // Sources are read through the file system when one is set: scans add the files its archives
+    // serve below the root (which has to lie inside a mounted directory), and meshes and glTF
+    // imports load from whichever mount has the file. Packed sources are not cooked into the
+    // derived data cache. Set before Scan.
+    void SetFileSystem(std::shared_ptr<const VirtualFileSystem> fileSystem);
+    [[nodiscard]] const std::shared_ptr<const VirtualFileSystem>& GetFileSystem() const noexcept;
     [[nodiscard]] const AssetEntry* FindEntry(const std::string& assetId) const noexcept;
 
     struct CachedTexture
@@ -61,6 +113,19 @@ public:
         std::array<float, 3> boundsMax{0.0f, 0.0f, 0.0f};
         std::array<float, 3> boundsCenter{0.0f, 0.0f, 0.0f};
         float boundsRadius{0.0f};
+        bool compressedVertices{false}; // Upload with the packed GPU vertex layout
+    };
+
+    // Read-only mesh data shared with the registry's cache. A handle pins the mesh: only meshes
+    // nobody else holds are evicted, so the data stays valid for as long as the handle lives.
+    using MeshDataHandle = std::shared_ptr<const MeshData>;
+
+    struct MeshBounds
+    {
+        std::array<float, 3> min{0.0f, 0.0f, 0.0f};
+        std::array<float, 3> max{0.0f, 0.0f, 0.0f};
+        std::array<float, 3> center{0.0f, 0.0f, 0.0f};
+        float radius{0.0f};
     };
 
     struct CachedMesh
@@ -80,6 +145,7 @@ public:
         bool flipUVs{false};
         bool flipWinding{false};
         bool optimize{false};
+        bool compressVertices{false};
     };
 
     struct CachedMaterial
@@ -111,8 +177,27 @@ public:
                                const MeshImportSettings& settings);
     bool ReimportMeshAsset(const std::string& assetId,
                            std::string* outMessage = nullptr);
-    [[nodiscard]] const MeshData* GetMeshData(const std::string& assetId) const noexcept;
-    [[nodiscard]] const MeshData* LoadMeshData(const std::string& assetId);
+    using MeshLoadCallback = std::function<void(const MeshDataHandle&)>;
+
+    // Null unless the mesh is in memory; does not load.
+    [[nodiscard]] MeshDataHandle GetMeshData(const std::string& assetId) const noexcept;
+    // Loads on the calling thread. A mesh that is already loading elsewhere is waited for instead
+    // of loaded twice.
+    [[nodiscard]] MeshDataHandle LoadMeshData(const std::string& assetId);
+    // Queues the load on a background thread and returns at once; concurrent requests for the
+    // same mesh share one load. `onLoaded` runs on the thread that finished the load, after the
+    // future is ready (immediately on the caller's thread if the mesh is already in memory).
+    std::shared_future<MeshDataHandle> LoadMeshDataAsync(const std::string& assetId,
+                                                         MeshLoadCallback onLoaded = {});
+    // Background load threads; 0 (the default) picks a count from the hardware. Takes effect when
+    // the first asynchronous load starts them.
+    void SetLoadThreadCount(std::size_t threads) noexcept;
+    // Bounds of any mesh loaded so far, kept after its data has been evicted so culling and LOD
+    // selection never need the vertices again.
+    [[nodiscard]] bool GetMeshBounds(const std::string& assetId, MeshBounds& out) const noexcept;
+    // The cooked container a load of the mesh would use for its current source and settings;
+    // empty if it has not been cooked yet.
+    [[nodiscard]] std::filesystem::path FindCookedMesh(const std::string& assetId);
 
     struct AssetChange
     {
@@ -131,6 +216,52 @@ public:
         std::uint64_t serial{0};
     };
 
+    struct ScanStats
+    {
+        double milliseconds{0.0};
+        std::size_t files{0};
+        // Sidecars opened (and parsed or written); the rest came from the scan index.
+        std::size_t sidecarsParsed{0};
+        // The index was loaded from the cache root, i.e. saved by an earlier session.
+        bool indexFromDisk{false};
+        std::size_t threads{1};
+    };
+
+    [[nodiscard]] const ScanStats& GetLastScanStats() const noexcept;
+
+    struct MemoryUsage
+    {
+        std::size_t entries{0};
+        std::uint64_t bytes{0};
+        // Held through a handle outside the registry; these cannot be evicted.
+        std::size_t pinnedEntries{0};
+        std::uint64_t pinnedBytes{0};
+    };
+
+    // CPU memory held by the registry, per kind of data.
+    struct MemoryStats
+    {
+        std::uint64_t meshDataBudget{0};
+        MemoryUsage meshData;
+        MemoryUsage meshBounds;
+        MemoryUsage importMetadata; // glTF meshes, textures and materials
+        std::size_t meshDataHits{0};
+        std::size_t meshDataMisses{0};
+        std::size_t meshDataEvictions{0};
+        // Requests that found the mesh already loading and waited for that load.
+        std::size_t meshLoadsShared{0};
+        std::size_t meshLoadsInFlight{0};
+    };
+
+    [[nodiscard]] MemoryStats GetMemoryStats() const;
+    // Loaded mesh data is kept within this many bytes (512 MB by default) by dropping the least
+    // recently used unpinned meshes; they are reloaded, usually from the cook, when asked for
+    // again. 0 keeps everything.
+    void SetMeshDataBudget(std::uint64_t bytes);
+    // Threads a Scan walks directories and reads sidecars with; 0 (the default) picks a count
+    // from the hardware. Small trees are read on the calling thread either way.
+    void SetScanThreadCount(std::size_t threads) noexcept;
+
     [[nodiscard]] std::uint64_t GetChangeSerial() const noexcept;
     void GetChangesSince(std::uint64_t serial, std::vector<AssetChange>& out) const;
 
@@ -143,21 +274,151 @@ private:
     std::unordered_map<std::string, CachedMesh> m_meshes;
     std::unordered_map<std::string, CachedTexture> m_textures;
     std::unordered_map<std::string, CachedMaterial> m_materials;
-    std::unordered_map<std::string, MeshData> m_meshData;
+    struct MeshDataSlot
+    {
+        std::shared_ptr<const MeshData> data;
+        std::uint64_t bytes{0};
+        mutable std::uint64_t lastUse{0};
+    };
+
+    std::unordered_map<std::string, MeshDataSlot> m_meshData;
+    std::unordered_map<std::string, MeshBounds> m_meshBounds;
+    std::uint64_t m_meshDataBytes{0};
+    std::uint64_t m_meshDataBudget{std::uint64_t{512} << 20};
+    mutable std::uint64_t m_meshDataUseCounter{0};
+    std::size_t m_meshDataHits{0};
+    std::size_t m_meshDataMisses{0};
+    std::size_t m_meshDataEvictions{0};
+    std::size_t m_meshLoadsShared{0};
+
+    // A mesh being loaded. Later requests for it wait on `future` or leave a callback.
+    struct MeshLoad
+    {
+        std::promise<MeshDataHandle> promise;
+        std::shared_future<MeshDataHandle> future;
+        std::vector<MeshLoadCallback> callbacks;
+        std::uint64_t generation{0};
+    };
+
+    std::unordered_map<std::string, std::shared_ptr<MeshLoad>> m_meshLoads;
+    // Bumped whenever cached mesh data is dropped; a load that started before is handed to its
+    // waiters but not cached, since it may have read the old file.
+    std::uint64_t m_meshDataGeneration{0};
+    // Guards the mesh data, bounds and in-flight tables. Never held while a mesh is imported, so
+    // readers only wait for table updates.
+    mutable std::recursive_mutex m_meshDataMutex;
+
+    struct LoadJob
+    {
+        std::string assetId;
+        std::shared_ptr<MeshLoad> load;
+    };
+
+    std::mutex m_loadQueueMutex;
+    std::condition_variable m_loadQueueWake;
+    std::deque<LoadJob> m_loadQueue;
+    std::vector<std::thread> m_loadThreads;
+    std::size_t m_loadThreadCount{0};
+    bool m_stopLoading{false};
+
+    mutable std::mutex m_snapshotMutex;
+    std::shared_ptr<const Snapshot> m_snapshot{std::make_shared<const Snapshot>()};
     std::filesystem::path m_rootPath;
+    std::filesystem::path m_cacheRoot;
+    DerivedDataCache m_derivedData;
+    std::shared_ptr<const VirtualFileSystem> m_fileSystem;
     std::vector<AssetEntry> m_entries;
     std::unordered_map<std::string, size_t> m_entryLookup;
     std::unordered_map<std::string, std::string> m_pathToId;
 
+    // A file as last seen on disk; any difference means it changed.
+    struct FileStamp
+    {
+        std::uint64_t size{0};
+        std::int64_t mtimeNs{0};
+        std::uint64_t inode{0};
+        bool exists{false};
+
+        bool operator==(const FileStamp&) const = default;
+    };
+
     struct FileState
     {
         std::filesystem::path path;
-        std::filesystem::file_time_type assetTime{};
-        std::filesystem::file_time_type metaTime{};
+        FileStamp asset;
+        FileStamp meta;
     };
 
     std::unordered_map<std::string, FileState> m_fileStates;
     std::vector<AssetChange> m_changeLog;
     std::uint64_t m_changeSerial{0};
+
+    // What each file's sidecar said while the file and sidecar had these stamps, keyed by
+    // root-relative path. Scans reuse it instead of opening unchanged sidecars; it is kept in
+    // the cache root across sessions.
+    struct IndexedFile
+    {
+        std::string id;
+        AssetType type{AssetType::Other};
+        FileStamp asset;
+        FileStamp meta;
+        std::uint64_t lastSeenScan{0}; // Not persisted
+    };
+
+    std::unordered_map<std::string, IndexedFile> m_scanIndex;
+    bool m_scanIndexLoaded{false};
+    bool m_scanIndexDirty{false};
+    std::uint64_t m_scanGeneration{0};
+    std::size_t m_sidecarReads{0};
+    std::size_t m_scanThreadCount{0};
+    ScanStats m_lastScanStats;
+
+    // One file as read by a scan worker, applied to the registry afterwards in path order.
+    struct ScannedFile
+    {
+        std::string label;
+        std::string key;
+        AssetEntry entry;
+        FileState state;
+        bool sidecarRead{false};
+    };
+
+    // Reads (and creates or fixes) the sidecar of one file; false for files that are not assets.
+    // Only reads registry state (the root and the scan index), so workers may call it
+    // concurrently while nothing else touches the registry.
+    bool ScanFile(const std::filesystem::path& path, ScannedFile& out) const;
+    // Records a scanned file in the scan index.
+    void CommitScannedFile(const ScannedFile& file);
+    bool ReadAssetFile(const std::filesystem::path& path, AssetEntry& outEntry, FileState& outState);
+    [[nodiscard]] std::size_t ResolveScanThreadCount() const noexcept;
+    [[nodiscard]] static FileStamp StatFile(const std::filesystem::path& path);
+    [[nodiscard]] std::filesystem::path GetScanIndexPath() const;
+    // Publishes the owner's entries as the new snapshot.
+    void PublishSnapshot();
+    [[nodiscard]] std::filesystem::path ResolveMeshSource(const std::string& assetId) const;
+    // Returns the in-memory mesh in `outCached`, or the load to wait for. `outOwner` is set when
+    // the caller registered a new load and has to run it with RunMeshLoad.
+    std::shared_ptr<MeshLoad> AcquireMeshLoad(const std::string& assetId, MeshDataHandle& outCached,
+                                              bool& outOwner);
+    void RunMeshLoad(const std::string& assetId, MeshLoad& load);
+    // Reads a cook or imports the source; touches no registry table.
+    bool ImportMeshData(const std::string& assetId, MeshData& out);
+    // False if no thread could be started.
+    bool StartLoadThreads();
+    void LoadThreadMain();
+    // The m_meshData helpers expect m_meshDataMutex to be held.
+    MeshDataHandle StoreMeshData(const std::string& assetId, MeshData&& mesh);
+    void EraseMeshData(const std::string& assetId);
+    void EvictMeshData();
+    // Hashes a source and, for .gltf, the buffers it references.
+    bool HashAssetSource(const std::filesystem::path& source, std::uint64_t& outHash);
+    bool GetCookedMeshKey(const std::filesystem::path& source, std::uint64_t settingsHash,
+                          DerivedDataCache::Key& outKey);
+    void LoadScanIndex();
+    void SaveScanIndex();
+    void SortEntries();
+    AssetChange RecordChange(const std::string& id, AssetType type, AssetChange::Kind kind);
+    void DropCachedData(const AssetChange& change);
+    void TrimChangeLog();
 };
 } // namespace Aetherion::Assets
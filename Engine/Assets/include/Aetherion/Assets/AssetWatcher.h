@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Aetherion::Assets
+{
+// A change reported by a watch backend. Paths are absolute.
+struct FileEvent
+{
+    enum class Kind
+    {
+        Changed,  // Created, written, touched or moved in
+        Removed,  // Deleted or moved out; may name a directory
+        Overflow, // Events were lost; only a full rescan is reliable
+    };
+
+    std::filesystem::path path;
+    Kind kind{Kind::Changed};
+};
+
+// Platform side of the watcher: reports changes below a directory without blocking.
+class IFileWatchBackend
+{
+public:
+    virtual ~IFileWatchBackend() = default;
+
+    [[nodiscard]] virtual const char* GetName() const = 0;
+    // False when the facility is unavailable (e.g. out of inotify watches).
+    virtual bool Start(const std::filesystem::path& root) = 0;
+    virtual void Stop() = 0;
+    // Appends what happened since the last call.
+    virtual void Poll(std::vector<FileEvent>& out) = 0;
+};
+
+// inotify on Linux; null on platforms without a native backend.
+[[nodiscard]] std::unique_ptr<IFileWatchBackend> CreateNativeFileWatchBackend();
+// Compares write times and sizes of the whole tree once per `interval`. Only stats files; no
+// sidecar is opened.
+[[nodiscard]] std::unique_ptr<IFileWatchBackend> CreatePollingFileWatchBackend(
+    std::chrono::milliseconds interval);
+
+// Watches the asset root and hands out changed paths once the tree has been quiet for the
+// debounce window, so an editor saving in several writes, an asset and its sidecar written back
+// to back, or a rename arrive as one batch for AssetRegistry::ApplyFileChanges.
+class AssetWatcher
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Settings
+    {
+        std::chrono::milliseconds debounce{250};
+        // Pending changes are handed out after this long even if events keep coming.
+        std::chrono::milliseconds maxDelay{2000};
+        // Used by the polling fallback only.
+        std::chrono::milliseconds pollInterval{2000};
+        bool allowNative{true};
+    };
+
+    struct Batch
+    {
+        std::vector<std::filesystem::path> paths;
+        // Set after an overflow; `paths` is empty then.
+        bool rescanRequired{false};
+
+        [[nodiscard]] bool IsEmpty() const noexcept { return paths.empty() && !rescanRequired; }
+    };
+
+    AssetWatcher();
+    explicit AssetWatcher(const Settings& settings);
+    ~AssetWatcher();
+
+    AssetWatcher(const AssetWatcher&) = delete;
+    AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+    // Uses the native backend when allowed and available, else polls.
+    bool Start(const std::filesystem::path& root);
+    bool Start(const std::filesystem::path& root, std::unique_ptr<IFileWatchBackend> backend);
+    void Stop();
+    [[nodiscard]] bool IsRunning() const noexcept { return m_backend != nullptr; }
+    [[nodiscard]] const std::filesystem::path& GetRoot() const noexcept { return m_root; }
+    [[nodiscard]] const char* GetBackendName() const noexcept;
+
+    // Drains the backend; returns the pending paths once the tree has been quiet long enough.
+    [[nodiscard]] Batch Poll(Clock::time_point now = Clock::now());
+
+private:
+    Settings m_settings;
+    std::filesystem::path m_root;
+    std::unique_ptr<IFileWatchBackend> m_backend;
+    std::vector<FileEvent> m_events;
+    std::unordered_map<std::string, std::filesystem::path> m_pending;
+    bool m_overflow{false};
+    Clock::time_point m_firstEvent{};
+    Clock::time_point m_lastEvent{};
+};
+} // namespace Aetherion::Assets
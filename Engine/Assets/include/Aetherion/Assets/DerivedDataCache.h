@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Aetherion::Assets
+{
+// Content-addressed store for data derived from source assets (cooked meshes, textures, import
+// results). Entries are files named after a key built from the hash of the source bytes and of
+// everything else that affects the output, so a touched, renamed or copied source still hits and
+// an edited one never does. The cache is bounded: once it grows past its budget the least
+// recently used entries are deleted.
+//
+// Source hashes are remembered per path together with the size, write time and inode they were
+// computed for, and persisted with the entry index. A project reopened without changes therefore
+// only stats its sources; no source byte is read for an entry that is already cooked.
+//
+// All members are thread-safe.
+class DerivedDataCache
+{
+public:
+    struct Key
+    {
+        // Short tag naming what the entry holds; used as the file extension.
+        std::string kind;
+        std::uint64_t hash{0};
+    };
+
+    struct Stats
+    {
+        std::size_t hits{0};
+        std::size_t misses{0};
+        std::size_t stores{0};
+        std::size_t evictions{0};
+        std::size_t entries{0};
+        std::uint64_t bytes{0};
+        // Sources whose hash had to be computed from their bytes, and how many bytes that read.
+        std::size_t sourcesHashed{0};
+        std::uint64_t bytesHashed{0};
+    };
+
+    // Lists the other files a source's output depends on (e.g. the buffers of a .gltf). Only
+    // called when the source has to be hashed.
+    using DependencyLister = std::function<std::vector<std::filesystem::path>(const std::filesystem::path&)>;
+
+    DerivedDataCache() = default;
+    ~DerivedDataCache();
+
+    DerivedDataCache(const DerivedDataCache&) = delete;
+    DerivedDataCache& operator=(const DerivedDataCache&) = delete;
+
+    // Uses `root` for entries and the index (created on demand). Closes the previous root first.
+    void Open(const std::filesystem::path& root);
+    // Writes the index and forgets the root.
+    void Close();
+    // Writes the index if anything changed since it was last written.
+    void Flush();
+
+    [[nodiscard]] bool IsOpen() const;
+    [[nodiscard]] std::filesystem::path GetRoot() const;
+    // Total size of the entries before eviction kicks in (4 GiB by default). 0 disables eviction.
+    void SetMaxBytes(std::uint64_t maxBytes);
+
+    // Hashes the bytes of `source` and of whatever `dependencies` lists for it. False if any of
+    // them cannot be read.
+    bool HashSource(const std::filesystem::path& source, std::uint64_t& outHash,
+                    const DependencyLister& dependencies = {});
+
+    // `settingsHash` covers everything besides the source that changes the output, including the
+    // version of the code producing it.
+    [[nodiscard]] static Key MakeKey(std::string_view kind, std::uint64_t contentHash,
+                                     std::uint64_t settingsHash);
+    [[nodiscard]] static std::uint64_t HashBytes(const void* data, std::size_t size,
+                                                 std::uint64_t seed = 0) noexcept;
+    // A temporary next to `path` that no other writer, in this process or another, uses. Files
+    // are written there and renamed into place.
+    [[nodiscard]] static std::filesystem::path MakeTempPath(const std::filesystem::path& path);
+
+    // Where the entry for `key` lives, whether or not it exists. Writers create the file there
+    // (via a temporary and a rename) and then call Commit.
+    [[nodiscard]] std::filesystem::path GetEntryPath(const Key& key) const;
+    // A hit marks the entry as used and returns its path.
+    bool Find(const Key& key, std::filesystem::path& outPath);
+    // Records the file written to GetEntryPath(key) and evicts entries over the budget.
+    void Commit(const Key& key);
+    // Drops an entry, e.g. one that turned out to be unreadable or that a forced reimport replaces.
+    void Remove(const Key& key);
+
+    // Small entries held in memory by the caller.
+    bool Load(const Key& key, std::vector<std::uint8_t>& out);
+    bool Store(const Key& key, const std::vector<std::uint8_t>& data);
+
+    [[nodiscard]] Stats GetStats() const;
+
+private:
+    struct FileStamp
+    {
+        std::uint64_t size{0};
+        std::int64_t mtimeNs{0};
+        std::uint64_t inode{0};
+
+        bool operator==(const FileStamp&) const = default;
+    };
+
+    struct Dependency
+    {
+        std::string path;
+        FileStamp stamp;
+    };
+
+    struct SourceHash
+    {
+        FileStamp stamp;
+        std::vector<Dependency> dependencies;
+        std::uint64_t hash{0};
+    };
+
+    struct Entry
+    {
+        std::string kind;
+        std::uint64_t size{0};
+        std::uint64_t lastUse{0};
+    };
+
+    [[nodiscard]] static bool StatFile(const std::filesystem::path& path, FileStamp& out);
+    [[nodiscard]] static bool HashFile(const std::filesystem::path& path, std::uint64_t& hash,
+                                       std::uint64_t& bytesRead);
+    [[nodiscard]] std::filesystem::path GetEntryPathLocked(const Key& key) const;
+    void EvictLocked();
+    void LoadIndexLocked();
+    void SaveIndexLocked();
+
+    mutable std::mutex m_mutex;
+    std::filesystem::path m_root;
+    std::uint64_t m_maxBytes{std::uint64_t{4} << 30};
+    std::unordered_map<std::uint64_t, Entry> m_entries;
+    std::unordered_map<std::string, SourceHash> m_sources;
+    std::uint64_t m_totalBytes{0};
+    std::uint64_t m_useCounter{0};
+    bool m_dirty{false};
+    Stats m_stats;
+};
+} // namespace Aetherion::Assets
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+#include "Aetherion/Assets/AssetRegistry.h"
+
+namespace Aetherion::Assets
+{
+// Read-only memory mapping of a whole file. Move-only; unmapped on destruction.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // False for missing or empty files.
+    bool Open(const std::filesystem::path& path);
+    void Close() noexcept;
+
+    [[nodiscard]] bool IsOpen() const noexcept { return m_data != nullptr; }
+    [[nodiscard]] const std::uint8_t* GetData() const noexcept { return m_data; }
+    [[nodiscard]] std::size_t GetSize() const noexcept { return m_size; }
+
+private:
+    const std::uint8_t* m_data{nullptr};
+    std::size_t m_size{0};
+#ifdef _WIN32
+    void* m_mapping{nullptr};
+#endif
+};
+
+// Index range of one level of detail. Cooks currently store the imported mesh as level 0 only.
+struct CookedMeshLod
+{
+    std::uint32_t firstIndex{0};
+    std::uint32_t indexCount{0};
+    float screenError{0.0f};
+    std::uint32_t reserved{0};
+};
+
+// A mesh as laid out in an `.amesh` container. The spans point into the mapping owned by the
+// CookedMeshFile they came from and stay valid while it is open.
+struct CookedMeshView
+{
+    std::span<const std::array<float, 3>> positions;
+    std::span<const std::array<float, 3>> normals;
+    std::span<const std::array<float, 4>> colors;
+    std::span<const std::array<float, 2>> uvs;
+    std::span<const std::array<float, 4>> tangents;
+    std::span<const std::uint32_t> indices;
+    std::span<const CookedMeshLod> lods;
+    std::array<float, 3> boundsMin{0.0f, 0.0f, 0.0f};
+    std::array<float, 3> boundsMax{0.0f, 0.0f, 0.0f};
+    std::array<float, 3> boundsCenter{0.0f, 0.0f, 0.0f};
+    float boundsRadius{0.0f};
+    bool compressedVertices{false};
+};
+
+// An open `.amesh` container. Opening validates the header, the source stamp, the
+// import-settings hash and the index range and maps the file; nothing is parsed or copied. An
+// empty `source` skips the stamp check, for containers found by content.
+class CookedMeshFile
+{
+public:
+    bool Open(const std::filesystem::path& path, const std::filesystem::path& source,
+              std::uint64_t settingsHash);
+    void Close() noexcept;
+
+    [[nodiscard]] bool IsOpen() const noexcept { return m_file.IsOpen(); }
+    [[nodiscard]] const CookedMeshView& GetView() const noexcept { return m_view; }
+
+private:
+    MappedFile m_file;
+    CookedMeshView m_view;
+};
+
+// Changes whenever a setting that affects the imported geometry changes.
+[[nodiscard]] std::uint64_t HashMeshImportSettings(const AssetRegistry::MeshImportSettings& settings) noexcept;
+
+// Streams are written 16-byte aligned so the mapped spans are aligned as well.
+bool WriteCookedMesh(const std::filesystem::path& path, const std::filesystem::path& source,
+                     std::uint64_t settingsHash, const AssetRegistry::MeshData& mesh);
+// One bulk copy per stream into `out`.
+void CopyCookedMesh(const CookedMeshView& view, AssetRegistry::MeshData& out);
+} // namespace Aetherion::Assets
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+#include "Aetherion/Assets/AssetRegistry.h"
+
+namespace Aetherion::Assets
+{
+struct ObjParseInfo
+{
+    // Some vertex referenced a valid normal / some vertex had none.
+    bool hasNormals{false};
+    bool missingNormals{false};
+    std::size_t lines{0};
+    std::size_t chunks{0};
+};
+
+// Reads the geometry of an OBJ file: `v` (with optional RGB[A] vertex colors), `vt`, `vn` and `f`
+// lines, fanning polygons into triangles and merging corners that share position, texcoord and
+// normal indices. Everything else is ignored. Fills positions, colors, normals (normalized,
+// +Z where missing), uvs and indices; no other post-processing is done.
+//
+// Text at or above a few MB is split into chunks at line boundaries and parsed on up to
+// `threads` threads (0 picks from the hardware); the result does not depend on the split.
+// `minChunkBytes` overrides the 1 MB minimum chunk size (texts from four chunks up are split),
+// which lets tests split tiny texts. Returns false when no triangle was produced.
+[[nodiscard]] bool ParseObj(std::string_view text, AssetRegistry::MeshData& out,
+                            ObjParseInfo* info = nullptr, std::size_t threads = 0,
+                            std::size_t minChunkBytes = 0);
+// Maps the file and parses it in place.
+[[nodiscard]] bool ParseObjFile(const std::filesystem::path& path, AssetRegistry::MeshData& out,
+                                ObjParseInfo* info = nullptr, std::size_t threads = 0);
+} // namespace Aetherion::Assets
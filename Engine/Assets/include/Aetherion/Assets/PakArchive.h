@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Aetherion/Assets/MeshCooker.h"
+
+namespace Aetherion::Assets
+{
+// How an entry's bytes are stored. Values are stored on disk.
+enum class PakCompression : std::uint32_t
+{
+    None = 0,
+    // LZ4 block format (no frame header); any LZ4 block decoder reads it.
+    Lz4 = 1,
+};
+
+// One file of an archive. The strings point into the archive's mapping.
+struct PakEntry
+{
+    // Asset id from the file's sidecar; empty for files that are not assets.
+    std::string_view id;
+    // '/'-separated path relative to the packed directory.
+    std::string_view path;
+    std::uint64_t offset{0};
+    std::uint64_t size{0};
+    std::uint64_t storedSize{0};
+    // DerivedDataCache::HashBytes of the uncompressed bytes.
+    std::uint64_t hash{0};
+    PakCompression compression{PakCompression::None};
+};
+
+// Read-only `.apak` archive: the files of a cooked content directory in one memory-mapped file,
+// so a load opens one file instead of thousands. Entry data starts on 64-byte boundaries, which
+// keeps stored entries usable in place with the alignment they would have as files of their own
+// (e.g. the 16-byte aligned streams of an `.amesh`). The table of contents at the end of the file
+// is sorted by asset id; opening an archive reads nothing else.
+class PakArchive
+{
+public:
+    PakArchive() = default;
+
+    PakArchive(const PakArchive&) = delete;
+    PakArchive& operator=(const PakArchive&) = delete;
+
+    // False for missing, truncated or malformed archives.
+    bool Open(const std::filesystem::path& path);
+    void Close() noexcept;
+
+    [[nodiscard]] bool IsOpen() const noexcept { return m_file.IsOpen(); }
+    [[nodiscard]] const std::filesystem::path& GetPath() const noexcept { return m_path; }
+    // Sorted by id.
+    [[nodiscard]] const std::vector<PakEntry>& GetEntries() const noexcept { return m_entries; }
+
+    [[nodiscard]] const PakEntry* FindById(std::string_view id) const noexcept;
+    [[nodiscard]] const PakEntry* FindByPath(std::string_view path) const noexcept;
+
+    // The entry's bytes as stored, valid while the archive is open. For uncompressed entries
+    // these are the file's contents.
+    [[nodiscard]] std::span<const std::uint8_t> GetStoredData(const PakEntry& entry) const noexcept;
+    // Uncompressed contents. False if the stored data does not decode to the entry's size.
+    bool Read(const PakEntry& entry, std::vector<std::uint8_t>& out) const;
+
+private:
+    MappedFile m_file;
+    std::filesystem::path m_path;
+    std::vector<PakEntry> m_entries;
+    std::unordered_map<std::string_view, std::size_t> m_pathLookup;
+};
+
+struct PakWriteEntry
+{
+    std::string id;
+    std::string path;
+    std::filesystem::path source;
+    PakCompression compression{PakCompression::None};
+};
+
+struct PakWriteStats
+{
+    std::size_t entries{0};
+    std::size_t compressedEntries{0};
+    std::uint64_t bytes{0};
+    std::uint64_t storedBytes{0};
+};
+
+// Packs the files into `path`, written through a temporary and a rename. Entries asked to be
+// compressed are stored uncompressed when compression saves less than an eighth of their size.
+// Paths, and ids that are not empty, must be unique.
+bool WritePakArchive(const std::filesystem::path& path, const std::vector<PakWriteEntry>& entries,
+                     PakWriteStats* outStats = nullptr, std::string* outError = nullptr);
+} // namespace Aetherion::Assets
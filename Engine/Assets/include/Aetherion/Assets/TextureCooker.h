@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Aetherion/Assets/DerivedDataCache.h"
+
+namespace Aetherion::Assets
+{
+// Block/texel layouts understood by the renderer. Values are stored on disk.
+enum class TextureFormat : std::uint32_t
+{
+    RGBA8 = 0,
+    BC1 = 1, // RGB, 4 bpp
+    BC3 = 2, // RGBA (BC1 color + BC4 alpha), 8 bpp
+    BC5 = 3, // Two channels (normal maps), 8 bpp
+    BC7 = 4, // RGBA, 8 bpp, higher quality than BC1/BC3
+};
+
+enum class TextureCompression
+{
+    None, // RGBA8 mips only
+    Auto, // BC1 for opaque, BC3 when alpha is used
+    BC5,
+    BC7,
+};
+
+struct TextureCookSettings
+{
+    TextureCompression compression{TextureCompression::Auto};
+    bool generateMips{true};
+    bool srgb{true};
+};
+
+struct CookedTexture
+{
+    struct Mip
+    {
+        std::uint32_t width{0};
+        std::uint32_t height{0};
+        std::uint64_t offset{0};
+        std::uint64_t size{0};
+    };
+
+    TextureFormat format{TextureFormat::RGBA8};
+    bool srgb{true};
+    // Size of level 0 of the full chain. When leading levels were skipped on load, `mips[0]`
+    // is level `baseMip` of that chain and carries its own, smaller size.
+    std::uint32_t width{0};
+    std::uint32_t height{0};
+    std::uint32_t baseMip{0};
+    std::vector<Mip> mips;
+    std::vector<std::uint8_t> data;
+};
+
+// Selects which part of a mip chain to load. Levels above `firstMip`, and levels larger than
+// `maxSize` (when non-zero), are skipped; the smallest level is always kept. Texture streaming
+// uses this to keep only the mips that are actually visible resident.
+struct TextureMipRange
+{
+    std::uint32_t firstMip{0};
+    std::uint32_t maxSize{0};
+};
+
+[[nodiscard]] bool IsBlockCompressed(TextureFormat format) noexcept;
+[[nodiscard]] std::uint32_t GetBlockBytes(TextureFormat format) noexcept;
+[[nodiscard]] std::uint64_t GetMipLevelSize(TextureFormat format, std::uint32_t width, std::uint32_t height) noexcept;
+[[nodiscard]] std::uint32_t GetMipLevelCount(std::uint32_t width, std::uint32_t height) noexcept;
+
+// Decodes `source` (any stb_image format, or a .dds with BC/RGBA8 data), builds a mip chain
+// (box filter, sRGB-aware) and block-compresses it. DDS sources keep their stored format.
+[[nodiscard]] bool CookTexture(const std::filesystem::path& source, const TextureCookSettings& settings,
+                               CookedTexture& out, std::string* outError = nullptr);
+
+// Same as CookTexture, but first looks for an up-to-date `.atex` container under `cacheDir`
+// and writes one after cooking. An empty `cacheDir` disables the disk cache. Any block-compressed
+// container satisfies a compressed request, so offline BC7/BC5 cooks are picked up at runtime.
+[[nodiscard]] bool LoadOrCookTexture(const std::filesystem::path& source, const std::filesystem::path& cacheDir,
+                                     const TextureCookSettings& settings, CookedTexture& out,
+                                     std::string* outError = nullptr, const TextureMipRange& range = {});
+
+// Same again with the container kept in a derived-data cache under the hash of the source bytes,
+// so touched, moved or duplicated sources reuse one cook. Falls back to cooking without a disk
+// cache when `cache` is closed.
+[[nodiscard]] bool LoadOrCookTexture(const std::filesystem::path& source, DerivedDataCache& cache,
+                                     const TextureCookSettings& settings, CookedTexture& out,
+                                     std::string* outError = nullptr, const TextureMipRange& range = {});
+// Like the `.atex` slots, all BCn variants share one key. False if the source cannot be read.
+[[nodiscard]] bool GetCookedTextureKey(const std::filesystem::path& source, DerivedDataCache& cache,
+                                       const TextureCookSettings& settings, DerivedDataCache::Key& out);
+
+[[nodiscard]] std::filesystem::path GetCookedTexturePath(const std::filesystem::path& source,
+                                                         const std::filesystem::path& cacheDir,
+                                                         const TextureCookSettings& settings);
+bool WriteCookedTexture(const std::filesystem::path& path, const std::filesystem::path& source,
+                        const CookedTexture& texture);
+// Only the levels selected by `range` are read from disk; the rest of the payload is skipped. An
+// empty `source` skips the staleness check, for containers found by content.
+[[nodiscard]] bool ReadCookedTexture(const std::filesystem::path& path, const std::filesystem::path& source,
+                                     CookedTexture& out, const TextureMipRange& range = {});
+} // namespace Aetherion::Assets
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Aetherion/Assets/MeshCooker.h"
+#include "Aetherion/Assets/PakArchive.h"
+
+namespace Aetherion::Assets
+{
+// Read access to content that lives in loose directories, pak archives or both. Each mount serves
+// its files below a virtual directory (its mount point). Lookups try the mounts by descending
+// priority, the latest mount first among equal ones, so a loose directory mounted above an
+// archive overrides single files of it and a patch archive overrides the base one.
+//
+// Paths are either virtual ('/'-separated and relative, e.g. "scenes/level.json") or absolute.
+// An absolute path inside a mounted directory is looked up by its virtual path as well, so code
+// that holds paths below the content root reads packed files without knowing about archives.
+// Paths that no mount knows are read from disk as they are.
+//
+// All members are thread-safe. Open views keep their archive alive across an unmount.
+class VirtualFileSystem
+{
+public:
+    using MountId = std::uint32_t;
+
+    // The contents of one file: a mapping of a loose file, the archive's mapping for stored
+    // entries, or a decompressed copy.
+    class FileView
+    {
+    public:
+        [[nodiscard]] std::span<const std::uint8_t> GetData() const noexcept { return m_data; }
+        [[nodiscard]] std::string_view GetText() const noexcept
+        {
+            return {reinterpret_cast<const char*>(m_data.data()), m_data.size()};
+        }
+
+    private:
+        friend class VirtualFileSystem;
+
+        std::span<const std::uint8_t> m_data;
+        MappedFile m_mapping;
+        std::shared_ptr<const PakArchive> m_archive;
+        std::vector<std::uint8_t> m_buffer;
+    };
+
+    // A file served from an archive.
+    struct ArchiveFile
+    {
+        std::string path;
+        std::string id;
+        std::uint64_t size{0};
+        std::uint64_t hash{0};
+    };
+
+    VirtualFileSystem() = default;
+
+    VirtualFileSystem(const VirtualFileSystem&) = delete;
+    VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+    // An empty mount point serves the files at the top of the virtual tree.
+    MountId MountDirectory(const std::filesystem::path& directory, std::string_view mountPoint = {},
+                           int priority = 0);
+    // 0 if the archive cannot be opened.
+    MountId MountArchive(const std::filesystem::path& archive, std::string_view mountPoint = {},
+                         int priority = 0);
+    bool Unmount(MountId id);
+    void UnmountAll();
+
+    [[nodiscard]] bool Exists(const std::filesystem::path& path) const;
+    bool OpenFile(const std::filesystem::path& path, FileView& out) const;
+    bool ReadFile(const std::filesystem::path& path, std::vector<std::uint8_t>& out) const;
+    bool ReadText(const std::filesystem::path& path, std::string& out) const;
+
+    // The virtual path of a path inside a mounted directory ("" for the top of the tree).
+    bool GetVirtualPath(const std::filesystem::path& path, std::string& outVirtualPath) const;
+    // The virtual path of the file the first archive in lookup order stores under asset `id`.
+    // Reads of that path still go through the mounts, so a loose override of it wins. Loose files
+    // carry no ids and are not searched.
+    bool FindArchivedAsset(std::string_view id, std::string& outVirtualPath) const;
+    // Every file the archives serve, once each (from the archive a lookup would pick). Loose
+    // files that hide some of them are not checked for.
+    [[nodiscard]] std::vector<ArchiveFile> ListArchiveFiles() const;
+
+private:
+    struct Mount
+    {
+        MountId id{0};
+        int priority{0};
+        std::string mountPoint;
+        std::filesystem::path directory;
+        std::shared_ptr<const PakArchive> archive;
+    };
+
+    // Where a lookup found a file: on disk, or in an archive.
+    struct Location
+    {
+        std::filesystem::path diskPath;
+        std::shared_ptr<const PakArchive> archive;
+        const PakEntry* entry{nullptr};
+    };
+
+    MountId AddMount(Mount mount);
+    bool Resolve(const std::filesystem::path& path, Location& out) const;
+    bool GetVirtualPathLocked(const std::filesystem::path& path, std::string& out) const;
+
+    mutable std::shared_mutex m_mutex;
+    // In lookup order.
+    std::vector<Mount> m_mounts;
+    MountId m_nextMountId{1};
+};
+} // namespace Aetherion::Assets
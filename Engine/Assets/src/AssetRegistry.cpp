@@ -1,19 +1,35 @@
 #include "Aetherion/Assets/AssetRegistry.h"
+#include "Aetherion/Assets/MeshCooker.h"
+#include "Aetherion/Assets/ObjParser.h"
+#include "Aetherion/Assets/TextureCooker.h"
+#include "Aetherion/Assets/VirtualFileSystem.h"
 #include "Aetherion/Core/String.h"
 #include "Aetherion/Core/UUID.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <iterator>
 #include <limits>
+#include <mutex>
 #include <random>
-#include <sstream>
+#include <system_error>
+#include <thread>
 #include <unordered_set>
 
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
 #define CGLTF_IMPLEMENTATION
 #include "cgltf/cgltf.h"
 #include "nlohmann/json.hpp"
@@ -122,6 +138,10 @@ ReadMeshImportSettingsFromJson(const Json &root) {
   if (import.contains("optimize") && import["optimize"].is_boolean()) {
     settings.optimize = import["optimize"].get<bool>();
   }
+  if (import.contains("compressVertices") &&
+      import["compressVertices"].is_boolean()) {
+    settings.compressVertices = import["compressVertices"].get<bool>();
+  }
 
   settings.scale = SanitizeImportScale(settings.scale);
   return settings;
@@ -162,6 +182,10 @@ void WriteMeshImportSettingsToJson(
       !import["optimize"].is_boolean()) {
     import["optimize"] = settings.optimize;
   }
+  if (overwrite || !import.contains("compressVertices") ||
+      !import["compressVertices"].is_boolean()) {
+    import["compressVertices"] = settings.compressVertices;
+  }
 }
 
 bool ReadMetadataFile(const std::filesystem::path &metaPath, std::string &outId,
@@ -248,18 +272,60 @@ bool EnsureMetadataForAsset(const std::filesystem::path &assetPath,
   return true;
 }
 
-std::filesystem::file_time_type
-SafeWriteTime(const std::filesystem::path &path) {
-  std::error_code ec;
-  auto time = std::filesystem::last_write_time(path, ec);
-  if (ec) {
-    return {};
+constexpr char kScanIndexMagic[4] = {'A', 'I', 'D', 'X'};
+constexpr std::uint32_t kScanIndexVersion = 1;
+
+template <typename T> void WritePod(std::ostream &output, const T &value) {
+  output.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> bool ReadPod(std::istream &input, T &value) {
+  return static_cast<bool>(
+      input.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+void WriteString(std::ostream &output, const std::string &value) {
+  WritePod(output, static_cast<std::uint32_t>(value.size()));
+  output.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+bool ReadString(std::istream &input, std::string &value) {
+  std::uint32_t size = 0;
+  if (!ReadPod(input, size) || size > (1u << 20)) {
+    return false;
+  }
+  value.resize(size);
+  return static_cast<bool>(
+      input.read(value.data(), static_cast<std::streamsize>(size)));
+}
+
+// Label stored in sidecars and used as the scan index key. Scanned files lie
+// below the root, so the lexical form matches std::filesystem::relative
+// without the canonicalizing syscalls.
+std::string RelativeLabel(const std::filesystem::path &path,
+                          const std::filesystem::path &root) {
+  std::filesystem::path relative = path.lexically_relative(root);
+  if (relative.empty() || *relative.begin() == "..") {
+    std::error_code ec;
+    relative = std::filesystem::relative(path, root, ec);
+    if (ec || relative.empty()) {
+      return path.filename().generic_string();
+    }
   }
-  return time;
+  return relative.generic_string();
 }
 
 std::string MakePathKey(const std::filesystem::path &path,
                         const std::filesystem::path &root) {
+  // Paths below the root (every scanned file) are keyed lexically; resolving
+  // symlinks costs several syscalls per file and dominated warm scans.
+  if (!root.empty() && path.is_absolute()) {
+    const auto relative = path.lexically_normal().lexically_relative(root);
+    if (!relative.empty() && *relative.begin() != "..") {
+      return relative.generic_string();
+    }
+  }
+
   std::error_code ec;
   std::filesystem::path normalized =
       std::filesystem::weakly_canonical(path, ec);
@@ -306,24 +372,39 @@ AssetRegistry::AssetType ClassifyAssetType(const std::filesystem::path &path) {
   return AssetRegistry::AssetType::Other;
 }
 
-void TransformPosition(const cgltf_float *matrix, const float in[3],
-                       float out[3]) {
-  out[0] = static_cast<float>(matrix[0] * in[0] + matrix[4] * in[1] +
-                              matrix[8] * in[2] + matrix[12]);
-  out[1] = static_cast<float>(matrix[1] * in[0] + matrix[5] * in[1] +
-                              matrix[9] * in[2] + matrix[13]);
-  out[2] = static_cast<float>(matrix[2] * in[0] + matrix[6] * in[1] +
-                              matrix[10] * in[2] + matrix[14]);
-}
-
-void TransformDirection(const cgltf_float *matrix, const float in[3],
-                        float out[3]) {
-  out[0] = static_cast<float>(matrix[0] * in[0] + matrix[4] * in[1] +
-                              matrix[8] * in[2]);
-  out[1] = static_cast<float>(matrix[1] * in[0] + matrix[5] * in[1] +
-                              matrix[9] * in[2]);
-  out[2] = static_cast<float>(matrix[2] * in[0] + matrix[6] * in[1] +
-                              matrix[10] * in[2]);
+// Vertices are transformed in blocks: each block is split into x/y/z
+// arrays, run through branch-free loops over those arrays (which the
+// compiler turns into SIMD code), and interleaved again.
+constexpr std::size_t kTransformBlock = 64;
+
+// `count` vertices of `stride` floats each, xyz first.
+void TransformPositions(const cgltf_float *matrix, float *data,
+                        std::size_t count, std::size_t stride) {
+  float x[kTransformBlock];
+  float y[kTransformBlock];
+  float z[kTransformBlock];
+  for (std::size_t base = 0; base < count; base += kTransformBlock) {
+    const std::size_t n = std::min(kTransformBlock, count - base);
+    float *block = data + base * stride;
+    for (std::size_t i = 0; i < n; ++i) {
+      x[i] = block[i * stride];
+      y[i] = block[i * stride + 1];
+      z[i] = block[i * stride + 2];
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      const float px = x[i];
+      const float py = y[i];
+      const float pz = z[i];
+      x[i] = matrix[0] * px + matrix[4] * py + matrix[8] * pz + matrix[12];
+      y[i] = matrix[1] * px + matrix[5] * py + matrix[9] * pz + matrix[13];
+      z[i] = matrix[2] * px + matrix[6] * py + matrix[10] * pz + matrix[14];
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      block[i * stride] = x[i];
+      block[i * stride + 1] = y[i];
+      block[i * stride + 2] = z[i];
+    }
+  }
 }
 
 bool ComputeNormalMatrix(const cgltf_float *matrix, float out[9]) {
@@ -367,14 +448,47 @@ bool ComputeNormalMatrix(const cgltf_float *matrix, float out[9]) {
   return true;
 }
 
-void TransformNormal(const float normalMatrix[9], const float in[3],
-                     float out[3]) {
-  out[0] = normalMatrix[0] * in[0] + normalMatrix[3] * in[1] +
-           normalMatrix[6] * in[2];
-  out[1] = normalMatrix[1] * in[0] + normalMatrix[4] * in[1] +
-           normalMatrix[7] * in[2];
-  out[2] = normalMatrix[2] * in[0] + normalMatrix[5] * in[1] +
-           normalMatrix[8] * in[2];
+// Transforms the xyz of `count` directions by `normalMatrix` (when given)
+// and normalizes them; zero-length results become `fallback`.
+void TransformDirections(const float *normalMatrix, float *data,
+                         std::size_t count, std::size_t stride,
+                         const float fallback[3]) {
+  float x[kTransformBlock];
+  float y[kTransformBlock];
+  float z[kTransformBlock];
+  for (std::size_t base = 0; base < count; base += kTransformBlock) {
+    const std::size_t n = std::min(kTransformBlock, count - base);
+    float *block = data + base * stride;
+    for (std::size_t i = 0; i < n; ++i) {
+      x[i] = block[i * stride];
+      y[i] = block[i * stride + 1];
+      z[i] = block[i * stride + 2];
+    }
+    if (normalMatrix) {
+      const float *m = normalMatrix;
+      for (std::size_t i = 0; i < n; ++i) {
+        const float dx = x[i];
+        const float dy = y[i];
+        const float dz = z[i];
+        x[i] = m[0] * dx + m[3] * dy + m[6] * dz;
+        y[i] = m[1] * dx + m[4] * dy + m[7] * dz;
+        z[i] = m[2] * dx + m[5] * dy + m[8] * dz;
+      }
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      const float lenSq = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+      const bool valid = lenSq > 0.0f;
+      const float invLen = valid ? 1.0f / std::sqrt(lenSq) : 0.0f;
+      x[i] = valid ? x[i] * invLen : fallback[0];
+      y[i] = valid ? y[i] * invLen : fallback[1];
+      z[i] = valid ? z[i] * invLen : fallback[2];
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      block[i * stride] = x[i];
+      block[i * stride + 1] = y[i];
+      block[i * stride + 2] = z[i];
+    }
+  }
 }
 
 void NormalizeVector(float v[3], const float fallback[3]) {
@@ -879,232 +993,24 @@ bool SanitizeMeshData(AssetRegistry::MeshData &mesh, bool recomputeNormals,
 
 bool LoadObjMesh(const std::filesystem::path &sourcePath,
                  const AssetRegistry::MeshImportSettings &settings,
-                 AssetRegistry::MeshData &mesh) {
-  std::ifstream input(sourcePath);
-  if (!input.is_open()) {
-    return false;
-  }
-
-  struct ObjVertexKey {
-    int position = -1;
-    int texcoord = -1;
-    int normal = -1;
-  };
-
-  struct ObjVertexKeyHash {
-    size_t operator()(const ObjVertexKey &key) const noexcept {
-      size_t seed = std::hash<int>{}(key.position);
-      seed ^= std::hash<int>{}(key.texcoord) + 0x9e3779b9 + (seed << 6) +
-              (seed >> 2);
-      seed ^=
-          std::hash<int>{}(key.normal) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-      return seed;
-    }
-  };
-
-  struct ObjVertexKeyEq {
-    bool operator()(const ObjVertexKey &lhs,
-                    const ObjVertexKey &rhs) const noexcept {
-      return lhs.position == rhs.position && lhs.texcoord == rhs.texcoord &&
-             lhs.normal == rhs.normal;
-    }
-  };
-
-  auto resolveIndex = [](int value, size_t count) -> int {
-    if (value == 0) {
-      return -1;
-    }
-    int idx = value;
-    if (idx < 0) {
-      idx = static_cast<int>(count) + idx;
-    } else {
-      idx -= 1;
-    }
-    if (idx < 0 || idx >= static_cast<int>(count)) {
-      return -1;
-    }
-    return idx;
-  };
-
-  auto parseIndex = [](const std::string &value, int &outIndex) {
-    if (value.empty()) {
-      outIndex = 0;
-      return;
-    }
-    try {
-      outIndex = std::stoi(value);
-    } catch (const std::exception &) {
-      outIndex = 0;
-    }
-  };
-
-  std::vector<std::array<float, 3>> positions;
-  std::vector<std::array<float, 4>> colors;
-  std::vector<std::array<float, 3>> normals;
-  std::vector<std::array<float, 2>> texcoords;
-
-  std::vector<std::array<float, 3>> outPositions;
-  std::vector<std::array<float, 4>> outColors;
-  std::vector<std::array<float, 3>> outNormals;
-  std::vector<std::array<float, 2>> outUvs;
-  std::vector<std::uint32_t> indices;
-
-  std::unordered_map<ObjVertexKey, std::uint32_t, ObjVertexKeyHash,
-                     ObjVertexKeyEq>
-      vertexLookup;
-  vertexLookup.reserve(1024);
-
-  bool hasNormals = false;
-  bool missingNormals = false;
-
-  std::string line;
-  while (std::getline(input, line)) {
-    std::istringstream stream(line);
-    std::string keyword;
-    if (!(stream >> keyword)) {
-      continue;
-    }
-    if (!keyword.empty() && keyword.front() == '#') {
-      continue;
-    }
-
-    if (keyword == "v") {
-      float x = 0.0f;
-      float y = 0.0f;
-      float z = 0.0f;
-      if (!(stream >> x >> y >> z)) {
-        continue;
-      }
-
-      float r = 1.0f;
-      float g = 1.0f;
-      float b = 1.0f;
-      float a = 1.0f;
-      if (stream >> r >> g >> b) {
-        if (!(stream >> a)) {
-          a = 1.0f;
-        }
-        colors.push_back({r, g, b, a});
-      } else {
-        colors.push_back({1.0f, 1.0f, 1.0f, 1.0f});
-      }
-      positions.push_back({x, y, z});
-    } else if (keyword == "vn") {
-      float nx = 0.0f;
-      float ny = 0.0f;
-      float nz = 0.0f;
-      if (stream >> nx >> ny >> nz) {
-        normals.push_back({nx, ny, nz});
-      }
-    } else if (keyword == "vt") {
-      float u = 0.0f;
-      float v = 0.0f;
-      if (stream >> u >> v) {
-        texcoords.push_back({u, v});
-      }
-    } else if (keyword == "f") {
-      std::vector<std::uint32_t> face;
-      std::string token;
-      while (stream >> token) {
-        if (positions.empty()) {
-          continue;
-        }
-
-        int positionValue = 0;
-        int texValue = 0;
-        int normalValue = 0;
-
-        const size_t slash = token.find('/');
-        if (slash == std::string::npos) {
-          parseIndex(token, positionValue);
-        } else {
-          parseIndex(token.substr(0, slash), positionValue);
-          const size_t slash2 = token.find('/', slash + 1);
-          if (slash2 == std::string::npos) {
-            parseIndex(token.substr(slash + 1), texValue);
-          } else {
-            parseIndex(token.substr(slash + 1, slash2 - slash - 1), texValue);
-            size_t slash3 = token.find('/', slash2 + 1);
-            if (slash3 != std::string::npos) {
-              parseIndex(token.substr(slash2 + 1, slash3 - slash2 - 1),
-                         normalValue);
-            } else {
-              parseIndex(token.substr(slash2 + 1), normalValue);
-            }
-          }
-        }
-
-        const int positionIndex = resolveIndex(positionValue, positions.size());
-        if (positionIndex < 0) {
-          continue;
-        }
-        const int texIndex = resolveIndex(texValue, texcoords.size());
-        const int normalIndex = resolveIndex(normalValue, normals.size());
-
-        const ObjVertexKey key{positionIndex, texIndex, normalIndex};
-        auto it = vertexLookup.find(key);
-        std::uint32_t vertexIndex = 0;
-        if (it == vertexLookup.end()) {
-          outPositions.push_back(positions[static_cast<size_t>(positionIndex)]);
-          if (static_cast<size_t>(positionIndex) < colors.size()) {
-            outColors.push_back(colors[static_cast<size_t>(positionIndex)]);
-          } else {
-            outColors.push_back({1.0f, 1.0f, 1.0f, 1.0f});
-          }
-
-          if (texIndex >= 0 &&
-              static_cast<size_t>(texIndex) < texcoords.size()) {
-            outUvs.push_back(texcoords[static_cast<size_t>(texIndex)]);
-          } else {
-            outUvs.push_back({0.0f, 0.0f});
-          }
-
-          if (normalIndex >= 0 &&
-              static_cast<size_t>(normalIndex) < normals.size()) {
-            auto normal = normals[static_cast<size_t>(normalIndex)];
-            float normalValues[3] = {normal[0], normal[1], normal[2]};
-            const float defaultNormal[3] = {0.0f, 0.0f, 1.0f};
-            NormalizeVector(normalValues, defaultNormal);
-            outNormals.push_back(
-                {normalValues[0], normalValues[1], normalValues[2]});
-            hasNormals = true;
-          } else {
-            outNormals.push_back({0.0f, 0.0f, 1.0f});
-            missingNormals = true;
-          }
-
-          vertexIndex = static_cast<std::uint32_t>(outPositions.size() - 1);
-          vertexLookup.emplace(key, vertexIndex);
-        } else {
-          vertexIndex = it->second;
-        }
-        face.push_back(vertexIndex);
-      }
-
-      if (face.size() >= 3) {
-        for (size_t i = 1; i + 1 < face.size(); ++i) {
-          indices.push_back(face[0]);
-          indices.push_back(face[i]);
-          indices.push_back(face[i + 1]);
-        }
-      }
+                 AssetRegistry::MeshData &mesh,
+                 const VirtualFileSystem *fileSystem = nullptr) {
+  ObjParseInfo parsed{};
+  if (fileSystem) {
+    // Parsed in place from the loose file's or the archive's mapping.
+    VirtualFileSystem::FileView view;
+    if (!fileSystem->OpenFile(sourcePath, view) ||
+        !ParseObj(view.GetText(), mesh, &parsed)) {
+      return false;
     }
-  }
-
-  if (outPositions.empty() || indices.empty()) {
+  } else if (!ParseObjFile(sourcePath, mesh, &parsed)) {
     return false;
   }
 
-  mesh.positions = std::move(outPositions);
-  mesh.colors = std::move(outColors);
-  mesh.normals = std::move(outNormals);
-  mesh.uvs = std::move(outUvs);
-  mesh.indices = std::move(indices);
-
   ApplyMeshImportSettings(mesh, settings);
 
-  const bool recomputeNormals =
-      settings.generateNormals || !hasNormals || missingNormals;
+  const bool recomputeNormals = settings.generateNormals ||
+                                !parsed.hasNormals || parsed.missingNormals;
   const bool recomputeTangents = settings.generateTangents || settings.flipUVs;
   if (!SanitizeMeshData(mesh, recomputeNormals, recomputeTangents)) {
     return false;
@@ -1141,238 +1047,1446 @@ int AssetTypeOrder(AssetRegistry::AssetType type) {
     return 6;
   }
 }
-} // namespace
 
-namespace Aetherion::Assets {
-const char *AssetRegistry::AssetTypeToString(AssetType type) {
-  switch (type) {
-  case AssetType::Texture:
-    return "Texture";
-  case AssetType::Mesh:
-    return "Mesh";
-  case AssetType::Audio:
-    return "Audio";
-  case AssetType::Script:
-    return "Script";
-  case AssetType::Scene:
-    return "Scene";
-  case AssetType::Shader:
-    return "Shader";
-  case AssetType::Other:
-  default:
-    return "Other";
-  }
+template <typename T> std::uint64_t VectorBytes(const std::vector<T> &values) {
+  return static_cast<std::uint64_t>(values.capacity()) * sizeof(T);
 }
 
-void AssetRegistry::Scan(const std::string &rootPath) {
-  std::unordered_map<std::string, FileState> previousStates = m_fileStates;
-  std::unordered_map<std::string, AssetType> previousTypes;
-  for (const auto &entry : m_entries) {
-    previousTypes.emplace(entry.id, entry.type);
-  }
+std::uint64_t GetMeshDataBytes(const AssetRegistry::MeshData &mesh) {
+  return sizeof(mesh) + VectorBytes(mesh.positions) +
+         VectorBytes(mesh.normals) + VectorBytes(mesh.colors) +
+         VectorBytes(mesh.uvs) + VectorBytes(mesh.tangents) +
+         VectorBytes(mesh.indices);
+}
 
-  m_placeholderAssets.clear();
-  m_entries.clear();
-  m_entryLookup.clear();
-  m_pathToId.clear();
+constexpr std::size_t kMaxScanThreads = 32;
+constexpr std::size_t kMaxLoadThreads = 16;
+constexpr std::size_t kDefaultLoadThreads = 4;
+// Below this many files, starting threads costs more than reading the
+// sidecars one after another.
+constexpr std::size_t kParallelScanMinFiles = 256;
+
+// Runs `work` on `threads` threads, the caller included, and rethrows the
+// first exception any of them raised once all are joined. Runs with fewer
+// threads when the system refuses to start more.
+template <typename Fn> void RunWorkers(std::size_t threads, Fn &&work) {
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  auto guarded = [&]() {
+    try {
+      work();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  };
 
-  std::error_code ec;
-  std::filesystem::path nextRoot = std::filesystem::absolute(rootPath, ec);
-  if (ec) {
-    ec.clear();
-    nextRoot = std::filesystem::path(rootPath);
+  std::vector<std::thread> workers;
+  if (threads > 1) {
+    workers.reserve(threads - 1);
   }
-  const bool rootChanged = (!m_rootPath.empty() && nextRoot != m_rootPath);
-  m_rootPath = nextRoot;
-  m_placeholderAssets.emplace("root", m_rootPath.string());
-
-  if (rootChanged) {
-    previousStates.clear();
-    m_meshData.clear();
-    m_meshes.clear();
-    m_textures.clear();
-    m_materials.clear();
-    m_changeLog.clear();
-    m_changeSerial = 0;
+  for (std::size_t i = 1; i < threads; ++i) {
+    try {
+      workers.emplace_back(guarded);
+    } catch (const std::system_error &) {
+      break;
+    }
   }
+  guarded();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
 
-  std::unordered_map<std::string, FileState> nextStates;
-  std::unordered_map<std::string, AssetType> nextTypes;
-
-  if (std::filesystem::exists(m_rootPath, ec)) {
-    const auto options =
-        std::filesystem::directory_options::skip_permission_denied;
-    for (auto it = std::filesystem::recursive_directory_iterator(m_rootPath,
-                                                                 options, ec);
-         it != std::filesystem::recursive_directory_iterator();
-         it.increment(ec)) {
-      if (ec) {
-        ec.clear();
-        continue;
-      }
-
-      const auto &entry = *it;
-      if (!entry.is_regular_file(ec)) {
-        continue;
-      }
+// cgltf file callback that reads the .gltf/.glb and its buffers through the
+// VirtualFileSystem in `file->user_data`. cgltf frees the copy with its
+// default release callback.
+cgltf_result ReadGltfFile(const cgltf_memory_options *memory,
+                          const cgltf_file_options *file, const char *path,
+                          cgltf_size *size, void **data) {
+  const auto *fileSystem =
+      static_cast<const VirtualFileSystem *>(file->user_data);
+  VirtualFileSystem::FileView view;
+  if (!fileSystem->OpenFile(std::filesystem::path(path), view)) {
+    return cgltf_result_file_not_found;
+  }
+  const auto bytes = view.GetData();
+  // Buffers are read at their declared size, like the default callback does.
+  const std::size_t count = (*size != 0) ? *size : bytes.size();
+  if (count > bytes.size()) {
+    return cgltf_result_io_error;
+  }
+  void *copy = memory->alloc_func
+                   ? memory->alloc_func(memory->user_data, count)
+                   : std::malloc(count);
+  if (!copy) {
+    return cgltf_result_out_of_memory;
+  }
+  std::memcpy(copy, bytes.data(), count);
+  *size = count;
+  *data = copy;
+  return cgltf_result_success;
+}
 
-      if (IsMetadataPath(entry.path())) {
-        continue;
-      }
+void UseFileSystem(cgltf_options &options,
+                   const VirtualFileSystem *fileSystem) {
+  if (fileSystem) {
+    options.file.read = &ReadGltfFile;
+    options.file.user_data = const_cast<VirtualFileSystem *>(fileSystem);
+  }
+}
 
-      const auto filename = entry.path().filename().string();
-      if (!filename.empty() && filename.front() == '.') {
-        continue;
-      }
+// Ids the registry has not scanned may still be packed, e.g. in an archive
+// mounted outside of the root; archives index their files by id.
+bool FindPackedAsset(const VirtualFileSystem *fileSystem,
+                     const std::string &assetId, std::filesystem::path &out) {
+  std::string virtualPath;
+  if (!fileSystem || !fileSystem->FindArchivedAsset(assetId, virtualPath)) {
+    return false;
+  }
+  out = std::filesystem::path(virtualPath);
+  return true;
+}
 
-      std::filesystem::path relative =
-          std::filesystem::relative(entry.path(), m_rootPath, ec);
-      std::string sourceLabel = (!ec && !relative.empty())
-                                    ? relative.generic_string()
-                                    : entry.path().filename().generic_string();
-      if (sourceLabel.empty()) {
-        continue;
+// Regular files below `root`, in no particular order. Directories are shared
+// out to the workers one at a time, so wide and deep trees both keep every
+// thread listing. Like recursive_directory_iterator, symlinked directories
+// are not followed.
+std::vector<std::filesystem::path>
+CollectScanFiles(const std::filesystem::path &root, std::size_t threads) {
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::vector<std::filesystem::path> directories{root};
+  std::vector<std::filesystem::path> files;
+  std::size_t listing = 0;
+
+  RunWorkers(threads, [&]() {
+    std::vector<std::filesystem::path> foundDirectories;
+    std::vector<std::filesystem::path> foundFiles;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+      wake.wait(lock, [&]() { return !directories.empty() || listing == 0; });
+      if (directories.empty()) {
+        // Nothing queued and nobody listing: the walk is done.
+        wake.notify_all();
+        return;
       }
-
-      const std::filesystem::path metaPath = BuildMetadataPath(entry.path());
-      std::string assetId;
-      std::string metaSource;
-      std::string metaType;
-      bool writeMeta = false;
-
-      if (std::filesystem::exists(metaPath, ec)) {
-        if (!ReadMetadataFile(metaPath, assetId, &metaSource, &metaType)) {
-          assetId.clear();
+      const std::filesystem::path directory = std::move(directories.back());
+      directories.pop_back();
+      ++listing;
+      lock.unlock();
+
+      std::error_code ec;
+      const auto options =
+          std::filesystem::directory_options::skip_permission_denied;
+      for (auto it = std::filesystem::directory_iterator(directory, options,
+                                                         ec);
+           it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        if (ec) {
+          break;
+        }
+        if (it->is_directory(ec) && !it->is_symlink(ec)) {
+          foundDirectories.push_back(it->path());
+        } else if (it->is_regular_file(ec)) {
+          foundFiles.push_back(it->path());
         }
       }
 
-      if (assetId.empty()) {
-        assetId = Core::GenerateUUID();
-        writeMeta = true;
+      lock.lock();
+      --listing;
+      std::move(foundFiles.begin(), foundFiles.end(),
+                std::back_inserter(files));
+      if (!foundDirectories.empty() || listing == 0) {
+        std::move(foundDirectories.begin(), foundDirectories.end(),
+                  std::back_inserter(directories));
+        wake.notify_all();
       }
+      foundFiles.clear();
+      foundDirectories.clear();
+    }
+  });
+  return files;
+}
 
-      const AssetType type = ClassifyAssetType(entry.path());
-      if (metaSource.empty() || metaSource != sourceLabel) {
-        writeMeta = true;
-      }
-      if (metaType.empty() || metaType != AssetTypeToString(type)) {
-        writeMeta = true;
-      }
+constexpr const char *kCookedMeshKind = "amesh";
+constexpr const char *kGltfImportKind = "gltfimport";
+// Bumped when ImportGltf records something different for the same file.
+constexpr std::uint32_t kGltfImportVersion = 1;
+
+// What ImportGltf reads from a glTF file. Kept in the derived-data cache so
+// files already imported in an earlier session are not parsed again.
+struct GltfImportRecord {
+  struct Material {
+    std::string name;
+    std::array<float, 4> baseColor{1.0f, 1.0f, 1.0f, 1.0f};
+    float metallic{0.0f};
+    float roughness{1.0f};
+    std::int32_t albedoTexture{-1};
+  };
 
-      if (writeMeta) {
-        WriteMetadataFile(metaPath, assetId, type, sourceLabel);
+  // Empty for embedded images.
+  std::vector<std::string> imageUris;
+  // Image of each texture, or -1.
+  std::vector<std::int32_t> textureImages;
+  std::vector<Material> materials;
+};
+
+void ReadGltfImportRecord(const cgltf_data &data, GltfImportRecord &out) {
+  out.imageUris.reserve(data.images_count);
+  for (cgltf_size i = 0; i < data.images_count; ++i) {
+    const char *uri = data.images[i].uri;
+    // Data URIs never name a file next to the glTF.
+    out.imageUris.emplace_back(uri && std::strncmp(uri, "data:", 5) != 0
+                                   ? uri
+                                   : "");
+  }
+  out.textureImages.reserve(data.textures_count);
+  for (cgltf_size i = 0; i < data.textures_count; ++i) {
+    const cgltf_image *image = data.textures[i].image;
+    out.textureImages.push_back(
+        image ? static_cast<std::int32_t>(image - data.images) : -1);
+  }
+  out.materials.reserve(data.materials_count);
+  for (cgltf_size i = 0; i < data.materials_count; ++i) {
+    const cgltf_material &material = data.materials[i];
+    GltfImportRecord::Material &recorded = out.materials.emplace_back();
+    recorded.name = material.name ? material.name : std::string();
+    if (material.has_pbr_metallic_roughness) {
+      const auto &pbr = material.pbr_metallic_roughness;
+      recorded.baseColor = {
+          pbr.base_color_factor[0], pbr.base_color_factor[1],
+          pbr.base_color_factor[2], pbr.base_color_factor[3]};
+      recorded.metallic = pbr.metallic_factor;
+      recorded.roughness = pbr.roughness_factor;
+      if (pbr.base_color_texture.texture) {
+        recorded.albedoTexture = static_cast<std::int32_t>(
+            pbr.base_color_texture.texture - data.textures);
       }
+    }
+  }
+}
+
+template <typename T>
+void AppendPod(std::vector<std::uint8_t> &out, const T &value) {
+  const auto *bytes = reinterpret_cast<const std::uint8_t *>(&value);
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
 
-      AssetEntry asset{};
-      asset.id = assetId;
-      asset.path = entry.path();
-      asset.type = type;
+void AppendString(std::vector<std::uint8_t> &out, const std::string &value) {
+  AppendPod(out, static_cast<std::uint32_t>(value.size()));
+  out.insert(out.end(), value.begin(), value.end());
+}
 
-      m_entryLookup.emplace(asset.id, m_entries.size());
-      m_entries.push_back(std::move(asset));
-      m_pathToId.emplace(MakePathKey(entry.path(), m_rootPath), assetId);
+class RecordReader {
+public:
+  explicit RecordReader(const std::vector<std::uint8_t> &data)
+      : m_data(data) {}
 
-      FileState state{};
-      state.path = entry.path();
-      state.assetTime = SafeWriteTime(entry.path());
-      state.metaTime = SafeWriteTime(metaPath);
-      nextStates.emplace(assetId, state);
-      nextTypes.emplace(assetId, type);
+  template <typename T> bool Read(T &value) {
+    if (m_data.size() - m_offset < sizeof(T)) {
+      return false;
     }
+    std::memcpy(&value, m_data.data() + m_offset, sizeof(T));
+    m_offset += sizeof(T);
+    return true;
   }
 
-  std::sort(m_entries.begin(), m_entries.end(),
-            [](const AssetEntry &a, const AssetEntry &b) {
-              const int orderA = AssetTypeOrder(a.type);
-              const int orderB = AssetTypeOrder(b.type);
-              if (orderA != orderB) {
-                return orderA < orderB;
-              }
-              return a.id < b.id;
-            });
+  bool ReadString(std::string &value) {
+    std::uint32_t size = 0;
+    if (!Read(size) || m_data.size() - m_offset < size) {
+      return false;
+    }
+    value.assign(reinterpret_cast<const char *>(m_data.data() + m_offset),
+                 size);
+    m_offset += size;
+    return true;
+  }
 
-  m_entryLookup.clear();
-  for (size_t i = 0; i < m_entries.size(); ++i) {
-    m_entryLookup.emplace(m_entries[i].id, i);
+  // Guards resize() against counts a corrupt record would claim.
+  bool ReadCount(std::uint32_t &count) {
+    return Read(count) && count <= m_data.size() - m_offset;
   }
 
-  std::vector<AssetChange> scanChanges;
-  auto recordChange = [this, &scanChanges](const std::string &id,
-                                           AssetType type,
-                                           AssetChange::Kind kind) {
-    AssetChange change{};
-    change.id = id;
-    change.type = type;
-    change.kind = kind;
-    change.serial = ++m_changeSerial;
-    m_changeLog.push_back(change);
-    scanChanges.push_back(change);
-  };
+  [[nodiscard]] bool AtEnd() const { return m_offset == m_data.size(); }
 
-  for (const auto &[id, state] : nextStates) {
-    auto prevIt = previousStates.find(id);
-    if (prevIt == previousStates.end()) {
-      recordChange(id, nextTypes[id], AssetChange::Kind::Added);
-      continue;
-    }
+private:
+  const std::vector<std::uint8_t> &m_data;
+  std::size_t m_offset{0};
+};
 
-    const FileState &prev = prevIt->second;
-    if (prev.path != state.path) {
-      recordChange(id, nextTypes[id], AssetChange::Kind::Moved);
-      continue;
-    }
+std::vector<std::uint8_t>
+SerializeGltfImportRecord(const GltfImportRecord &record) {
+  std::vector<std::uint8_t> out;
+  AppendPod(out, static_cast<std::uint32_t>(record.imageUris.size()));
+  for (const auto &uri : record.imageUris) {
+    AppendString(out, uri);
+  }
+  AppendPod(out, static_cast<std::uint32_t>(record.textureImages.size()));
+  for (std::int32_t image : record.textureImages) {
+    AppendPod(out, image);
+  }
+  AppendPod(out, static_cast<std::uint32_t>(record.materials.size()));
+  for (const auto &material : record.materials) {
+    AppendString(out, material.name);
+    AppendPod(out, material.baseColor);
+    AppendPod(out, material.metallic);
+    AppendPod(out, material.roughness);
+    AppendPod(out, material.albedoTexture);
+  }
+  return out;
+}
 
-    if (prev.assetTime != state.assetTime || prev.metaTime != state.metaTime) {
-      const bool onlyMeta = (prev.assetTime == state.assetTime) &&
-                            (prev.metaTime != state.metaTime);
-      recordChange(id, nextTypes[id],
-                   onlyMeta ? AssetChange::Kind::Metadata
-                            : AssetChange::Kind::Modified);
+bool DeserializeGltfImportRecord(const std::vector<std::uint8_t> &data,
+                                 GltfImportRecord &out) {
+  RecordReader reader(data);
+  std::uint32_t count = 0;
+  if (!reader.ReadCount(count)) {
+    return false;
+  }
+  out.imageUris.resize(count);
+  for (auto &uri : out.imageUris) {
+    if (!reader.ReadString(uri)) {
+      return false;
     }
   }
-
-  for (const auto &[id, prev] : previousStates) {
-    if (nextStates.find(id) != nextStates.end()) {
-      continue;
+  if (!reader.ReadCount(count)) {
+    return false;
+  }
+  out.textureImages.resize(count);
+  for (auto &image : out.textureImages) {
+    if (!reader.Read(image)) {
+      return false;
     }
-    AssetType type = AssetType::Other;
-    if (auto typeIt = previousTypes.find(id); typeIt != previousTypes.end()) {
-      type = typeIt->second;
-    } else {
-      type = ClassifyAssetType(prev.path);
+  }
+  if (!reader.ReadCount(count)) {
+    return false;
+  }
+  out.materials.resize(count);
+  for (auto &material : out.materials) {
+    if (!reader.ReadString(material.name) ||
+        !reader.Read(material.baseColor) || !reader.Read(material.metallic) ||
+        !reader.Read(material.roughness) ||
+        !reader.Read(material.albedoTexture)) {
+      return false;
     }
-    recordChange(id, type, AssetChange::Kind::Removed);
   }
+  return reader.AtEnd();
+}
 
-  for (const auto &change : scanChanges) {
-    if (change.kind == AssetChange::Kind::Removed ||
-        change.kind == AssetChange::Kind::Modified ||
-        change.kind == AssetChange::Kind::Moved) {
-      m_meshData.erase(change.id);
-      m_meshes.erase(change.id);
-      m_textures.erase(change.id);
-
-      if (change.type == AssetType::Mesh) {
-        for (auto it = m_materials.begin(); it != m_materials.end();) {
-          if (it->first.rfind(change.id + ":", 0) == 0) {
-            it = m_materials.erase(it);
-          } else {
-            ++it;
-          }
-        }
-      }
+// External buffer files of a .gltf; its mesh data changes with them.
+std::vector<std::filesystem::path>
+ListGltfBuffers(const std::filesystem::path &source) {
+  std::vector<std::filesystem::path> buffers;
+  cgltf_options options{};
+  cgltf_data *data = nullptr;
+  if (cgltf_parse_file(&options, source.string().c_str(), &data) !=
+          cgltf_result_success ||
+      !data) {
+    if (data) {
+      cgltf_free(data);
     }
+    return buffers;
   }
-
-  const size_t maxChanges = 2048;
+  for (cgltf_size i = 0; i < data->buffers_count; ++i) {
+    const char *uri = data->buffers[i].uri;
+    if (!uri || uri[0] == '\0' || std::strncmp(uri, "data:", 5) == 0) {
+      continue;
+    }
+    std::string decoded(uri);
+    decoded.resize(cgltf_decode_uri(decoded.data()));
+    buffers.push_back(source.parent_path() / decoded);
+  }
+  cgltf_free(data);
+  return buffers;
+}
+
+// One triangle primitive of an imported scene: its accessors, the world
+// matrix of the node that instances it, and where its vertices and indices
+// start in the merged mesh.
+struct GltfPrimitive {
+  const cgltf_accessor *positions{nullptr};
+  const cgltf_accessor *colors{nullptr};
+  const cgltf_accessor *normals{nullptr};
+  const cgltf_accessor *uvs{nullptr};
+  const cgltf_accessor *tangents{nullptr};
+  const cgltf_accessor *indices{nullptr};
+  bool hasMatrix{false};
+  bool hasNormalMatrix{false};
+  cgltf_float matrix[16]{};
+  float normalMatrix[9]{};
+  std::size_t firstVertex{0};
+  std::size_t firstIndex{0};
+  std::size_t indexCount{0};
+};
+
+// A slice of one primitive's vertices or indices; the unit of work handed to
+// the import threads.
+struct GltfTask {
+  std::size_t primitive{0};
+  std::size_t begin{0};
+  std::size_t end{0};
+  bool indices{false};
+};
+
+constexpr std::size_t kGltfTaskVertices = 32 * 1024;
+constexpr std::size_t kGltfTaskIndices = 3 * kGltfTaskVertices;
+// Smaller scenes import faster than threads start.
+constexpr std::size_t kParallelGltfMinVertices = 64 * 1024;
+
+static_assert(sizeof(std::array<float, 3>) == 3 * sizeof(float) &&
+                  sizeof(std::array<float, 4>) == 4 * sizeof(float),
+              "vertex streams are read as packed floats");
+
+void AddGltfPrimitive(const cgltf_primitive &primitive,
+                      const cgltf_float *matrix,
+                      std::vector<GltfPrimitive> &out) {
+  if (primitive.type != cgltf_primitive_type_triangles) {
+    return;
+  }
+
+  GltfPrimitive added{};
+  for (cgltf_size i = 0; i < primitive.attributes_count; ++i) {
+    const cgltf_attribute &attr = primitive.attributes[i];
+    if (attr.type == cgltf_attribute_type_position) {
+      added.positions = attr.data;
+    } else if (attr.type == cgltf_attribute_type_color) {
+      added.colors = attr.data;
+    } else if (attr.type == cgltf_attribute_type_normal) {
+      added.normals = attr.data;
+    } else if (attr.type == cgltf_attribute_type_tangent) {
+      added.tangents = attr.data;
+    } else if (attr.type == cgltf_attribute_type_texcoord && attr.index == 0) {
+      added.uvs = attr.data;
+    }
+  }
+  if (!added.positions || added.positions->count == 0) {
+    return;
+  }
+
+  added.indices = primitive.indices;
+  added.indexCount =
+      primitive.indices ? primitive.indices->count : added.positions->count;
+  if (matrix) {
+    added.hasMatrix = true;
+    std::copy(matrix, matrix + 16, added.matrix);
+    added.hasNormalMatrix = ComputeNormalMatrix(matrix, added.normalMatrix);
+  }
+  out.push_back(added);
+}
+
+// Triangle primitives in merge order: the scene's nodes depth first (every
+// node when there is no scene), or every mesh untransformed when the file
+// has no nodes at all.
+std::vector<GltfPrimitive> CollectGltfPrimitives(const cgltf_data &data) {
+  std::vector<GltfPrimitive> primitives;
+  auto addMesh = [&](const cgltf_mesh *mesh, const cgltf_float *matrix) {
+    if (!mesh) {
+      return;
+    }
+    for (cgltf_size i = 0; i < mesh->primitives_count; ++i) {
+      AddGltfPrimitive(mesh->primitives[i], matrix, primitives);
+    }
+  };
+  auto addNode = [&](const cgltf_node *node, auto &&self) -> void {
+    if (!node) {
+      return;
+    }
+    cgltf_float matrix[16];
+    cgltf_node_transform_world(node, matrix);
+    addMesh(node->mesh, matrix);
+    for (cgltf_size i = 0; i < node->children_count; ++i) {
+      self(node->children[i], self);
+    }
+  };
+
+  if (data.scene && data.scene->nodes_count > 0) {
+    for (cgltf_size i = 0; i < data.scene->nodes_count; ++i) {
+      addNode(data.scene->nodes[i], addNode);
+    }
+  } else if (data.nodes_count > 0) {
+    for (cgltf_size i = 0; i < data.nodes_count; ++i) {
+      addNode(&data.nodes[i], addNode);
+    }
+  } else {
+    for (cgltf_size i = 0; i < data.meshes_count; ++i) {
+      addMesh(&data.meshes[i], nullptr);
+    }
+  }
+  return primitives;
+}
+
+// Reads elements [first, first + count) of `accessor` into `out`, one every
+// `stride` floats. As with cgltf_accessor_read_float, components the
+// accessor does not have are left untouched. Dense float data is copied
+// straight out of the buffer.
+void ReadGltfFloats(const cgltf_accessor &accessor, std::size_t first,
+                    std::size_t count, std::size_t components, float *out,
+                    std::size_t stride) {
+  const std::size_t present = cgltf_num_components(accessor.type);
+  const std::uint8_t *source =
+      accessor.buffer_view ? cgltf_buffer_view_data(accessor.buffer_view)
+                           : nullptr;
+  if (!accessor.is_sparse && source &&
+      accessor.component_type == cgltf_component_type_r_32f &&
+      present <= components) {
+    source += accessor.offset + accessor.stride * first;
+    for (std::size_t i = 0; i < count; ++i) {
+      std::memcpy(out + i * stride, source + accessor.stride * i,
+                  present * sizeof(float));
+    }
+    return;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    cgltf_accessor_read_float(&accessor, first + i, out + i * stride,
+                              components);
+  }
+}
+
+template <typename T>
+void ReadGltfIndices(const std::uint8_t *source, std::size_t stride,
+                     std::size_t count, std::size_t baseVertex,
+                     std::uint32_t *out) {
+  for (std::size_t i = 0; i < count; ++i) {
+    T index;
+    std::memcpy(&index, source + stride * i, sizeof(T));
+    out[i] = static_cast<std::uint32_t>(baseVertex + index);
+  }
+}
+
+// Indices [first, first + count) of `accessor`, offset by `baseVertex`.
+void ReadGltfIndices(const cgltf_accessor &accessor, std::size_t first,
+                     std::size_t count, std::size_t baseVertex,
+                     std::uint32_t *out) {
+  const std::uint8_t *source =
+      accessor.buffer_view ? cgltf_buffer_view_data(accessor.buffer_view)
+                           : nullptr;
+  if (!accessor.is_sparse && source) {
+    source += accessor.offset + accessor.stride * first;
+    switch (accessor.component_type) {
+    case cgltf_component_type_r_8u:
+      ReadGltfIndices<std::uint8_t>(source, accessor.stride, count,
+                                    baseVertex, out);
+      return;
+    case cgltf_component_type_r_16u:
+      ReadGltfIndices<std::uint16_t>(source, accessor.stride, count,
+                                     baseVertex, out);
+      return;
+    case cgltf_component_type_r_32u:
+      ReadGltfIndices<std::uint32_t>(source, accessor.stride, count,
+                                     baseVertex, out);
+      return;
+    default:
+      break;
+    }
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = static_cast<std::uint32_t>(
+        baseVertex + cgltf_accessor_read_index(&accessor, first + i));
+  }
+}
+
+// Fills the task's slice of `mesh`, which is already sized for every
+// primitive. Attributes a primitive lacks (or has fewer elements of than
+// positions) get the same defaults as OBJ imports.
+void RunGltfTask(const GltfPrimitive &primitive, const GltfTask &task,
+                 AssetRegistry::MeshData &mesh) {
+  const std::size_t count = task.end - task.begin;
+  if (task.indices) {
+    std::uint32_t *out =
+        mesh.indices.data() + primitive.firstIndex + task.begin;
+    if (primitive.indices) {
+      ReadGltfIndices(*primitive.indices, task.begin, count,
+                      primitive.firstVertex, out);
+    } else {
+      for (std::size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<std::uint32_t>(primitive.firstVertex +
+                                            task.begin + i);
+      }
+    }
+    return;
+  }
+
+  const std::size_t first = primitive.firstVertex + task.begin;
+  auto available = [&](const cgltf_accessor *accessor) -> std::size_t {
+    if (!accessor || accessor->count <= task.begin) {
+      return 0;
+    }
+    return std::min<std::size_t>(accessor->count, task.end) - task.begin;
+  };
+
+  float *positions = mesh.positions[first].data();
+  ReadGltfFloats(*primitive.positions, task.begin, count, 3, positions, 3);
+  if (primitive.hasMatrix) {
+    TransformPositions(primitive.matrix, positions, count, 3);
+  }
+
+  std::fill_n(mesh.colors.begin() + static_cast<std::ptrdiff_t>(first), count,
+              std::array<float, 4>{1.0f, 1.0f, 1.0f, 1.0f});
+  if (const std::size_t n = available(primitive.colors)) {
+    ReadGltfFloats(*primitive.colors, task.begin, n, 4,
+                   mesh.colors[first].data(), 4);
+  }
+
+  const float *normalMatrix =
+      primitive.hasNormalMatrix ? primitive.normalMatrix : nullptr;
+  const float defaultNormal[3] = {0.0f, 0.0f, 1.0f};
+  float *normals = mesh.normals[first].data();
+  std::fill_n(mesh.normals.begin() + static_cast<std::ptrdiff_t>(first),
+              count, std::array<float, 3>{0.0f, 0.0f, 1.0f});
+  if (const std::size_t n = available(primitive.normals)) {
+    ReadGltfFloats(*primitive.normals, task.begin, n, 3, normals, 3);
+  }
+  TransformDirections(normalMatrix, normals, count, 3, defaultNormal);
+
+  std::fill_n(mesh.uvs.begin() + static_cast<std::ptrdiff_t>(first), count,
+              std::array<float, 2>{0.0f, 0.0f});
+  if (const std::size_t n = available(primitive.uvs)) {
+    ReadGltfFloats(*primitive.uvs, task.begin, n, 2, mesh.uvs[first].data(),
+                   2);
+  }
+
+  const float defaultTangent[3] = {1.0f, 0.0f, 0.0f};
+  float *tangents = mesh.tangents[first].data();
+  std::fill_n(mesh.tangents.begin() + static_cast<std::ptrdiff_t>(first),
+              count, std::array<float, 4>{1.0f, 0.0f, 0.0f, 1.0f});
+  if (const std::size_t n = available(primitive.tangents)) {
+    ReadGltfFloats(*primitive.tangents, task.begin, n, 4, tangents, 4);
+  }
+  TransformDirections(normalMatrix, tangents, count, 4, defaultTangent);
+}
+
+// Merges every triangle primitive of `data` into `mesh`. Offsets come from a
+// prefix sum over the primitives, so the slices are filled independently, on
+// several threads for large scenes, and need no concatenation afterwards.
+// `outNormals`/`outTangents` report whether any vertex had its own.
+void ReadGltfGeometry(const cgltf_data &data, AssetRegistry::MeshData &mesh,
+                      bool &outNormals, bool &outTangents) {
+  std::vector<GltfPrimitive> primitives = CollectGltfPrimitives(data);
+  std::vector<GltfTask> tasks;
+  std::size_t vertexCount = 0;
+  std::size_t indexCount = 0;
+  outNormals = false;
+  outTangents = false;
+  for (std::size_t p = 0; p < primitives.size(); ++p) {
+    GltfPrimitive &primitive = primitives[p];
+    primitive.firstVertex = vertexCount;
+    primitive.firstIndex = indexCount;
+    const std::size_t vertices = primitive.positions->count;
+    vertexCount += vertices;
+    indexCount += primitive.indexCount;
+    outNormals = outNormals || (primitive.normals && primitive.normals->count);
+    outTangents =
+        outTangents || (primitive.tangents && primitive.tangents->count);
+
+    for (std::size_t begin = 0; begin < vertices; begin += kGltfTaskVertices) {
+      tasks.push_back(
+          {p, begin, std::min(vertices, begin + kGltfTaskVertices), false});
+    }
+    for (std::size_t begin = 0; begin < primitive.indexCount;
+         begin += kGltfTaskIndices) {
+      tasks.push_back(
+          {p, begin,
+           std::min(primitive.indexCount, begin + kGltfTaskIndices), true});
+    }
+  }
+
+  mesh.positions.resize(vertexCount);
+  mesh.colors.resize(vertexCount);
+  mesh.normals.resize(vertexCount);
+  mesh.uvs.resize(vertexCount);
+  mesh.tangents.resize(vertexCount);
+  mesh.indices.resize(indexCount);
+
+  std::size_t threads = 1;
+  if (vertexCount >= kParallelGltfMinVertices) {
+    threads = std::min<std::size_t>(
+        {tasks.size(), std::max(1u, std::thread::hardware_concurrency()),
+         kMaxScanThreads});
+  }
+  std::atomic<std::size_t> next{0};
+  RunWorkers(threads, [&]() {
+    for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+         i < tasks.size(); i = next.fetch_add(1, std::memory_order_relaxed)) {
+      RunGltfTask(primitives[tasks[i].primitive], tasks[i], mesh);
+    }
+  });
+}
+
+// An image referenced by an imported glTF, resolved on an import thread.
+struct GltfImage {
+  std::filesystem::path path;
+  std::string id;
+};
+
+// Cooks `source` into `cache` unless it is there already. Default settings
+// produce the key the viewport looks up when the device samples BCn, so its
+// first use of the texture reads the cook instead of decoding the image.
+void PrecookTexture(const std::filesystem::path &source,
+                    DerivedDataCache &cache) {
+  const TextureCookSettings settings{};
+  DerivedDataCache::Key key{};
+  std::filesystem::path cookedPath;
+  if (Aetherion::Core::String::ToLower(source.extension().string()) ==
+          ".dds" ||
+      !GetCookedTextureKey(source, cache, settings, key) ||
+      cache.Find(key, cookedPath)) {
+    return;
+  }
+  CookedTexture cooked;
+  (void)LoadOrCookTexture(source, cache, settings, cooked);
+}
+} // namespace
+
+namespace Aetherion::Assets {
+const char *AssetRegistry::AssetTypeToString(AssetType type) {
+  switch (type) {
+  case AssetType::Texture:
+    return "Texture";
+  case AssetType::Mesh:
+    return "Mesh";
+  case AssetType::Audio:
+    return "Audio";
+  case AssetType::Script:
+    return "Script";
+  case AssetType::Scene:
+    return "Scene";
+  case AssetType::Shader:
+    return "Shader";
+  case AssetType::Other:
+  default:
+    return "Other";
+  }
+}
+
+void AssetRegistry::Scan(const std::string &rootPath) {
+  const auto scanStart = std::chrono::steady_clock::now();
+  const std::size_t sidecarReadsBefore = m_sidecarReads;
+  std::unordered_map<std::string, FileState> previousStates = m_fileStates;
+  std::unordered_map<std::string, AssetType> previousTypes;
+  for (const auto &entry : m_entries) {
+    previousTypes.emplace(entry.id, entry.type);
+  }
+
+  m_placeholderAssets.clear();
+  m_entries.clear();
+  m_entryLookup.clear();
+  m_pathToId.clear();
+
+  std::error_code ec;
+  std::filesystem::path nextRoot = std::filesystem::absolute(rootPath, ec);
+  if (ec) {
+    ec.clear();
+    nextRoot = std::filesystem::path(rootPath);
+  }
+  // Keys and sidecar labels are taken relative to the root lexically.
+  nextRoot = nextRoot.lexically_normal();
+  if (!nextRoot.has_filename() && nextRoot.has_relative_path()) {
+    nextRoot = nextRoot.parent_path();
+  }
+  const bool rootChanged = (!m_rootPath.empty() && nextRoot != m_rootPath);
+  m_rootPath = nextRoot;
+  m_placeholderAssets.emplace("root", m_rootPath.string());
+
+  if (rootChanged) {
+    previousStates.clear();
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_meshDataMutex);
+      m_meshData.clear();
+      m_meshBounds.clear();
+      m_meshDataBytes = 0;
+      ++m_meshDataGeneration;
+    }
+    m_meshes.clear();
+    m_textures.clear();
+    m_materials.clear();
+    m_changeLog.clear();
+    m_changeSerial = 0;
+    m_scanIndex.clear();
+    m_scanIndexLoaded = false;
+  }
+
+  ScanStats stats{};
+  if (!m_scanIndexLoaded) {
+    LoadScanIndex();
+    stats.indexFromDisk = !m_scanIndex.empty();
+  }
+  ++m_scanGeneration;
+
+  std::unordered_map<std::string, FileState> nextStates;
+  std::unordered_map<std::string, AssetType> nextTypes;
+
+  if (std::filesystem::is_directory(m_rootPath, ec)) {
+    // Listing and reading sidecars is mostly waiting on the disk, so both run
+    // on several threads; the registry is only written afterwards, here.
+    const std::size_t threads = ResolveScanThreadCount();
+    std::vector<std::filesystem::path> files =
+        CollectScanFiles(m_rootPath, threads);
+    // Applying the files in path order keeps the outcome independent of
+    // thread timing, e.g. which copy keeps a duplicated sidecar's id.
+    std::sort(files.begin(), files.end(),
+              [](const std::filesystem::path &a,
+                 const std::filesystem::path &b) {
+                return a.native() < b.native();
+              });
+
+    std::vector<ScannedFile> scanned(files.size());
+    std::vector<char> isAsset(files.size(), 0);
+    std::atomic<std::size_t> next{0};
+    stats.threads = files.size() >= kParallelScanMinFiles ? threads : 1;
+    RunWorkers(stats.threads, [&]() {
+      for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+           i < files.size();
+           i = next.fetch_add(1, std::memory_order_relaxed)) {
+        isAsset[i] = ScanFile(files[i], scanned[i]) ? 1 : 0;
+      }
+    });
+
+    m_entries.reserve(files.size());
+    for (std::size_t i = 0; i < files.size(); ++i) {
+      if (!isAsset[i]) {
+        continue;
+      }
+      ScannedFile &file = scanned[i];
+      CommitScannedFile(file);
+      m_pathToId.emplace(std::move(file.key), file.entry.id);
+      nextStates.emplace(file.entry.id, std::move(file.state));
+      nextTypes.emplace(file.entry.id, file.entry.type);
+      m_entries.push_back(std::move(file.entry));
+    }
+  }
+
+  // Assets packed into mounted archives, unless a loose copy was found above.
+  // Their ids were taken from the sidecars when the archive was written.
+  std::string rootVirtualPath;
+  if (m_fileSystem &&
+      m_fileSystem->GetVirtualPath(m_rootPath, rootVirtualPath)) {
+    for (const auto &file : m_fileSystem->ListArchiveFiles()) {
+      std::string_view relative = file.path;
+      if (!rootVirtualPath.empty()) {
+        if (relative.size() <= rootVirtualPath.size() ||
+            !relative.starts_with(rootVirtualPath) ||
+            relative[rootVirtualPath.size()] != '/') {
+          continue;
+        }
+        relative.remove_prefix(rootVirtualPath.size() + 1);
+      }
+      if (file.id.empty() || nextStates.count(file.id) != 0) {
+        continue;
+      }
+
+      AssetEntry entry;
+      entry.id = file.id;
+      entry.path = m_rootPath / std::filesystem::path(relative);
+      entry.type = ClassifyAssetType(entry.path);
+      std::string key = MakePathKey(entry.path, m_rootPath);
+      if (!m_pathToId.emplace(std::move(key), entry.id).second) {
+        continue;
+      }
+      FileState state;
+      state.path = entry.path;
+      // Archived files have no mtime or inode; the content hash stands in
+      // for both, so a rebuilt archive reports the assets that changed.
+      state.asset.size = file.size;
+      state.asset.inode = file.hash;
+      state.asset.exists = true;
+      nextStates.emplace(entry.id, std::move(state));
+      nextTypes.emplace(entry.id, entry.type);
+      m_entries.push_back(std::move(entry));
+    }
+  }
+
+  SortEntries();
+
+  // Files that are gone leave the index.
+  for (auto it = m_scanIndex.begin(); it != m_scanIndex.end();) {
+    if (it->second.lastSeenScan != m_scanGeneration) {
+      it = m_scanIndex.erase(it);
+      m_scanIndexDirty = true;
+    } else {
+      ++it;
+    }
+  }
+
+  std::vector<AssetChange> scanChanges;
+  auto recordChange = [this, &scanChanges](const std::string &id,
+                                           AssetType type,
+                                           AssetChange::Kind kind) {
+    scanChanges.push_back(RecordChange(id, type, kind));
+  };
+
+  for (const auto &[id, state] : nextStates) {
+    auto prevIt = previousStates.find(id);
+    if (prevIt == previousStates.end()) {
+      recordChange(id, nextTypes[id], AssetChange::Kind::Added);
+      continue;
+    }
+
+    const FileState &prev = prevIt->second;
+    if (prev.path != state.path) {
+      recordChange(id, nextTypes[id], AssetChange::Kind::Moved);
+      continue;
+    }
+
+    if (prev.asset != state.asset || prev.meta != state.meta) {
+      const bool onlyMeta = (prev.asset == state.asset);
+      recordChange(id, nextTypes[id],
+                   onlyMeta ? AssetChange::Kind::Metadata
+                            : AssetChange::Kind::Modified);
+    }
+  }
+
+  for (const auto &[id, prev] : previousStates) {
+    if (nextStates.find(id) != nextStates.end()) {
+      continue;
+    }
+    AssetType type = AssetType::Other;
+    if (auto typeIt = previousTypes.find(id); typeIt != previousTypes.end()) {
+      type = typeIt->second;
+    } else {
+      type = ClassifyAssetType(prev.path);
+    }
+    recordChange(id, type, AssetChange::Kind::Removed);
+  }
+
+  for (const auto &change : scanChanges) {
+    DropCachedData(change);
+  }
+  TrimChangeLog();
+
+  m_fileStates = std::move(nextStates);
+
+  if (m_scanIndexDirty) {
+    SaveScanIndex();
+  }
+  m_derivedData.Flush();
+  PublishSnapshot();
+  stats.files = m_fileStates.size();
+  stats.sidecarsParsed = m_sidecarReads - sidecarReadsBefore;
+  stats.milliseconds = std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - scanStart)
+                           .count();
+  m_lastScanStats = stats;
+}
+
+void AssetRegistry::ApplyFileChanges(
+    const std::vector<std::filesystem::path> &paths) {
+  if (m_rootPath.empty()) {
+    return;
+  }
+
+  // Sidecar edits count as edits of their asset.
+  std::vector<std::filesystem::path> assetPaths;
+  std::unordered_set<std::string> seen;
+  assetPaths.reserve(paths.size());
+  for (const auto &path : paths) {
+    std::filesystem::path assetPath = path;
+    if (IsMetadataPath(path)) {
+      std::string native = path.string();
+      native.resize(native.size() - std::strlen(".asset.json"));
+      assetPath = native;
+    }
+    if (seen.insert(assetPath.generic_string()).second) {
+      assetPaths.push_back(std::move(assetPath));
+    }
+  }
+
+  // Paths that exist are (re)read; a directory that appeared is read whole.
+  // Paths that are gone drop the assets at or below them once the updates are
+  // in, so a rename reported as remove + create becomes a move.
+  std::vector<std::filesystem::path> present;
+  std::vector<std::filesystem::path> gone;
+  std::error_code ec;
+  for (const auto &path : assetPaths) {
+    const auto status = std::filesystem::status(path, ec);
+    if (ec || !std::filesystem::exists(status)) {
+      ec.clear();
+      gone.push_back(path);
+    } else if (std::filesystem::is_directory(status)) {
+      const auto options =
+          std::filesystem::directory_options::skip_permission_denied;
+      for (auto it =
+               std::filesystem::recursive_directory_iterator(path, options, ec);
+           it != std::filesystem::recursive_directory_iterator();
+           it.increment(ec)) {
+        if (ec) {
+          ec.clear();
+          continue;
+        }
+        if (it->is_regular_file(ec) && !IsMetadataPath(it->path())) {
+          present.push_back(it->path());
+        }
+      }
+    } else if (std::filesystem::is_regular_file(status)) {
+      present.push_back(path);
+    }
+  }
+
+  std::vector<AssetChange> changes;
+  std::unordered_set<std::string> removedIds;
+  bool entriesChanged = false;
+  for (const auto &path : present) {
+    AssetEntry asset{};
+    FileState state{};
+    if (!ReadAssetFile(path, asset, state)) {
+      continue;
+    }
+
+    const std::string key = MakePathKey(path, m_rootPath);
+    // A deleted or rewritten sidecar (e.g. after a checkout) gives an
+    // unchanged path a new id. The old id is removed, as a full Scan would.
+    if (auto pathIt = m_pathToId.find(key);
+        pathIt != m_pathToId.end() && pathIt->second != asset.id) {
+      const std::string oldId = pathIt->second;
+      AssetType oldType = ClassifyAssetType(path);
+      if (auto entryIt = m_entryLookup.find(oldId);
+          entryIt != m_entryLookup.end()) {
+        oldType = m_entries[entryIt->second].type;
+      }
+      if (auto oldIt = m_fileStates.find(oldId); oldIt != m_fileStates.end()) {
+        // The label of this path already holds the new id.
+        const std::string oldLabel =
+            RelativeLabel(oldIt->second.path, m_rootPath);
+        if (oldLabel != RelativeLabel(path, m_rootPath) &&
+            m_scanIndex.erase(oldLabel) > 0) {
+          m_scanIndexDirty = true;
+        }
+        m_fileStates.erase(oldIt);
+      }
+      m_pathToId.erase(pathIt);
+      changes.push_back(
+          RecordChange(oldId, oldType, AssetChange::Kind::Removed));
+      removedIds.insert(oldId);
+    }
+
+    auto stateIt = m_fileStates.find(asset.id);
+    if (stateIt == m_fileStates.end()) {
+      m_pathToId[key] = asset.id;
+      m_fileStates.emplace(asset.id, state);
+      changes.push_back(RecordChange(asset.id, asset.type,
+                                     AssetChange::Kind::Added));
+      // An id retired above (sidecars swapped between files) still has its
+      // entry, which is reused.
+      auto entryIt = m_entryLookup.find(asset.id);
+      if (removedIds.erase(asset.id) > 0 && entryIt != m_entryLookup.end()) {
+        m_entries[entryIt->second] = std::move(asset);
+      } else {
+        m_entries.push_back(std::move(asset));
+      }
+      entriesChanged = true;
+      continue;
+    }
+
+    FileState &previous = stateIt->second;
+    AssetChange::Kind kind = AssetChange::Kind::Modified;
+    if (previous.path != state.path) {
+      m_pathToId.erase(MakePathKey(previous.path, m_rootPath));
+      kind = AssetChange::Kind::Moved;
+    } else if (previous.asset == state.asset && previous.meta == state.meta) {
+      continue;
+    } else if (previous.asset == state.asset) {
+      kind = AssetChange::Kind::Metadata;
+    }
+
+    m_pathToId[key] = asset.id;
+    previous = state;
+    if (auto entryIt = m_entryLookup.find(asset.id);
+        entryIt != m_entryLookup.end()) {
+      entriesChanged |= m_entries[entryIt->second].type != asset.type;
+      m_entries[entryIt->second] = asset;
+    }
+    changes.push_back(RecordChange(asset.id, asset.type, kind));
+  }
+
+  for (const auto &path : gone) {
+    for (auto it = m_fileStates.begin(); it != m_fileStates.end();) {
+      const auto relative = it->second.path.lexically_relative(path);
+      const bool inside = !relative.empty() && *relative.begin() != "..";
+      if (!inside) {
+        ++it;
+        continue;
+      }
+
+      AssetType type = ClassifyAssetType(it->second.path);
+      if (auto entryIt = m_entryLookup.find(it->first);
+          entryIt != m_entryLookup.end()) {
+        type = m_entries[entryIt->second].type;
+      }
+      m_pathToId.erase(MakePathKey(it->second.path, m_rootPath));
+      if (m_scanIndex.erase(RelativeLabel(it->second.path, m_rootPath)) > 0) {
+        m_scanIndexDirty = true;
+      }
+      changes.push_back(
+          RecordChange(it->first, type, AssetChange::Kind::Removed));
+      removedIds.insert(it->first);
+      it = m_fileStates.erase(it);
+    }
+  }
+
+  if (!removedIds.empty()) {
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                   [&removedIds](const AssetEntry &entry) {
+                                     return removedIds.count(entry.id) != 0;
+                                   }),
+                    m_entries.end());
+    entriesChanged = true;
+  }
+  if (entriesChanged) {
+    SortEntries();
+  }
+
+  for (const auto &change : changes) {
+    DropCachedData(change);
+  }
+  TrimChangeLog();
+
+  if (m_scanIndexDirty) {
+    SaveScanIndex();
+  }
+  m_derivedData.Flush();
+  PublishSnapshot();
+}
+
+bool AssetRegistry::ScanFile(const std::filesystem::path &path,
+                             ScannedFile &out) const {
+  if (IsMetadataPath(path)) {
+    return false;
+  }
+
+  const auto filename = path.filename().string();
+  if (!filename.empty() && filename.front() == '.') {
+    return false;
+  }
+  // Archives are mounted by the application, not listed as assets.
+  if (Aetherion::Core::String::ToLower(path.extension().string()) ==
+      ".apak") {
+    return false;
+  }
+
+  const std::string sourceLabel = RelativeLabel(path, m_rootPath);
+  if (sourceLabel.empty()) {
+    return false;
+  }
+
+  const std::filesystem::path metaPath = BuildMetadataPath(path);
+  const FileStamp assetStamp = StatFile(path);
+  const FileStamp metaStamp = StatFile(metaPath);
+  out.label = sourceLabel;
+  out.key = MakePathKey(path, m_rootPath);
+  out.entry.path = path;
+  out.state.path = path;
+  out.state.asset = assetStamp;
+
+  // Neither file changed since the sidecar was last read or written, so it
+  // still holds this id, source and type.
+  auto indexed = m_scanIndex.find(sourceLabel);
+  if (indexed != m_scanIndex.end() && metaStamp.exists &&
+      indexed->second.asset == assetStamp &&
+      indexed->second.meta == metaStamp) {
+    out.entry.id = indexed->second.id;
+    out.entry.type = indexed->second.type;
+    out.state.meta = metaStamp;
+    out.sidecarRead = false;
+    return true;
+  }
+
+  out.sidecarRead = true;
+  std::string assetId;
+  std::string metaSource;
+  std::string metaType;
+  bool writeMeta = false;
+
+  if (metaStamp.exists) {
+    if (!ReadMetadataFile(metaPath, assetId, &metaSource, &metaType)) {
+      assetId.clear();
+    }
+  }
+
+  if (assetId.empty()) {
+    assetId = Core::GenerateUUID();
+    writeMeta = true;
+  }
+
+  const AssetType type = ClassifyAssetType(path);
+  if (metaSource.empty() || metaSource != sourceLabel) {
+    writeMeta = true;
+  }
+  if (metaType.empty() || metaType != AssetTypeToString(type)) {
+    writeMeta = true;
+  }
+
+  if (writeMeta) {
+    WriteMetadataFile(metaPath, assetId, type, sourceLabel);
+  }
+
+  out.entry.id = assetId;
+  out.entry.type = type;
+  out.state.meta = writeMeta ? StatFile(metaPath) : metaStamp;
+  return true;
+}
+
+void AssetRegistry::CommitScannedFile(const ScannedFile &file) {
+  IndexedFile &entry = m_scanIndex[file.label];
+  entry.lastSeenScan = m_scanGeneration;
+  if (!file.sidecarRead) {
+    return;
+  }
+
+  ++m_sidecarReads;
+  entry.id = file.entry.id;
+  entry.type = file.entry.type;
+  entry.asset = file.state.asset;
+  entry.meta = file.state.meta;
+  m_scanIndexDirty = true;
+}
+
+bool AssetRegistry::ReadAssetFile(const std::filesystem::path &path,
+                                  AssetEntry &outEntry, FileState &outState) {
+  ScannedFile file;
+  if (!ScanFile(path, file)) {
+    return false;
+  }
+  CommitScannedFile(file);
+  outEntry = std::move(file.entry);
+  outState = std::move(file.state);
+  return true;
+}
+
+std::size_t AssetRegistry::ResolveScanThreadCount() const noexcept {
+  if (m_scanThreadCount > 0) {
+    return m_scanThreadCount;
+  }
+  // Workers mostly wait on stat() and small reads, so more of them than
+  // cores still helps keep the disk queue full.
+  const std::size_t cores =
+      std::max(1u, std::thread::hardware_concurrency());
+  return std::clamp<std::size_t>(cores * 2, 2, kMaxScanThreads);
+}
+
+void AssetRegistry::SetScanThreadCount(std::size_t threads) noexcept {
+  m_scanThreadCount = std::min(threads, kMaxScanThreads);
+}
+
+AssetRegistry::FileStamp
+AssetRegistry::StatFile(const std::filesystem::path &path) {
+  FileStamp stamp{};
+#ifdef _WIN32
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return stamp;
+  }
+  const auto time = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return stamp;
+  }
+  stamp.size = size;
+  stamp.mtimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      time.time_since_epoch())
+                      .count();
+#else
+  // One stat() instead of separate size and time queries.
+  struct stat info {};
+  if (::stat(path.c_str(), &info) != 0) {
+    return stamp;
+  }
+  stamp.size = static_cast<std::uint64_t>(info.st_size);
+  stamp.inode = static_cast<std::uint64_t>(info.st_ino);
+#ifdef __APPLE__
+  const auto &mtime = info.st_mtimespec;
+#else
+  const auto &mtime = info.st_mtim;
+#endif
+  stamp.mtimeNs = static_cast<std::int64_t>(mtime.tv_sec) * 1000000000 +
+                  static_cast<std::int64_t>(mtime.tv_nsec);
+#endif
+  stamp.exists = true;
+  return stamp;
+}
+
+std::filesystem::path AssetRegistry::GetScanIndexPath() const {
+  if (m_cacheRoot.empty()) {
+    return {};
+  }
+  return m_cacheRoot / "asset_index.bin";
+}
+
+void AssetRegistry::LoadScanIndex() {
+  m_scanIndexLoaded = true;
+  m_scanIndex.clear();
+  m_scanIndexDirty = false;
+
+  const std::filesystem::path indexPath = GetScanIndexPath();
+  if (indexPath.empty()) {
+    return;
+  }
+  std::ifstream input(indexPath, std::ios::binary);
+  if (!input.is_open()) {
+    return;
+  }
+
+  char magic[4] = {};
+  std::uint32_t version = 0;
+  std::string root;
+  std::uint64_t count = 0;
+  if (!input.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kScanIndexMagic, sizeof(magic)) != 0 ||
+      !ReadPod(input, version) || version != kScanIndexVersion ||
+      !ReadString(input, root) || root != m_rootPath.generic_string() ||
+      !ReadPod(input, count)) {
+    return;
+  }
+
+  auto readStamp = [&input](FileStamp &stamp) {
+    std::uint8_t exists = 0;
+    const bool ok = ReadPod(input, stamp.size) &&
+                    ReadPod(input, stamp.mtimeNs) &&
+                    ReadPod(input, stamp.inode) && ReadPod(input, exists);
+    stamp.exists = exists != 0;
+    return ok;
+  };
+
+  // The count is only a hint; a corrupt one must not throw from the reserve.
+  m_scanIndex.reserve(
+      static_cast<size_t>(std::min<std::uint64_t>(count, 1u << 20)));
+  for (std::uint64_t i = 0; i < count; ++i) {
+    std::string key;
+    IndexedFile entry;
+    std::uint8_t type = 0;
+    if (!ReadString(input, key) || !ReadString(input, entry.id) ||
+        !ReadPod(input, type) || !readStamp(entry.asset) ||
+        !readStamp(entry.meta) ||
+        type > static_cast<std::uint8_t>(AssetType::Other)) {
+      // A torn or foreign file; everything gets re-read instead.
+      m_scanIndex.clear();
+      return;
+    }
+    entry.type = static_cast<AssetType>(type);
+    m_scanIndex.emplace(std::move(key), std::move(entry));
+  }
+}
+
+void AssetRegistry::SaveScanIndex() {
+  m_scanIndexDirty = false;
+  const std::filesystem::path indexPath = GetScanIndexPath();
+  if (indexPath.empty()) {
+    return;
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(indexPath.parent_path(), ec);
+  const std::filesystem::path tempPath =
+      DerivedDataCache::MakeTempPath(indexPath);
+  {
+    std::ofstream output(tempPath, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+      return;
+    }
+
+    auto writeStamp = [&output](const FileStamp &stamp) {
+      WritePod(output, stamp.size);
+      WritePod(output, stamp.mtimeNs);
+      WritePod(output, stamp.inode);
+      WritePod(output, static_cast<std::uint8_t>(stamp.exists ? 1 : 0));
+    };
+
+    output.write(kScanIndexMagic, sizeof(kScanIndexMagic));
+    WritePod(output, kScanIndexVersion);
+    WriteString(output, m_rootPath.generic_string());
+    WritePod(output, static_cast<std::uint64_t>(m_scanIndex.size()));
+    for (const auto &[key, entry] : m_scanIndex) {
+      WriteString(output, key);
+      WriteString(output, entry.id);
+      WritePod(output, static_cast<std::uint8_t>(entry.type));
+      writeStamp(entry.asset);
+      writeStamp(entry.meta);
+    }
+    if (!output) {
+      output.close();
+      std::filesystem::remove(tempPath, ec);
+      return;
+    }
+  }
+  // Readers never see a half-written index.
+  std::filesystem::rename(tempPath, indexPath, ec);
+  if (ec) {
+    std::filesystem::remove(tempPath, ec);
+  }
+}
+
+const AssetRegistry::ScanStats &
+AssetRegistry::GetLastScanStats() const noexcept {
+  return m_lastScanStats;
+}
+
+void AssetRegistry::SortEntries() {
+  std::sort(m_entries.begin(), m_entries.end(),
+            [](const AssetEntry &a, const AssetEntry &b) {
+              const int orderA = AssetTypeOrder(a.type);
+              const int orderB = AssetTypeOrder(b.type);
+              if (orderA != orderB) {
+                return orderA < orderB;
+              }
+              return a.id < b.id;
+            });
+
+  m_entryLookup.clear();
+  for (size_t i = 0; i < m_entries.size(); ++i) {
+    m_entryLookup.emplace(m_entries[i].id, i);
+  }
+}
+
+AssetRegistry::AssetChange
+AssetRegistry::RecordChange(const std::string &id, AssetType type,
+                            AssetChange::Kind kind) {
+  AssetChange change{};
+  change.id = id;
+  change.type = type;
+  change.kind = kind;
+  change.serial = ++m_changeSerial;
+  m_changeLog.push_back(change);
+  return change;
+}
+
+void AssetRegistry::DropCachedData(const AssetChange &change) {
+  if (change.kind != AssetChange::Kind::Removed &&
+      change.kind != AssetChange::Kind::Modified &&
+      change.kind != AssetChange::Kind::Moved) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_meshDataMutex);
+    EraseMeshData(change.id);
+    m_meshBounds.erase(change.id);
+    ++m_meshDataGeneration;
+  }
+  m_meshes.erase(change.id);
+  m_textures.erase(change.id);
+
+  if (change.type == AssetType::Mesh) {
+    for (auto it = m_materials.begin(); it != m_materials.end();) {
+      if (it->first.rfind(change.id + ":", 0) == 0) {
+        it = m_materials.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+void AssetRegistry::TrimChangeLog() {
+  const size_t maxChanges = 2048;
   if (m_changeLog.size() > maxChanges) {
     m_changeLog.erase(
         m_changeLog.begin(),
         m_changeLog.begin() +
             static_cast<std::ptrdiff_t>(m_changeLog.size() - maxChanges));
   }
-
-  m_fileStates = std::move(nextStates);
 }
 
 void AssetRegistry::Rescan() {
@@ -1385,12 +2499,13 @@ void AssetRegistry::Rescan() {
 }
 
 bool AssetRegistry::HasAsset(const std::string &assetId) const {
+  std::lock_guard<std::recursive_mutex> lock(m_meshDataMutex);
   return m_placeholderAssets.find(assetId) != m_placeholderAssets.end() ||
          m_entryLookup.find(assetId) != m_entryLookup.end() ||
          m_meshes.find(assetId) != m_meshes.end() ||
          m_textures.find(assetId) != m_textures.end() ||
          m_materials.find(assetId) != m_materials.end() ||
-         m_meshData.find(assetId) != m_meshData.end();
+         m_meshBounds.find(assetId) != m_meshBounds.end();
 }
 
 const std::vector<AssetRegistry::AssetEntry> &
@@ -1402,6 +2517,55 @@ const std::filesystem::path &AssetRegistry::GetRootPath() const noexcept {
   return m_rootPath;
 }
 
+void AssetRegistry::SetCacheRoot(const std::filesystem::path &cacheRoot) {
+  m_cacheRoot = cacheRoot;
+  m_derivedData.Open(cacheRoot.empty() ? std::filesystem::path()
+                                       : cacheRoot / "ddc");
+}
+
+const std::filesystem::path &AssetRegistry::GetCacheRoot() const noexcept {
+  return m_cacheRoot;
+}
+
+DerivedDataCache *AssetRegistry::GetDerivedDataCache() noexcept {
+  return &m_derivedData;
+}
+
+void AssetRegistry::SetFileSystem(
+    std::shared_ptr<const VirtualFileSystem> fileSystem) {
+  m_fileSystem = std::move(fileSystem);
+  PublishSnapshot();
+}
+
+const std::shared_ptr<const VirtualFileSystem> &
+AssetRegistry::GetFileSystem() const noexcept {
+  return m_fileSystem;
+}
+
+bool AssetRegistry::HashAssetSource(const std::filesystem::path &source,
+                                    std::uint64_t &outHash) {
+  // Every caller has to list the same dependencies for a path, or their
+  // remembered hashes would keep replacing each other.
+  const std::string extension =
+      Aetherion::Core::String::ToLower(source.extension().string());
+  if (extension == ".gltf") {
+    return m_derivedData.HashSource(source, outHash, ListGltfBuffers);
+  }
+  return m_derivedData.HashSource(source, outHash);
+}
+
+bool AssetRegistry::GetCookedMeshKey(const std::filesystem::path &source,
+                                     std::uint64_t settingsHash,
+                                     DerivedDataCache::Key &outKey) {
+  std::uint64_t contentHash = 0;
+  if (!m_derivedData.IsOpen() || !HashAssetSource(source, contentHash)) {
+    return false;
+  }
+  outKey = DerivedDataCache::MakeKey(kCookedMeshKind, contentHash,
+                                     settingsHash);
+  return true;
+}
+
 const AssetRegistry::AssetEntry *
 AssetRegistry::FindEntry(const std::string &assetId) const noexcept {
   auto it = m_entryLookup.find(assetId);
@@ -1433,239 +2597,464 @@ AssetRegistry::FindEntry(const std::string &assetId) const noexcept {
   return nullptr;
 }
 
-const AssetRegistry::MeshData *
+AssetRegistry::MeshDataHandle
 AssetRegistry::GetMeshData(const std::string &assetId) const noexcept {
+  std::lock_guard<std::recursive_mutex> lock(m_meshDataMutex);
   auto it = m_meshData.find(assetId);
   if (it == m_meshData.end()) {
     return nullptr;
   }
-  return &it->second;
+  it->second.lastUse = ++m_meshDataUseCounter;
+  return it->second.data;
 }
 
-const AssetRegistry::MeshData *
-AssetRegistry::LoadMeshData(const std::string &assetId) {
-  if (assetId.empty()) {
-    return nullptr;
+bool AssetRegistry::GetMeshBounds(const std::string &assetId,
+                                  MeshBounds &out) const noexcept {
+  std::lock_guard<std::recursive_mutex> lock(m_meshDataMutex);
+  auto it = m_meshBounds.find(assetId);
+  if (it == m_meshBounds.end()) {
+    return false;
   }
+  out = it->second;
+  return true;
+}
 
-  if (const auto *cached = GetMeshData(assetId)) {
-    return cached;
+AssetRegistry::MeshDataHandle
+AssetRegistry::StoreMeshData(const std::string &assetId, MeshData &&mesh) {
+  auto data = std::make_shared<const MeshData>(std::move(mesh));
+  MeshBounds &bounds = m_meshBounds[assetId];
+  bounds.min = data->boundsMin;
+  bounds.max = data->boundsMax;
+  bounds.center = data->boundsCenter;
+  bounds.radius = data->boundsRadius;
+
+  EraseMeshData(assetId);
+  MeshDataSlot &slot = m_meshData[assetId];
+  slot.data = data;
+  slot.bytes = GetMeshDataBytes(*data);
+  slot.lastUse = ++m_meshDataUseCounter;
+  m_meshDataBytes += slot.bytes;
+  // `data` pins the new mesh until the caller has its handle.
+  EvictMeshData();
+  return data;
+}
+
+void AssetRegistry::EraseMeshData(const std::string &assetId) {
+  auto it = m_meshData.find(assetId);
+  if (it == m_meshData.end()) {
+    return;
+  }
+  m_meshDataBytes -= it->second.bytes;
+  m_meshData.erase(it);
+}
+
+void AssetRegistry::EvictMeshData() {
+  if (m_meshDataBudget == 0 || m_meshDataBytes <= m_meshDataBudget) {
+    return;
+  }
+  std::vector<std::pair<std::uint64_t, const std::string *>> byAge;
+  byAge.reserve(m_meshData.size());
+  for (const auto &[id, slot] : m_meshData) {
+    // Anything held outside the registry is in use and stays.
+    if (slot.data.use_count() == 1) {
+      byAge.emplace_back(slot.lastUse, &id);
+    }
+  }
+  std::sort(byAge.begin(), byAge.end());
+  for (const auto &[lastUse, id] : byAge) {
+    if (m_meshDataBytes <= m_meshDataBudget) {
+      break;
+    }
+    EraseMeshData(std::string(*id));
+    ++m_meshDataEvictions;
+  }
+}
+
+void AssetRegistry::SetMeshDataBudget(std::uint64_t bytes) {
+  std::lock_guard<std::recursive_mutex> lock(m_meshDataMutex);
+  m_meshDataBudget = bytes;
+  EvictMeshData();
+}
+
+AssetRegistry::MemoryStats AssetRegistry::GetMemoryStats() const {
+  std::lock_guard<std::recursive_mutex> lock(m_meshDataMutex);
+  MemoryStats stats{};
+  stats.meshDataBudget = m_meshDataBudget;
+  stats.meshDataHits = m_meshDataHits;
+  stats.meshDataMisses = m_meshDataMisses;
+  stats.meshDataEvictions = m_meshDataEvictions;
+  stats.meshLoadsShared = m_meshLoadsShared;
+  stats.meshLoadsInFlight = m_meshLoads.size();
+  for (const auto &[id, slot] : m_meshData) {
+    ++stats.meshData.entries;
+    stats.meshData.bytes += slot.bytes;
+    if (slot.data.use_count() > 1) {
+      ++stats.meshData.pinnedEntries;
+      stats.meshData.pinnedBytes += slot.bytes;
+    }
+  }
+  stats.meshBounds.entries = m_meshBounds.size();
+  for (const auto &[id, bounds] : m_meshBounds) {
+    stats.meshBounds.bytes += id.capacity() + sizeof(bounds);
+  }
+  stats.importMetadata.entries =
+      m_meshes.size() + m_textures.size() + m_materials.size();
+  for (const auto &[id, mesh] : m_meshes) {
+    stats.importMetadata.bytes += sizeof(mesh) + id.capacity();
+    for (const auto &texture : mesh.textureIds) {
+      stats.importMetadata.bytes += sizeof(texture) + texture.capacity();
+    }
+    for (const auto &material : mesh.materialIds) {
+      stats.importMetadata.bytes += sizeof(material) + material.capacity();
+    }
+  }
+  for (const auto &[id, texture] : m_textures) {
+    stats.importMetadata.bytes += sizeof(texture) + id.capacity();
+  }
+  for (const auto &[id, material] : m_materials) {
+    stats.importMetadata.bytes +=
+        sizeof(material) + id.capacity() + material.name.capacity();
+  }
+  return stats;
+}
+
+std::shared_ptr<const AssetRegistry::Snapshot>
+AssetRegistry::GetSnapshot() const {
+  std::lock_guard<std::mutex> lock(m_snapshotMutex);
+  return m_snapshot;
+}
+
+void AssetRegistry::PublishSnapshot() {
+  auto snapshot = std::make_shared<Snapshot>();
+  snapshot->rootPath = m_rootPath;
+  snapshot->entries = m_entries;
+  snapshot->fileSystem = m_fileSystem;
+  snapshot->idLookup.reserve(m_entries.size());
+  snapshot->pathLookup.reserve(m_entries.size());
+  for (std::size_t i = 0; i < m_entries.size(); ++i) {
+    snapshot->idLookup.emplace(m_entries[i].id, i);
+    snapshot->pathLookup.emplace(MakePathKey(m_entries[i].path, m_rootPath),
+                                 i);
+  }
+  // The previous snapshot lives on with whoever still holds it.
+  std::lock_guard<std::mutex> lock(m_snapshotMutex);
+  m_snapshot = std::move(snapshot);
+}
+
+const AssetRegistry::AssetEntry *
+AssetRegistry::Snapshot::Find(const std::string &assetId) const noexcept {
+  if (auto it = idLookup.find(assetId); it != idLookup.end()) {
+    return &entries[it->second];
+  }
+  if (assetId.empty() || rootPath.empty()) {
+    return nullptr;
   }
+  std::filesystem::path assetPath(assetId);
+  if (!assetPath.is_absolute()) {
+    assetPath = rootPath / assetPath;
+  }
+  if (auto it = pathLookup.find(MakePathKey(assetPath, rootPath));
+      it != pathLookup.end()) {
+    return &entries[it->second];
+  }
+  return nullptr;
+}
 
+std::filesystem::path
+AssetRegistry::ResolveMeshSource(const std::string &assetId) const {
+  // Called from loading threads, so only the snapshot is read.
+  const auto snapshot = GetSnapshot();
   std::filesystem::path sourcePath;
-  if (const auto *entry = FindEntry(assetId)) {
+  if (const auto *entry = snapshot->Find(assetId)) {
     sourcePath = entry->path;
-  } else {
+  } else if (!FindPackedAsset(snapshot->fileSystem.get(), assetId,
+                              sourcePath)) {
     sourcePath = std::filesystem::path(assetId);
-    if (!sourcePath.is_absolute() && !m_rootPath.empty()) {
-      sourcePath = m_rootPath / sourcePath;
+    if (!sourcePath.is_absolute() && !snapshot->rootPath.empty()) {
+      sourcePath = snapshot->rootPath / sourcePath;
     }
   }
 
   std::error_code ec;
-  if (sourcePath.empty() || !std::filesystem::exists(sourcePath, ec)) {
-    return nullptr;
+  if (sourcePath.empty() ||
+      (!std::filesystem::exists(sourcePath, ec) &&
+       !(snapshot->fileSystem && snapshot->fileSystem->Exists(sourcePath)))) {
+    return {};
   }
+  return sourcePath;
+}
 
-  const auto settings = GetMeshImportSettings(assetId);
-
-  const std::string extension =
-      Aetherion::Core::String::ToLower(sourcePath.extension().string());
-  if (extension == ".obj") {
-    MeshData mesh{};
-    if (!LoadObjMesh(sourcePath, settings, mesh)) {
-      return nullptr;
-    }
-
-    auto &stored = m_meshData[assetId];
-    stored = std::move(mesh);
-    return &stored;
+std::filesystem::path
+AssetRegistry::FindCookedMesh(const std::string &assetId) {
+  const std::filesystem::path sourcePath = ResolveMeshSource(assetId);
+  DerivedDataCache::Key key{};
+  std::filesystem::path cookedPath;
+  if (sourcePath.empty() ||
+      !GetCookedMeshKey(sourcePath,
+                        HashMeshImportSettings(GetMeshImportSettings(assetId)),
+                        key) ||
+      !m_derivedData.Find(key, cookedPath)) {
+    return {};
   }
+  return cookedPath;
+}
 
-  if (extension != ".gltf" && extension != ".glb") {
+AssetRegistry::MeshDataHandle
+AssetRegistry::LoadMeshData(const std::string &assetId) {
+  if (assetId.empty()) {
     return nullptr;
   }
 
-  cgltf_options options{};
-  cgltf_data *data = nullptr;
-  cgltf_result result =
-      cgltf_parse_file(&options, sourcePath.string().c_str(), &data);
-  if (result != cgltf_result_success || !data) {
-    if (data) {
-      cgltf_free(data);
+  MeshDataHandle cached;
+  bool owner = false;
+  const auto load = AcquireMeshLoad(assetId, cached, owner);
+  if (!load) {
+    return cached;
+  }
+  if (owner) {
+    RunMeshLoad(assetId, *load);
+  }
+  return load->future.get();
+}
+
+std::shared_future<AssetRegistry::MeshDataHandle>
+AssetRegistry::LoadMeshDataAsync(const std::string &assetId,
+                                 MeshLoadCallback onLoaded) {
+  MeshDataHandle cached;
+  bool owner = false;
+  std::shared_ptr<MeshLoad> load;
+  if (!assetId.empty()) {
+    std::lock_guard<std::recursive_mutex> lock(m_meshDataMutex);
+    load = AcquireMeshLoad(assetId, cached, owner);
+    if (load && onLoaded) {
+      // Taken by RunMeshLoad under the same lock, so it cannot be missed.
+      load->callbacks.push_back(std::move(onLoaded));
+    }
+  }
+  if (!load) {
+    std::promise<MeshDataHandle> ready;
+    ready.set_value(cached);
+    if (onLoaded) {
+      onLoaded(cached);
+    }
+    return ready.get_future().share();
+  }
+
+  if (owner) {
+    if (StartLoadThreads()) {
+      {
+        std::lock_guard<std::mutex> lock(m_loadQueueMutex);
+        m_loadQueue.push_back({assetId, load});
+      }
+      m_loadQueueWake.notify_one();
+    } else {
+      RunMeshLoad(assetId, *load);
     }
-    return nullptr;
   }
+  return load->future;
+}
 
-  result = cgltf_load_buffers(&options, data, sourcePath.string().c_str());
-  if (result != cgltf_result_success) {
-    cgltf_free(data);
+std::shared_ptr<AssetRegistry::MeshLoad>
+AssetRegistry::AcquireMeshLoad(const std::string &assetId,
+                               MeshDataHandle &outCached, bool &outOwner) {
+  std::lock_guard<std::recursive_mutex> lock(m_meshDataMutex);
+  outOwner = false;
+  if (auto it = m_meshData.find(assetId); it != m_meshData.end()) {
+    it->second.lastUse = ++m_meshDataUseCounter;
+    ++m_meshDataHits;
+    outCached = it->second.data;
     return nullptr;
   }
+  if (auto it = m_meshLoads.find(assetId); it != m_meshLoads.end()) {
+    ++m_meshLoadsShared;
+    return it->second;
+  }
 
-  MeshData mesh{};
-  bool loadedNormals = false;
-  bool loadedTangents = false;
+  ++m_meshDataMisses;
+  auto load = std::make_shared<MeshLoad>();
+  load->future = load->promise.get_future().share();
+  load->generation = m_meshDataGeneration;
+  m_meshLoads.emplace(assetId, load);
+  outOwner = true;
+  return load;
+}
 
-  auto appendPrimitive = [&](const cgltf_primitive &primitive,
-                             const cgltf_float *matrix) {
-    if (primitive.type != cgltf_primitive_type_triangles) {
-      return;
-    }
+void AssetRegistry::RunMeshLoad(const std::string &assetId, MeshLoad &load) {
+  MeshData mesh{};
+  bool loaded = false;
+  std::exception_ptr error;
+  try {
+    loaded = ImportMeshData(assetId, mesh);
+  } catch (...) {
+    error = std::current_exception();
+  }
 
-    const cgltf_accessor *positionAccessor = nullptr;
-    const cgltf_accessor *colorAccessor = nullptr;
-    const cgltf_accessor *normalAccessor = nullptr;
-    const cgltf_accessor *uvAccessor = nullptr;
-    const cgltf_accessor *tangentAccessor = nullptr;
-    for (cgltf_size attrIndex = 0; attrIndex < primitive.attributes_count;
-         ++attrIndex) {
-      const cgltf_attribute &attr = primitive.attributes[attrIndex];
-      if (attr.type == cgltf_attribute_type_position) {
-        positionAccessor = attr.data;
-      } else if (attr.type == cgltf_attribute_type_color) {
-        colorAccessor = attr.data;
-      } else if (attr.type == cgltf_attribute_type_normal) {
-        normalAccessor = attr.data;
-      } else if (attr.type == cgltf_attribute_type_tangent) {
-        tangentAccessor = attr.data;
-      } else if (attr.type == cgltf_attribute_type_texcoord &&
-                 attr.index == 0) {
-        uvAccessor = attr.data;
-      }
+  MeshDataHandle handle;
+  std::vector<MeshLoadCallback> callbacks;
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_meshDataMutex);
+    if (loaded) {
+      handle = load.generation == m_meshDataGeneration
+                   ? StoreMeshData(assetId, std::move(mesh))
+                   : std::make_shared<const MeshData>(std::move(mesh));
     }
-
-    if (!positionAccessor || positionAccessor->count == 0) {
-      return;
+    if (auto it = m_meshLoads.find(assetId);
+        it != m_meshLoads.end() && it->second.get() == &load) {
+      m_meshLoads.erase(it);
     }
+    callbacks.swap(load.callbacks);
+  }
 
-    const size_t baseVertex = mesh.positions.size();
-    mesh.positions.reserve(baseVertex + positionAccessor->count);
-    mesh.colors.reserve(baseVertex + positionAccessor->count);
-    mesh.normals.reserve(baseVertex + positionAccessor->count);
-    mesh.uvs.reserve(baseVertex + positionAccessor->count);
-
-    float normalMatrix[9] = {};
-    const bool hasNormalMatrix =
-        matrix ? ComputeNormalMatrix(matrix, normalMatrix) : false;
-    for (cgltf_size i = 0; i < positionAccessor->count; ++i) {
-      float values[3] = {0.0f, 0.0f, 0.0f};
-      cgltf_accessor_read_float(positionAccessor, i, values, 3);
-      if (matrix) {
-        float transformed[3];
-        TransformPosition(matrix, values, transformed);
-        mesh.positions.push_back(
-            {transformed[0], transformed[1], transformed[2]});
-      } else {
-        mesh.positions.push_back({values[0], values[1], values[2]});
-      }
+  if (error) {
+    load.promise.set_exception(error);
+  } else {
+    load.promise.set_value(handle);
+  }
+  for (const auto &callback : callbacks) {
+    callback(handle);
+  }
+}
 
-      // Load vertex color if available, otherwise use white
-      if (colorAccessor && i < colorAccessor->count) {
-        float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
-        cgltf_accessor_read_float(colorAccessor, i, color, 4);
-        mesh.colors.push_back({color[0], color[1], color[2], color[3]});
-      } else {
-        mesh.colors.push_back({1.0f, 1.0f, 1.0f, 1.0f});
-      }
+void AssetRegistry::SetLoadThreadCount(std::size_t threads) noexcept {
+  std::lock_guard<std::mutex> lock(m_loadQueueMutex);
+  m_loadThreadCount = std::min(threads, kMaxLoadThreads);
+}
 
-      float normal[3] = {0.0f, 0.0f, 1.0f};
-      if (normalAccessor && i < normalAccessor->count) {
-        cgltf_accessor_read_float(normalAccessor, i, normal, 3);
-        loadedNormals = true;
-      }
-      if (hasNormalMatrix) {
-        float transformed[3];
-        TransformNormal(normalMatrix, normal, transformed);
-        normal[0] = transformed[0];
-        normal[1] = transformed[1];
-        normal[2] = transformed[2];
-      }
-      const float defaultNormal[3] = {0.0f, 0.0f, 1.0f};
-      NormalizeVector(normal, defaultNormal);
-      mesh.normals.push_back({normal[0], normal[1], normal[2]});
+bool AssetRegistry::StartLoadThreads() {
+  std::lock_guard<std::mutex> lock(m_loadQueueMutex);
+  if (!m_loadThreads.empty() || m_stopLoading) {
+    return !m_loadThreads.empty();
+  }
+  std::size_t count = m_loadThreadCount;
+  if (count == 0) {
+    // Loads mostly parse and copy; leave a core to the threads that asked.
+    const std::size_t cores =
+        std::max(1u, std::thread::hardware_concurrency());
+    count = std::clamp<std::size_t>(cores - 1, 1, kDefaultLoadThreads);
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    try {
+      m_loadThreads.emplace_back([this] { LoadThreadMain(); });
+    } catch (const std::system_error &) {
+      break;
+    }
+  }
+  // Without any thread, loads run on the caller instead.
+  return !m_loadThreads.empty();
+}
 
-      float uv[2] = {0.0f, 0.0f};
-      if (uvAccessor && i < uvAccessor->count) {
-        cgltf_accessor_read_float(uvAccessor, i, uv, 2);
+void AssetRegistry::LoadThreadMain() {
+  for (;;) {
+    LoadJob job;
+    {
+      std::unique_lock<std::mutex> lock(m_loadQueueMutex);
+      m_loadQueueWake.wait(
+          lock, [this] { return m_stopLoading || !m_loadQueue.empty(); });
+      if (m_stopLoading) {
+        return;
       }
-      mesh.uvs.push_back({uv[0], uv[1]});
+      job = std::move(m_loadQueue.front());
+      m_loadQueue.pop_front();
+    }
+    RunMeshLoad(job.assetId, *job.load);
+  }
+}
 
-      float tangent[4] = {1.0f, 0.0f, 0.0f, 1.0f};
-      if (tangentAccessor && i < tangentAccessor->count) {
-        cgltf_accessor_read_float(tangentAccessor, i, tangent, 4);
-        loadedTangents = true;
-      }
-      if (hasNormalMatrix) {
-        float transformed[3];
-        TransformNormal(normalMatrix, tangent, transformed);
-        tangent[0] = transformed[0];
-        tangent[1] = transformed[1];
-        tangent[2] = transformed[2];
-      }
-      const float defaultTangent[3] = {1.0f, 0.0f, 0.0f};
-      NormalizeVector(tangent, defaultTangent);
-      mesh.tangents.push_back({tangent[0], tangent[1], tangent[2], tangent[3]});
+AssetRegistry::~AssetRegistry() {
+  std::deque<LoadJob> cancelled;
+  {
+    std::lock_guard<std::mutex> lock(m_loadQueueMutex);
+    m_stopLoading = true;
+    cancelled.swap(m_loadQueue);
+  }
+  m_loadQueueWake.notify_all();
+  for (auto &thread : m_loadThreads) {
+    if (thread.joinable()) {
+      thread.join();
     }
+  }
+  // Waiters get null; callbacks are dropped since their owners may already
+  // be gone.
+  for (auto &job : cancelled) {
+    job.load->promise.set_value(nullptr);
+  }
+}
 
-    if (primitive.indices) {
-      mesh.indices.reserve(mesh.indices.size() + primitive.indices->count);
-      for (cgltf_size i = 0; i < primitive.indices->count; ++i) {
-        const cgltf_size idx = cgltf_accessor_read_index(primitive.indices, i);
-        mesh.indices.push_back(static_cast<std::uint32_t>(baseVertex + idx));
-      }
-    } else {
-      mesh.indices.reserve(mesh.indices.size() + positionAccessor->count);
-      for (cgltf_size i = 0; i < positionAccessor->count; ++i) {
-        mesh.indices.push_back(static_cast<std::uint32_t>(baseVertex + i));
+bool AssetRegistry::ImportMeshData(const std::string &assetId,
+                                   MeshData &out) {
+  const std::filesystem::path sourcePath = ResolveMeshSource(assetId);
+  if (sourcePath.empty()) {
+    return false;
+  }
+
+  const auto settings = GetMeshImportSettings(assetId);
+  const auto fileSystem = GetSnapshot()->fileSystem;
+
+  // A cooked container, found by the hash of the source bytes, replaces
+  // parsing and all of the post-processing below with one copy per stream.
+  const std::uint64_t settingsHash = HashMeshImportSettings(settings);
+  DerivedDataCache::Key cookedKey{};
+  const bool cacheable = GetCookedMeshKey(sourcePath, settingsHash, cookedKey);
+  if (cacheable) {
+    std::filesystem::path cookedPath;
+    if (m_derivedData.Find(cookedKey, cookedPath)) {
+      CookedMeshFile cooked;
+      if (cooked.Open(cookedPath, std::filesystem::path(), settingsHash)) {
+        CopyCookedMesh(cooked.GetView(), out);
+        return true;
       }
+      // Truncated, corrupt, or written by an older container version.
+      m_derivedData.Remove(cookedKey);
     }
-  };
+  }
 
-  auto appendMesh = [&](const cgltf_mesh *srcMesh, const cgltf_float *matrix) {
-    if (!srcMesh) {
-      return;
-    }
-    for (cgltf_size primIndex = 0; primIndex < srcMesh->primitives_count;
-         ++primIndex) {
-      appendPrimitive(srcMesh->primitives[primIndex], matrix);
+  auto store = [&](MeshData &&mesh) {
+    // A failed write only costs a re-import next time.
+    if (cacheable && WriteCookedMesh(m_derivedData.GetEntryPath(cookedKey),
+                                     sourcePath, settingsHash, mesh)) {
+      m_derivedData.Commit(cookedKey);
     }
+    out = std::move(mesh);
+    return true;
   };
 
-  auto traverseNode = [&](const cgltf_node *node, auto &&self) -> void {
-    if (!node) {
-      return;
+  const std::string extension =
+      Aetherion::Core::String::ToLower(sourcePath.extension().string());
+  if (extension == ".obj") {
+    MeshData mesh{};
+    if (!LoadObjMesh(sourcePath, settings, mesh, fileSystem.get())) {
+      return false;
     }
+    mesh.compressedVertices = settings.compressVertices;
+    return store(std::move(mesh));
+  }
 
-    cgltf_float matrix[16];
-    cgltf_node_transform_world(node, matrix);
-    appendMesh(node->mesh, matrix);
-
-    for (cgltf_size i = 0; i < node->children_count; ++i) {
-      self(node->children[i], self);
-    }
-  };
+  if (extension != ".gltf" && extension != ".glb") {
+    return false;
+  }
 
-  bool usedNodes = false;
-  if (data->scene && data->scene->nodes_count > 0) {
-    usedNodes = true;
-    for (cgltf_size i = 0; i < data->scene->nodes_count; ++i) {
-      traverseNode(data->scene->nodes[i], traverseNode);
-    }
-  } else if (data->nodes_count > 0) {
-    usedNodes = true;
-    for (cgltf_size i = 0; i < data->nodes_count; ++i) {
-      traverseNode(&data->nodes[i], traverseNode);
+  cgltf_options options{};
+  UseFileSystem(options, fileSystem.get());
+  cgltf_data *data = nullptr;
+  cgltf_result result =
+      cgltf_parse_file(&options, sourcePath.string().c_str(), &data);
+  if (result != cgltf_result_success || !data) {
+    if (data) {
+      cgltf_free(data);
     }
+    return false;
   }
 
-  if (!usedNodes) {
-    for (cgltf_size meshIndex = 0; meshIndex < data->meshes_count;
-         ++meshIndex) {
-      appendMesh(&data->meshes[meshIndex], nullptr);
-    }
+  result = cgltf_load_buffers(&options, data, sourcePath.string().c_str());
+  if (result != cgltf_result_success) {
+    cgltf_free(data);
+    return false;
   }
 
+  MeshData mesh{};
+  bool loadedNormals = false;
+  bool loadedTangents = false;
+  ReadGltfGeometry(*data, mesh, loadedNormals, loadedTangents);
   cgltf_free(data);
 
   ApplyMeshImportSettings(mesh, settings);
@@ -1674,7 +3063,7 @@ AssetRegistry::LoadMeshData(const std::string &assetId) {
   const bool recomputeTangents =
       settings.generateTangents || settings.flipUVs || !loadedTangents;
   if (!SanitizeMeshData(mesh, recomputeNormals, recomputeTangents)) {
-    return nullptr;
+    return false;
   }
 
   if (settings.optimize) {
@@ -1685,10 +3074,8 @@ AssetRegistry::LoadMeshData(const std::string &assetId) {
   if (settings.optimize || settings.centerMesh) {
     ComputeMeshBounds(mesh);
   }
-
-  auto &stored = m_meshData[assetId];
-  stored = std::move(mesh);
-  return &stored;
+  mesh.compressedVertices = settings.compressVertices;
+  return store(std::move(mesh));
 }
 
 AssetRegistry::GltfImportResult
@@ -1696,7 +3083,9 @@ AssetRegistry::ImportGltf(const std::string &gltfPath, bool forceReimport) {
   GltfImportResult result{};
 
   std::filesystem::path source(gltfPath);
-  if (!std::filesystem::exists(source)) {
+  std::error_code ec;
+  const bool onDisk = std::filesystem::exists(source, ec);
+  if (!onDisk && !(m_fileSystem && m_fileSystem->Exists(source))) {
     result.message = "GLTF file not found";
     return result;
   }
@@ -1706,7 +3095,17 @@ AssetRegistry::ImportGltf(const std::string &gltfPath, bool forceReimport) {
       m_rootPath.empty() ? source.parent_path() : m_rootPath;
 
   std::string meshId;
-  EnsureMetadataForAsset(source, root, AssetType::Mesh, meshId);
+  if (onDisk) {
+    EnsureMetadataForAsset(source, root, AssetType::Mesh, meshId);
+  } else if (auto it = m_pathToId.find(MakePathKey(source, m_rootPath));
+             it != m_pathToId.end()) {
+    // Packed, so there is no sidecar to read or write; the scan took the id
+    // from the archive.
+    meshId = it->second;
+  } else {
+    result.message = "GLTF file is not a scanned asset";
+    return result;
+  }
 
   if (!forceReimport) {
     if (auto cached = m_meshes.find(meshId); cached != m_meshes.end()) {
@@ -1719,23 +3118,47 @@ AssetRegistry::ImportGltf(const std::string &gltfPath, bool forceReimport) {
     }
   }
 
-  cgltf_options options{};
-  cgltf_data *data = nullptr;
-  cgltf_result parseResult =
-      cgltf_parse_file(&options, source.string().c_str(), &data);
-  if (parseResult != cgltf_result_success || !data) {
-    if (data) {
+  // An earlier session's import of the same bytes skips parsing the file and
+  // loading its buffers. A forced reimport always parses.
+  GltfImportRecord record{};
+  DerivedDataCache::Key recordKey{};
+  std::uint64_t contentHash = 0;
+  const bool cacheable = m_derivedData.IsOpen() &&
+                         HashAssetSource(source, contentHash);
+  if (cacheable) {
+    recordKey = DerivedDataCache::MakeKey(kGltfImportKind, contentHash,
+                                          kGltfImportVersion);
+  }
+  std::vector<std::uint8_t> recordData;
+  if (forceReimport || !cacheable ||
+      !m_derivedData.Load(recordKey, recordData) ||
+      !DeserializeGltfImportRecord(recordData, record)) {
+    cgltf_options options{};
+    UseFileSystem(options, m_fileSystem.get());
+    cgltf_data *data = nullptr;
+    cgltf_result parseResult =
+        cgltf_parse_file(&options, source.string().c_str(), &data);
+    if (parseResult != cgltf_result_success || !data) {
+      if (data) {
+        cgltf_free(data);
+      }
+      result.message = "Unable to parse GLTF";
+      return result;
+    }
+
+    parseResult = cgltf_load_buffers(&options, data, source.string().c_str());
+    if (parseResult != cgltf_result_success) {
       cgltf_free(data);
+      result.message = "Unable to load GLTF buffers";
+      return result;
     }
-    result.message = "Unable to parse GLTF";
-    return result;
-  }
 
-  parseResult = cgltf_load_buffers(&options, data, source.string().c_str());
-  if (parseResult != cgltf_result_success) {
+    record = {};
+    ReadGltfImportRecord(*data, record);
     cgltf_free(data);
-    result.message = "Unable to load GLTF buffers";
-    return result;
+    if (cacheable) {
+      m_derivedData.Store(recordKey, SerializeGltfImportRecord(record));
+    }
   }
 
   CachedMesh mesh{};
@@ -1743,66 +3166,91 @@ AssetRegistry::ImportGltf(const std::string &gltfPath, bool forceReimport) {
   mesh.source = source;
   std::unordered_set<std::string> uniqueTextures;
 
+  // Sidecars and cooks of the referenced images do not depend on each
+  // other; CAD exports reference hundreds, so they run on several threads.
+  // The registry's maps are only filled in afterwards, on this thread.
+  constexpr std::size_t kNoImage = std::numeric_limits<std::size_t>::max();
+  std::vector<GltfImage> images;
+  std::vector<std::size_t> imageSlots(record.imageUris.size(), kNoImage);
+  std::unordered_map<std::string, std::size_t> slotByPath;
+  for (std::size_t i = 0; i < record.imageUris.size(); ++i) {
+    if (record.imageUris[i].empty()) {
+      continue;
+    }
+    std::filesystem::path texPath = source.parent_path() / record.imageUris[i];
+    const auto [slot, added] =
+        slotByPath.emplace(texPath.string(), images.size());
+    if (added) {
+      images.push_back({std::move(texPath), {}});
+    }
+    imageSlots[i] = slot->second;
+  }
+
+  DerivedDataCache *textureCache =
+      m_derivedData.IsOpen() ? &m_derivedData : nullptr;
+  const std::size_t imageThreads = std::min<std::size_t>(
+      {images.size(), std::max(1u, std::thread::hardware_concurrency()),
+       kMaxScanThreads});
+  std::atomic<std::size_t> nextImage{0};
+  RunWorkers(std::max<std::size_t>(imageThreads, 1), [&]() {
+    for (std::size_t i = nextImage.fetch_add(1, std::memory_order_relaxed);
+         i < images.size();
+         i = nextImage.fetch_add(1, std::memory_order_relaxed)) {
+      std::error_code ec;
+      if (!std::filesystem::exists(images[i].path, ec)) {
+        continue;
+      }
+      EnsureMetadataForAsset(images[i].path, root, AssetType::Texture,
+                             images[i].id);
+      if (textureCache) {
+        PrecookTexture(images[i].path, *textureCache);
+      }
+    }
+  });
+
   std::vector<std::string> imageIds;
-  imageIds.reserve(data->images_count);
-  for (cgltf_size i = 0; i < data->images_count; ++i) {
-    const cgltf_image &image = data->images[i];
+  imageIds.reserve(record.imageUris.size());
+  for (std::size_t slot : imageSlots) {
     std::string texId;
-
-    if (image.uri && image.uri[0] != '\0') {
-      std::filesystem::path texPath = source.parent_path() / image.uri;
-      if (std::filesystem::exists(texPath)) {
-        EnsureMetadataForAsset(texPath, root, AssetType::Texture, texId);
-        if (!texId.empty()) {
-          CachedTexture tex{};
-          tex.id = texId;
-          tex.path = texPath;
-          m_textures[texId] = tex;
-          if (uniqueTextures.emplace(texId).second) {
-            mesh.textureIds.push_back(texId);
-          }
-        }
+    if (slot != kNoImage && !images[slot].id.empty()) {
+      texId = images[slot].id;
+      CachedTexture tex{};
+      tex.id = texId;
+      tex.path = images[slot].path;
+      m_textures[texId] = tex;
+      if (uniqueTextures.emplace(texId).second) {
+        mesh.textureIds.push_back(texId);
       }
     }
     imageIds.push_back(texId);
   }
 
   std::vector<std::string> textureToImageId;
-  textureToImageId.reserve(data->textures_count);
-  for (cgltf_size i = 0; i < data->textures_count; ++i) {
-    const cgltf_texture &tex = data->textures[i];
+  textureToImageId.reserve(record.textureImages.size());
+  for (std::int32_t imageIndex : record.textureImages) {
     std::string imageId;
-    if (tex.image) {
-      const cgltf_size imageIndex =
-          static_cast<cgltf_size>(tex.image - data->images);
-      if (imageIndex < imageIds.size()) {
-        imageId = imageIds[imageIndex];
-      }
+    if (imageIndex >= 0 &&
+        static_cast<std::size_t>(imageIndex) < imageIds.size()) {
+      imageId = imageIds[static_cast<std::size_t>(imageIndex)];
     }
     textureToImageId.push_back(imageId);
   }
 
-  for (cgltf_size i = 0; i < data->materials_count; ++i) {
-    const cgltf_material &material = data->materials[i];
+  for (std::size_t i = 0; i < record.materials.size(); ++i) {
+    const GltfImportRecord::Material &material = record.materials[i];
     std::string matId = meshId + ":mat:" + std::to_string(i);
 
     CachedMaterial cached{};
     cached.id = matId;
-    cached.name = material.name ? material.name : std::string();
-
-    if (material.has_pbr_metallic_roughness) {
-      const auto &pbr = material.pbr_metallic_roughness;
-      cached.baseColor = {pbr.base_color_factor[0], pbr.base_color_factor[1],
-                          pbr.base_color_factor[2], pbr.base_color_factor[3]};
-      cached.metallic = pbr.metallic_factor;
-      cached.roughness = pbr.roughness_factor;
-      if (pbr.base_color_texture.texture) {
-        const cgltf_size texIndex = static_cast<cgltf_size>(
-            pbr.base_color_texture.texture - data->textures);
-        if (texIndex < textureToImageId.size()) {
-          cached.albedoTextureId = textureToImageId[texIndex];
-        }
-      }
+    cached.name = material.name;
+    cached.baseColor = material.baseColor;
+    cached.metallic = material.metallic;
+    cached.roughness = material.roughness;
+    if (material.albedoTexture >= 0 &&
+        static_cast<std::size_t>(material.albedoTexture) <
+            textureToImageId.size()) {
+      cached.albedoTextureId =
+          textureToImageId[static_cast<std::size_t>(material.albedoTexture)];
     }
 
     m_materials[matId] = cached;
@@ -1815,8 +3263,6 @@ AssetRegistry::ImportGltf(const std::string &gltfPath, bool forceReimport) {
     }
   }
 
-  cgltf_free(data);
-
   m_meshes[meshId] = mesh;
 
   result.success = true;
@@ -1860,16 +3306,19 @@ AssetRegistry::GetMeshImportSettings(const std::string &assetId) const {
     return settings;
   }
 
-  const AssetEntry *entry = FindEntry(assetId);
+  const auto snapshot = GetSnapshot();
+  const AssetEntry *entry = snapshot->Find(assetId);
   std::filesystem::path assetPath;
   AssetType type = AssetType::Other;
   if (entry) {
     assetPath = entry->path;
     type = entry->type;
   } else {
-    assetPath = std::filesystem::path(assetId);
-    if (!assetPath.is_absolute() && !m_rootPath.empty()) {
-      assetPath = m_rootPath / assetPath;
+    if (!FindPackedAsset(snapshot->fileSystem.get(), assetId, assetPath)) {
+      assetPath = std::filesystem::path(assetId);
+      if (!assetPath.is_absolute() && !snapshot->rootPath.empty()) {
+        assetPath = snapshot->rootPath / assetPath;
+      }
     }
     type = ClassifyAssetType(assetPath);
   }
@@ -1880,13 +3329,26 @@ AssetRegistry::GetMeshImportSettings(const std::string &assetId) const {
 
   std::error_code ec;
   const std::filesystem::path metaPath = BuildMetadataPath(assetPath);
-  if (!std::filesystem::exists(metaPath, ec)) {
-    return settings;
-  }
-
   Json root;
-  if (!LoadMetadataJson(metaPath, root)) {
-    return settings;
+  if (std::filesystem::exists(metaPath, ec)) {
+    if (!LoadMetadataJson(metaPath, root)) {
+      return settings;
+    }
+  } else {
+    // Packed assets keep their sidecars in the archive.
+    std::string text;
+    if (!snapshot->fileSystem ||
+        !snapshot->fileSystem->ReadText(metaPath, text)) {
+      return settings;
+    }
+    try {
+      root = Json::parse(text);
+    } catch (const std::exception &) {
+      return settings;
+    }
+    if (!root.is_object()) {
+      return settings;
+    }
   }
 
   return ReadMeshImportSettingsFromJson(root);
@@ -1986,7 +3448,19 @@ bool AssetRegistry::ReimportMeshAsset(const std::string &assetId,
   }
 
   if (success) {
-    m_meshData.erase(entry->id);
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_meshDataMutex);
+      EraseMeshData(entry->id);
+      m_meshBounds.erase(entry->id);
+      ++m_meshDataGeneration;
+    }
+    // The next load imports afresh and cooks again.
+    DerivedDataCache::Key cookedKey{};
+    if (GetCookedMeshKey(sourcePath,
+                         HashMeshImportSettings(GetMeshImportSettings(assetId)),
+                         cookedKey)) {
+      m_derivedData.Remove(cookedKey);
+    }
 
     AssetChange change{};
     change.id = entry->id;
@@ -0,0 +1,362 @@
+#include "Aetherion/Assets/AssetWatcher.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <system_error>
+#include <utility>
+
+#ifdef __linux__
+#include <cerrno>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+using namespace Aetherion::Assets;
+
+constexpr auto kDirectoryOptions =
+    std::filesystem::directory_options::skip_permission_denied;
+
+#ifdef __linux__
+// One watch per directory; inotify is not recursive. Directories that appear
+// later get their watch when their creation is read, and the files already in
+// them are reported as changed since their own events predate the watch.
+class InotifyBackend final : public IFileWatchBackend {
+public:
+  ~InotifyBackend() override { Stop(); }
+
+  [[nodiscard]] const char *GetName() const override { return "inotify"; }
+
+  bool Start(const std::filesystem::path &root) override {
+    Stop();
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+      return false;
+    }
+    if (!AddTree(root, nullptr) || m_directories.empty()) {
+      Stop();
+      return false;
+    }
+    return true;
+  }
+
+  void Stop() override {
+    if (m_fd >= 0) {
+      close(m_fd);
+      m_fd = -1;
+    }
+    m_directories.clear();
+  }
+
+  void Poll(std::vector<FileEvent> &out) override {
+    if (m_fd < 0) {
+      return;
+    }
+
+    alignas(inotify_event) char buffer[64 * 1024];
+    for (;;) {
+      const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+      if (length <= 0) {
+        // EAGAIN: drained.
+        return;
+      }
+
+      for (ssize_t offset = 0; offset < length;) {
+        const auto *event = reinterpret_cast<const inotify_event *>(
+            buffer + offset);
+        offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        Handle(*event, out);
+      }
+    }
+  }
+
+private:
+  static constexpr uint32_t kMask = IN_CREATE | IN_CLOSE_WRITE | IN_ATTRIB |
+                                    IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                    IN_DELETE_SELF | IN_EXCL_UNLINK;
+
+  bool AddWatch(const std::filesystem::path &directory) {
+    const int wd = inotify_add_watch(m_fd, directory.c_str(), kMask);
+    if (wd < 0) {
+      return false;
+    }
+    m_directories[wd] = directory;
+    return true;
+  }
+
+  // With `out` set, files found below `root` are reported as changed.
+  // Returns false when the per-user watch limit ran out; directories that
+  // vanished meanwhile are simply skipped.
+  bool AddTree(const std::filesystem::path &root, std::vector<FileEvent> *out) {
+    if (!AddWatch(root) && errno == ENOSPC) {
+      return false;
+    }
+
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(
+             root, kDirectoryOptions, ec);
+         it != std::filesystem::recursive_directory_iterator();
+         it.increment(ec)) {
+      if (ec) {
+        ec.clear();
+        continue;
+      }
+      if (it->is_directory(ec)) {
+        if (!AddWatch(it->path()) && errno == ENOSPC) {
+          return false;
+        }
+      } else if (out && it->is_regular_file(ec)) {
+        out->push_back({it->path(), FileEvent::Kind::Changed});
+      }
+    }
+    return true;
+  }
+
+  void RemoveTree(const std::filesystem::path &root) {
+    for (auto it = m_directories.begin(); it != m_directories.end();) {
+      const auto relative = it->second.lexically_relative(root);
+      if (!relative.empty() && *relative.begin() != "..") {
+        inotify_rm_watch(m_fd, it->first);
+        it = m_directories.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  void Handle(const inotify_event &event, std::vector<FileEvent> &out) {
+    if (event.mask & IN_Q_OVERFLOW) {
+      out.push_back({{}, FileEvent::Kind::Overflow});
+      return;
+    }
+    if (event.mask & IN_IGNORED) {
+      m_directories.erase(event.wd);
+      return;
+    }
+
+    const auto dirIt = m_directories.find(event.wd);
+    if (dirIt == m_directories.end()) {
+      return;
+    }
+    if (event.mask & IN_DELETE_SELF) {
+      out.push_back({dirIt->second, FileEvent::Kind::Removed});
+      return;
+    }
+    if (event.len == 0) {
+      return;
+    }
+
+    const std::filesystem::path path = dirIt->second / event.name;
+    if (event.mask & IN_ISDIR) {
+      if (event.mask & (IN_CREATE | IN_MOVED_TO)) {
+        if (!AddTree(path, &out)) {
+          // Part of the tree is unwatched from here on; a rescan at least
+          // picks up what is there now.
+          out.push_back({path, FileEvent::Kind::Overflow});
+        }
+      } else if (event.mask & (IN_DELETE | IN_MOVED_FROM)) {
+        // Watches below a moved directory would keep reporting the old path.
+        RemoveTree(path);
+        out.push_back({path, FileEvent::Kind::Removed});
+      }
+      return;
+    }
+
+    if (event.mask & (IN_DELETE | IN_MOVED_FROM)) {
+      out.push_back({path, FileEvent::Kind::Removed});
+    } else {
+      out.push_back({path, FileEvent::Kind::Changed});
+    }
+  }
+
+  int m_fd{-1};
+  std::unordered_map<int, std::filesystem::path> m_directories;
+};
+#endif
+
+class PollingBackend final : public IFileWatchBackend {
+public:
+  explicit PollingBackend(std::chrono::milliseconds interval)
+      : m_interval(interval) {}
+
+  [[nodiscard]] const char *GetName() const override { return "polling"; }
+
+  bool Start(const std::filesystem::path &root) override {
+    m_root = root;
+    m_files = Walk();
+    m_lastWalk = std::chrono::steady_clock::now();
+    return true;
+  }
+
+  void Stop() override {
+    m_root.clear();
+    m_files.clear();
+  }
+
+  void Poll(std::vector<FileEvent> &out) override {
+    const auto now = std::chrono::steady_clock::now();
+    if (m_root.empty() || now - m_lastWalk < m_interval) {
+      return;
+    }
+    m_lastWalk = now;
+
+    auto files = Walk();
+    for (const auto &[key, state] : files) {
+      const auto previous = m_files.find(key);
+      if (previous == m_files.end() ||
+          previous->second.writeTime != state.writeTime ||
+          previous->second.size != state.size) {
+        out.push_back({state.path, FileEvent::Kind::Changed});
+      }
+    }
+    for (const auto &[key, state] : m_files) {
+      if (files.find(key) == files.end()) {
+        out.push_back({state.path, FileEvent::Kind::Removed});
+      }
+    }
+    m_files = std::move(files);
+  }
+
+private:
+  struct FileState {
+    std::filesystem::path path;
+    std::filesystem::file_time_type writeTime{};
+    std::uintmax_t size{0};
+  };
+
+  [[nodiscard]] std::unordered_map<std::string, FileState> Walk() const {
+    std::unordered_map<std::string, FileState> files;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(
+             m_root, kDirectoryOptions, ec);
+         it != std::filesystem::recursive_directory_iterator();
+         it.increment(ec)) {
+      if (ec) {
+        ec.clear();
+        continue;
+      }
+      if (!it->is_regular_file(ec)) {
+        continue;
+      }
+      FileState state;
+      state.path = it->path();
+      state.writeTime = it->last_write_time(ec);
+      state.size = it->file_size(ec);
+      ec.clear();
+      files.emplace(state.path.generic_string(), std::move(state));
+    }
+    return files;
+  }
+
+  std::chrono::milliseconds m_interval;
+  std::filesystem::path m_root;
+  std::unordered_map<std::string, FileState> m_files;
+  std::chrono::steady_clock::time_point m_lastWalk{};
+};
+} // namespace
+
+namespace Aetherion::Assets {
+std::unique_ptr<IFileWatchBackend> CreateNativeFileWatchBackend() {
+#ifdef __linux__
+  return std::make_unique<InotifyBackend>();
+#else
+  return nullptr;
+#endif
+}
+
+std::unique_ptr<IFileWatchBackend>
+CreatePollingFileWatchBackend(std::chrono::milliseconds interval) {
+  return std::make_unique<PollingBackend>(interval);
+}
+
+AssetWatcher::AssetWatcher() = default;
+
+AssetWatcher::AssetWatcher(const Settings &settings) : m_settings(settings) {}
+
+AssetWatcher::~AssetWatcher() { Stop(); }
+
+bool AssetWatcher::Start(const std::filesystem::path &root) {
+  if (m_settings.allowNative) {
+    if (auto native = CreateNativeFileWatchBackend();
+        native && Start(root, std::move(native))) {
+      return true;
+    }
+  }
+  return Start(root, CreatePollingFileWatchBackend(m_settings.pollInterval));
+}
+
+bool AssetWatcher::Start(const std::filesystem::path &root,
+                         std::unique_ptr<IFileWatchBackend> backend) {
+  Stop();
+  if (!backend || !backend->Start(root)) {
+    return false;
+  }
+  m_root = root;
+  m_backend = std::move(backend);
+  return true;
+}
+
+void AssetWatcher::Stop() {
+  if (m_backend) {
+    m_backend->Stop();
+    m_backend.reset();
+  }
+  m_root.clear();
+  m_events.clear();
+  m_pending.clear();
+  m_overflow = false;
+}
+
+const char *AssetWatcher::GetBackendName() const noexcept {
+  return m_backend ? m_backend->GetName() : "none";
+}
+
+AssetWatcher::Batch AssetWatcher::Poll(Clock::time_point now) {
+  Batch batch;
+  if (!m_backend) {
+    return batch;
+  }
+
+  m_events.clear();
+  m_backend->Poll(m_events);
+  for (auto &event : m_events) {
+    if (m_pending.empty() && !m_overflow) {
+      m_firstEvent = now;
+    }
+    m_lastEvent = now;
+    if (event.kind == FileEvent::Kind::Overflow) {
+      m_overflow = true;
+      continue;
+    }
+    // Removal or change makes no difference here: the registry looks at what
+    // is on disk once the batch is handed out.
+    m_pending.try_emplace(event.path.generic_string(), std::move(event.path));
+  }
+
+  if (m_pending.empty() && !m_overflow) {
+    return batch;
+  }
+
+  // The whole burst is released together so a rename (remove + create) stays
+  // in one batch; a tree that never goes quiet is flushed after maxDelay.
+  const bool quiet = now - m_lastEvent >= m_settings.debounce;
+  const bool overdue = now - m_firstEvent >= m_settings.maxDelay;
+  if (!quiet && !overdue) {
+    return batch;
+  }
+
+  if (m_overflow) {
+    batch.rescanRequired = true;
+  } else {
+    batch.paths.reserve(m_pending.size());
+    for (auto &[key, path] : m_pending) {
+      batch.paths.push_back(std::move(path));
+    }
+    // Stable order for the registry and for logs.
+    std::sort(batch.paths.begin(), batch.paths.end());
+  }
+  m_pending.clear();
+  m_overflow = false;
+  return batch;
+}
+} // namespace Aetherion::Assets
@@ -0,0 +1,634 @@
+#include "Aetherion/Assets/DerivedDataCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+using namespace Aetherion::Assets;
+
+constexpr char kIndexMagic[4] = {'A', 'D', 'D', 'C'};
+constexpr std::uint32_t kIndexVersion = 1;
+constexpr const char *kIndexFileName = "index.bin";
+constexpr std::size_t kHashBlockBytes = std::size_t{1} << 20;
+// Eviction trims below the budget so that the next few stores do not each
+// evict again.
+constexpr std::uint64_t kEvictSlackPercent = 10;
+
+constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+
+std::uint64_t Rotl(std::uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+std::uint64_t Round(std::uint64_t lane, std::uint64_t word) {
+  return Rotl(lane + word * kPrime2, 31) * kPrime1;
+}
+
+std::uint64_t Avalanche(std::uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDull;
+  hash ^= hash >> 33;
+  hash *= 0xC4CEB9FE1A85EC53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+std::uint64_t LoadWord(const unsigned char *bytes) {
+  std::uint64_t word = 0;
+  std::memcpy(&word, bytes, sizeof(word));
+  return word;
+}
+
+// Hashes a stream fed in arbitrary pieces; four independent lanes keep the
+// multiplies from serializing, so large sources hash at memory speed.
+class StreamHasher {
+public:
+  explicit StreamHasher(std::uint64_t seed)
+      : m_lanes{seed + kPrime1 + kPrime2, seed + kPrime2, seed,
+                seed - kPrime1} {}
+
+  void Update(const void *data, std::size_t size) {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    m_length += size;
+    if (m_pending > 0) {
+      const std::size_t take = std::min(size, sizeof(m_buffer) - m_pending);
+      std::memcpy(m_buffer + m_pending, bytes, take);
+      m_pending += take;
+      bytes += take;
+      size -= take;
+      if (m_pending < sizeof(m_buffer)) {
+        return;
+      }
+      Consume(m_buffer);
+      m_pending = 0;
+    }
+    while (size >= sizeof(m_buffer)) {
+      Consume(bytes);
+      bytes += sizeof(m_buffer);
+      size -= sizeof(m_buffer);
+    }
+    std::memcpy(m_buffer, bytes, size);
+    m_pending = size;
+  }
+
+  std::uint64_t Finish() const {
+    std::uint64_t hash = Rotl(m_lanes[0], 1) + Rotl(m_lanes[1], 7) +
+                         Rotl(m_lanes[2], 12) + Rotl(m_lanes[3], 18);
+    hash = (hash ^ m_length) * kPrime1;
+    std::size_t i = 0;
+    for (; i + 8 <= m_pending; i += 8) {
+      hash = Rotl(hash ^ Round(0, LoadWord(m_buffer + i)), 27) * kPrime1;
+    }
+    for (; i < m_pending; ++i) {
+      hash = Rotl(hash ^ (m_buffer[i] * kPrime2), 11) * kPrime1;
+    }
+    return Avalanche(hash);
+  }
+
+private:
+  void Consume(const unsigned char *block) {
+    for (int lane = 0; lane < 4; ++lane) {
+      m_lanes[lane] = Round(m_lanes[lane], LoadWord(block + lane * 8));
+    }
+  }
+
+  std::uint64_t m_lanes[4];
+  unsigned char m_buffer[32] = {};
+  std::size_t m_pending{0};
+  std::uint64_t m_length{0};
+};
+
+template <typename T> void WritePod(std::ostream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> bool ReadPod(std::istream &in, T &value) {
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+void WriteString(std::ostream &out, const std::string &value) {
+  WritePod(out, static_cast<std::uint32_t>(value.size()));
+  out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+bool ReadString(std::istream &in, std::string &value) {
+  std::uint32_t size = 0;
+  if (!ReadPod(in, size) || size > (1u << 16)) {
+    return false;
+  }
+  value.resize(size);
+  return static_cast<bool>(in.read(value.data(), size));
+}
+
+std::string PathKey(const std::filesystem::path &path) {
+  std::error_code ec;
+  auto absolute = std::filesystem::absolute(path, ec);
+  if (ec) {
+    absolute = path;
+  }
+  return absolute.lexically_normal().generic_string();
+}
+} // namespace
+
+namespace Aetherion::Assets {
+DerivedDataCache::~DerivedDataCache() { Close(); }
+
+void DerivedDataCache::Open(const std::filesystem::path &root) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_root.empty()) {
+    SaveIndexLocked();
+  }
+  m_root = root;
+  m_entries.clear();
+  m_sources.clear();
+  m_totalBytes = 0;
+  m_useCounter = 0;
+  m_dirty = false;
+  m_stats = {};
+  if (!m_root.empty()) {
+    LoadIndexLocked();
+  }
+}
+
+void DerivedDataCache::Close() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_root.empty()) {
+    return;
+  }
+  SaveIndexLocked();
+  m_root.clear();
+  m_entries.clear();
+  m_sources.clear();
+  m_totalBytes = 0;
+}
+
+void DerivedDataCache::Flush() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_root.empty()) {
+    SaveIndexLocked();
+  }
+}
+
+bool DerivedDataCache::IsOpen() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return !m_root.empty();
+}
+
+std::filesystem::path DerivedDataCache::GetRoot() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_root;
+}
+
+void DerivedDataCache::SetMaxBytes(std::uint64_t maxBytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_maxBytes = maxBytes;
+  EvictLocked();
+}
+
+bool DerivedDataCache::StatFile(const std::filesystem::path &path,
+                                FileStamp &out) {
+#ifdef _WIN32
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return false;
+  }
+  const auto time = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return false;
+  }
+  out.size = size;
+  out.mtimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    time.time_since_epoch())
+                    .count();
+  out.inode = 0;
+#else
+  struct stat info {};
+  if (::stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+    return false;
+  }
+  out.size = static_cast<std::uint64_t>(info.st_size);
+#ifdef __APPLE__
+  out.mtimeNs =
+      static_cast<std::int64_t>(info.st_mtimespec.tv_sec) * 1000000000 +
+      info.st_mtimespec.tv_nsec;
+#else
+  out.mtimeNs = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 +
+                info.st_mtim.tv_nsec;
+#endif
+  out.inode = static_cast<std::uint64_t>(info.st_ino);
+#endif
+  return true;
+}
+
+bool DerivedDataCache::HashFile(const std::filesystem::path &path,
+                                std::uint64_t &hash,
+                                std::uint64_t &bytesRead) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) {
+    return false;
+  }
+  StreamHasher hasher(hash);
+  std::vector<char> block(kHashBlockBytes);
+  while (in) {
+    in.read(block.data(), static_cast<std::streamsize>(block.size()));
+    const auto count = static_cast<std::size_t>(in.gcount());
+    hasher.Update(block.data(), count);
+    bytesRead += count;
+  }
+  if (in.bad()) {
+    return false;
+  }
+  hash = hasher.Finish();
+  return true;
+}
+
+bool DerivedDataCache::HashSource(const std::filesystem::path &source,
+                                  std::uint64_t &outHash,
+                                  const DependencyLister &dependencies) {
+  const std::string key = PathKey(source);
+  FileStamp stamp{};
+  if (!StatFile(source, stamp)) {
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_sources.find(key);
+    if (it != m_sources.end() && it->second.stamp == stamp) {
+      bool current = true;
+      for (const auto &dependency : it->second.dependencies) {
+        FileStamp dependencyStamp{};
+        if (!StatFile(dependency.path, dependencyStamp) ||
+            !(dependencyStamp == dependency.stamp)) {
+          current = false;
+          break;
+        }
+      }
+      if (current) {
+        outHash = it->second.hash;
+        return true;
+      }
+    }
+  }
+
+  // Hashed without holding the lock; two threads hashing the same source
+  // just store the same result twice.
+  SourceHash computed{};
+  computed.stamp = stamp;
+  std::uint64_t hash = 0;
+  std::uint64_t bytesRead = 0;
+  if (!HashFile(source, hash, bytesRead)) {
+    return false;
+  }
+  if (dependencies) {
+    for (const auto &dependency : dependencies(source)) {
+      Dependency recorded{};
+      recorded.path = PathKey(dependency);
+      if (!StatFile(dependency, recorded.stamp) ||
+          !HashFile(dependency, hash, bytesRead)) {
+        return false;
+      }
+      computed.dependencies.push_back(std::move(recorded));
+    }
+  }
+  // The stamp is taken before reading, so a write racing the hash leaves a
+  // stale stamp behind and the source is simply hashed again next time.
+  computed.hash = hash;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_stats.sourcesHashed;
+  m_stats.bytesHashed += bytesRead;
+  if (!m_root.empty()) {
+    m_sources[key] = std::move(computed);
+    m_dirty = true;
+  }
+  outHash = hash;
+  return true;
+}
+
+DerivedDataCache::Key DerivedDataCache::MakeKey(std::string_view kind,
+                                                std::uint64_t contentHash,
+                                                std::uint64_t settingsHash) {
+  const std::uint64_t words[2] = {contentHash, settingsHash};
+  Key key{};
+  key.kind = std::string(kind);
+  key.hash = HashBytes(words, sizeof(words),
+                       HashBytes(kind.data(), kind.size()));
+  return key;
+}
+
+std::uint64_t DerivedDataCache::HashBytes(const void *data, std::size_t size,
+                                          std::uint64_t seed) noexcept {
+  StreamHasher hasher(seed);
+  hasher.Update(data, size);
+  return hasher.Finish();
+}
+
+std::filesystem::path
+DerivedDataCache::MakeTempPath(const std::filesystem::path &path) {
+  static std::atomic<std::uint64_t> counter{0};
+#ifdef _WIN32
+  const auto process = static_cast<unsigned long long>(_getpid());
+#else
+  const auto process = static_cast<unsigned long long>(getpid());
+#endif
+  const auto thread = static_cast<unsigned long long>(
+      std::hash<std::thread::id>{}(std::this_thread::get_id()));
+  char suffix[80];
+  std::snprintf(suffix, sizeof(suffix), ".%llx.%llx.%llx.tmp", process,
+                thread,
+                static_cast<unsigned long long>(
+                    counter.fetch_add(1, std::memory_order_relaxed)));
+  auto tmpPath = path;
+  tmpPath += suffix;
+  return tmpPath;
+}
+
+std::filesystem::path DerivedDataCache::GetEntryPath(const Key &key) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return GetEntryPathLocked(key);
+}
+
+std::filesystem::path
+DerivedDataCache::GetEntryPathLocked(const Key &key) const {
+  if (m_root.empty()) {
+    return {};
+  }
+  // 256 subdirectories keep any one directory small for large projects.
+  char name[17] = {};
+  std::snprintf(name, sizeof(name), "%016llx",
+                static_cast<unsigned long long>(key.hash));
+  return m_root / std::string(name, 2) / (std::string(name) + "." + key.kind);
+}
+
+bool DerivedDataCache::Find(const Key &key, std::filesystem::path &outPath) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto it = m_entries.find(key.hash);
+  if (it == m_entries.end()) {
+    ++m_stats.misses;
+    return false;
+  }
+  outPath = GetEntryPathLocked(key);
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(outPath, ec)) {
+    // Deleted behind the cache's back.
+    m_totalBytes -= it->second.size;
+    m_entries.erase(it);
+    m_dirty = true;
+    ++m_stats.misses;
+    return false;
+  }
+  it->second.lastUse = ++m_useCounter;
+  m_dirty = true;
+  ++m_stats.hits;
+  return true;
+}
+
+void DerivedDataCache::Commit(const Key &key) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_root.empty()) {
+    return;
+  }
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(GetEntryPathLocked(key), ec);
+  if (ec) {
+    return;
+  }
+  auto &entry = m_entries[key.hash];
+  m_totalBytes -= entry.size;
+  entry.kind = key.kind;
+  entry.size = size;
+  entry.lastUse = ++m_useCounter;
+  m_totalBytes += size;
+  m_dirty = true;
+  ++m_stats.stores;
+  EvictLocked();
+}
+
+void DerivedDataCache::Remove(const Key &key) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_root.empty()) {
+    return;
+  }
+  std::error_code ec;
+  std::filesystem::remove(GetEntryPathLocked(key), ec);
+  const auto it = m_entries.find(key.hash);
+  if (it != m_entries.end()) {
+    m_totalBytes -= it->second.size;
+    m_entries.erase(it);
+    m_dirty = true;
+  }
+}
+
+bool DerivedDataCache::Load(const Key &key, std::vector<std::uint8_t> &out) {
+  std::filesystem::path path;
+  if (!Find(key, path)) {
+    return false;
+  }
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in.is_open()) {
+    return false;
+  }
+  out.resize(static_cast<std::size_t>(in.tellg()));
+  in.seekg(0);
+  return static_cast<bool>(in.read(reinterpret_cast<char *>(out.data()),
+                                   static_cast<std::streamsize>(out.size())));
+}
+
+bool DerivedDataCache::Store(const Key &key,
+                             const std::vector<std::uint8_t> &data) {
+  const auto path = GetEntryPath(key);
+  if (path.empty()) {
+    return false;
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  const auto tmpPath = MakeTempPath(path);
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      return false;
+    }
+    out.write(reinterpret_cast<const char *>(data.data()),
+              static_cast<std::streamsize>(data.size()));
+    if (!out.good()) {
+      out.close();
+      std::filesystem::remove(tmpPath, ec);
+      return false;
+    }
+  }
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec) {
+    std::filesystem::remove(tmpPath, ec);
+    return false;
+  }
+  Commit(key);
+  return true;
+}
+
+DerivedDataCache::Stats DerivedDataCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Stats stats = m_stats;
+  stats.entries = m_entries.size();
+  stats.bytes = m_totalBytes;
+  return stats;
+}
+
+void DerivedDataCache::EvictLocked() {
+  if (m_maxBytes == 0 || m_totalBytes <= m_maxBytes) {
+    return;
+  }
+  const std::uint64_t target =
+      m_maxBytes - m_maxBytes / 100 * kEvictSlackPercent;
+
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> byAge;
+  byAge.reserve(m_entries.size());
+  for (const auto &[hash, entry] : m_entries) {
+    byAge.emplace_back(entry.lastUse, hash);
+  }
+  std::sort(byAge.begin(), byAge.end());
+
+  for (const auto &[lastUse, hash] : byAge) {
+    if (m_totalBytes <= target) {
+      break;
+    }
+    const auto it = m_entries.find(hash);
+    // A file still mapped by a reader may refuse to go on Windows; it is
+    // forgotten anyway and overwritten when the key is stored again.
+    std::error_code ec;
+    std::filesystem::remove(GetEntryPathLocked({it->second.kind, hash}), ec);
+    m_totalBytes -= it->second.size;
+    m_entries.erase(it);
+    ++m_stats.evictions;
+  }
+  m_dirty = true;
+}
+
+void DerivedDataCache::LoadIndexLocked() {
+  std::ifstream in(m_root / kIndexFileName, std::ios::binary);
+  if (!in.is_open()) {
+    return;
+  }
+
+  char magic[4] = {};
+  std::uint32_t version = 0;
+  std::uint64_t useCounter = 0;
+  std::uint64_t entryCount = 0;
+  if (!in.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kIndexMagic, sizeof(magic)) != 0 ||
+      !ReadPod(in, version) || version != kIndexVersion ||
+      !ReadPod(in, useCounter) || !ReadPod(in, entryCount)) {
+    return;
+  }
+
+  // A truncated or corrupt index is dropped as a whole; entries on disk are
+  // then rewritten as they are needed.
+  std::unordered_map<std::uint64_t, Entry> entries;
+  std::uint64_t totalBytes = 0;
+  for (std::uint64_t i = 0; i < entryCount; ++i) {
+    std::uint64_t hash = 0;
+    Entry entry{};
+    if (!ReadPod(in, hash) || !ReadString(in, entry.kind) ||
+        !ReadPod(in, entry.size) || !ReadPod(in, entry.lastUse)) {
+      return;
+    }
+    totalBytes += entry.size;
+    entries.emplace(hash, std::move(entry));
+  }
+
+  std::uint64_t sourceCount = 0;
+  if (!ReadPod(in, sourceCount)) {
+    return;
+  }
+  std::unordered_map<std::string, SourceHash> sources;
+  sources.reserve(static_cast<std::size_t>(
+      std::min<std::uint64_t>(sourceCount, 1u << 20)));
+  for (std::uint64_t i = 0; i < sourceCount; ++i) {
+    std::string path;
+    SourceHash source{};
+    std::uint32_t dependencyCount = 0;
+    if (!ReadString(in, path) || !ReadPod(in, source.stamp) ||
+        !ReadPod(in, source.hash) || !ReadPod(in, dependencyCount) ||
+        dependencyCount > 4096) {
+      return;
+    }
+    source.dependencies.resize(dependencyCount);
+    for (auto &dependency : source.dependencies) {
+      if (!ReadString(in, dependency.path) ||
+          !ReadPod(in, dependency.stamp)) {
+        return;
+      }
+    }
+    sources.emplace(std::move(path), std::move(source));
+  }
+
+  m_entries = std::move(entries);
+  m_sources = std::move(sources);
+  m_totalBytes = totalBytes;
+  m_useCounter = useCounter;
+}
+
+void DerivedDataCache::SaveIndexLocked() {
+  if (!m_dirty) {
+    return;
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(m_root, ec);
+  const auto path = m_root / kIndexFileName;
+  const auto tmpPath = MakeTempPath(path);
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      return;
+    }
+    out.write(kIndexMagic, sizeof(kIndexMagic));
+    WritePod(out, kIndexVersion);
+    WritePod(out, m_useCounter);
+    WritePod(out, static_cast<std::uint64_t>(m_entries.size()));
+    for (const auto &[hash, entry] : m_entries) {
+      WritePod(out, hash);
+      WriteString(out, entry.kind);
+      WritePod(out, entry.size);
+      WritePod(out, entry.lastUse);
+    }
+    WritePod(out, static_cast<std::uint64_t>(m_sources.size()));
+    for (const auto &[sourcePath, source] : m_sources) {
+      WriteString(out, sourcePath);
+      WritePod(out, source.stamp);
+      WritePod(out, source.hash);
+      WritePod(out, static_cast<std::uint32_t>(source.dependencies.size()));
+      for (const auto &dependency : source.dependencies) {
+        WriteString(out, dependency.path);
+        WritePod(out, dependency.stamp);
+      }
+    }
+    if (!out.good()) {
+      out.close();
+      std::filesystem::remove(tmpPath, ec);
+      return;
+    }
+  }
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec) {
+    std::filesystem::remove(tmpPath, ec);
+    return;
+  }
+  m_dirty = false;
+}
+} // namespace Aetherion::Assets
@@ -0,0 +1,415 @@
+#include "Aetherion/Assets/MeshCooker.h"
+
+#include "Aetherion/Assets/DerivedDataCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+using namespace Aetherion::Assets;
+
+constexpr char kCookedMagic[4] = {'A', 'M', 'S', 'H'};
+constexpr std::uint32_t kCookedVersion = 1;
+// Bumped when the importers change what they produce for the same source
+// and settings, so older cooks are redone.
+constexpr std::uint64_t kImporterVersion = 1;
+constexpr std::uint64_t kStreamAlignment = 16;
+
+enum Stream : std::uint32_t {
+  kPositions,
+  kNormals,
+  kColors,
+  kUvs,
+  kTangents,
+  kIndices,
+  kLods,
+  kStreamCount
+};
+
+constexpr std::uint32_t kFlagCompressedVertices = 1u << 0;
+
+struct Section {
+  std::uint64_t offset{0};
+  std::uint64_t count{0};
+};
+
+// Written as is; the container is only read back on the machine (and
+// byte order) that cooked it.
+struct FileHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint64_t sourceSize;
+  std::int64_t sourceTime;
+  std::uint64_t settingsHash;
+  std::uint32_t flags;
+  float boundsRadius;
+  float boundsMin[3];
+  float boundsMax[3];
+  float boundsCenter[3];
+  std::uint32_t reserved;
+  Section sections[kStreamCount];
+};
+static_assert(sizeof(FileHeader) % kStreamAlignment == 0);
+
+constexpr std::size_t kElementSize[kStreamCount] = {
+    sizeof(std::array<float, 3>), sizeof(std::array<float, 3>),
+    sizeof(std::array<float, 4>), sizeof(std::array<float, 2>),
+    sizeof(std::array<float, 4>), sizeof(std::uint32_t),
+    sizeof(CookedMeshLod)};
+// The spans reinterpret the mapped bytes as these types.
+static_assert(sizeof(std::array<float, 3>) == 12 &&
+              sizeof(std::array<float, 4>) == 16 &&
+              sizeof(std::array<float, 2>) == 8);
+static_assert(sizeof(CookedMeshLod) == 16);
+
+struct SourceStamp {
+  std::uint64_t size{0};
+  std::int64_t time{0};
+};
+
+bool GetSourceStamp(const std::filesystem::path &source, SourceStamp &out) {
+  std::error_code ec;
+  out.size = std::filesystem::file_size(source, ec);
+  if (ec) {
+    return false;
+  }
+  const auto time = std::filesystem::last_write_time(source, ec);
+  if (ec) {
+    return false;
+  }
+  out.time = static_cast<std::int64_t>(time.time_since_epoch().count());
+  return true;
+}
+
+std::uint64_t HashBytes(std::uint64_t hash, const void *data,
+                        std::size_t size) {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+template <typename T> std::uint64_t HashValue(std::uint64_t hash, T value) {
+  return HashBytes(hash, &value, sizeof(value));
+}
+
+std::uint64_t AlignUp(std::uint64_t value) {
+  return (value + kStreamAlignment - 1) & ~(kStreamAlignment - 1);
+}
+
+template <typename T>
+std::span<const T> StreamSpan(const std::uint8_t *base,
+                              const Section &section) {
+  return {reinterpret_cast<const T *>(base + section.offset),
+          static_cast<std::size_t>(section.count)};
+}
+
+template <typename T>
+void WriteStream(std::ofstream &out, std::uint64_t &written,
+                 const Section &section, const T *data) {
+  static const char kPadding[kStreamAlignment] = {};
+  if (written < section.offset) {
+    out.write(kPadding, static_cast<std::streamsize>(section.offset - written));
+  }
+  const std::uint64_t bytes = section.count * sizeof(T);
+  out.write(reinterpret_cast<const char *>(data),
+            static_cast<std::streamsize>(bytes));
+  written = section.offset + bytes;
+}
+} // namespace
+
+namespace Aetherion::Assets {
+MappedFile::~MappedFile() { Close(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)),
+      m_size(std::exchange(other.m_size, 0))
+#ifdef _WIN32
+      ,
+      m_mapping(std::exchange(other.m_mapping, nullptr))
+#endif
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    Close();
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+    m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+  }
+  return *this;
+}
+
+bool MappedFile::Open(const std::filesystem::path &path) {
+  Close();
+#ifdef _WIN32
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER size{};
+  if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+    CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping =
+      CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  // The mapping keeps the file open.
+  CloseHandle(file);
+  if (!mapping) {
+    return false;
+  }
+  void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!view) {
+    CloseHandle(mapping);
+    return false;
+  }
+  m_mapping = mapping;
+  m_data = static_cast<const std::uint8_t *>(view);
+  m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info {};
+  if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+  void *view = mmap(nullptr, static_cast<std::size_t>(info.st_size),
+                    PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps the file open.
+  close(fd);
+  if (view == MAP_FAILED) {
+    return false;
+  }
+  m_data = static_cast<const std::uint8_t *>(view);
+  m_size = static_cast<std::size_t>(info.st_size);
+#endif
+  return true;
+}
+
+void MappedFile::Close() noexcept {
+  if (!m_data) {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(m_data);
+  CloseHandle(m_mapping);
+  m_mapping = nullptr;
+#else
+  munmap(const_cast<std::uint8_t *>(m_data), m_size);
+#endif
+  m_data = nullptr;
+  m_size = 0;
+}
+
+bool CookedMeshFile::Open(const std::filesystem::path &path,
+                          const std::filesystem::path &source,
+                          std::uint64_t settingsHash) {
+  Close();
+  MappedFile file;
+  if (!file.Open(path) || file.GetSize() < sizeof(FileHeader)) {
+    return false;
+  }
+
+  FileHeader header{};
+  std::memcpy(&header, file.GetData(), sizeof(header));
+  if (std::memcmp(header.magic, kCookedMagic, sizeof(kCookedMagic)) != 0 ||
+      header.version != kCookedVersion ||
+      header.settingsHash != settingsHash) {
+    return false;
+  }
+
+  // Stale if the source was edited after cooking.
+  SourceStamp current{};
+  if (GetSourceStamp(source, current) &&
+      (current.size != header.sourceSize ||
+       current.time != header.sourceTime)) {
+    return false;
+  }
+
+  for (std::uint32_t i = 0; i < kStreamCount; ++i) {
+    const Section &section = header.sections[i];
+    if (section.offset % kStreamAlignment != 0 ||
+        section.offset > file.GetSize() ||
+        section.count > (file.GetSize() - section.offset) / kElementSize[i]) {
+      return false;
+    }
+  }
+  const std::uint64_t vertexCount = header.sections[kPositions].count;
+  const std::uint64_t indexCount = header.sections[kIndices].count;
+  for (std::uint32_t i : {kNormals, kColors, kUvs, kTangents}) {
+    if (header.sections[i].count != 0 &&
+        header.sections[i].count != vertexCount) {
+      return false;
+    }
+  }
+
+  const std::uint8_t *base = file.GetData();
+  CookedMeshView view;
+  view.positions =
+      StreamSpan<std::array<float, 3>>(base, header.sections[kPositions]);
+  view.normals =
+      StreamSpan<std::array<float, 3>>(base, header.sections[kNormals]);
+  view.colors =
+      StreamSpan<std::array<float, 4>>(base, header.sections[kColors]);
+  view.uvs = StreamSpan<std::array<float, 2>>(base, header.sections[kUvs]);
+  view.tangents =
+      StreamSpan<std::array<float, 4>>(base, header.sections[kTangents]);
+  view.indices = StreamSpan<std::uint32_t>(base, header.sections[kIndices]);
+  view.lods = StreamSpan<CookedMeshLod>(base, header.sections[kLods]);
+  for (const auto &lod : view.lods) {
+    if (lod.firstIndex > indexCount ||
+        lod.indexCount > indexCount - lod.firstIndex) {
+      return false;
+    }
+  }
+  // Consumers index the vertex streams (and narrow to 16 bits for small
+  // meshes) without checking again.
+  for (const std::uint32_t index : view.indices) {
+    if (index >= vertexCount) {
+      return false;
+    }
+  }
+  std::memcpy(view.boundsMin.data(), header.boundsMin,
+              sizeof(header.boundsMin));
+  std::memcpy(view.boundsMax.data(), header.boundsMax,
+              sizeof(header.boundsMax));
+  std::memcpy(view.boundsCenter.data(), header.boundsCenter,
+              sizeof(header.boundsCenter));
+  view.boundsRadius = header.boundsRadius;
+  view.compressedVertices = (header.flags & kFlagCompressedVertices) != 0;
+
+  m_file = std::move(file);
+  m_view = view;
+  return true;
+}
+
+void CookedMeshFile::Close() noexcept {
+  m_view = {};
+  m_file.Close();
+}
+
+std::uint64_t HashMeshImportSettings(
+    const AssetRegistry::MeshImportSettings &settings) noexcept {
+  std::uint64_t hash = 1469598103934665603ull;
+  hash = HashValue(hash, kImporterVersion);
+  hash = HashValue(hash, settings.scale);
+  hash = HashValue(hash, settings.centerMesh);
+  hash = HashValue(hash, settings.generateNormals);
+  hash = HashValue(hash, settings.generateTangents);
+  hash = HashValue(hash, settings.flipUVs);
+  hash = HashValue(hash, settings.flipWinding);
+  hash = HashValue(hash, settings.optimize);
+  hash = HashValue(hash, settings.compressVertices);
+  return hash;
+}
+
+bool WriteCookedMesh(const std::filesystem::path &path,
+                     const std::filesystem::path &source,
+                     std::uint64_t settingsHash,
+                     const AssetRegistry::MeshData &mesh) {
+  SourceStamp stamp{};
+  if (mesh.positions.empty() || !GetSourceStamp(source, stamp)) {
+    return false;
+  }
+
+  const CookedMeshLod lod0{0, static_cast<std::uint32_t>(mesh.indices.size()),
+                           0.0f, 0};
+
+  FileHeader header{};
+  std::memcpy(header.magic, kCookedMagic, sizeof(kCookedMagic));
+  header.version = kCookedVersion;
+  header.sourceSize = stamp.size;
+  header.sourceTime = stamp.time;
+  header.settingsHash = settingsHash;
+  header.flags = mesh.compressedVertices ? kFlagCompressedVertices : 0u;
+  header.boundsRadius = mesh.boundsRadius;
+  std::memcpy(header.boundsMin, mesh.boundsMin.data(),
+              sizeof(header.boundsMin));
+  std::memcpy(header.boundsMax, mesh.boundsMax.data(),
+              sizeof(header.boundsMax));
+  std::memcpy(header.boundsCenter, mesh.boundsCenter.data(),
+              sizeof(header.boundsCenter));
+
+  const std::uint64_t counts[kStreamCount] = {
+      mesh.positions.size(), mesh.normals.size(), mesh.colors.size(),
+      mesh.uvs.size(),       mesh.tangents.size(), mesh.indices.size(),
+      1};
+  std::uint64_t offset = sizeof(FileHeader);
+  for (std::uint32_t i = 0; i < kStreamCount; ++i) {
+    offset = AlignUp(offset);
+    header.sections[i] = {offset, counts[i]};
+    offset += counts[i] * kElementSize[i];
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  const auto tmpPath = DerivedDataCache::MakeTempPath(path);
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      return false;
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    std::uint64_t written = sizeof(header);
+    WriteStream(out, written, header.sections[kPositions],
+                mesh.positions.data());
+    WriteStream(out, written, header.sections[kNormals], mesh.normals.data());
+    WriteStream(out, written, header.sections[kColors], mesh.colors.data());
+    WriteStream(out, written, header.sections[kUvs], mesh.uvs.data());
+    WriteStream(out, written, header.sections[kTangents],
+                mesh.tangents.data());
+    WriteStream(out, written, header.sections[kIndices], mesh.indices.data());
+    WriteStream(out, written, header.sections[kLods], &lod0);
+    if (!out.good()) {
+      out.close();
+      std::filesystem::remove(tmpPath, ec);
+      return false;
+    }
+  }
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec) {
+    std::filesystem::remove(tmpPath, ec);
+    return false;
+  }
+  return true;
+}
+
+void CopyCookedMesh(const CookedMeshView &view,
+                    AssetRegistry::MeshData &out) {
+  out.positions.assign(view.positions.begin(), view.positions.end());
+  out.normals.assign(view.normals.begin(), view.normals.end());
+  out.colors.assign(view.colors.begin(), view.colors.end());
+  out.uvs.assign(view.uvs.begin(), view.uvs.end());
+  out.tangents.assign(view.tangents.begin(), view.tangents.end());
+  out.indices.assign(view.indices.begin(), view.indices.end());
+  out.boundsMin = view.boundsMin;
+  out.boundsMax = view.boundsMax;
+  out.boundsCenter = view.boundsCenter;
+  out.boundsRadius = view.boundsRadius;
+  out.compressedVertices = view.compressedVertices;
+}
+} // namespace Aetherion::Assets
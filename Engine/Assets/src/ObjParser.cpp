@@ -0,0 +1,584 @@
+#include "Aetherion/Assets/ObjParser.h"
+#include "Aetherion/Assets/MeshCooker.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+using namespace Aetherion::Assets;
+
+// Texts shorter than this many chunks are parsed on the calling thread.
+constexpr std::size_t kParallelMinChunks = 4;
+constexpr std::size_t kMinChunkBytes = 1u << 20;
+
+// The parser reproduces what `std::istringstream >> float` and `std::stoi`
+// used to accept, token boundaries included: e.g. "1.5.3" reads as 1.5 and
+// 0.3, "1e" fails, and "2abc" is face index 2.
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+const char *SkipSpace(const char *p, const char *end) {
+  while (p < end && IsSpace(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+const char *SkipToken(const char *p, const char *end) {
+  while (p < end && !IsSpace(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+bool ReadFloat(const char *&p, const char *end, float &out) {
+  const char *start = SkipSpace(p, end);
+  // Same characters as the C locale's num_get: sign, digits, one decimal
+  // point, and an exponent (with sign) once a digit was seen.
+  const char *s = start;
+  if (s < end && (*s == '+' || *s == '-')) {
+    ++s;
+  }
+  bool mantissa = false;
+  bool decimal = false;
+  bool exponent = false;
+  while (s < end) {
+    const char c = *s;
+    if (IsDigit(c)) {
+      mantissa = true;
+      ++s;
+    } else if (c == '.' && !decimal && !exponent) {
+      decimal = true;
+      ++s;
+    } else if ((c == 'e' || c == 'E') && !exponent && mantissa) {
+      exponent = true;
+      ++s;
+      if (s < end && (*s == '+' || *s == '-')) {
+        ++s;
+      }
+    } else {
+      break;
+    }
+  }
+  p = s;
+
+  // from_chars takes no leading '+'; the scan above allows one at most.
+  const char *number = (start < s && *start == '+') ? start + 1 : start;
+  const auto result = std::from_chars(number, s, out);
+  if (result.ec == std::errc() && result.ptr == s) {
+    return true;
+  }
+  if (result.ec != std::errc::result_out_of_range || result.ptr != s) {
+    return false;
+  }
+  // from_chars rejects underflow, which strtof (and so the stream) rounds
+  // to a denormal or zero; only overflow is an error there.
+  char buffer[128];
+  const std::size_t length = static_cast<std::size_t>(s - start);
+  if (length >= sizeof(buffer)) {
+    std::string copy(start, s);
+    out = std::strtof(copy.c_str(), nullptr);
+  } else {
+    std::memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    out = std::strtof(buffer, nullptr);
+  }
+  return std::isfinite(out);
+}
+
+// std::stoi on the text from `p` on, with 0 for no digits or out of range.
+int ReadIndex(const char *p, const char *end) {
+  bool negative = false;
+  if (p < end && (*p == '+' || *p == '-')) {
+    negative = *p == '-';
+    ++p;
+  }
+  if (p == end || !IsDigit(*p)) {
+    return 0;
+  }
+  const std::int64_t limit =
+      negative ? -static_cast<std::int64_t>(std::numeric_limits<int>::min())
+               : std::numeric_limits<int>::max();
+  std::int64_t value = 0;
+  for (; p < end && IsDigit(*p); ++p) {
+    value = value * 10 + (*p - '0');
+    if (value > limit) {
+      return 0;
+    }
+  }
+  return static_cast<int>(negative ? -value : value);
+}
+
+// 1-based, negative from the end, 0 for none; -1 when out of range.
+int ResolveIndex(int value, std::size_t count) {
+  if (value == 0) {
+    return -1;
+  }
+  int idx = value;
+  if (idx < 0) {
+    idx = static_cast<int>(count) + idx;
+  } else {
+    idx -= 1;
+  }
+  if (idx < 0 || idx >= static_cast<int>(count)) {
+    return -1;
+  }
+  return idx;
+}
+
+struct RawCorner {
+  int position{0};
+  int texcoord{0};
+  int normal{0};
+};
+
+// Indices in a face resolve against the elements read before it, so each
+// face keeps the chunk-local counts at that point.
+struct RawFace {
+  std::uint32_t firstCorner{0};
+  std::uint32_t cornerCount{0};
+  std::uint32_t positions{0};
+  std::uint32_t texcoords{0};
+  std::uint32_t normals{0};
+};
+
+struct Chunk {
+  const char *begin{nullptr};
+  const char *end{nullptr};
+  std::vector<std::array<float, 3>> positions;
+  std::vector<std::array<float, 4>> colors;
+  std::vector<std::array<float, 3>> normals;
+  std::vector<std::array<float, 2>> texcoords;
+  std::vector<RawCorner> corners;
+  std::vector<RawFace> faces;
+  std::size_t lines{0};
+};
+
+bool KeywordIs(const char *begin, const char *end, const char *keyword) {
+  const std::size_t length = std::strlen(keyword);
+  return static_cast<std::size_t>(end - begin) == length &&
+         std::memcmp(begin, keyword, length) == 0;
+}
+
+void ParseLine(const char *p, const char *end, Chunk &chunk) {
+  p = SkipSpace(p, end);
+  const char *keyword = p;
+  p = SkipToken(p, end);
+  if (keyword == p || *keyword == '#') {
+    return;
+  }
+
+  if (KeywordIs(keyword, p, "v")) {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    if (!ReadFloat(p, end, x) || !ReadFloat(p, end, y) ||
+        !ReadFloat(p, end, z)) {
+      return;
+    }
+
+    float r = 1.0f;
+    float g = 1.0f;
+    float b = 1.0f;
+    float a = 1.0f;
+    if (ReadFloat(p, end, r) && ReadFloat(p, end, g) &&
+        ReadFloat(p, end, b)) {
+      if (!ReadFloat(p, end, a)) {
+        a = 1.0f;
+      }
+      chunk.colors.push_back({r, g, b, a});
+    } else {
+      chunk.colors.push_back({1.0f, 1.0f, 1.0f, 1.0f});
+    }
+    chunk.positions.push_back({x, y, z});
+  } else if (KeywordIs(keyword, p, "vn")) {
+    float nx = 0.0f;
+    float ny = 0.0f;
+    float nz = 0.0f;
+    if (ReadFloat(p, end, nx) && ReadFloat(p, end, ny) &&
+        ReadFloat(p, end, nz)) {
+      chunk.normals.push_back({nx, ny, nz});
+    }
+  } else if (KeywordIs(keyword, p, "vt")) {
+    float u = 0.0f;
+    float v = 0.0f;
+    if (ReadFloat(p, end, u) && ReadFloat(p, end, v)) {
+      chunk.texcoords.push_back({u, v});
+    }
+  } else if (KeywordIs(keyword, p, "f")) {
+    RawFace face;
+    face.firstCorner = static_cast<std::uint32_t>(chunk.corners.size());
+    face.positions = static_cast<std::uint32_t>(chunk.positions.size());
+    face.texcoords = static_cast<std::uint32_t>(chunk.texcoords.size());
+    face.normals = static_cast<std::uint32_t>(chunk.normals.size());
+    for (p = SkipSpace(p, end); p < end; p = SkipSpace(p, end)) {
+      const char *token = p;
+      p = SkipToken(p, end);
+
+      RawCorner corner;
+      corner.position = ReadIndex(token, p);
+      const char *slash =
+          static_cast<const char *>(std::memchr(token, '/', p - token));
+      if (slash) {
+        corner.texcoord = ReadIndex(slash + 1, p);
+        const char *slash2 = static_cast<const char *>(
+            std::memchr(slash + 1, '/', p - slash - 1));
+        if (slash2) {
+          corner.normal = ReadIndex(slash2 + 1, p);
+        }
+      }
+      chunk.corners.push_back(corner);
+    }
+    face.cornerCount =
+        static_cast<std::uint32_t>(chunk.corners.size()) - face.firstCorner;
+    if (face.cornerCount > 0) {
+      chunk.faces.push_back(face);
+    }
+  }
+}
+
+void ParseChunk(Chunk &chunk) {
+  const char *p = chunk.begin;
+  while (p < chunk.end) {
+    const char *lineEnd = static_cast<const char *>(
+        std::memchr(p, '\n', static_cast<std::size_t>(chunk.end - p)));
+    if (!lineEnd) {
+      lineEnd = chunk.end;
+    }
+    ParseLine(p, lineEnd, chunk);
+    ++chunk.lines;
+    p = lineEnd + 1;
+  }
+}
+
+// Open-addressing map from (position, texcoord, normal) to output vertex.
+// Positions are never negative in a key, so -1 marks a free slot.
+class VertexTable {
+public:
+  explicit VertexTable(std::size_t expected) {
+    std::size_t capacity = 1024;
+    while (capacity < expected * 2) {
+      capacity *= 2;
+    }
+    m_slots.assign(capacity, Slot{});
+    m_mask = capacity - 1;
+  }
+
+  // Returns the vertex stored for the key, or inserts `next` and returns it.
+  std::uint32_t FindOrInsert(int position, int texcoord, int normal,
+                             std::uint32_t next, bool &inserted) {
+    if ((m_size + 1) * 2 > m_slots.size()) {
+      Grow();
+    }
+    for (std::size_t i = Hash(position, texcoord, normal) & m_mask;;
+         i = (i + 1) & m_mask) {
+      Slot &slot = m_slots[i];
+      if (slot.position < 0) {
+        slot = {position, texcoord, normal, next};
+        ++m_size;
+        inserted = true;
+        return next;
+      }
+      if (slot.position == position && slot.texcoord == texcoord &&
+          slot.normal == normal) {
+        inserted = false;
+        return slot.vertex;
+      }
+    }
+  }
+
+private:
+  struct Slot {
+    int position{-1};
+    int texcoord{-1};
+    int normal{-1};
+    std::uint32_t vertex{0};
+  };
+
+  static std::size_t Hash(int position, int texcoord, int normal) {
+    std::uint64_t h =
+        static_cast<std::uint32_t>(position) * 0x9E3779B97F4A7C15ull;
+    h ^= static_cast<std::uint32_t>(texcoord) * 0xC2B2AE3D27D4EB4Full;
+    h ^= static_cast<std::uint32_t>(normal) * 0x165667B19E3779F9ull;
+    return static_cast<std::size_t>(h ^ (h >> 29));
+  }
+
+  void Grow() {
+    std::vector<Slot> old(m_slots.size() * 2);
+    old.swap(m_slots);
+    m_mask = m_slots.size() - 1;
+    for (const Slot &slot : old) {
+      if (slot.position < 0) {
+        continue;
+      }
+      std::size_t i = Hash(slot.position, slot.texcoord, slot.normal) & m_mask;
+      while (m_slots[i].position >= 0) {
+        i = (i + 1) & m_mask;
+      }
+      m_slots[i] = slot;
+    }
+  }
+
+  std::vector<Slot> m_slots;
+  std::size_t m_mask{0};
+  std::size_t m_size{0};
+};
+
+template <typename T>
+void Concatenate(std::vector<T> &out, std::vector<Chunk> &chunks,
+                 std::vector<T> Chunk::*member) {
+  std::size_t total = 0;
+  for (const auto &chunk : chunks) {
+    total += (chunk.*member).size();
+  }
+  out.reserve(total);
+  for (auto &chunk : chunks) {
+    auto &values = chunk.*member;
+    out.insert(out.end(), values.begin(), values.end());
+    std::vector<T>().swap(values);
+  }
+}
+
+void NormalizeVector(float v[3], const float fallback[3]) {
+  const float lenSq = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+  if (lenSq > 0.0f) {
+    const float invLen = 1.0f / std::sqrt(lenSq);
+    v[0] *= invLen;
+    v[1] *= invLen;
+    v[2] *= invLen;
+  } else {
+    v[0] = fallback[0];
+    v[1] = fallback[1];
+    v[2] = fallback[2];
+  }
+}
+
+std::vector<Chunk> SplitChunks(std::string_view text, std::size_t threads,
+                               std::size_t chunkBytes) {
+  std::size_t count = 1;
+  if (text.size() >= kParallelMinChunks * chunkBytes) {
+    if (threads == 0) {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    count = std::clamp<std::size_t>(text.size() / chunkBytes, 1, threads);
+  }
+
+  std::vector<Chunk> chunks(count);
+  const char *begin = text.data();
+  const char *end = text.data() + text.size();
+  const char *cursor = begin;
+  for (std::size_t i = 0; i < count; ++i) {
+    chunks[i].begin = cursor;
+    if (i + 1 == count) {
+      chunks[i].end = end;
+      break;
+    }
+    // Cut after the first newline past the even split point.
+    const char *target =
+        std::max(cursor, begin + text.size() / count * (i + 1));
+    const char *newline = static_cast<const char *>(
+        std::memchr(target, '\n', static_cast<std::size_t>(end - target)));
+    cursor = newline ? newline + 1 : end;
+    chunks[i].end = cursor;
+  }
+  return chunks;
+}
+
+void ParseChunks(std::vector<Chunk> &chunks) {
+  std::vector<std::exception_ptr> errors(chunks.size());
+  auto parse = [&chunks, &errors](std::size_t index) {
+    try {
+      ParseChunk(chunks[index]);
+    } catch (...) {
+      errors[index] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  std::size_t next = 1;
+  for (; next < chunks.size(); ++next) {
+    try {
+      workers.emplace_back(parse, next);
+    } catch (const std::system_error &) {
+      break;
+    }
+  }
+  parse(0);
+  // Chunks no thread could be started for are parsed here.
+  for (std::size_t i = next; i < chunks.size(); ++i) {
+    parse(i);
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  for (const auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+} // namespace
+
+namespace Aetherion::Assets {
+bool ParseObj(std::string_view text, AssetRegistry::MeshData &out,
+              ObjParseInfo *info, std::size_t threads,
+              std::size_t minChunkBytes) {
+  std::vector<Chunk> chunks = SplitChunks(
+      text, threads, minChunkBytes != 0 ? minChunkBytes : kMinChunkBytes);
+  ParseChunks(chunks);
+
+  // Chunk-local counts become global ones by adding what earlier chunks
+  // read; the elements themselves are simply appended in order.
+  struct Base {
+    std::size_t positions{0};
+    std::size_t texcoords{0};
+    std::size_t normals{0};
+  };
+  std::vector<Base> bases(chunks.size());
+  std::size_t cornerTotal = 0;
+  std::size_t lines = 0;
+  for (std::size_t i = 1; i < chunks.size(); ++i) {
+    const Chunk &previous = chunks[i - 1];
+    bases[i].positions = bases[i - 1].positions + previous.positions.size();
+    bases[i].texcoords = bases[i - 1].texcoords + previous.texcoords.size();
+    bases[i].normals = bases[i - 1].normals + previous.normals.size();
+  }
+  for (const auto &chunk : chunks) {
+    cornerTotal += chunk.corners.size();
+    lines += chunk.lines;
+  }
+
+  std::vector<std::array<float, 3>> positions;
+  std::vector<std::array<float, 4>> colors;
+  std::vector<std::array<float, 3>> normals;
+  std::vector<std::array<float, 2>> texcoords;
+  Concatenate(positions, chunks, &Chunk::positions);
+  Concatenate(colors, chunks, &Chunk::colors);
+  Concatenate(normals, chunks, &Chunk::normals);
+  Concatenate(texcoords, chunks, &Chunk::texcoords);
+
+  std::vector<std::array<float, 3>> outPositions;
+  std::vector<std::array<float, 4>> outColors;
+  std::vector<std::array<float, 3>> outNormals;
+  std::vector<std::array<float, 2>> outUvs;
+  std::vector<std::uint32_t> indices;
+  outPositions.reserve(positions.size());
+  outColors.reserve(positions.size());
+  outNormals.reserve(positions.size());
+  outUvs.reserve(positions.size());
+  indices.reserve(cornerTotal * 3 / 2);
+
+  // Vertices are numbered in order of first use, which makes this pass
+  // serial; it only hashes and copies.
+  VertexTable vertexLookup(std::min(cornerTotal, positions.size() * 2));
+  bool hasNormals = false;
+  bool missingNormals = false;
+  std::vector<std::uint32_t> face;
+
+  for (std::size_t c = 0; c < chunks.size(); ++c) {
+    const Chunk &chunk = chunks[c];
+    for (const RawFace &raw : chunk.faces) {
+      const std::size_t positionCount = bases[c].positions + raw.positions;
+      const std::size_t texcoordCount = bases[c].texcoords + raw.texcoords;
+      const std::size_t normalCount = bases[c].normals + raw.normals;
+
+      face.clear();
+      for (std::uint32_t k = 0; k < raw.cornerCount; ++k) {
+        const RawCorner &corner = chunk.corners[raw.firstCorner + k];
+        const int positionIndex = ResolveIndex(corner.position, positionCount);
+        if (positionIndex < 0) {
+          continue;
+        }
+        const int texIndex = ResolveIndex(corner.texcoord, texcoordCount);
+        const int normalIndex = ResolveIndex(corner.normal, normalCount);
+
+        bool inserted = false;
+        const std::uint32_t vertexIndex = vertexLookup.FindOrInsert(
+            positionIndex, texIndex, normalIndex,
+            static_cast<std::uint32_t>(outPositions.size()), inserted);
+        if (inserted) {
+          const auto position = static_cast<std::size_t>(positionIndex);
+          outPositions.push_back(positions[position]);
+          if (position < colors.size()) {
+            outColors.push_back(colors[position]);
+          } else {
+            outColors.push_back({1.0f, 1.0f, 1.0f, 1.0f});
+          }
+
+          if (texIndex >= 0) {
+            outUvs.push_back(texcoords[static_cast<std::size_t>(texIndex)]);
+          } else {
+            outUvs.push_back({0.0f, 0.0f});
+          }
+
+          if (normalIndex >= 0) {
+            const auto &normal = normals[static_cast<std::size_t>(normalIndex)];
+            float normalValues[3] = {normal[0], normal[1], normal[2]};
+            const float defaultNormal[3] = {0.0f, 0.0f, 1.0f};
+            NormalizeVector(normalValues, defaultNormal);
+            outNormals.push_back(
+                {normalValues[0], normalValues[1], normalValues[2]});
+            hasNormals = true;
+          } else {
+            outNormals.push_back({0.0f, 0.0f, 1.0f});
+            missingNormals = true;
+          }
+        }
+        face.push_back(vertexIndex);
+      }
+
+      if (face.size() >= 3) {
+        for (std::size_t i = 1; i + 1 < face.size(); ++i) {
+          indices.push_back(face[0]);
+          indices.push_back(face[i]);
+          indices.push_back(face[i + 1]);
+        }
+      }
+    }
+  }
+
+  if (info) {
+    info->hasNormals = hasNormals;
+    info->missingNormals = missingNormals;
+    info->lines = lines;
+    info->chunks = chunks.size();
+  }
+  if (outPositions.empty() || indices.empty()) {
+    return false;
+  }
+
+  out.positions = std::move(outPositions);
+  out.colors = std::move(outColors);
+  out.normals = std::move(outNormals);
+  out.uvs = std::move(outUvs);
+  out.indices = std::move(indices);
+  return true;
+}
+
+bool ParseObjFile(const std::filesystem::path &path,
+                  AssetRegistry::MeshData &out, ObjParseInfo *info,
+                  std::size_t threads) {
+  MappedFile file;
+  if (!file.Open(path)) {
+    return false;
+  }
+  const std::string_view text(reinterpret_cast<const char *>(file.GetData()),
+                              file.GetSize());
+  return ParseObj(text, out, info, threads);
+}
+} // namespace Aetherion::Assets
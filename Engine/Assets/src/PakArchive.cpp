@@ -0,0 +1,484 @@
+#include "Aetherion/Assets/PakArchive.h"
+
+#include "Aetherion/Assets/DerivedDataCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+using namespace Aetherion::Assets;
+
+constexpr char kPakMagic[4] = {'A', 'P', 'A', 'K'};
+constexpr std::uint32_t kPakVersion = 1;
+constexpr std::uint64_t kPakAlignment = 64;
+
+// Written as is. Unlike cooked containers, archives are shipped to other
+// machines; every platform the engine targets is little-endian.
+struct PakHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint64_t entryCount;
+  std::uint64_t tocOffset;
+  std::uint64_t tocSize;
+  std::uint64_t reserved[4];
+};
+static_assert(sizeof(PakHeader) == kPakAlignment);
+
+// The table of contents is `entryCount` records followed by their strings;
+// each record's id is followed directly by its path.
+struct PakRecord {
+  std::uint64_t offset;
+  std::uint64_t size;
+  std::uint64_t storedSize;
+  std::uint64_t hash;
+  std::uint64_t stringOffset;
+  std::uint32_t idLength;
+  std::uint32_t pathLength;
+  std::uint32_t compression;
+  std::uint32_t reserved;
+};
+static_assert(sizeof(PakRecord) == 56);
+
+std::uint64_t AlignUp(std::uint64_t value) {
+  return (value + kPakAlignment - 1) & ~(kPakAlignment - 1);
+}
+
+void WritePadding(std::ofstream &out, std::uint64_t &written,
+                  std::uint64_t target) {
+  static const char kPadding[kPakAlignment] = {};
+  if (written < target) {
+    out.write(kPadding, static_cast<std::streamsize>(target - written));
+    written = target;
+  }
+}
+
+// LZ4 block format: sequences of a token (literal count in the high nibble,
+// match length - 4 in the low one, 15 meaning "more bytes follow"), the
+// literals, and a 16-bit back offset for the match. The last sequence is
+// literals only. Greedy single-probe matching, like LZ4's fast mode.
+constexpr std::size_t kLz4MinMatch = 4;
+// The format wants the last 5 bytes to be literals and no match to start in
+// the last 12.
+constexpr std::size_t kLz4LastLiterals = 5;
+constexpr std::size_t kLz4MatchLimit = 12;
+constexpr std::size_t kLz4MaxOffset = 65535;
+constexpr int kLz4HashBits = 16;
+// A block expands at most about 255 times (every length byte of 255 adds 255
+// bytes of match); sizes beyond that cannot decode from the stored bytes.
+constexpr std::uint64_t kLz4MaxExpansion = 255;
+constexpr std::uint64_t kLz4ExpansionSlack = 64;
+constexpr std::uint32_t kNoPosition =
+    std::numeric_limits<std::uint32_t>::max();
+
+std::uint32_t Read32(const std::uint8_t *bytes) {
+  std::uint32_t value;
+  std::memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+std::uint32_t Lz4Hash(std::uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - kLz4HashBits);
+}
+
+void Lz4WriteLength(std::vector<std::uint8_t> &out, std::size_t length) {
+  while (length >= 255) {
+    out.push_back(255);
+    length -= 255;
+  }
+  out.push_back(static_cast<std::uint8_t>(length));
+}
+
+// `matchLength` 0 writes the final, literal-only sequence.
+void Lz4WriteSequence(std::vector<std::uint8_t> &out,
+                      const std::uint8_t *literals, std::size_t literalCount,
+                      std::size_t offset, std::size_t matchLength) {
+  const std::size_t matchCode = matchLength ? matchLength - kLz4MinMatch : 0;
+  out.push_back(static_cast<std::uint8_t>(
+      (std::min<std::size_t>(literalCount, 15) << 4) |
+      std::min<std::size_t>(matchCode, 15)));
+  if (literalCount >= 15) {
+    Lz4WriteLength(out, literalCount - 15);
+  }
+  out.insert(out.end(), literals, literals + literalCount);
+  if (matchLength == 0) {
+    return;
+  }
+  out.push_back(static_cast<std::uint8_t>(offset & 0xff));
+  out.push_back(static_cast<std::uint8_t>(offset >> 8));
+  if (matchCode >= 15) {
+    Lz4WriteLength(out, matchCode - 15);
+  }
+}
+
+// Inputs must be smaller than 4 GiB.
+std::vector<std::uint8_t> Lz4Compress(const std::uint8_t *src,
+                                      std::size_t size) {
+  std::vector<std::uint8_t> out;
+  out.reserve(size + size / 255 + 16);
+  std::vector<std::uint32_t> table(std::size_t{1} << kLz4HashBits,
+                                   kNoPosition);
+  std::size_t anchor = 0;
+  if (size > kLz4MatchLimit) {
+    const std::size_t matchStartLimit = size - kLz4MatchLimit;
+    const std::size_t matchEndLimit = size - kLz4LastLiterals;
+    std::size_t ip = 0;
+    while (ip < matchStartLimit) {
+      const std::uint32_t sequence = Read32(src + ip);
+      const std::uint32_t hash = Lz4Hash(sequence);
+      const std::uint32_t candidate = table[hash];
+      table[hash] = static_cast<std::uint32_t>(ip);
+      if (candidate == kNoPosition || ip - candidate > kLz4MaxOffset ||
+          Read32(src + candidate) != sequence) {
+        // Steps grow while nothing matches, so incompressible data is
+        // skipped quickly.
+        ip += 1 + ((ip - anchor) >> 6);
+        continue;
+      }
+
+      std::size_t length = kLz4MinMatch;
+      while (ip + length < matchEndLimit &&
+             src[candidate + length] == src[ip + length]) {
+        ++length;
+      }
+      Lz4WriteSequence(out, src + anchor, ip - anchor, ip - candidate,
+                       length);
+      ip += length;
+      anchor = ip;
+    }
+  }
+  Lz4WriteSequence(out, src + anchor, size - anchor, 0, 0);
+  return out;
+}
+
+bool Lz4Decompress(const std::uint8_t *src, std::size_t srcSize,
+                   std::uint8_t *dst, std::size_t dstSize) {
+  std::size_t ip = 0;
+  std::size_t op = 0;
+  auto readLength = [&](std::size_t &length) {
+    std::uint8_t byte = 0;
+    do {
+      if (ip >= srcSize) {
+        return false;
+      }
+      byte = src[ip++];
+      length += byte;
+    } while (byte == 255);
+    return true;
+  };
+
+  while (ip < srcSize) {
+    const std::uint8_t token = src[ip++];
+    std::size_t literalCount = token >> 4;
+    if (literalCount == 15 && !readLength(literalCount)) {
+      return false;
+    }
+    if (literalCount > srcSize - ip || literalCount > dstSize - op) {
+      return false;
+    }
+    std::memcpy(dst + op, src + ip, literalCount);
+    ip += literalCount;
+    op += literalCount;
+    if (ip == srcSize) {
+      break;
+    }
+
+    if (srcSize - ip < 2) {
+      return false;
+    }
+    const std::size_t offset =
+        static_cast<std::size_t>(src[ip]) |
+        (static_cast<std::size_t>(src[ip + 1]) << 8);
+    ip += 2;
+    std::size_t length = token & 15;
+    if (length == 15 && !readLength(length)) {
+      return false;
+    }
+    length += kLz4MinMatch;
+    if (offset == 0 || offset > op || length > dstSize - op) {
+      return false;
+    }
+    const std::uint8_t *match = dst + op - offset;
+    if (offset >= length) {
+      std::memcpy(dst + op, match, length);
+    } else {
+      // Overlapping matches repeat the last `offset` bytes.
+      for (std::size_t i = 0; i < length; ++i) {
+        dst[op + i] = match[i];
+      }
+    }
+    op += length;
+  }
+  return op == dstSize;
+}
+} // namespace
+
+namespace Aetherion::Assets {
+bool PakArchive::Open(const std::filesystem::path &path) {
+  Close();
+  MappedFile file;
+  if (!file.Open(path) || file.GetSize() < sizeof(PakHeader)) {
+    return false;
+  }
+
+  PakHeader header{};
+  std::memcpy(&header, file.GetData(), sizeof(header));
+  const std::uint64_t fileSize = file.GetSize();
+  if (std::memcmp(header.magic, kPakMagic, sizeof(kPakMagic)) != 0 ||
+      header.version != kPakVersion ||
+      header.tocOffset < sizeof(PakHeader) || header.tocOffset > fileSize ||
+      header.tocSize > fileSize - header.tocOffset ||
+      header.entryCount > header.tocSize / sizeof(PakRecord)) {
+    return false;
+  }
+
+  const std::uint8_t *toc = file.GetData() + header.tocOffset;
+  const std::uint64_t recordBytes = header.entryCount * sizeof(PakRecord);
+  const char *strings = reinterpret_cast<const char *>(toc + recordBytes);
+  const std::uint64_t stringBytes = header.tocSize - recordBytes;
+
+  std::vector<PakEntry> entries;
+  std::unordered_map<std::string_view, std::size_t> pathLookup;
+  entries.reserve(static_cast<std::size_t>(header.entryCount));
+  pathLookup.reserve(static_cast<std::size_t>(header.entryCount));
+  for (std::uint64_t i = 0; i < header.entryCount; ++i) {
+    PakRecord record{};
+    std::memcpy(&record, toc + i * sizeof(PakRecord), sizeof(record));
+    const std::uint64_t stringLength =
+        std::uint64_t{record.idLength} + record.pathLength;
+    if (record.stringOffset > stringBytes ||
+        stringLength > stringBytes - record.stringOffset ||
+        record.pathLength == 0 || record.offset < sizeof(PakHeader) ||
+        record.offset > header.tocOffset ||
+        record.storedSize > header.tocOffset - record.offset ||
+        record.compression > static_cast<std::uint32_t>(PakCompression::Lz4) ||
+        (record.compression == 0 && record.storedSize != record.size) ||
+        (record.size == 0 && record.storedSize != 0)) {
+      return false;
+    }
+    // Read allocates `size` bytes up front, so a corrupt or hostile size
+    // must be caught here rather than throw from an allocation.
+    if (record.compression != 0 &&
+        record.size > record.storedSize * kLz4MaxExpansion +
+                          kLz4ExpansionSlack) {
+      return false;
+    }
+
+    PakEntry entry{};
+    entry.id = {strings + record.stringOffset, record.idLength};
+    entry.path = {strings + record.stringOffset + record.idLength,
+                  record.pathLength};
+    entry.offset = record.offset;
+    entry.size = record.size;
+    entry.storedSize = record.storedSize;
+    entry.hash = record.hash;
+    entry.compression = static_cast<PakCompression>(record.compression);
+    // FindById relies on the order.
+    if (!entries.empty() && entry.id < entries.back().id) {
+      return false;
+    }
+    if (!pathLookup.emplace(entry.path, entries.size()).second) {
+      return false;
+    }
+    entries.push_back(entry);
+  }
+
+  m_file = std::move(file);
+  m_path = path;
+  m_entries = std::move(entries);
+  m_pathLookup = std::move(pathLookup);
+  return true;
+}
+
+void PakArchive::Close() noexcept {
+  m_pathLookup.clear();
+  m_entries.clear();
+  m_path.clear();
+  m_file.Close();
+}
+
+const PakEntry *PakArchive::FindById(std::string_view id) const noexcept {
+  if (id.empty()) {
+    return nullptr;
+  }
+  auto it = std::lower_bound(
+      m_entries.begin(), m_entries.end(), id,
+      [](const PakEntry &entry, std::string_view value) {
+        return entry.id < value;
+      });
+  return it != m_entries.end() && it->id == id ? &*it : nullptr;
+}
+
+const PakEntry *PakArchive::FindByPath(std::string_view path) const noexcept {
+  auto it = m_pathLookup.find(path);
+  return it != m_pathLookup.end() ? &m_entries[it->second] : nullptr;
+}
+
+std::span<const std::uint8_t>
+PakArchive::GetStoredData(const PakEntry &entry) const noexcept {
+  if (!m_file.IsOpen()) {
+    return {};
+  }
+  return {m_file.GetData() + entry.offset,
+          static_cast<std::size_t>(entry.storedSize)};
+}
+
+bool PakArchive::Read(const PakEntry &entry,
+                      std::vector<std::uint8_t> &out) const {
+  const auto stored = GetStoredData(entry);
+  if (stored.size() != entry.storedSize) {
+    return false;
+  }
+  if (entry.compression == PakCompression::None) {
+    out.assign(stored.begin(), stored.end());
+    return true;
+  }
+  out.resize(static_cast<std::size_t>(entry.size));
+  if (!Lz4Decompress(stored.data(), stored.size(), out.data(), out.size())) {
+    out.clear();
+    return false;
+  }
+  return true;
+}
+
+bool WritePakArchive(const std::filesystem::path &path,
+                     const std::vector<PakWriteEntry> &entries,
+                     PakWriteStats *outStats, std::string *outError) {
+  auto fail = [outError](std::string message) {
+    if (outError) {
+      *outError = std::move(message);
+    }
+    return false;
+  };
+
+  std::unordered_set<std::string_view> paths;
+  std::unordered_set<std::string_view> ids;
+  for (const auto &entry : entries) {
+    if (entry.path.empty() || !paths.insert(entry.path).second) {
+      return fail("duplicate or empty path '" + entry.path + "'");
+    }
+    if (!entry.id.empty() && !ids.insert(entry.id).second) {
+      return fail("duplicate id '" + entry.id + "'");
+    }
+  }
+
+  std::error_code ec;
+  if (path.has_parent_path()) {
+    std::filesystem::create_directories(path.parent_path(), ec);
+  }
+  const auto tmpPath = DerivedDataCache::MakeTempPath(path);
+
+  PakWriteStats stats{};
+  std::string error;
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      return fail("cannot write " + tmpPath.string());
+    }
+
+    PakHeader header{};
+    std::memcpy(header.magic, kPakMagic, sizeof(kPakMagic));
+    header.version = kPakVersion;
+    // Rewritten once the table of contents is in place.
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    std::uint64_t written = sizeof(header);
+
+    std::vector<PakRecord> records(entries.size());
+    std::vector<std::uint8_t> data;
+    std::vector<std::uint8_t> compressed;
+    for (std::size_t i = 0; i < entries.size() && error.empty(); ++i) {
+      const PakWriteEntry &entry = entries[i];
+      std::ifstream input(entry.source, std::ios::binary);
+      if (!input.is_open()) {
+        error = "cannot read " + entry.source.string();
+        break;
+      }
+      data.assign(std::istreambuf_iterator<char>(input),
+                  std::istreambuf_iterator<char>());
+
+      PakRecord &record = records[i];
+      record.size = data.size();
+      record.hash = DerivedDataCache::HashBytes(data.data(), data.size());
+      record.compression = static_cast<std::uint32_t>(PakCompression::None);
+      const std::vector<std::uint8_t> *stored = &data;
+      if (entry.compression == PakCompression::Lz4 && !data.empty() &&
+          data.size() < kNoPosition) {
+        compressed = Lz4Compress(data.data(), data.size());
+        if (compressed.size() <= data.size() - data.size() / 8) {
+          stored = &compressed;
+          record.compression =
+              static_cast<std::uint32_t>(PakCompression::Lz4);
+          ++stats.compressedEntries;
+        }
+      }
+
+      record.offset = AlignUp(written);
+      record.storedSize = stored->size();
+      WritePadding(out, written, record.offset);
+      out.write(reinterpret_cast<const char *>(stored->data()),
+                static_cast<std::streamsize>(stored->size()));
+      written += stored->size();
+      stats.bytes += record.size;
+      stats.storedBytes += record.storedSize;
+    }
+
+    if (error.empty()) {
+      // Sorted by id for FindById; files without one come first, by path.
+      std::vector<std::size_t> order(entries.size());
+      std::iota(order.begin(), order.end(), std::size_t{0});
+      std::sort(order.begin(), order.end(),
+                [&entries](std::size_t a, std::size_t b) {
+                  return std::tie(entries[a].id, entries[a].path) <
+                         std::tie(entries[b].id, entries[b].path);
+                });
+      std::string strings;
+      std::vector<PakRecord> toc;
+      toc.reserve(order.size());
+      for (std::size_t index : order) {
+        PakRecord record = records[index];
+        record.stringOffset = strings.size();
+        record.idLength = static_cast<std::uint32_t>(entries[index].id.size());
+        record.pathLength =
+            static_cast<std::uint32_t>(entries[index].path.size());
+        strings += entries[index].id;
+        strings += entries[index].path;
+        toc.push_back(record);
+      }
+
+      header.entryCount = toc.size();
+      header.tocOffset = AlignUp(written);
+      header.tocSize = toc.size() * sizeof(PakRecord) + strings.size();
+      WritePadding(out, written, header.tocOffset);
+      out.write(reinterpret_cast<const char *>(toc.data()),
+                static_cast<std::streamsize>(toc.size() * sizeof(PakRecord)));
+      out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+      out.seekp(0);
+      out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      if (!out.good()) {
+        error = "write failed for " + tmpPath.string();
+      }
+    }
+  }
+
+  if (!error.empty()) {
+    std::filesystem::remove(tmpPath, ec);
+    return fail(std::move(error));
+  }
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec) {
+    std::filesystem::remove(tmpPath, ec);
+    return fail("cannot replace " + path.string());
+  }
+  stats.entries = entries.size();
+  if (outStats) {
+    *outStats = stats;
+  }
+  return true;
+}
+} // namespace Aetherion::Assets
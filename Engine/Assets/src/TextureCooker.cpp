@@ -0,0 +1,1026 @@
+#include "Aetherion/Assets/TextureCooker.h"
+#include "Aetherion/Core/String.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb/stb_image.h"
+
+namespace {
+using namespace Aetherion::Assets;
+
+constexpr char kCookedMagic[4] = {'A', 'T', 'E', 'X'};
+constexpr std::uint32_t kCookedVersion = 1;
+// Bumped when cooking produces different blocks or mips for the same source
+// and settings, so content-keyed cooks are redone.
+constexpr std::uint64_t kCookerVersion = 1;
+constexpr const char *kCookedTextureKind = "atex";
+
+// ---------------------------------------------------------------------------
+// Mip generation
+// ---------------------------------------------------------------------------
+
+const std::array<float, 256> &SrgbToLinearTable() {
+  static const std::array<float, 256> table = [] {
+    std::array<float, 256> values{};
+    for (int i = 0; i < 256; ++i) {
+      const float c = static_cast<float>(i) / 255.0f;
+      values[i] = (c <= 0.04045f) ? c / 12.92f
+                                  : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    return values;
+  }();
+  return table;
+}
+
+std::uint8_t LinearToSrgb(float c) {
+  c = std::clamp(c, 0.0f, 1.0f);
+  const float s = (c <= 0.0031308f)
+                      ? c * 12.92f
+                      : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+  return static_cast<std::uint8_t>(std::lround(s * 255.0f));
+}
+
+// 2x2 box filter. Color channels are averaged in linear space when `srgb`
+// is set so mips do not darken; alpha is always linear.
+std::vector<std::uint8_t> DownsampleRgba(const std::vector<std::uint8_t> &src,
+                                         std::uint32_t width,
+                                         std::uint32_t height, bool srgb) {
+  const std::uint32_t dstWidth = std::max(1u, width / 2);
+  const std::uint32_t dstHeight = std::max(1u, height / 2);
+  std::vector<std::uint8_t> dst(static_cast<size_t>(dstWidth) * dstHeight * 4);
+  const auto &toLinear = SrgbToLinearTable();
+
+  for (std::uint32_t y = 0; y < dstHeight; ++y) {
+    const std::uint32_t y0 = std::min(y * 2, height - 1);
+    const std::uint32_t y1 = std::min(y * 2 + 1, height - 1);
+    for (std::uint32_t x = 0; x < dstWidth; ++x) {
+      const std::uint32_t x0 = std::min(x * 2, width - 1);
+      const std::uint32_t x1 = std::min(x * 2 + 1, width - 1);
+      const std::uint8_t *taps[4] = {
+          &src[(static_cast<size_t>(y0) * width + x0) * 4],
+          &src[(static_cast<size_t>(y0) * width + x1) * 4],
+          &src[(static_cast<size_t>(y1) * width + x0) * 4],
+          &src[(static_cast<size_t>(y1) * width + x1) * 4],
+      };
+      std::uint8_t *out = &dst[(static_cast<size_t>(y) * dstWidth + x) * 4];
+      for (int c = 0; c < 4; ++c) {
+        if (srgb && c < 3) {
+          float sum = 0.0f;
+          for (const auto *tap : taps) {
+            sum += toLinear[tap[c]];
+          }
+          out[c] = LinearToSrgb(sum * 0.25f);
+        } else {
+          std::uint32_t sum = 0;
+          for (const auto *tap : taps) {
+            sum += tap[c];
+          }
+          out[c] = static_cast<std::uint8_t>((sum + 2) / 4);
+        }
+      }
+    }
+  }
+  return dst;
+}
+
+// ---------------------------------------------------------------------------
+// Block compression
+// ---------------------------------------------------------------------------
+
+// Principal axis of the block's colors (first `channels` components) via a
+// few power iterations on the covariance matrix.
+template <int Channels>
+void PrincipalAxis(const std::uint8_t *pixels,
+                   std::array<float, Channels> &mean,
+                   std::array<float, Channels> &axis) {
+  mean.fill(0.0f);
+  for (int i = 0; i < 16; ++i) {
+    for (int c = 0; c < Channels; ++c) {
+      mean[c] += pixels[i * 4 + c];
+    }
+  }
+  for (auto &m : mean) {
+    m /= 16.0f;
+  }
+
+  std::array<float, Channels * Channels> cov{};
+  for (int i = 0; i < 16; ++i) {
+    std::array<float, Channels> d{};
+    for (int c = 0; c < Channels; ++c) {
+      d[c] = pixels[i * 4 + c] - mean[c];
+    }
+    for (int r = 0; r < Channels; ++r) {
+      for (int c = 0; c < Channels; ++c) {
+        cov[r * Channels + c] += d[r] * d[c];
+      }
+    }
+  }
+
+  axis.fill(1.0f);
+  for (int iter = 0; iter < 8; ++iter) {
+    std::array<float, Channels> next{};
+    for (int r = 0; r < Channels; ++r) {
+      for (int c = 0; c < Channels; ++c) {
+        next[r] += cov[r * Channels + c] * axis[c];
+      }
+    }
+    float length = 0.0f;
+    for (float v : next) {
+      length += v * v;
+    }
+    if (length <= 1e-12f) {
+      break;
+    }
+    length = std::sqrt(length);
+    for (int c = 0; c < Channels; ++c) {
+      axis[c] = next[c] / length;
+    }
+  }
+}
+
+template <int Channels>
+void AxisEndpoints(const std::uint8_t *pixels, std::array<float, Channels> &lo,
+                   std::array<float, Channels> &hi) {
+  std::array<float, Channels> mean{};
+  std::array<float, Channels> axis{};
+  PrincipalAxis<Channels>(pixels, mean, axis);
+
+  float tMin = 0.0f;
+  float tMax = 0.0f;
+  for (int i = 0; i < 16; ++i) {
+    float t = 0.0f;
+    for (int c = 0; c < Channels; ++c) {
+      t += (pixels[i * 4 + c] - mean[c]) * axis[c];
+    }
+    tMin = std::min(tMin, t);
+    tMax = std::max(tMax, t);
+  }
+  // Inset slightly; extremes are usually better represented by the
+  // interpolated entries than by clamped endpoints.
+  const float inset = (tMax - tMin) / 16.0f;
+  tMin += inset;
+  tMax -= inset;
+  for (int c = 0; c < Channels; ++c) {
+    lo[c] = std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+    hi[c] = std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+  }
+}
+
+std::uint16_t PackRgb565(const std::array<float, 3> &c) {
+  const auto r = static_cast<std::uint16_t>(std::lround(c[0] * 31.0f / 255.0f));
+  const auto g = static_cast<std::uint16_t>(std::lround(c[1] * 63.0f / 255.0f));
+  const auto b = static_cast<std::uint16_t>(std::lround(c[2] * 31.0f / 255.0f));
+  return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+}
+
+std::array<int, 3> UnpackRgb565(std::uint16_t c) {
+  const int r = (c >> 11) & 31;
+  const int g = (c >> 5) & 63;
+  const int b = c & 31;
+  return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+// Four-color BC1 block (also the color half of BC3).
+void EncodeBC1Block(const std::uint8_t *pixels, std::uint8_t *out) {
+  std::array<float, 3> lo{};
+  std::array<float, 3> hi{};
+  AxisEndpoints<3>(pixels, lo, hi);
+
+  std::uint16_t c0 = PackRgb565(hi);
+  std::uint16_t c1 = PackRgb565(lo);
+  if (c0 < c1) {
+    std::swap(c0, c1);
+  }
+
+  std::uint32_t indices = 0;
+  if (c0 != c1) {
+    const auto e0 = UnpackRgb565(c0);
+    const auto e1 = UnpackRgb565(c1);
+    std::array<std::array<int, 3>, 4> palette{};
+    for (int c = 0; c < 3; ++c) {
+      palette[0][c] = e0[c];
+      palette[1][c] = e1[c];
+      palette[2][c] = (2 * e0[c] + e1[c]) / 3;
+      palette[3][c] = (e0[c] + 2 * e1[c]) / 3;
+    }
+    for (int i = 0; i < 16; ++i) {
+      int best = 0;
+      int bestError = std::numeric_limits<int>::max();
+      for (int p = 0; p < 4; ++p) {
+        int error = 0;
+        for (int c = 0; c < 3; ++c) {
+          const int d = pixels[i * 4 + c] - palette[p][c];
+          error += d * d;
+        }
+        if (error < bestError) {
+          bestError = error;
+          best = p;
+        }
+      }
+      indices |= static_cast<std::uint32_t>(best) << (i * 2);
+    }
+  }
+
+  out[0] = static_cast<std::uint8_t>(c0 & 0xFF);
+  out[1] = static_cast<std::uint8_t>(c0 >> 8);
+  out[2] = static_cast<std::uint8_t>(c1 & 0xFF);
+  out[3] = static_cast<std::uint8_t>(c1 >> 8);
+  for (int b = 0; b < 4; ++b) {
+    out[4 + b] = static_cast<std::uint8_t>(indices >> (b * 8));
+  }
+}
+
+// Single-channel BC4 block using the 8-value mode; `channel` selects the
+// RGBA component to encode (alpha for BC3, R/G for BC5).
+void EncodeBC4Block(const std::uint8_t *pixels, int channel,
+                    std::uint8_t *out) {
+  int lo = 255;
+  int hi = 0;
+  for (int i = 0; i < 16; ++i) {
+    lo = std::min<int>(lo, pixels[i * 4 + channel]);
+    hi = std::max<int>(hi, pixels[i * 4 + channel]);
+  }
+
+  std::uint64_t indices = 0;
+  if (hi != lo) {
+    std::array<int, 8> palette{};
+    palette[0] = hi;
+    palette[1] = lo;
+    for (int p = 2; p < 8; ++p) {
+      palette[p] = ((8 - p) * hi + (p - 1) * lo) / 7;
+    }
+    for (int i = 0; i < 16; ++i) {
+      const int value = pixels[i * 4 + channel];
+      int best = 0;
+      int bestError = std::numeric_limits<int>::max();
+      for (int p = 0; p < 8; ++p) {
+        const int error = std::abs(value - palette[p]);
+        if (error < bestError) {
+          bestError = error;
+          best = p;
+        }
+      }
+      indices |= static_cast<std::uint64_t>(best) << (i * 3);
+    }
+  }
+
+  out[0] = static_cast<std::uint8_t>(hi);
+  out[1] = static_cast<std::uint8_t>(lo);
+  for (int b = 0; b < 6; ++b) {
+    out[2 + b] = static_cast<std::uint8_t>(indices >> (b * 8));
+  }
+}
+
+class BlockBitWriter {
+public:
+  explicit BlockBitWriter(std::uint8_t *out) : m_out(out) {
+    std::memset(m_out, 0, 16);
+  }
+
+  void Write(std::uint32_t value, int bits) {
+    for (int b = 0; b < bits; ++b, ++m_bit) {
+      if (value & (1u << b)) {
+        m_out[m_bit >> 3] |= static_cast<std::uint8_t>(1u << (m_bit & 7));
+      }
+    }
+  }
+
+private:
+  std::uint8_t *m_out;
+  int m_bit{0};
+};
+
+// BC7 mode 6: one subset, RGBA 7.7.7.7 endpoints with per-endpoint p-bits and
+// 4-bit indices. Not the best mode for every block, but a good quality/speed
+// trade-off for a CPU encoder.
+void EncodeBC7Block(const std::uint8_t *pixels, std::uint8_t *out) {
+  static constexpr int kWeights[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                                       34, 38, 43, 47, 51, 55, 60, 64};
+
+  std::array<float, 4> lo{};
+  std::array<float, 4> hi{};
+  AxisEndpoints<4>(pixels, lo, hi);
+
+  std::array<int, 4> bestQ0{};
+  std::array<int, 4> bestQ1{};
+  int bestP0 = 0;
+  int bestP1 = 0;
+  std::array<int, 16> bestIndices{};
+  long long bestError = std::numeric_limits<long long>::max();
+
+  for (int p0 = 0; p0 < 2; ++p0) {
+    for (int p1 = 0; p1 < 2; ++p1) {
+      std::array<int, 4> q0{};
+      std::array<int, 4> q1{};
+      std::array<int, 4> e0{};
+      std::array<int, 4> e1{};
+      for (int c = 0; c < 4; ++c) {
+        q0[c] = std::clamp(static_cast<int>(std::lround((lo[c] - p0) / 2.0f)),
+                           0, 127);
+        q1[c] = std::clamp(static_cast<int>(std::lround((hi[c] - p1) / 2.0f)),
+                           0, 127);
+        e0[c] = (q0[c] << 1) | p0;
+        e1[c] = (q1[c] << 1) | p1;
+      }
+
+      std::array<std::array<int, 4>, 16> palette{};
+      for (int w = 0; w < 16; ++w) {
+        for (int c = 0; c < 4; ++c) {
+          palette[w][c] =
+              ((64 - kWeights[w]) * e0[c] + kWeights[w] * e1[c] + 32) >> 6;
+        }
+      }
+
+      std::array<int, 16> indices{};
+      long long error = 0;
+      for (int i = 0; i < 16; ++i) {
+        int best = 0;
+        int bestPixelError = std::numeric_limits<int>::max();
+        for (int w = 0; w < 16; ++w) {
+          int pixelError = 0;
+          for (int c = 0; c < 4; ++c) {
+            const int d = pixels[i * 4 + c] - palette[w][c];
+            pixelError += d * d;
+          }
+          if (pixelError < bestPixelError) {
+            bestPixelError = pixelError;
+            best = w;
+          }
+        }
+        indices[i] = best;
+        error += bestPixelError;
+      }
+
+      if (error < bestError) {
+        bestError = error;
+        bestQ0 = q0;
+        bestQ1 = q1;
+        bestP0 = p0;
+        bestP1 = p1;
+        bestIndices = indices;
+      }
+    }
+  }
+
+  // The anchor index (pixel 0) is stored with its MSB implied as zero.
+  if (bestIndices[0] >= 8) {
+    std::swap(bestQ0, bestQ1);
+    std::swap(bestP0, bestP1);
+    for (auto &index : bestIndices) {
+      index = 15 - index;
+    }
+  }
+
+  BlockBitWriter writer(out);
+  writer.Write(1u << 6, 7);
+  for (int c = 0; c < 4; ++c) {
+    writer.Write(static_cast<std::uint32_t>(bestQ0[c]), 7);
+    writer.Write(static_cast<std::uint32_t>(bestQ1[c]), 7);
+  }
+  writer.Write(static_cast<std::uint32_t>(bestP0), 1);
+  writer.Write(static_cast<std::uint32_t>(bestP1), 1);
+  writer.Write(static_cast<std::uint32_t>(bestIndices[0]), 3);
+  for (int i = 1; i < 16; ++i) {
+    writer.Write(static_cast<std::uint32_t>(bestIndices[i]), 4);
+  }
+}
+
+void CompressLevel(const std::vector<std::uint8_t> &rgba, std::uint32_t width,
+                   std::uint32_t height, TextureFormat format,
+                   std::vector<std::uint8_t> &out) {
+  const std::uint32_t blocksX = (width + 3) / 4;
+  const std::uint32_t blocksY = (height + 3) / 4;
+  const std::uint32_t blockBytes = GetBlockBytes(format);
+  const size_t base = out.size();
+  out.resize(base + static_cast<size_t>(blocksX) * blocksY * blockBytes);
+
+  std::array<std::uint8_t, 64> block{};
+  for (std::uint32_t by = 0; by < blocksY; ++by) {
+    for (std::uint32_t bx = 0; bx < blocksX; ++bx) {
+      // Edge blocks of small/odd mips replicate the last row/column.
+      for (std::uint32_t y = 0; y < 4; ++y) {
+        const std::uint32_t sy = std::min(by * 4 + y, height - 1);
+        for (std::uint32_t x = 0; x < 4; ++x) {
+          const std::uint32_t sx = std::min(bx * 4 + x, width - 1);
+          std::memcpy(&block[(y * 4 + x) * 4],
+                      &rgba[(static_cast<size_t>(sy) * width + sx) * 4], 4);
+        }
+      }
+
+      std::uint8_t *dst =
+          &out[base + (static_cast<size_t>(by) * blocksX + bx) * blockBytes];
+      switch (format) {
+      case TextureFormat::BC1:
+        EncodeBC1Block(block.data(), dst);
+        break;
+      case TextureFormat::BC3:
+        EncodeBC4Block(block.data(), 3, dst);
+        EncodeBC1Block(block.data(), dst + 8);
+        break;
+      case TextureFormat::BC5:
+        EncodeBC4Block(block.data(), 0, dst);
+        EncodeBC4Block(block.data(), 1, dst + 8);
+        break;
+      case TextureFormat::BC7:
+        EncodeBC7Block(block.data(), dst);
+        break;
+      case TextureFormat::RGBA8:
+        break;
+      }
+    }
+  }
+}
+
+// Index of the first level `range` keeps. The last level is always kept.
+std::uint32_t SelectFirstMip(const std::vector<CookedTexture::Mip> &mips,
+                             const TextureMipRange &range) {
+  if (mips.empty()) {
+    return 0;
+  }
+  const auto last = static_cast<std::uint32_t>(mips.size() - 1);
+  std::uint32_t first = std::min(range.firstMip, last);
+  if (range.maxSize != 0) {
+    while (first < last && std::max(mips[first].width, mips[first].height) >
+                               range.maxSize) {
+      ++first;
+    }
+  }
+  return first;
+}
+
+// Drops the levels above `range` from an in-memory chain.
+void TrimMips(CookedTexture &texture, const TextureMipRange &range) {
+  const std::uint32_t first = SelectFirstMip(texture.mips, range);
+  if (first == 0) {
+    return;
+  }
+  const std::uint64_t base = texture.mips[first].offset;
+  texture.mips.erase(texture.mips.begin(), texture.mips.begin() + first);
+  for (auto &mip : texture.mips) {
+    mip.offset -= base;
+  }
+  texture.data.erase(texture.data.begin(),
+                     texture.data.begin() + static_cast<std::ptrdiff_t>(base));
+  texture.baseMip += first;
+}
+
+// ---------------------------------------------------------------------------
+// DDS
+// ---------------------------------------------------------------------------
+
+std::uint32_t ReadU32(const std::uint8_t *p) {
+  return static_cast<std::uint32_t>(p[0]) |
+         (static_cast<std::uint32_t>(p[1]) << 8) |
+         (static_cast<std::uint32_t>(p[2]) << 16) |
+         (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+constexpr std::uint32_t FourCC(char a, char b, char c, char d) {
+  return static_cast<std::uint32_t>(static_cast<std::uint8_t>(a)) |
+         (static_cast<std::uint32_t>(static_cast<std::uint8_t>(b)) << 8) |
+         (static_cast<std::uint32_t>(static_cast<std::uint8_t>(c)) << 16) |
+         (static_cast<std::uint32_t>(static_cast<std::uint8_t>(d)) << 24);
+}
+
+bool LoadDds(const std::filesystem::path &source, bool srgb,
+             CookedTexture &out, std::string &error) {
+  std::ifstream input(source, std::ios::binary);
+  if (!input.is_open()) {
+    error = "cannot open file";
+    return false;
+  }
+  std::vector<std::uint8_t> file((std::istreambuf_iterator<char>(input)),
+                                 std::istreambuf_iterator<char>());
+  if (file.size() < 128 || ReadU32(file.data()) != FourCC('D', 'D', 'S', ' ')) {
+    error = "not a DDS file";
+    return false;
+  }
+
+  const std::uint8_t *header = file.data() + 4;
+  const std::uint32_t height = ReadU32(header + 8);
+  const std::uint32_t width = ReadU32(header + 12);
+  const std::uint32_t mipCount = std::max(1u, ReadU32(header + 24));
+  const std::uint32_t pfFlags = ReadU32(header + 76);
+  const std::uint32_t fourCC = ReadU32(header + 80);
+  const std::uint32_t bitCount = ReadU32(header + 84);
+  const std::uint32_t redMask = ReadU32(header + 88);
+  size_t offset = 128;
+
+  constexpr std::uint32_t kFourCCFlag = 0x4;
+  constexpr std::uint32_t kRgbFlag = 0x40;
+  bool swizzleBgra = false;
+  TextureFormat format{};
+  if ((pfFlags & kFourCCFlag) && fourCC == FourCC('D', 'X', '1', '0')) {
+    if (file.size() < 148) {
+      error = "truncated DX10 header";
+      return false;
+    }
+    // DXGI_FORMAT values for the formats we can sample.
+    switch (ReadU32(file.data() + 128)) {
+    case 28:
+      format = TextureFormat::RGBA8;
+      break;
+    case 29:
+      format = TextureFormat::RGBA8;
+      srgb = true;
+      break;
+    case 71:
+      format = TextureFormat::BC1;
+      break;
+    case 72:
+      format = TextureFormat::BC1;
+      srgb = true;
+      break;
+    case 77:
+      format = TextureFormat::BC3;
+      break;
+    case 78:
+      format = TextureFormat::BC3;
+      srgb = true;
+      break;
+    case 83:
+      format = TextureFormat::BC5;
+      break;
+    case 98:
+      format = TextureFormat::BC7;
+      break;
+    case 99:
+      format = TextureFormat::BC7;
+      srgb = true;
+      break;
+    default:
+      error = "unsupported DXGI format";
+      return false;
+    }
+    offset = 148;
+  } else if (pfFlags & kFourCCFlag) {
+    if (fourCC == FourCC('D', 'X', 'T', '1')) {
+      format = TextureFormat::BC1;
+    } else if (fourCC == FourCC('D', 'X', 'T', '5')) {
+      format = TextureFormat::BC3;
+    } else if (fourCC == FourCC('A', 'T', 'I', '2') ||
+               fourCC == FourCC('B', 'C', '5', 'U')) {
+      format = TextureFormat::BC5;
+    } else {
+      error = "unsupported FourCC";
+      return false;
+    }
+  } else if ((pfFlags & kRgbFlag) && bitCount == 32) {
+    format = TextureFormat::RGBA8;
+    swizzleBgra = redMask == 0x00FF0000u;
+  } else {
+    error = "unsupported pixel format";
+    return false;
+  }
+
+  if (width == 0 || height == 0) {
+    error = "invalid dimensions";
+    return false;
+  }
+
+  out = {};
+  out.format = format;
+  out.srgb = srgb && format != TextureFormat::BC5;
+  out.width = width;
+  out.height = height;
+  std::uint32_t w = width;
+  std::uint32_t h = height;
+  for (std::uint32_t level = 0; level < mipCount; ++level) {
+    const std::uint64_t size = GetMipLevelSize(format, w, h);
+    if (offset + size > file.size()) {
+      break;
+    }
+    CookedTexture::Mip mip{};
+    mip.width = w;
+    mip.height = h;
+    mip.offset = out.data.size();
+    mip.size = size;
+    out.data.insert(out.data.end(), file.begin() + offset,
+                    file.begin() + offset + size);
+    out.mips.push_back(mip);
+    offset += size;
+    if (w == 1 && h == 1) {
+      break;
+    }
+    w = std::max(1u, w / 2);
+    h = std::max(1u, h / 2);
+  }
+  if (out.mips.empty()) {
+    error = "truncated pixel data";
+    return false;
+  }
+  if (swizzleBgra) {
+    for (size_t i = 0; i + 3 < out.data.size(); i += 4) {
+      std::swap(out.data[i], out.data[i + 2]);
+    }
+  }
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// Cooked container
+// ---------------------------------------------------------------------------
+
+struct SourceStamp {
+  std::uint64_t size{0};
+  std::int64_t time{0};
+};
+
+bool GetSourceStamp(const std::filesystem::path &source, SourceStamp &out) {
+  std::error_code ec;
+  out.size = std::filesystem::file_size(source, ec);
+  if (ec) {
+    return false;
+  }
+  const auto time = std::filesystem::last_write_time(source, ec);
+  if (ec) {
+    return false;
+  }
+  out.time = static_cast<std::int64_t>(time.time_since_epoch().count());
+  return true;
+}
+
+template <typename T> void WritePod(std::ofstream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> bool ReadPod(std::ifstream &in, T &value) {
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+std::uint64_t HashPath(const std::string &text) {
+  std::uint64_t hash = 1469598103934665603ull;
+  for (unsigned char c : text) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+} // namespace
+
+namespace Aetherion::Assets {
+bool IsBlockCompressed(TextureFormat format) noexcept {
+  return format != TextureFormat::RGBA8;
+}
+
+std::uint32_t GetBlockBytes(TextureFormat format) noexcept {
+  switch (format) {
+  case TextureFormat::BC1:
+    return 8;
+  case TextureFormat::BC3:
+  case TextureFormat::BC5:
+  case TextureFormat::BC7:
+    return 16;
+  case TextureFormat::RGBA8:
+    break;
+  }
+  return 4;
+}
+
+std::uint64_t GetMipLevelSize(TextureFormat format, std::uint32_t width,
+                              std::uint32_t height) noexcept {
+  if (!IsBlockCompressed(format)) {
+    return static_cast<std::uint64_t>(width) * height * 4;
+  }
+  return static_cast<std::uint64_t>((width + 3) / 4) * ((height + 3) / 4) *
+         GetBlockBytes(format);
+}
+
+std::uint32_t GetMipLevelCount(std::uint32_t width,
+                               std::uint32_t height) noexcept {
+  std::uint32_t levels = 1;
+  while (width > 1 || height > 1) {
+    width = std::max(1u, width / 2);
+    height = std::max(1u, height / 2);
+    ++levels;
+  }
+  return levels;
+}
+
+bool CookTexture(const std::filesystem::path &source,
+                 const TextureCookSettings &settings, CookedTexture &out,
+                 std::string *outError) {
+  std::string error;
+  const std::string ext = Core::String::ToLower(source.extension().string());
+  if (ext == ".dds") {
+    if (!LoadDds(source, settings.srgb, out, error)) {
+      if (outError) {
+        *outError = error;
+      }
+      return false;
+    }
+    return true;
+  }
+
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  stbi_uc *pixels = stbi_load(source.string().c_str(), &width, &height,
+                              &channels, STBI_rgb_alpha);
+  if (!pixels || width <= 0 || height <= 0) {
+    if (outError) {
+      *outError =
+          stbi_failure_reason() ? stbi_failure_reason() : "decode failed";
+    }
+    if (pixels) {
+      stbi_image_free(pixels);
+    }
+    return false;
+  }
+
+  std::vector<std::uint8_t> level(
+      pixels, pixels + static_cast<size_t>(width) * height * 4);
+  stbi_image_free(pixels);
+
+  bool hasAlpha = false;
+  for (size_t i = 3; i < level.size(); i += 4) {
+    if (level[i] != 255) {
+      hasAlpha = true;
+      break;
+    }
+  }
+
+  out = {};
+  out.width = static_cast<std::uint32_t>(width);
+  out.height = static_cast<std::uint32_t>(height);
+  switch (settings.compression) {
+  case TextureCompression::None:
+    out.format = TextureFormat::RGBA8;
+    break;
+  case TextureCompression::Auto:
+    out.format = hasAlpha ? TextureFormat::BC3 : TextureFormat::BC1;
+    break;
+  case TextureCompression::BC5:
+    out.format = TextureFormat::BC5;
+    break;
+  case TextureCompression::BC7:
+    out.format = TextureFormat::BC7;
+    break;
+  }
+  out.srgb = settings.srgb && out.format != TextureFormat::BC5;
+
+  std::uint32_t w = out.width;
+  std::uint32_t h = out.height;
+  while (true) {
+    CookedTexture::Mip mip{};
+    mip.width = w;
+    mip.height = h;
+    mip.offset = out.data.size();
+    if (IsBlockCompressed(out.format)) {
+      CompressLevel(level, w, h, out.format, out.data);
+    } else {
+      out.data.insert(out.data.end(), level.begin(), level.end());
+    }
+    mip.size = out.data.size() - mip.offset;
+    out.mips.push_back(mip);
+
+    if (!settings.generateMips || (w == 1 && h == 1)) {
+      break;
+    }
+    level = DownsampleRgba(level, w, h, out.srgb);
+    w = std::max(1u, w / 2);
+    h = std::max(1u, h / 2);
+  }
+  return true;
+}
+
+std::filesystem::path
+GetCookedTexturePath(const std::filesystem::path &source,
+                     const std::filesystem::path &cacheDir,
+                     const TextureCookSettings &settings) {
+  std::error_code ec;
+  auto absolute = std::filesystem::absolute(source, ec);
+  if (ec) {
+    absolute = source;
+  }
+  // All BCn variants share one slot: a runtime asking for `Auto` picks up a
+  // BC7/BC5 container produced offline, since the header records the format.
+  const char *suffix =
+      settings.compression == TextureCompression::None ? "rgba" : "bc";
+
+  char hash[17] = {};
+  std::snprintf(hash, sizeof(hash), "%016llx",
+                static_cast<unsigned long long>(
+                    HashPath(absolute.lexically_normal().generic_string())));
+  std::string name = source.stem().string() + "_" + hash + "_" + suffix;
+  if (!settings.generateMips) {
+    name += "_nomip";
+  }
+  if (!settings.srgb) {
+    name += "_linear";
+  }
+  return cacheDir / "textures" / (name + ".atex");
+}
+
+bool WriteCookedTexture(const std::filesystem::path &path,
+                        const std::filesystem::path &source,
+                        const CookedTexture &texture) {
+  // A container always holds the full chain.
+  SourceStamp stamp{};
+  if (texture.baseMip != 0 || !GetSourceStamp(source, stamp)) {
+    return false;
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  const auto tmpPath = DerivedDataCache::MakeTempPath(path);
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      return false;
+    }
+    out.write(kCookedMagic, sizeof(kCookedMagic));
+    WritePod(out, kCookedVersion);
+    WritePod(out, static_cast<std::uint32_t>(texture.format));
+    WritePod(out, static_cast<std::uint32_t>(texture.srgb ? 1 : 0));
+    WritePod(out, texture.width);
+    WritePod(out, texture.height);
+    WritePod(out, static_cast<std::uint32_t>(texture.mips.size()));
+    WritePod(out, stamp.size);
+    WritePod(out, stamp.time);
+    for (const auto &mip : texture.mips) {
+      WritePod(out, mip.width);
+      WritePod(out, mip.height);
+      WritePod(out, mip.offset);
+      WritePod(out, mip.size);
+    }
+    WritePod(out, static_cast<std::uint64_t>(texture.data.size()));
+    out.write(reinterpret_cast<const char *>(texture.data.data()),
+              static_cast<std::streamsize>(texture.data.size()));
+    if (!out.good()) {
+      out.close();
+      std::filesystem::remove(tmpPath, ec);
+      return false;
+    }
+  }
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec) {
+    std::filesystem::remove(tmpPath, ec);
+    return false;
+  }
+  return true;
+}
+
+bool ReadCookedTexture(const std::filesystem::path &path,
+                       const std::filesystem::path &source,
+                       CookedTexture &out, const TextureMipRange &range) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) {
+    return false;
+  }
+
+  char magic[4] = {};
+  std::uint32_t version = 0;
+  std::uint32_t format = 0;
+  std::uint32_t srgb = 0;
+  std::uint32_t mipCount = 0;
+  SourceStamp stored{};
+  CookedTexture texture{};
+  if (!in.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kCookedMagic, sizeof(magic)) != 0 ||
+      !ReadPod(in, version) || version != kCookedVersion ||
+      !ReadPod(in, format) ||
+      format > static_cast<std::uint32_t>(TextureFormat::BC7) ||
+      !ReadPod(in, srgb) || !ReadPod(in, texture.width) ||
+      !ReadPod(in, texture.height) || !ReadPod(in, mipCount) ||
+      mipCount == 0 || mipCount > 32 || !ReadPod(in, stored.size) ||
+      !ReadPod(in, stored.time)) {
+    return false;
+  }
+
+  // Stale if the source was edited after cooking.
+  SourceStamp current{};
+  if (GetSourceStamp(source, current) &&
+      (current.size != stored.size || current.time != stored.time)) {
+    return false;
+  }
+
+  texture.format = static_cast<TextureFormat>(format);
+  texture.srgb = srgb != 0;
+  texture.mips.resize(mipCount);
+  for (auto &mip : texture.mips) {
+    if (!ReadPod(in, mip.width) || !ReadPod(in, mip.height) ||
+        !ReadPod(in, mip.offset) || !ReadPod(in, mip.size)) {
+      return false;
+    }
+  }
+  std::uint64_t dataSize = 0;
+  if (!ReadPod(in, dataSize)) {
+    return false;
+  }
+  for (const auto &mip : texture.mips) {
+    if (mip.offset + mip.size > dataSize ||
+        mip.size != GetMipLevelSize(texture.format, mip.width, mip.height)) {
+      return false;
+    }
+  }
+
+  // Levels are stored largest first, so skipping the top of the chain is a
+  // single seek past their payload.
+  const std::uint32_t first = SelectFirstMip(texture.mips, range);
+  const std::uint64_t base = texture.mips[first].offset;
+  texture.mips.erase(texture.mips.begin(), texture.mips.begin() + first);
+  for (auto &mip : texture.mips) {
+    if (mip.offset < base) {
+      return false;
+    }
+    mip.offset -= base;
+  }
+  texture.baseMip = first;
+  texture.data.resize(static_cast<size_t>(dataSize - base));
+  if (!in.seekg(static_cast<std::streamoff>(base), std::ios::cur) ||
+      !in.read(reinterpret_cast<char *>(texture.data.data()),
+               static_cast<std::streamsize>(texture.data.size()))) {
+    return false;
+  }
+
+  out = std::move(texture);
+  return true;
+}
+
+bool LoadOrCookTexture(const std::filesystem::path &source,
+                       const std::filesystem::path &cacheDir,
+                       const TextureCookSettings &settings, CookedTexture &out,
+                       std::string *outError, const TextureMipRange &range) {
+  // DDS files are already in a GPU format; reading them directly is as cheap
+  // as reading a cooked copy.
+  const std::string ext = Core::String::ToLower(source.extension().string());
+  if (cacheDir.empty() || ext == ".dds") {
+    if (!CookTexture(source, settings, out, outError)) {
+      return false;
+    }
+    TrimMips(out, range);
+    return true;
+  }
+
+  const auto cookedPath = GetCookedTexturePath(source, cacheDir, settings);
+  if (ReadCookedTexture(cookedPath, source, out, range)) {
+    return true;
+  }
+  if (!CookTexture(source, settings, out, outError)) {
+    return false;
+  }
+  // A failed write only costs a re-cook next time.
+  WriteCookedTexture(cookedPath, source, out);
+  TrimMips(out, range);
+  return true;
+}
+
+bool GetCookedTextureKey(const std::filesystem::path &source,
+                         DerivedDataCache &cache,
+                         const TextureCookSettings &settings,
+                         DerivedDataCache::Key &out) {
+  std::uint64_t contentHash = 0;
+  if (!cache.HashSource(source, contentHash)) {
+    return false;
+  }
+  const std::uint64_t words[4] = {
+      kCookerVersion,
+      settings.compression == TextureCompression::None ? 0u : 1u,
+      settings.generateMips ? 1u : 0u, settings.srgb ? 1u : 0u};
+  out = DerivedDataCache::MakeKey(
+      kCookedTextureKind, contentHash,
+      DerivedDataCache::HashBytes(words, sizeof(words)));
+  return true;
+}
+
+bool LoadOrCookTexture(const std::filesystem::path &source,
+                       DerivedDataCache &cache,
+                       const TextureCookSettings &settings, CookedTexture &out,
+                       std::string *outError, const TextureMipRange &range) {
+  const std::string ext = Core::String::ToLower(source.extension().string());
+  DerivedDataCache::Key key{};
+  if (ext == ".dds" || !cache.IsOpen() ||
+      !GetCookedTextureKey(source, cache, settings, key)) {
+    return LoadOrCookTexture(source, std::filesystem::path(), settings, out,
+                             outError, range);
+  }
+
+  std::filesystem::path cookedPath;
+  if (cache.Find(key, cookedPath)) {
+    if (ReadCookedTexture(cookedPath, std::filesystem::path(), out, range)) {
+      return true;
+    }
+    // Truncated, or written by an older container version.
+    cache.Remove(key);
+  }
+  if (!CookTexture(source, settings, out, outError)) {
+    return false;
+  }
+  if (WriteCookedTexture(cache.GetEntryPath(key), source, out)) {
+    cache.Commit(key);
+  }
+  TrimMips(out, range);
+  return true;
+}
+} // namespace Aetherion::Assets
@@ -0,0 +1,315 @@
+#include "Aetherion/Assets/VirtualFileSystem.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <system_error>
+#include <utility>
+
+namespace Aetherion::Assets {
+namespace {
+// '/'-separated, without "." segments or leading and trailing separators.
+// False for paths that climb out of the tree.
+bool NormalizeVirtualPath(const std::filesystem::path &path, std::string &out) {
+  out = path.lexically_normal().generic_string();
+  while (!out.empty() && out.front() == '/') {
+    out.erase(out.begin());
+  }
+  while (!out.empty() && out.back() == '/') {
+    out.pop_back();
+  }
+  if (out == ".") {
+    out.clear();
+  }
+  return out != ".." && out.rfind("../", 0) != 0;
+}
+
+// Absolute and normalized, without a trailing separator.
+std::filesystem::path MakeDiskPath(const std::filesystem::path &path) {
+  std::error_code ec;
+  std::filesystem::path result =
+      std::filesystem::absolute(path, ec).lexically_normal();
+  if (ec) {
+    result = path.lexically_normal();
+  }
+  if (!result.has_filename() && result.has_relative_path()) {
+    result = result.parent_path();
+  }
+  return result;
+}
+
+// The part of `path` below `mountPoint`, or false if it is outside of it.
+bool StripMountPoint(std::string_view path, std::string_view mountPoint,
+                     std::string_view &rest) {
+  if (mountPoint.empty()) {
+    rest = path;
+    return true;
+  }
+  if (path.size() < mountPoint.size() ||
+      path.compare(0, mountPoint.size(), mountPoint) != 0) {
+    return false;
+  }
+  if (path.size() == mountPoint.size()) {
+    rest = {};
+    return true;
+  }
+  if (path[mountPoint.size()] != '/') {
+    return false;
+  }
+  rest = path.substr(mountPoint.size() + 1);
+  return true;
+}
+
+bool IsRegularFile(const std::filesystem::path &path) {
+  std::error_code ec;
+  return std::filesystem::is_regular_file(path, ec);
+}
+} // namespace
+
+VirtualFileSystem::MountId
+VirtualFileSystem::MountDirectory(const std::filesystem::path &directory,
+                                  std::string_view mountPoint, int priority) {
+  std::error_code ec;
+  if (!std::filesystem::is_directory(directory, ec)) {
+    return 0;
+  }
+  Mount mount;
+  if (!NormalizeVirtualPath(std::filesystem::path(mountPoint),
+                            mount.mountPoint)) {
+    return 0;
+  }
+  mount.priority = priority;
+  mount.directory = MakeDiskPath(directory);
+  return AddMount(std::move(mount));
+}
+
+VirtualFileSystem::MountId
+VirtualFileSystem::MountArchive(const std::filesystem::path &archive,
+                                std::string_view mountPoint, int priority) {
+  Mount mount;
+  if (!NormalizeVirtualPath(std::filesystem::path(mountPoint),
+                            mount.mountPoint)) {
+    return 0;
+  }
+  auto opened = std::make_shared<PakArchive>();
+  if (!opened->Open(archive)) {
+    return 0;
+  }
+  mount.priority = priority;
+  mount.archive = std::move(opened);
+  return AddMount(std::move(mount));
+}
+
+VirtualFileSystem::MountId VirtualFileSystem::AddMount(Mount mount) {
+  std::unique_lock lock(m_mutex);
+  mount.id = m_nextMountId++;
+  // Ahead of every mount with the same or a lower priority.
+  const auto position = std::find_if(
+      m_mounts.begin(), m_mounts.end(), [&mount](const Mount &existing) {
+        return existing.priority <= mount.priority;
+      });
+  const MountId id = mount.id;
+  m_mounts.insert(position, std::move(mount));
+  return id;
+}
+
+bool VirtualFileSystem::Unmount(MountId id) {
+  std::unique_lock lock(m_mutex);
+  const auto it =
+      std::find_if(m_mounts.begin(), m_mounts.end(),
+                   [id](const Mount &mount) { return mount.id == id; });
+  if (it == m_mounts.end()) {
+    return false;
+  }
+  m_mounts.erase(it);
+  return true;
+}
+
+void VirtualFileSystem::UnmountAll() {
+  std::unique_lock lock(m_mutex);
+  m_mounts.clear();
+}
+
+bool VirtualFileSystem::GetVirtualPath(const std::filesystem::path &path,
+                                       std::string &outVirtualPath) const {
+  std::shared_lock lock(m_mutex);
+  return GetVirtualPathLocked(path, outVirtualPath);
+}
+
+bool VirtualFileSystem::GetVirtualPathLocked(const std::filesystem::path &path,
+                                             std::string &out) const {
+  const std::filesystem::path diskPath = MakeDiskPath(path);
+  for (const Mount &mount : m_mounts) {
+    if (mount.directory.empty()) {
+      continue;
+    }
+    const std::filesystem::path relative =
+        diskPath.lexically_relative(mount.directory);
+    std::string relativePath;
+    if (relative.empty() || !NormalizeVirtualPath(relative, relativePath)) {
+      continue;
+    }
+    if (mount.mountPoint.empty() || relativePath.empty()) {
+      out = mount.mountPoint.empty() ? relativePath : mount.mountPoint;
+    } else {
+      out = mount.mountPoint + "/" + relativePath;
+    }
+    return true;
+  }
+  return false;
+}
+
+bool VirtualFileSystem::Resolve(const std::filesystem::path &path,
+                                Location &out) const {
+  out = Location{};
+  std::shared_lock lock(m_mutex);
+
+  std::string virtualPath;
+  const bool isVirtual = path.is_absolute()
+                             ? GetVirtualPathLocked(path, virtualPath)
+                             : NormalizeVirtualPath(path, virtualPath);
+  if (isVirtual && !virtualPath.empty()) {
+    for (const Mount &mount : m_mounts) {
+      std::string_view rest;
+      if (!StripMountPoint(virtualPath, mount.mountPoint, rest) ||
+          rest.empty()) {
+        continue;
+      }
+      if (mount.archive) {
+        if (const PakEntry *entry = mount.archive->FindByPath(rest)) {
+          out.archive = mount.archive;
+          out.entry = entry;
+          return true;
+        }
+      } else if (std::filesystem::path candidate = mount.directory / rest;
+                 IsRegularFile(candidate)) {
+        out.diskPath = std::move(candidate);
+        return true;
+      }
+    }
+  }
+
+  if (IsRegularFile(path)) {
+    out.diskPath = path;
+    return true;
+  }
+  return false;
+}
+
+bool VirtualFileSystem::Exists(const std::filesystem::path &path) const {
+  Location location;
+  return Resolve(path, location);
+}
+
+bool VirtualFileSystem::OpenFile(const std::filesystem::path &path,
+                                 FileView &out) const {
+  out = FileView{};
+  Location location;
+  if (!Resolve(path, location)) {
+    return false;
+  }
+
+  if (location.entry) {
+    if (location.entry->compression == PakCompression::None) {
+      out.m_data = location.archive->GetStoredData(*location.entry);
+      out.m_archive = std::move(location.archive);
+      return true;
+    }
+    if (!location.archive->Read(*location.entry, out.m_buffer)) {
+      return false;
+    }
+    out.m_data = out.m_buffer;
+    return true;
+  }
+
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(location.diskPath, ec);
+  if (ec) {
+    return false;
+  }
+  if (size == 0) {
+    // Nothing to map; an empty view.
+    return true;
+  }
+  if (!out.m_mapping.Open(location.diskPath)) {
+    return false;
+  }
+  out.m_data = {out.m_mapping.GetData(), out.m_mapping.GetSize()};
+  return true;
+}
+
+bool VirtualFileSystem::ReadFile(const std::filesystem::path &path,
+                                 std::vector<std::uint8_t> &out) const {
+  FileView view;
+  if (!OpenFile(path, view)) {
+    return false;
+  }
+  if (!view.m_buffer.empty()) {
+    out = std::move(view.m_buffer);
+    return true;
+  }
+  out.assign(view.m_data.begin(), view.m_data.end());
+  return true;
+}
+
+bool VirtualFileSystem::ReadText(const std::filesystem::path &path,
+                                 std::string &out) const {
+  FileView view;
+  if (!OpenFile(path, view)) {
+    return false;
+  }
+  out.assign(view.GetText());
+  return true;
+}
+
+bool VirtualFileSystem::FindArchivedAsset(std::string_view id,
+                                          std::string &outVirtualPath) const {
+  std::shared_lock lock(m_mutex);
+  for (const Mount &mount : m_mounts) {
+    if (!mount.archive) {
+      continue;
+    }
+    if (const PakEntry *entry = mount.archive->FindById(id)) {
+      outVirtualPath = mount.mountPoint.empty()
+                           ? std::string(entry->path)
+                           : mount.mountPoint + "/" + std::string(entry->path);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<VirtualFileSystem::ArchiveFile>
+VirtualFileSystem::ListArchiveFiles() const {
+  std::shared_lock lock(m_mutex);
+  // Keyed by virtual path; mounts are in lookup order, so the first archive
+  // to serve a path is the one a lookup picks.
+  std::map<std::string, ArchiveFile, std::less<>> files;
+  for (const Mount &mount : m_mounts) {
+    if (!mount.archive) {
+      continue;
+    }
+    for (const PakEntry &entry : mount.archive->GetEntries()) {
+      std::string path = mount.mountPoint.empty()
+                             ? std::string(entry.path)
+                             : mount.mountPoint + "/" + std::string(entry.path);
+      if (files.find(path) != files.end()) {
+        continue;
+      }
+      ArchiveFile file;
+      file.path = path;
+      file.id = std::string(entry.id);
+      file.size = entry.size;
+      file.hash = entry.hash;
+      files.emplace(std::move(path), std::move(file));
+    }
+  }
+
+  std::vector<ArchiveFile> result;
+  result.reserve(files.size());
+  for (auto &[path, file] : files) {
+    result.push_back(std::move(file));
+  }
+  return result;
+}
+} // namespace Aetherion::Assets
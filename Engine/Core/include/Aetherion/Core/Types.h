@@ -43,7 +43,8 @@ struct EnginePaths {
   std::filesystem::path content;
   std::filesystem::path cache;
 
-  // TODO: Integrate path resolution and virtual file systems.
+  // Content is read through the Assets::VirtualFileSystem held by the
+  // EngineContext, which mounts `content` and the archives inside it.
 };
 
 enum class LogLevel { Info, Warning, Error, Debug };
@@ -5,9 +5,9 @@ namespace Aetherion::Core
 {
     std::string GenerateUUID()
     {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<int> dist(0, 15);
+        // Per thread: asset scans create sidecars (and ids) from several threads at once.
+        thread_local std::mt19937 gen(std::random_device{}());
+        thread_local std::uniform_int_distribution<int> dist(0, 15);
         const char* digits = "0123456789abcdef";
 
         std::string guid;
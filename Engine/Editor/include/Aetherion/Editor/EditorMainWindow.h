@@ -21,8 +21,14 @@ class QActionGroup;
 class QLabel;
 class QDockWidget;
 
+namespace Aetherion::Assets
+{
+class AssetWatcher;
+} // namespace Aetherion::Assets
+
 namespace Aetherion::Rendering
 {
+class RenderThread;
 class VulkanViewport;
 } // namespace Aetherion::Rendering
 
@@ -109,15 +115,18 @@ private:
     std::unordered_map<Core::EntityId, TransformData> m_playSessionSnapshot;
 
     std::unique_ptr<Rendering::VulkanViewport> m_vulkanViewport;
+    // Owns m_vulkanViewport once started; other access goes through its command queue or a pause.
+    std::unique_ptr<Rendering::RenderThread> m_renderThread;
     WId m_surfaceHandle{0};
     QSize m_surfaceSize{};
     bool m_surfaceInitialized{false};
     class QTimer* m_renderTimer = nullptr;
     class QTimer* m_assetWatchTimer = nullptr;
+    std::unique_ptr<Assets::AssetWatcher> m_assetWatcher;
     QElapsedTimer m_frameTimer;
     QLabel* m_fpsLabel = nullptr;
     QElapsedTimer m_fpsTimer;
-    int m_fpsFrameCounter{0};
+    uint64_t m_fpsFramesAtStart{0};
     QAction* m_validationMenuAction = nullptr;
     QAction* m_loggingMenuAction = nullptr;
     QAction* m_showHierarchyAction = nullptr;
@@ -202,6 +211,8 @@ private:
     bool LoadSceneFromPath(const std::filesystem::path& path);
     void RecreateRuntimeAndRenderer(bool enableValidation);
     void DestroyViewportRenderer();
+    void StartViewportRenderThread();
+    [[nodiscard]] bool IsViewportRendering() const;
     void AttachVulkanLogSink();
     void DetachVulkanLogSink();
     void LoadLayout();
@@ -2,6 +2,7 @@
 
 #include <QObject>
 #include <memory>
+#include <vector>
 
 #include "Aetherion/Core/Types.h"
 
@@ -24,9 +25,14 @@ public:
     void SetActiveScene(std::shared_ptr<Scene::Scene> scene);
     void SelectEntityById(Core::EntityId id);
     void SelectEntity(std::shared_ptr<Scene::Entity> entity);
+    // Multi-selection (e.g. marquee). The first entity that still exists becomes the primary
+    // selection returned by GetSelectedEntity(); ids missing from the scene are dropped.
+    void SelectEntitiesById(const std::vector<Core::EntityId>& ids);
     void Clear();
 
     [[nodiscard]] std::shared_ptr<Scene::Entity> GetSelectedEntity() const noexcept;
+    // Primary entity first.
+    [[nodiscard]] const std::vector<Core::EntityId>& GetSelectedEntityIds() const noexcept;
 
 signals:
     void SelectionChanged(Aetherion::Core::EntityId id);
@@ -35,5 +41,6 @@ signals:
 private:
     std::shared_ptr<Scene::Scene> m_scene;
     std::shared_ptr<Scene::Entity> m_selectedEntity;
+    std::vector<Core::EntityId> m_selectedIds;
 };
 } // namespace Aetherion::Editor
@@ -319,7 +319,7 @@ void EditorInspectorPanel::RebuildUi() {
         }
 
         if (registry && entry->type == Assets::AssetRegistry::AssetType::Mesh) {
-          const auto *meshData = registry->LoadMeshData(entry->id);
+          const auto meshData = registry->LoadMeshData(entry->id);
           if (meshData) {
             form->addRow(tr("Geometry"), new QLabel(tr("Loaded"), formHost));
             addMeshStatsRows(form, formHost, *meshData);
@@ -385,9 +385,13 @@ void EditorInspectorPanel::RebuildUi() {
           importFlipWinding->setChecked(importSettings.flipWinding);
           auto *importOptimize = new QCheckBox(formHost);
           importOptimize->setChecked(importSettings.optimize);
+          auto *importCompress = new QCheckBox(formHost);
+          importCompress->setChecked(importSettings.compressVertices);
 
           importCenter->setToolTip(tr("Recenters the mesh to its bounds"));
           importOptimize->setToolTip(tr("Compacts unused vertices"));
+          importCompress->setToolTip(
+              tr("Uploads quantized vertices and 16-bit indices when possible"));
           importFlipWinding->setToolTip(
               tr("Reverses triangle winding for backface culling"));
 
@@ -398,10 +402,12 @@ void EditorInspectorPanel::RebuildUi() {
           form->addRow(tr("Flip UVs"), importFlipUvs);
           form->addRow(tr("Flip Winding"), importFlipWinding);
           form->addRow(tr("Optimize"), importOptimize);
+          form->addRow(tr("Compress Vertices"), importCompress);
 
           auto applyImportSettings =
               [this, meshId, importScale, importNormals, importTangents,
-               importFlipUvs, importFlipWinding, importOptimize, importCenter]() {
+               importFlipUvs, importFlipWinding, importOptimize, importCompress,
+               importCenter]() {
                 if (!m_assetRegistry) {
                   return;
                 }
@@ -414,6 +420,7 @@ void EditorInspectorPanel::RebuildUi() {
                 settings.flipUVs = importFlipUvs->isChecked();
                 settings.flipWinding = importFlipWinding->isChecked();
                 settings.optimize = importOptimize->isChecked();
+                settings.compressVertices = importCompress->isChecked();
 
                 m_assetRegistry->SetMeshImportSettings(meshId, settings);
               };
@@ -434,6 +441,8 @@ void EditorInspectorPanel::RebuildUi() {
                   [applyImportSettings](bool) { applyImportSettings(); });
           connect(importOptimize, &QCheckBox::toggled, this,
                   [applyImportSettings](bool) { applyImportSettings(); });
+          connect(importCompress, &QCheckBox::toggled, this,
+                  [applyImportSettings](bool) { applyImportSettings(); });
 
           auto *reimportButton = new QPushButton(tr("Reimport"), formHost);
           form->addRow(reimportButton);
@@ -874,7 +883,7 @@ void EditorInspectorPanel::RebuildUi() {
         return;
       }
 
-      const auto *meshData = m_assetRegistry->LoadMeshData(meshId);
+      const auto meshData = m_assetRegistry->LoadMeshData(meshId);
       if (!meshData) {
         setAll(tr("Not loaded"));
         return;
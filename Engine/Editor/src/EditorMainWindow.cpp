@@ -25,8 +25,10 @@
 #include <QVBoxLayout>
 #include <QKeyEvent>
 #include <QKeySequence>
+#include <QScreen>
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
@@ -44,7 +46,10 @@
 #include "Aetherion/Editor/EditorSettingsDialog.h"
 #include "Aetherion/Editor/EditorViewport.h"
 #include "Aetherion/Assets/AssetRegistry.h"
+#include "Aetherion/Assets/AssetWatcher.h"
 #include "Aetherion/Rendering/RenderView.h"
+#include "Aetherion/Rendering/GpuResourceCache.h"
+#include "Aetherion/Rendering/RenderThread.h"
 #include "Aetherion/Rendering/VulkanContext.h"
 #include "Aetherion/Rendering/VulkanViewport.h"
 #include "Aetherion/Runtime/EngineApplication.h"
@@ -475,21 +480,23 @@ EditorMainWindow::EditorMainWindow(std::shared_ptr<Runtime::EngineApplication> r
     centerSplit->addWidget(m_viewport);
 
     m_renderTimer = new QTimer(this);
+    m_renderTimer->setTimerType(Qt::PreciseTimer);
     m_renderTimer->setInterval(m_targetFrameIntervalMs);
     connect(m_renderTimer, &QTimer::timeout, this, [this] {
-        const bool viewportReady = m_vulkanViewport && m_vulkanViewport->IsReady();
-        UpdateRenderTimerInterval(viewportReady);
+        const bool viewportReady = IsViewportRendering();
         if (m_runtimeApp)
         {
             m_runtimeApp->Tick();
         }
+        // After the tick, so the timer is armed for the frame deadline it just scheduled.
+        UpdateRenderTimerInterval(viewportReady);
         if (!viewportReady)
         {
             if (m_fpsLabel)
             {
                 m_fpsLabel->setText(tr("FPS: --"));
             }
-            m_fpsFrameCounter = 0;
+            m_fpsFramesAtStart = 0;
             m_fpsTimer.invalidate();
             return;
         }
@@ -499,11 +506,20 @@ EditorMainWindow::EditorMainWindow(std::shared_ptr<Runtime::EngineApplication> r
             {
                 m_fpsLabel->setText(tr("FPS: --"));
             }
-            m_fpsFrameCounter = 0;
+            m_fpsFramesAtStart = 0;
             m_fpsTimer.invalidate();
             return;
         }
 
+        if (auto error = m_renderThread->TakeError())
+        {
+            AppendConsole(m_console, QString::fromStdString(*error), ConsoleSeverity::Error);
+            fprintf(stderr, "Render failed: %s\n", error->c_str());
+            m_renderTimer->stop();
+            statusBar()->showMessage(tr("Renderer error: %1").arg(QString::fromStdString(*error)));
+            return;
+        }
+
         const qint64 nanos = m_frameTimer.isValid() ? m_frameTimer.nsecsElapsed() : 0;
         const float dt = static_cast<float>(nanos) / 1'000'000'000.0f;
         m_frameTimer.restart();
@@ -518,71 +534,77 @@ EditorMainWindow::EditorMainWindow(std::shared_ptr<Runtime::EngineApplication> r
         const bool useSceneCamera = m_modePlaytestAction && m_modePlaytestAction->isChecked();
         auto ctx = m_runtimeApp ? m_runtimeApp->GetContext() : nullptr;
         auto renderView = ctx ? ctx->GetRenderView() : nullptr;
-        Rendering::RenderView emptyView{};
-        Rendering::RenderView viewCopy{};
-        const Rendering::RenderView* activeView = &emptyView;
+
+        // The render thread draws the newest published snapshot whenever it is free, so UI work
+        // and slow frames no longer wait on each other.
+        Rendering::RenderView& snapshot = m_renderThread->BeginSnapshot();
         if (renderView)
         {
-            viewCopy = *renderView;
-            viewCopy.selectedEntityId =
+            snapshot = *renderView;
+            snapshot.selectedEntityId =
                 (m_selection && m_selection->GetSelectedEntity()) ? m_selection->GetSelectedEntity()->GetId()
                                                                   : 0;
-            viewCopy.showEditorIcons = !useSceneCamera;
+            snapshot.showEditorIcons = !useSceneCamera;
             if (!useSceneCamera)
             {
-                viewCopy.camera.enabled = false;
+                snapshot.camera.enabled = false;
             }
-            activeView = &viewCopy;
-        }
-        try
-        {
-            m_vulkanViewport->RenderFrame(dt, *activeView);
         }
-        catch (const std::exception& ex)
+        else
         {
-            AppendConsole(m_console, QString::fromStdString(ex.what()), ConsoleSeverity::Error);
-            fprintf(stderr, "Render failed: %s\n", ex.what());
-            m_renderTimer->stop();
-            statusBar()->showMessage(tr("Renderer error: %1").arg(QString::fromStdString(ex.what())));
-            return;
+            snapshot = Rendering::RenderView{};
         }
+        m_renderThread->PublishSnapshot();
 
-        if (m_vulkanViewport)
-        {
-            const auto pick = m_vulkanViewport->GetLastPickResult();
-            if (pick.valid)
+        m_renderThread->Post([this](Rendering::VulkanViewport& viewport) {
+            const auto pick = viewport.GetLastPickResult();
+            if (!pick.valid)
             {
-                if (m_selection)
+                return;
+            }
+            viewport.ClearPickResult();
+            QMetaObject::invokeMethod(this, [this, entityId = pick.entityId] {
+                if (!m_selection)
                 {
-                    if (pick.entityId != 0)
-                    {
-                        m_selection->SelectEntityById(pick.entityId);
-                    }
-                    else
-                    {
-                        m_selection->Clear();
-                    }
+                    return;
                 }
-                m_vulkanViewport->ClearPickResult();
-            }
-        }
+                if (entityId != 0)
+                {
+                    m_selection->SelectEntityById(entityId);
+                }
+                else
+                {
+                    m_selection->Clear();
+                }
+            }, Qt::QueuedConnection);
+        });
 
         if (m_fpsLabel)
         {
+            const uint64_t framesRendered = m_renderThread->GetStats().framesRendered;
             if (!m_fpsTimer.isValid())
             {
                 m_fpsTimer.start();
-                m_fpsFrameCounter = 0;
+                m_fpsFramesAtStart = framesRendered;
             }
 
-            ++m_fpsFrameCounter;
             const qint64 elapsedMs = m_fpsTimer.elapsed();
             if (elapsedMs >= 1000)
             {
-                const double fps = (elapsedMs > 0) ? (static_cast<double>(m_fpsFrameCounter) * 1000.0 / static_cast<double>(elapsedMs))
-                                                   : 0.0;
-                m_fpsLabel->setText(tr("FPS: %1").arg(QString::number(fps, 'f', 1)));
-                m_fpsFrameCounter = 0;
+                const double fps = static_cast<double>(framesRendered - m_fpsFramesAtStart) * 1000.0 /
+                                   static_cast<double>(elapsedMs);
+                QString text = tr("FPS: %1").arg(QString::number(fps, 'f', 1));
+                if (m_runtimeApp)
+                {
+                    const auto stats = m_runtimeApp->GetFramePacer().GetStats();
+                    text += tr(" | p95 %1 ms").arg(QString::number(stats.frameMs.p95, 'f', 1));
+                    if (stats.latencySamples > 0)
+                    {
+                        text += tr(" | latency p95 %1 ms").arg(QString::number(stats.latencyMs.p95, 'f', 1));
+                    }
+                }
+                m_fpsLabel->setText(text);
+                m_fpsFramesAtStart = framesRendered;
                 m_fpsTimer.restart();
             }
         }
@@ -608,6 +630,23 @@ EditorMainWindow::EditorMainWindow(std::shared_ptr<Runtime::EngineApplication> r
             m_vulkanViewport = std::make_unique<Rendering::VulkanViewport>(vk, registry);
             m_vulkanViewport->SetLoggingEnabled(m_renderLoggingEnabled);
             m_vulkanViewport->Initialize(reinterpret_cast<void*>(nativeHandle), width, height);
+
+            // Keep the editor interactive on slow GPUs: trade scene resolution for a ~60 fps GPU budget.
+            Rendering::VulkanViewport::DynamicResolutionSettings dynamicResolution;
+            dynamicResolution.enabled = true;
+            dynamicResolution.targetGpuMs = 14.0;
+            dynamicResolution.minScale = 0.5f;
+            m_vulkanViewport->SetDynamicResolution(dynamicResolution);
+
+            // Allow two refreshes from input to display: FIFO on double-buffered swapchains,
+            // MAILBOX when more images would queue up.
+            Rendering::VulkanViewport::PresentSettings present;
+            if (const QScreen* window = screen())
+            {
+                present.refreshRateHz = std::max(1.0, static_cast<double>(window->refreshRate()));
+            }
+            present.latencyTargetMs = 2.0 * 1000.0 / present.refreshRateHz;
+            m_vulkanViewport->SetPresentSettings(present);
             
             // Sync camera from viewport widget
             if (m_viewport)
@@ -631,9 +670,10 @@ EditorMainWindow::EditorMainWindow(std::shared_ptr<Runtime::EngineApplication> r
 
         if (m_vulkanViewport->IsReady())
         {
+            StartViewportRenderThread();
             m_frameTimer.start();
             m_renderTimer->start();
-            m_fpsFrameCounter = 0;
+            m_fpsFramesAtStart = 0;
             m_fpsTimer.start();
             statusBar()->showMessage(tr("Viewport Vulkan renderer active"));
 
@@ -665,17 +705,21 @@ EditorMainWindow::EditorMainWindow(std::shared_ptr<Runtime::EngineApplication> r
 
     connect(m_viewport, &EditorViewport::surfaceResized, this, [this](int width, int height) {
         m_surfaceSize = QSize(width, height);
-        if (m_vulkanViewport && m_vulkanViewport->IsReady())
+        if (IsViewportRendering())
         {
-            try
-            {
-                m_vulkanViewport->Resize(width, height);
-            }
-            catch (const std::exception& ex)
-            {
-                AppendConsole(m_console, QString::fromStdString(ex.what()), ConsoleSeverity::Error);
-                statusBar()->showMessage(tr("Viewport resize failed: %1").arg(QString::fromStdString(ex.what())));
-            }
+            m_renderThread->Post([this, width, height](Rendering::VulkanViewport& viewport) {
+                try
+                {
+                    viewport.Resize(width, height);
+                }
+                catch (const std::exception& ex)
+                {
+                    QMetaObject::invokeMethod(this, [this, message = QString::fromStdString(ex.what())] {
+                        AppendConsole(m_console, message, ConsoleSeverity::Error);
+                        statusBar()->showMessage(tr("Viewport resize failed: %1").arg(message));
+                    }, Qt::QueuedConnection);
+                }
+            });
         }
 
         if (m_auxPanel)
@@ -686,16 +730,19 @@ EditorMainWindow::EditorMainWindow(std::shared_ptr<Runtime::EngineApplication> r
 
     // Connect camera changes from viewport to renderer
     connect(m_viewport, &EditorViewport::cameraChanged, this, [this]() {
-        if (m_vulkanViewport)
+        if (m_renderThread && m_viewport)
         {
-            m_vulkanViewport->SetCameraPosition(
-                m_viewport->getCameraX(),
-                m_viewport->getCameraY(),
-                m_viewport->getCameraZ());
-            m_vulkanViewport->SetCameraRotation(
-                m_viewport->getCameraRotationY(),
-                m_viewport->getCameraRotationX());
-            m_vulkanViewport->SetCameraZoom(m_viewport->getCameraZoom());
+            const float x = m_viewport->getCameraX();
+            const float y = m_viewport->getCameraY();
+            const float z = m_viewport->getCameraZ();
+            const float yaw = m_viewport->getCameraRotationY();
+            const float pitch = m_viewport->getCameraRotationX();
+            const float zoom = m_viewport->getCameraZoom();
+            m_renderThread->Post([=](Rendering::VulkanViewport& viewport) {
+                viewport.SetCameraPosition(x, y, z);
+                viewport.SetCameraRotation(yaw, pitch);
+                viewport.SetCameraZoom(zoom);
+            });
         }
 
         if (m_auxPanel && m_viewport)
@@ -884,8 +931,10 @@ EditorMainWindow::EditorMainWindow(std::shared_ptr<Runtime::EngineApplication> r
         }
     }
 
+    // Draining the watcher is cheap; the registry only does work once a burst of file events has
+    // settled.
     m_assetWatchTimer = new QTimer(this);
-    m_assetWatchTimer->setInterval(500);
+    m_assetWatchTimer->setInterval(100);
     connect(m_assetWatchTimer, &QTimer::timeout, this, &EditorMainWindow::PollAssetChanges);
     m_assetWatchTimer->start();
 
@@ -1298,9 +1347,9 @@ void EditorMainWindow::CreateMenuBarContent()
         {
             m_viewport->resetCamera();
         }
-        if (m_vulkanViewport)
+        if (m_renderThread)
         {
-            m_vulkanViewport->ResetCamera();
+            m_renderThread->Post([](Rendering::VulkanViewport& viewport) { viewport.ResetCamera(); });
         }
         statusBar()->showMessage(tr("Camera reset"), 2000);
     });
@@ -1445,12 +1494,14 @@ void EditorMainWindow::ApplySettings(const EditorSettings& settings, bool persis
     {
         RecreateRuntimeAndRenderer(m_validationEnabled);
     }
-    else if (m_vulkanViewport)
+    else if (m_renderThread)
     {
-        m_vulkanViewport->SetLoggingEnabled(m_renderLoggingEnabled);
+        m_renderThread->Post([enabled = m_renderLoggingEnabled](Rendering::VulkanViewport& viewport) {
+            viewport.SetLoggingEnabled(enabled);
+        });
     }
 
-    UpdateRenderTimerInterval(m_vulkanViewport && m_vulkanViewport->IsReady());
+    UpdateRenderTimerInterval(IsViewportRendering());
 }
 
 void EditorMainWindow::UpdateRenderTimerInterval(bool viewportReady)
@@ -1461,7 +1512,20 @@ void EditorMainWindow::UpdateRenderTimerInterval(bool viewportReady)
     }
 
     const bool headless = !viewportReady || !m_surfaceInitialized || isMinimized();
-    const int desiredInterval = (headless && m_headlessSleepMs > 0) ? m_headlessSleepMs : m_targetFrameIntervalMs;
+    int desiredInterval = (headless && m_headlessSleepMs > 0) ? m_headlessSleepMs : m_targetFrameIntervalMs;
+    if (m_runtimeApp)
+    {
+        auto& pacer = m_runtimeApp->GetFramePacer();
+        pacer.SetTargetFrameRate(static_cast<double>(m_settings.targetFps));
+        if (!headless && m_renderTimer->isActive())
+        {
+            // Fire on the pacer's deadline instead of a full interval from now, so tick and
+            // render time are not added to every frame.
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(pacer.TimeUntilNextFrame());
+            m_renderTimer->start(static_cast<int>(remaining.count()));
+            return;
+        }
+    }
     if (desiredInterval > 0 && m_renderTimer->interval() != desiredInterval)
     {
         m_renderTimer->setInterval(desiredInterval);
@@ -1585,6 +1649,8 @@ void EditorMainWindow::RescanAssets()
     {
         root = std::filesystem::path("assets");
     }
+    // Scanning replaces the entries the render thread reads.
+    const auto renderPause = m_renderThread ? m_renderThread->Pause() : Rendering::RenderThread::PauseScope{};
     registry->Scan(root.string());
     RefreshAssetBrowser();
     m_assetChangeSerial = registry->GetChangeSerial();
@@ -1592,7 +1658,12 @@ void EditorMainWindow::RescanAssets()
     {
         m_inspectorPanel->SetAssetRegistry(registry);
     }
-    statusBar()->showMessage(tr("Assets rescanned"), 2000);
+    const auto& scan = registry->GetLastScanStats();
+    statusBar()->showMessage(tr("Assets rescanned in %1 ms (%2 of %3 sidecars read)")
+                                 .arg(scan.milliseconds, 0, 'f', 1)
+                                 .arg(scan.sidecarsParsed)
+                                 .arg(scan.files),
+                             3000);
 }
 
 void EditorMainWindow::PollAssetChanges()
@@ -1604,7 +1675,39 @@ void EditorMainWindow::PollAssetChanges()
         return;
     }
 
-    registry->Rescan();
+    const std::filesystem::path& root = registry->GetRootPath();
+    if (root.empty())
+    {
+        return;
+    }
+    if (!m_assetWatcher || m_assetWatcher->GetRoot() != root)
+    {
+        m_assetWatcher = std::make_unique<Assets::AssetWatcher>();
+        if (!m_assetWatcher->Start(root))
+        {
+            m_assetWatcher.reset();
+            return;
+        }
+        AppendConsole(m_console, tr("Watching assets with %1").arg(QString::fromUtf8(m_assetWatcher->GetBackendName())), ConsoleSeverity::Info);
+    }
+
+    const Assets::AssetWatcher::Batch batch = m_assetWatcher->Poll();
+    if (batch.IsEmpty())
+    {
+        return;
+    }
+
+    // Updating replaces registry entries the render thread reads; keep it parked until its
+    // viewport has dropped the stale references below.
+    const auto renderPause = m_renderThread ? m_renderThread->Pause() : Rendering::RenderThread::PauseScope{};
+    if (batch.rescanRequired)
+    {
+        registry->Rescan();
+    }
+    else
+    {
+        registry->ApplyFileChanges(batch.paths);
+    }
 
     std::vector<Assets::AssetRegistry::AssetChange> changes;
     registry->GetChangesSince(m_assetChangeSerial, changes);
@@ -1656,6 +1759,15 @@ void EditorMainWindow::PollAssetChanges()
         m_inspectorPanel->SetSelectedAsset(m_selectedAssetId);
     }
 
+    // GPU copies are shared by every viewport, so invalidate them once here; the viewports
+    // below only drop their own references (the camera preview re-resolves lazily).
+    if (auto vk = ctx->GetVulkanContext())
+    {
+        if (auto cache = vk->GetResourceCache())
+        {
+            cache->HandleAssetChanges(changes);
+        }
+    }
     if (m_vulkanViewport)
     {
         m_vulkanViewport->HandleAssetChanges(changes);
@@ -1732,6 +1844,8 @@ void EditorMainWindow::ImportGltfAsset()
         }
     }
 
+    // Importing and rescanning change registry entries the render thread reads.
+    const auto renderPause = m_renderThread ? m_renderThread->Pause() : Rendering::RenderThread::PauseScope{};
     const auto result = registry->ImportGltf(importPath.string());
     if (!result.success)
     {
@@ -2742,9 +2856,10 @@ void EditorMainWindow::RecreateRuntimeAndRenderer(bool enableValidation)
                 
                 if (m_vulkanViewport->IsReady())
                 {
+                    StartViewportRenderThread();
                     m_frameTimer.restart();
                     m_renderTimer->start();
-                    m_fpsFrameCounter = 0;
+                    m_fpsFramesAtStart = 0;
                     m_fpsTimer.start();
                 }
             }
@@ -2756,7 +2871,7 @@ void EditorMainWindow::RecreateRuntimeAndRenderer(bool enableValidation)
         }
     }
 
-    UpdateRenderTimerInterval(m_vulkanViewport && m_vulkanViewport->IsReady());
+    UpdateRenderTimerInterval(IsViewportRendering());
     statusBar()->showMessage(tr("Renderer reset (%1 validation, %2 logging)")
                                  .arg(m_validationEnabled ? tr("with") : tr("without"))
                                  .arg(m_renderLoggingEnabled ? tr("verbose") : tr("minimal")));
@@ -2769,6 +2884,8 @@ void EditorMainWindow::DestroyViewportRenderer()
         m_renderTimer->stop();
     }
 
+    // Stop rendering before the viewport goes away; anything still queued runs first.
+    m_renderThread.reset();
     if (m_vulkanViewport)
     {
         m_vulkanViewport->Shutdown();
@@ -2777,7 +2894,31 @@ void EditorMainWindow::DestroyViewportRenderer()
 
     m_frameTimer.invalidate();
     m_fpsTimer.invalidate();
-    m_fpsFrameCounter = 0;
+    m_fpsFramesAtStart = 0;
+}
+
+void EditorMainWindow::StartViewportRenderThread()
+{
+    if (!m_vulkanViewport)
+    {
+        return;
+    }
+
+    m_renderThread = std::make_unique<Rendering::RenderThread>(*m_vulkanViewport);
+    m_renderThread->SetFrameCallback([this](Rendering::RenderThread::Clock::time_point presentedAt) {
+        QMetaObject::invokeMethod(this, [this, presentedAt] {
+            if (m_runtimeApp)
+            {
+                m_runtimeApp->GetFramePacer().MarkPresented(presentedAt);
+            }
+        }, Qt::QueuedConnection);
+    });
+    m_renderThread->Start();
+}
+
+bool EditorMainWindow::IsViewportRendering() const
+{
+    return m_renderThread && m_renderThread->IsRunning();
 }
 
 void EditorMainWindow::AttachVulkanLogSink()
@@ -2790,8 +2931,11 @@ void EditorMainWindow::AttachVulkanLogSink()
     }
 
     vk->SetLoggingEnabled(m_renderLoggingEnabled);
+    // The render thread logs too; the console is only touched on the UI thread.
     vk->SetLogCallback([this](Rendering::LogSeverity severity, const std::string& message) {
-        AppendConsole(m_console, QString::fromStdString(message), ToConsoleSeverity(severity));
+        QMetaObject::invokeMethod(this, [this, severity, text = QString::fromStdString(message)] {
+            AppendConsole(m_console, text, ToConsoleSeverity(severity));
+        }, Qt::AutoConnection);
     });
 }
 
@@ -3280,6 +3424,18 @@ bool EditorMainWindow::eventFilter(QObject* watched, QEvent* event)
 {
     if (watched == m_viewport || (m_viewport && watched == m_viewport->surfaceWidget()))
     {
+        if (m_runtimeApp)
+        {
+            const QEvent::Type type = event->type();
+            const bool dragging = type == QEvent::MouseMove &&
+                                  static_cast<QMouseEvent*>(event)->buttons() != Qt::NoButton;
+            if (dragging || type == QEvent::MouseButtonPress || type == QEvent::MouseButtonRelease ||
+                type == QEvent::Wheel || type == QEvent::KeyPress || type == QEvent::KeyRelease)
+            {
+                m_runtimeApp->GetFramePacer().MarkInput();
+            }
+        }
+
         if (event->type() == QEvent::MouseButtonPress)
         {
             QMouseEvent* me = static_cast<QMouseEvent*>(event);
@@ -3349,20 +3505,64 @@ bool EditorMainWindow::eventFilter(QObject* watched, QEvent* event)
         {
             if (static_cast<QMouseEvent*>(event)->button() == Qt::LeftButton)
             {
-                if (m_requestPickOnRelease && m_vulkanViewport && m_vulkanViewport->IsReady())
+                if (m_requestPickOnRelease && IsViewportRendering())
                 {
                     QMouseEvent* me = static_cast<QMouseEvent*>(event);
                     const int dx = std::abs(me->x() - m_dragStartMouseX);
                     const int dy = std::abs(me->y() - m_dragStartMouseY);
+                    auto toSurface = [&](QPoint pos) {
+                        if (m_viewport && m_viewport->surfaceWidget() && watched == m_viewport)
+                        {
+                            pos = m_viewport->surfaceWidget()->mapFrom(m_viewport, pos);
+                        }
+                        return QPoint(std::max(0, pos.x()), std::max(0, pos.y()));
+                    };
                     if (dx <= 3 && dy <= 3)
                     {
-                        QPoint pickPos = me->pos();
-                        if (m_viewport && m_viewport->surfaceWidget() && watched == m_viewport)
+                        // Answered on the CPU from the last frame, so the selection updates without
+                        // waiting for a GPU readback; the render thread owns that frame's picker.
+                        const QPoint pickPos = toSurface(me->pos());
+                        const auto x = static_cast<uint32_t>(pickPos.x());
+                        const auto y = static_cast<uint32_t>(pickPos.y());
+                        const auto pick = m_renderThread
+                                              ->Invoke([x, y](Rendering::VulkanViewport& viewport) {
+                                                  return viewport.PickCpu(x, y);
+                                              })
+                                              .get();
+                        if (pick.valid && m_selection)
                         {
-                            pickPos = m_viewport->surfaceWidget()->mapFrom(m_viewport, pickPos);
+                            if (pick.entityId != 0)
+                            {
+                                m_selection->SelectEntityById(pick.entityId);
+                            }
+                            else
+                            {
+                                m_selection->Clear();
+                            }
                         }
-                        m_vulkanViewport->RequestPick(static_cast<uint32_t>(pickPos.x()),
-                                                      static_cast<uint32_t>(pickPos.y()));
+                    }
+                    else if (m_selection && (m_gizmoMode == GizmoMode::Translate || !m_selection->GetSelectedEntity()))
+                    {
+                        // Marquee selection; Shift adds to the current selection. Rotate/scale drags
+                        // with a selection belong to the gizmo.
+                        const QPoint start = toSurface(QPoint(m_dragStartMouseX, m_dragStartMouseY));
+                        const QPoint end = toSurface(me->pos());
+                        std::vector<Core::EntityId> ids;
+                        if (me->modifiers() & Qt::ShiftModifier)
+                        {
+                            ids = m_selection->GetSelectedEntityIds();
+                        }
+                        const auto hits = m_renderThread
+                                              ->Invoke([start, end](Rendering::VulkanViewport& viewport) {
+                                                  return viewport.PickRectCpu(
+                                                      static_cast<uint32_t>(start.x()), static_cast<uint32_t>(start.y()),
+                                                      static_cast<uint32_t>(end.x()), static_cast<uint32_t>(end.y()));
+                                              })
+                                              .get();
+                        ids.insert(ids.end(), hits.begin(), hits.end());
+                        m_selection->SelectEntitiesById(ids);
+                        statusBar()->showMessage(tr("%1 entities selected").arg(static_cast<int>(m_selection->GetSelectedEntityIds().size())),
+                                                 1500);
                     }
                 }
                 m_requestPickOnRelease = false;
@@ -3679,7 +3879,7 @@ void EditorMainWindow::FocusCameraOnSelection()
     auto mesh = entity->GetComponent<Scene::MeshRendererComponent>();
     if (mesh && registry && !mesh->GetMeshAssetId().empty() && m_scene)
     {
-        if (const auto* meshData = registry->LoadMeshData(mesh->GetMeshAssetId()))
+        if (const auto meshData = registry->LoadMeshData(mesh->GetMeshAssetId()))
         {
             const auto world = GetWorldMatrix(*m_scene, entity->GetId());
             const auto worldCenter = TransformPoint(world, meshData->boundsCenter);
@@ -3695,9 +3895,11 @@ void EditorMainWindow::FocusCameraOnSelection()
     {
         m_viewport->SetCameraTarget(targetX, targetY, targetZ);
     }
-    if (m_vulkanViewport)
+    if (m_renderThread)
     {
-        m_vulkanViewport->FocusOnBounds(targetX, targetY, targetZ, radius);
+        m_renderThread->Post([=](Rendering::VulkanViewport& viewport) {
+            viewport.FocusOnBounds(targetX, targetY, targetZ, radius);
+        });
     }
 
     statusBar()->showMessage(tr("Focused on '%1'").arg(QString::fromStdString(entity->GetName())), 2000);
@@ -280,8 +280,6 @@ void EditorMeshPreview::onRenderFrame()
             instance.albedoTextureId = cached->textureIds.front();
         }
     }
-    instance.transform = nullptr;
-    instance.mesh = nullptr;
     // Identity matrix
     instance.model[0] = 1.0f; instance.model[5] = 1.0f; 
     instance.model[10] = 1.0f; instance.model[15] = 1.0f;
@@ -360,7 +358,7 @@ void EditorMeshPreview::ApplyAutoFit()
         return;
     }
 
-    const auto* meshData = m_assetRegistry->LoadMeshData(m_currentAssetId.toStdString());
+    const auto meshData = m_assetRegistry->LoadMeshData(m_currentAssetId.toStdString());
     if (!meshData)
     {
         return;
@@ -1,5 +1,6 @@
 #include "Aetherion/Editor/EditorSelection.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "Aetherion/Scene/Entity.h"
@@ -20,7 +21,11 @@ void EditorSelection::SetActiveScene(std::shared_ptr<Scene::Scene> scene)
         if (!m_scene->FindEntityById(m_selectedEntity->GetId()))
         {
             Clear();
+            return;
         }
+        m_selectedIds.erase(std::remove_if(m_selectedIds.begin(), m_selectedIds.end(),
+                                           [this](Core::EntityId id) { return !m_scene->FindEntityById(id); }),
+                            m_selectedIds.end());
     }
 }
 
@@ -38,14 +43,16 @@ void EditorSelection::SelectEntityById(Core::EntityId id)
 
 void EditorSelection::SelectEntity(std::shared_ptr<Scene::Entity> entity)
 {
-    if (m_selectedEntity == entity)
+    if (m_selectedEntity == entity && m_selectedIds.size() <= 1)
     {
         return;
     }
 
     m_selectedEntity = std::move(entity);
+    m_selectedIds.clear();
     if (m_selectedEntity)
     {
+        m_selectedIds.push_back(m_selectedEntity->GetId());
         emit SelectionChanged(m_selectedEntity->GetId());
     }
     else
@@ -54,12 +61,54 @@ void EditorSelection::SelectEntity(std::shared_ptr<Scene::Entity> entity)
     }
 }
 
+void EditorSelection::SelectEntitiesById(const std::vector<Core::EntityId>& ids)
+{
+    std::vector<Core::EntityId> resolved;
+    std::shared_ptr<Scene::Entity> primary;
+    if (m_scene)
+    {
+        resolved.reserve(ids.size());
+        for (const Core::EntityId id : ids)
+        {
+            if (std::find(resolved.begin(), resolved.end(), id) != resolved.end())
+            {
+                continue;
+            }
+            auto entity = m_scene->FindEntityById(id);
+            if (!entity)
+            {
+                continue;
+            }
+            if (!primary)
+            {
+                primary = std::move(entity);
+            }
+            resolved.push_back(id);
+        }
+    }
+
+    if (!primary)
+    {
+        Clear();
+        return;
+    }
+    if (m_selectedEntity == primary && m_selectedIds == resolved)
+    {
+        return;
+    }
+
+    m_selectedEntity = std::move(primary);
+    m_selectedIds = std::move(resolved);
+    emit SelectionChanged(m_selectedEntity->GetId());
+}
+
 void EditorSelection::Clear()
 {
     if (m_selectedEntity)
     {
         m_selectedEntity.reset();
     }
+    m_selectedIds.clear();
     emit SelectionCleared();
 }
 
@@ -67,4 +116,9 @@ std::shared_ptr<Scene::Entity> EditorSelection::GetSelectedEntity() const noexce
 {
     return m_selectedEntity;
 }
+
+const std::vector<Core::EntityId>& EditorSelection::GetSelectedEntityIds() const noexcept
+{
+    return m_selectedIds;
+}
 } // namespace Aetherion::Editor
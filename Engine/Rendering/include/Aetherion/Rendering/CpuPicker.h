@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Aetherion/Assets/AssetRegistry.h"
+#include "Aetherion/Core/Types.h"
+
+namespace Aetherion::Rendering {
+// CPU-side picking over a snapshot of draw instances. A BVH over the
+// world-space bounds of every instance narrows rays and selection rectangles
+// down to a few candidates, which are then refined against the mesh triangles
+// so picks match what was drawn. Answers are immediate, unlike the GPU picking
+// pass whose result arrives a few frames later.
+class CpuPicker {
+public:
+  struct Instance {
+    Core::EntityId entityId{0};
+    // Column-major mesh-to-world transform, as drawn.
+    float model[16]{};
+    // Mesh-space bounds; used as the pick shape when the mesh has no
+    // triangles in memory.
+    std::array<float, 3> boundsMin{-0.5f, -0.5f, -0.5f};
+    std::array<float, 3> boundsMax{0.5f, 0.5f, 0.5f};
+    // Looked up in the registry only when a query reaches the instance, and
+    // held just while its triangles are tested, so the picker never pins
+    // meshes the budget could evict. Meshes that are not loaded at that point
+    // are picked by their bounds.
+    std::string meshId;
+  };
+
+  struct Hit {
+    Core::EntityId entityId{0};
+    // Distance along the normalized ray direction.
+    float distance{0.0f};
+    bool valid{false};
+  };
+
+  void Build(std::vector<Instance> instances,
+             std::shared_ptr<const Assets::AssetRegistry> registry = nullptr);
+  void Clear();
+  [[nodiscard]] bool IsEmpty() const noexcept { return m_instances.empty(); }
+
+  // Closest instance whose triangles the ray hits. Triangles are two-sided.
+  [[nodiscard]] Hit Raycast(const float origin[3],
+                            const float direction[3]) const;
+  // Ray through a point given in normalized device coordinates of `viewProj`
+  // (depth 0..1), starting at the near plane.
+  [[nodiscard]] Hit RaycastNdc(const float viewProj[16], float ndcX,
+                               float ndcY) const;
+
+  // Every instance with geometry inside the rectangle [minX, maxX] x
+  // [minY, maxY] in normalized device coordinates of `viewProj` and in front
+  // of the camera. Each entity is reported once, in instance order.
+  [[nodiscard]] std::vector<Core::EntityId>
+  SelectRect(const float viewProj[16], float minX, float minY, float maxX,
+             float maxY) const;
+
+private:
+  struct Node {
+    float boundsMin[3];
+    float boundsMax[3];
+    // Leaves reference [first, first + count) of m_order; inner nodes have
+    // count == 0 and their children at `first` and `first + 1`.
+    uint32_t first{0};
+    uint32_t count{0};
+  };
+
+  struct Entry {
+    Instance instance;
+    float inverseModel[16];
+    float worldMin[3];
+    float worldMax[3];
+  };
+
+  void BuildNode(uint32_t node, uint32_t begin, uint32_t end);
+  [[nodiscard]] bool RefineRay(const Entry &entry, const float origin[3],
+                               const float direction[3], float &t) const;
+  [[nodiscard]] bool RefineRect(const Entry &entry,
+                                const float planes[6][4]) const;
+
+  [[nodiscard]] Assets::AssetRegistry::MeshDataHandle
+  FindMesh(const Entry &entry) const;
+
+  std::shared_ptr<const Assets::AssetRegistry> m_registry;
+  std::vector<Entry> m_instances;
+  std::vector<uint32_t> m_order;
+  std::vector<Node> m_nodes;
+};
+} // namespace Aetherion::Rendering
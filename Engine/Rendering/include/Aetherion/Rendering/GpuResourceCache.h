@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "Aetherion/Assets/AssetRegistry.h"
+
+namespace Aetherion::Rendering {
+struct GpuMesh {
+  VkBuffer vertexBuffer{VK_NULL_HANDLE};
+  VkDeviceMemory vertexMemory{VK_NULL_HANDLE};
+  VkBuffer indexBuffer{VK_NULL_HANDLE};
+  VkDeviceMemory indexMemory{VK_NULL_HANDLE};
+  // Positions only (float3, or the packed UNORM16x4), for the depth pre-pass
+  // and shadow passes, which would otherwise fetch whole vertices.
+  VkBuffer positionBuffer{VK_NULL_HANDLE};
+  VkDeviceMemory positionMemory{VK_NULL_HANDLE};
+  uint32_t indexCount{0};
+  VkIndexType indexType{VK_INDEX_TYPE_UINT32};
+  // Packed meshes store positions normalized to their bounds; `dequantize`
+  // maps them back to mesh space and is folded into the model matrix.
+  bool packed{false};
+  float dequantize[16]{};
+};
+
+// Sampled image without any descriptor state. Descriptor sets stay with the
+// viewport that binds them, since each viewport owns its set layout and pools.
+// `width`/`height` describe level 0 of the full chain; a streamed texture only
+// holds levels `baseMip` and below, so the image itself may be smaller.
+struct GpuTextureImage {
+  VkImage image{VK_NULL_HANDLE};
+  VkDeviceMemory memory{VK_NULL_HANDLE};
+  VkImageView view{VK_NULL_HANDLE};
+  uint32_t width{0};
+  uint32_t height{0};
+  uint32_t mipLevels{1};
+  uint32_t baseMip{0};
+};
+
+// Device-wide mesh/texture residency shared by every VulkanViewport on one
+// VulkanContext. Each viewport holds at most one reference per asset id;
+// resources are retired when the last reference is released or when the
+// asset changes on disk. Retired resources are destroyed once all work
+// submitted to the graphics queue before the retirement has completed, so a
+// viewport never has to know what other viewports still have in flight.
+class GpuResourceCache {
+public:
+  struct MeshHandle {
+    uint32_t slot{UINT32_MAX};
+    uint32_t generation{0};
+    [[nodiscard]] bool IsValid() const noexcept { return slot != UINT32_MAX; }
+  };
+
+  struct TextureHandle {
+    uint32_t slot{UINT32_MAX};
+    uint32_t generation{0};
+    [[nodiscard]] bool IsValid() const noexcept { return slot != UINT32_MAX; }
+  };
+
+  struct Stats {
+    uint32_t meshes{0};
+    uint32_t textures{0};
+    uint32_t references{0};
+    uint32_t pendingRetirements{0};
+  };
+
+  // Texture streaming keeps only the mips that are visible resident. Viewports
+  // report the finest level each texture needs; the cache turns that into
+  // upgrade/demote work bounded by a VRAM budget and a per-frame upload limit.
+  struct TextureStreamingSettings {
+    bool enabled{true};
+    VkDeviceSize budgetBytes{256ull << 20};
+    VkDeviceSize uploadBytesPerFrame{8ull << 20};
+    // Textures start with their top level clamped to this size and are never
+    // demoted below it.
+    uint32_t residentFloorSize{64};
+    // Requests older than this many frames no longer pin a level; the
+    // texture becomes a demotion candidate under budget pressure.
+    uint32_t idleFrames{120};
+  };
+
+  struct TextureStreamingStats {
+    VkDeviceSize residentBytes{0};
+    VkDeviceSize budgetBytes{0};
+    // Bytes the current requests would need if the budget were unlimited.
+    VkDeviceSize requestedBytes{0};
+    uint32_t textures{0};
+    uint32_t fullyResident{0};
+    uint32_t pendingUpgrades{0};
+    uint32_t uploadsLastFrame{0};
+    VkDeviceSize uploadedBytesLastFrame{0};
+    uint64_t totalUploads{0};
+    VkDeviceSize totalUploadedBytes{0};
+    // Textures whose top mips were dropped to get back under budget.
+    uint64_t evictions{0};
+  };
+
+  // One re-upload of `assetId` with levels [targetMip, end) resident. The
+  // viewport that took the work rebuilds the image and hands it back through
+  // ReplaceTexture() before its next TakeStreamingWork() call.
+  struct StreamingWork {
+    std::string assetId;
+    uint32_t targetMip{0};
+  };
+
+  GpuResourceCache() = default;
+  ~GpuResourceCache();
+
+  GpuResourceCache(const GpuResourceCache &) = delete;
+  GpuResourceCache &operator=(const GpuResourceCache &) = delete;
+
+  // `queueMutex` guards `queue` against submissions from other threads.
+  void Initialize(VkDevice device, VkQueue queue, std::mutex *queueMutex);
+  // Destroys every resource immediately; the caller must have idled the
+  // device. Outstanding handles become stale rather than dangling.
+  void Shutdown();
+
+  // Adds a reference to an already resident asset. Returns an invalid handle
+  // when the asset has not been uploaded yet.
+  [[nodiscard]] MeshHandle AcquireMesh(const std::string &assetId);
+  [[nodiscard]] TextureHandle AcquireTexture(const std::string &assetId);
+
+  // Takes ownership of freshly uploaded resources and returns the first
+  // reference. If another viewport won the race the new copy is retired and
+  // the resident one is shared instead.
+  [[nodiscard]] MeshHandle InsertMesh(const std::string &assetId,
+                                      const GpuMesh &mesh);
+  // `levelBytes` lists the size of every level of the full chain and enables
+  // streaming for the texture; leave it empty for fixed-residency textures.
+  [[nodiscard]] TextureHandle
+  InsertTexture(const std::string &assetId, const GpuTextureImage &texture,
+                std::vector<VkDeviceSize> levelBytes = {});
+
+  // Returns nullptr for stale handles (asset invalidated or cache shut down).
+  // Pointers stay valid until the next invalidation or release.
+  [[nodiscard]] const GpuMesh *GetMesh(MeshHandle handle) const;
+  [[nodiscard]] const GpuTextureImage *GetTexture(TextureHandle handle) const;
+
+  void ReleaseMesh(MeshHandle handle);
+  void ReleaseTexture(TextureHandle handle);
+
+  // Applies registry changes once for every viewport sharing this cache.
+  // Handles to invalidated assets go stale and are re-resolved lazily.
+  void HandleAssetChanges(
+      const std::vector<Assets::AssetRegistry::AssetChange> &changes);
+
+  // Destroys retired resources whose guarding fence has signaled. Called by
+  // each viewport once per frame; cheap when nothing is pending.
+  void CollectGarbage();
+
+  [[nodiscard]] Stats GetStats() const;
+
+  void SetTextureStreamingSettings(const TextureStreamingSettings &settings);
+  [[nodiscard]] TextureStreamingSettings GetTextureStreamingSettings() const;
+  [[nodiscard]] TextureStreamingStats GetTextureStreamingStats() const;
+
+  // Marks the texture as used this frame and asks for `mip` (a level of the
+  // full chain) to be resident. Multiple requests in a frame keep the finest.
+  void RequestTextureMip(TextureHandle handle, uint32_t mip);
+
+  // Plans this frame's streaming: drops the unneeded top mips of the least
+  // recently used textures while the budget is exceeded and returns that work
+  // plus the upgrades that fit the budget and the per-frame upload limit.
+  [[nodiscard]] std::vector<StreamingWork> TakeStreamingWork();
+
+  // Swaps in a re-uploaded image for a resident texture. Handles stay valid;
+  // GetTexture() returns the new image and the old one is retired.
+  void ReplaceTexture(const std::string &assetId,
+                      const GpuTextureImage &texture);
+
+private:
+  template <typename Resource> struct Slot {
+    std::string assetId;
+    Resource resource{};
+    uint32_t generation{1};
+    uint32_t refCount{0};
+    bool live{false};
+  };
+
+  template <typename Resource> struct Table {
+    std::deque<Slot<Resource>> slots;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<std::string, uint32_t> byAssetId;
+  };
+
+  // Requests are folded over two short windows so that viewports rendering
+  // on alternate frames do not overwrite each other's demand.
+  struct TextureStream {
+    std::vector<VkDeviceSize> levelBytes;
+    uint32_t floorMip{0};
+    uint32_t requestedMip{UINT32_MAX};
+    uint32_t previousRequestedMip{UINT32_MAX};
+    uint64_t windowStart{0};
+    uint64_t lastUsedFrame{0};
+  };
+
+  struct RetireBatch {
+    VkFence fence{VK_NULL_HANDLE};
+    std::vector<std::function<void()>> callbacks;
+  };
+
+  template <typename Resource>
+  uint32_t Acquire(Table<Resource> &table, const std::string &assetId);
+  template <typename Resource>
+  uint32_t Insert(Table<Resource> &table, const std::string &assetId,
+                  const Resource &resource);
+  template <typename Resource>
+  const Resource *Get(const Table<Resource> &table, uint32_t slot,
+                      uint32_t generation) const;
+  template <typename Resource>
+  void Release(Table<Resource> &table, uint32_t slot, uint32_t generation);
+  template <typename Resource>
+  void Invalidate(Table<Resource> &table, const std::string &assetId);
+  template <typename Resource>
+  void Evict(Table<Resource> &table, uint32_t slot);
+
+  [[nodiscard]] uint32_t FloorMip(const GpuTextureImage &texture,
+                                  uint32_t levelCount) const;
+  [[nodiscard]] uint32_t WantedMip(const TextureStream &stream) const;
+  [[nodiscard]] static VkDeviceSize
+  ResidentBytes(const TextureStream &stream, uint32_t baseMip);
+
+  void Retire(const GpuMesh &mesh);
+  void Retire(const GpuTextureImage &texture);
+  void Destroy(const GpuMesh &mesh) const;
+  void Destroy(const GpuTextureImage &texture) const;
+
+  mutable std::mutex m_mutex;
+  VkDevice m_device{VK_NULL_HANDLE};
+  VkQueue m_queue{VK_NULL_HANDLE};
+  std::mutex *m_queueMutex{nullptr};
+  Table<GpuMesh> m_meshes;
+  Table<GpuTextureImage> m_textures;
+  std::vector<std::function<void()>> m_pendingRetirements;
+  std::vector<RetireBatch> m_retireBatches;
+
+  // Keyed by texture slot; only streamed textures have an entry.
+  std::unordered_map<uint32_t, TextureStream> m_textureStreams;
+  TextureStreamingSettings m_streamingSettings;
+  TextureStreamingStats m_streamingStats;
+  // Advances once per CollectGarbage(), i.e. once per viewport frame.
+  uint64_t m_frame{0};
+};
+} // namespace Aetherion::Rendering
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace Aetherion::Rendering {
+// How a pass touches an image. Each access implies the layout the image has to
+// be in and the stage/access masks the graph uses to build barriers.
+enum class RenderGraphAccess : uint32_t {
+  ColorAttachment,
+  DepthAttachment,
+  FragmentSampled,
+  TransferSrc,
+  TransferDst,
+};
+
+// Small frame graph for one command buffer. Passes declare the images they
+// read and write; the graph owns transient images, derives layout transitions
+// and barriers between passes, culls passes whose output nobody consumes and
+// emits per-pass CPU/GPU timings.
+//
+// Passes run in declaration order, so producers have to be added before their
+// consumers. Transient images whose lifetimes (first to last declared use) do
+// not overlap share one memory allocation. Lifetimes are planned once at
+// Compile() over every declared pass; enabling, disabling and culling passes
+// per frame only shortens them, so the aliasing plan stays valid.
+class RenderGraph {
+public:
+  using ResourceId = uint32_t;
+  using PassId = uint32_t;
+  static constexpr ResourceId kInvalidResource = UINT32_MAX;
+
+  struct ImageDesc {
+    std::string name;
+    VkFormat format{VK_FORMAT_UNDEFINED};
+    VkExtent2D extent{0, 0};
+    VkImageUsageFlags usage{0};
+    VkImageAspectFlags aspect{VK_IMAGE_ASPECT_COLOR_BIT};
+  };
+
+  // Image owned outside the graph, e.g. a swapchain image. The handle and its
+  // current layout are supplied every frame through SetImportedImage().
+  struct ImportDesc {
+    std::string name;
+    VkImageAspectFlags aspect{VK_IMAGE_ASPECT_COLOR_BIT};
+    // Stage the first access has to wait for; for a swapchain image this is
+    // the stage the acquire semaphore is waited on.
+    VkPipelineStageFlags initialStage{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
+    // Layout the image is left in after the last pass. UNDEFINED keeps
+    // whatever layout the last access needed.
+    VkImageLayout finalLayout{VK_IMAGE_LAYOUT_UNDEFINED};
+  };
+
+  class PassBuilder {
+  public:
+    void Read(ResourceId resource, RenderGraphAccess access);
+    void Write(ResourceId resource, RenderGraphAccess access);
+    // Writes on top of what earlier passes left, e.g. a depth attachment
+    // loaded rather than cleared; keeps those passes alive.
+    void ReadWrite(ResourceId resource, RenderGraphAccess access);
+    // Keeps the pass even when nothing in the graph reads its output, e.g.
+    // copies to host-visible buffers.
+    void SetSideEffects();
+
+  private:
+    friend class RenderGraph;
+    PassBuilder(RenderGraph &graph, PassId pass)
+        : m_graph(graph), m_pass(pass) {}
+
+    RenderGraph &m_graph;
+    PassId m_pass;
+  };
+
+  struct Stats {
+    uint32_t passes{0};
+    uint32_t executedPasses{0};
+    uint32_t transientImages{0};
+    uint32_t memoryBlocks{0};
+    // Transient memory actually allocated, and what it would take without
+    // aliasing.
+    VkDeviceSize transientBytes{0};
+    VkDeviceSize unaliasedBytes{0};
+    // Image barriers recorded by the last Execute().
+    uint32_t barriers{0};
+  };
+
+  RenderGraph() = default;
+  ~RenderGraph();
+
+  RenderGraph(const RenderGraph &) = delete;
+  RenderGraph &operator=(const RenderGraph &) = delete;
+
+  [[nodiscard]] ResourceId CreateImage(const ImageDesc &desc);
+  [[nodiscard]] ResourceId ImportImage(const ImportDesc &desc);
+  PassId AddPass(std::string name,
+                 const std::function<void(PassBuilder &)> &setup,
+                 std::function<void(VkCommandBuffer)> execute);
+
+  // Creates the transient images and their (aliased) memory. Throws
+  // std::runtime_error on failure.
+  void Compile(VkPhysicalDevice gpu, VkDevice device);
+  // Destroys all GPU objects and forgets every resource and pass.
+  void Reset();
+
+  void
+  SetImportedImage(ResourceId resource, VkImage image, VkImageView view,
+                   VkImageLayout currentLayout = VK_IMAGE_LAYOUT_UNDEFINED);
+  // Disabled passes are skipped and do not keep their producers alive.
+  void SetPassEnabled(PassId pass, bool enabled);
+
+  // Records the live passes. With a query pool, timestamps for pass `i` are
+  // written to queries 2i and 2i+1; culled passes write both back to back so
+  // every query is available. The caller resets the queries.
+  void Execute(VkCommandBuffer cb, VkQueryPool queryPool = VK_NULL_HANDLE);
+
+  [[nodiscard]] VkImage GetImage(ResourceId resource) const;
+  [[nodiscard]] VkImageView GetImageView(ResourceId resource) const;
+  [[nodiscard]] uint32_t GetPassCount() const {
+    return static_cast<uint32_t>(m_passes.size());
+  }
+  [[nodiscard]] const std::string &GetPassName(PassId pass) const;
+  // Results of the last Execute().
+  [[nodiscard]] double GetPassCpuMs(PassId pass) const;
+  [[nodiscard]] bool WasPassExecuted(PassId pass) const;
+  [[nodiscard]] Stats GetStats() const;
+
+private:
+  struct Use {
+    ResourceId resource{kInvalidResource};
+    RenderGraphAccess access{RenderGraphAccess::ColorAttachment};
+    bool read{false};
+    bool write{false};
+  };
+
+  struct Pass {
+    std::string name;
+    std::function<void(VkCommandBuffer)> execute;
+    std::vector<Use> uses;
+    bool sideEffects{false};
+    bool enabled{true};
+    bool executed{false};
+    double cpuMs{0.0};
+  };
+
+  struct Resource {
+    std::string name;
+    bool imported{false};
+    ImageDesc desc;
+    VkPipelineStageFlags initialStage{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
+    VkImageLayout finalLayout{VK_IMAGE_LAYOUT_UNDEFINED};
+    VkImage image{VK_NULL_HANDLE};
+    VkImageView view{VK_NULL_HANDLE};
+    VkImageLayout importedLayout{VK_IMAGE_LAYOUT_UNDEFINED};
+    // Index into m_blocks for transients; UINT32_MAX when never used.
+    uint32_t block{UINT32_MAX};
+    // Per-frame tracking.
+    VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+    VkPipelineStageFlags stages{0};
+    VkAccessFlags accesses{0};
+  };
+
+  // One allocation shared by transients with disjoint lifetimes. `owner` is
+  // the image whose contents currently live in it during Execute().
+  struct MemoryBlock {
+    VkDeviceMemory memory{VK_NULL_HANDLE};
+    VkDeviceSize size{0};
+    uint32_t memoryTypeBits{0};
+    std::vector<ResourceId> members;
+    ResourceId owner{kInvalidResource};
+    VkPipelineStageFlags stages{0};
+    VkAccessFlags accesses{0};
+  };
+
+  void AddUse(PassId pass, ResourceId resource, RenderGraphAccess access,
+              bool read, bool write);
+  void CullPasses(std::vector<bool> &live) const;
+  void AppendBarrier(const Use &use, VkPipelineStageFlags &srcStages,
+                     VkPipelineStageFlags &dstStages,
+                     std::vector<VkImageMemoryBarrier> &barriers);
+  void DestroyGpuObjects();
+
+  VkDevice m_device{VK_NULL_HANDLE};
+  std::vector<Resource> m_resources;
+  std::vector<Pass> m_passes;
+  std::vector<MemoryBlock> m_blocks;
+  Stats m_stats;
+  bool m_compiled{false};
+};
+} // namespace Aetherion::Rendering
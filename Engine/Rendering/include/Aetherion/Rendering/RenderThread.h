@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Aetherion/Rendering/RenderView.h"
+
+namespace Aetherion::Rendering {
+class VulkanViewport;
+
+// Renders a VulkanViewport on a thread of its own. The simulation side hands
+// over RenderView snapshots through a lock-free triple buffer: it fills one
+// slot while the render thread draws from another, and the third holds the
+// newest complete snapshot, so neither side waits for the other. Everything
+// else the viewport needs (camera input, resizes, picks) is queued as
+// commands that run on the render thread before the next frame.
+class RenderThread {
+public:
+  using Clock = std::chrono::steady_clock;
+  using Command = std::function<void(VulkanViewport &)>;
+
+  struct Stats {
+    uint64_t framesRendered{0};
+    // Snapshots replaced by a newer one before the render thread took them.
+    uint64_t snapshotsDropped{0};
+  };
+
+  // Keeps the render thread parked between frames while alive.
+  class PauseScope {
+  public:
+    PauseScope() = default;
+    PauseScope(PauseScope &&other) noexcept
+        : m_owner(std::exchange(other.m_owner, nullptr)) {}
+    PauseScope &operator=(PauseScope &&other) noexcept;
+    ~PauseScope();
+
+    PauseScope(const PauseScope &) = delete;
+    PauseScope &operator=(const PauseScope &) = delete;
+
+  private:
+    friend class RenderThread;
+    explicit PauseScope(RenderThread *owner) : m_owner(owner) {}
+    RenderThread *m_owner{nullptr};
+  };
+
+  // The viewport must be initialized and outlive this object. While the
+  // thread runs only it touches the viewport, except under a PauseScope.
+  explicit RenderThread(VulkanViewport &viewport);
+  ~RenderThread();
+
+  RenderThread(const RenderThread &) = delete;
+  RenderThread &operator=(const RenderThread &) = delete;
+
+  // Called on the render thread after each presented frame.
+  void SetFrameCallback(std::function<void(Clock::time_point)> callback);
+
+  void Start();
+  // Runs the queued commands, then joins the thread.
+  void Stop();
+  [[nodiscard]] bool IsRunning() const noexcept {
+    return m_running.load(std::memory_order_acquire);
+  }
+
+  // Producer side, for a single thread: fill the slot returned by
+  // BeginSnapshot(), then publish it. Publishing never blocks; a snapshot
+  // the render thread has not taken yet is replaced.
+  [[nodiscard]] RenderView &BeginSnapshot() noexcept {
+    return m_slots[m_backIndex];
+  }
+  void PublishSnapshot();
+
+  // Runs on the render thread before its next frame, in posting order. When
+  // the thread is not running the command runs on the caller right away.
+  void Post(Command command);
+  // Like Post(), with the result delivered through a future. Never wait on
+  // it from the render thread or while holding a PauseScope.
+  template <typename Fn>
+  [[nodiscard]] auto Invoke(Fn fn)
+      -> std::future<std::invoke_result_t<Fn &, VulkanViewport &>>;
+
+  // Parks the render thread between frames, so the caller may use the
+  // viewport and the asset registry directly until the scope ends. Returns
+  // an empty scope if the thread is not running. Scopes nest.
+  [[nodiscard]] PauseScope Pause();
+
+  // Message of the exception that stopped rendering, if any. Commands keep
+  // running after a failure; frames do not.
+  [[nodiscard]] std::optional<std::string> TakeError();
+  [[nodiscard]] Stats GetStats() const noexcept;
+
+private:
+  static constexpr uint32_t kIndexMask = 0x3u;
+  static constexpr uint32_t kFreshBit = 0x4u;
+
+  void Run();
+  void Wake() noexcept;
+  void Resume() noexcept;
+  [[nodiscard]] bool ConsumeSnapshot() noexcept;
+  void DrainCommands();
+  void RecordError(std::string message);
+
+  VulkanViewport &m_viewport;
+  std::thread m_thread;
+  std::function<void(Clock::time_point)> m_frameCallback;
+
+  std::array<RenderView, 3> m_slots{};
+  // Producer-owned slot.
+  uint32_t m_backIndex{0};
+  // Render-thread-owned slot.
+  uint32_t m_frontIndex{1};
+  // Slot in between, with kFreshBit set while it holds an untaken snapshot.
+  std::atomic<uint32_t> m_middle{2};
+
+  std::mutex m_commandMutex;
+  std::vector<Command> m_commands;
+
+  // Bumped for every event the render thread waits on.
+  std::atomic<uint32_t> m_wakeups{0};
+  std::atomic<bool> m_running{false};
+  std::atomic<bool> m_stopRequested{false};
+  std::atomic<uint32_t> m_pauseRequests{0};
+  std::atomic<bool> m_paused{false};
+  bool m_failed{false};
+
+  std::mutex m_errorMutex;
+  std::optional<std::string> m_error;
+
+  std::atomic<uint64_t> m_framesRendered{0};
+  std::atomic<uint64_t> m_snapshotsDropped{0};
+};
+
+template <typename Fn>
+auto RenderThread::Invoke(Fn fn)
+    -> std::future<std::invoke_result_t<Fn &, VulkanViewport &>> {
+  using Result = std::invoke_result_t<Fn &, VulkanViewport &>;
+  auto task = std::make_shared<std::packaged_task<Result(VulkanViewport &)>>(
+      std::move(fn));
+  auto future = task->get_future();
+  Post([task](VulkanViewport &viewport) { (*task)(viewport); });
+  return future;
+}
+} // namespace Aetherion::Rendering
@@ -2,27 +2,23 @@
 
 #include <cstdint>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "Aetherion/Core/Types.h"
 
-namespace Aetherion::Scene {
-class TransformComponent;
-class MeshRendererComponent;
-} // namespace Aetherion::Scene
-
 namespace Aetherion::Rendering {
 enum class RenderLightType : uint32_t { Directional = 0, Point = 1, Spot = 2 };
 
 struct RenderInstance {
   Core::EntityId entityId{0};
-  const Scene::TransformComponent *transform{nullptr};
-  const Scene::MeshRendererComponent *mesh{nullptr};
   std::string meshAssetId;
   std::string albedoTextureId;
   float model[16]{};
   bool hasModel{false};
+  float color[3]{1.0f, 1.0f, 1.0f};
+  // Not moved by physics or animation; such instances cast into the cached
+  // shadow atlas instead of being redrawn every frame.
+  bool isStatic{true};
 };
 
 struct RenderBatch {
@@ -82,10 +78,6 @@ struct RenderCollider {
 struct RenderView {
   std::vector<RenderInstance> instances;
   std::vector<RenderBatch> batches;
-  std::unordered_map<Core::EntityId, const Scene::TransformComponent *>
-      transforms;
-  std::unordered_map<Core::EntityId, const Scene::MeshRendererComponent *>
-      meshes;
   Core::EntityId selectedEntityId{0};
   RenderDirectionalLight directionalLight{};
   std::vector<RenderLight> lights;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <filesystem>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -9,6 +12,8 @@
 
 namespace Aetherion::Rendering
 {
+class GpuResourceCache;
+
 enum class LogSeverity
 {
     Info,
@@ -25,7 +30,9 @@ public:
     VulkanContext(const VulkanContext&) = delete;
     VulkanContext& operator=(const VulkanContext&) = delete;
 
-    void Initialize(bool enableValidation, bool enableLogging);
+    // Headless contexts skip surface/swapchain extensions so they can run on machines
+    // without a display (offscreen rendering, benchmarks, CI).
+    void Initialize(bool enableValidation, bool enableLogging, bool headless = false);
     void Shutdown();
 
     void SetLogCallback(std::function<void(LogSeverity, const std::string&)> callback);
@@ -35,6 +42,7 @@ public:
     [[nodiscard]] bool IsInitialized() const noexcept { return m_initialized; }
     [[nodiscard]] bool IsValidationEnabled() const noexcept { return m_enableValidation; }
     [[nodiscard]] bool IsLoggingEnabled() const noexcept { return m_enableLogging; }
+    [[nodiscard]] bool IsHeadless() const noexcept { return m_headless; }
 
     [[nodiscard]] VkInstance GetInstance() const noexcept { return m_instance; }
     [[nodiscard]] VkPhysicalDevice GetPhysicalDevice() const noexcept { return m_physicalDevice; }
@@ -45,6 +53,21 @@ public:
     [[nodiscard]] uint32_t GetPresentQueueFamilyIndex() const noexcept { return m_presentQueueFamilyIndex; }
     [[nodiscard]] bool IsSamplerAnisotropyEnabled() const noexcept { return m_enabledFeatures.samplerAnisotropy == VK_TRUE; }
     [[nodiscard]] float GetMaxSamplerAnisotropy() const noexcept { return m_physicalDeviceProperties.limits.maxSamplerAnisotropy; }
+    [[nodiscard]] bool IsTextureCompressionBCEnabled() const noexcept { return m_enabledFeatures.textureCompressionBC == VK_TRUE; }
+
+    // Shared by every viewport. When a path is set before Initialize(), the cache is seeded from disk
+    // (if the header matches this device/driver) and written back on Shutdown().
+    void SetPipelineCachePath(std::filesystem::path path) { m_pipelineCachePath = std::move(path); }
+    [[nodiscard]] VkPipelineCache GetPipelineCache() const noexcept { return m_pipelineCache; }
+    void SavePipelineCache() const;
+
+    // Meshes and textures uploaded by any viewport on this context. Survives Shutdown()/Initialize()
+    // cycles so handles held across a device restart go stale instead of dangling.
+    [[nodiscard]] std::shared_ptr<GpuResourceCache> GetResourceCache() const noexcept { return m_resourceCache; }
+
+    // Queue submission, presentation and idle waits need external synchronization, and viewports
+    // may render from different threads. Hold this around every such call on this context's queues.
+    [[nodiscard]] std::mutex& GetQueueMutex() const noexcept { return m_queueMutex; }
 
     struct QueueFamilyIndices
     {
@@ -74,6 +97,7 @@ private:
     bool m_initialized{false};
     bool m_enableValidation{false};
     bool m_enableLogging{true};
+    bool m_headless{false};
     std::function<void(LogSeverity, const std::string&)> m_logCallback;
     VkInstance m_instance{VK_NULL_HANDLE};
     VkPhysicalDevice m_physicalDevice{VK_NULL_HANDLE};
@@ -87,6 +111,10 @@ private:
     VkPhysicalDeviceProperties m_physicalDeviceProperties{};
     VkPhysicalDeviceFeatures m_enabledFeatures{};
     VkDebugUtilsMessengerEXT m_debugMessenger{VK_NULL_HANDLE};
+    VkPipelineCache m_pipelineCache{VK_NULL_HANDLE};
+    std::filesystem::path m_pipelineCachePath;
+    std::shared_ptr<GpuResourceCache> m_resourceCache;
+    mutable std::mutex m_queueMutex;
 
     static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
         VkDebugUtilsMessageSeverityFlagBitsEXT severity,
@@ -98,11 +126,14 @@ private:
     void SetupDebugMessenger();
     void PickPhysicalDevice(VkSurfaceKHR surface);
     void CreateLogicalDevice();
+    void CreatePipelineCache();
+    [[nodiscard]] bool IsPipelineCacheCompatible(const std::vector<char>& data, std::string& reason) const;
 
     [[nodiscard]] bool CheckValidationLayerSupport() const;
     [[nodiscard]] bool CheckDeviceExtensionSupport(VkPhysicalDevice device) const;
     [[nodiscard]] std::vector<const char*> GetRequiredInstanceLayers() const;
     [[nodiscard]] std::vector<const char*> GetRequiredInstanceExtensions() const;
+    [[nodiscard]] std::vector<const char*> GetRequiredDeviceExtensions() const;
     [[nodiscard]] QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface) const;
     [[nodiscard]] SwapchainSupportDetails QuerySwapchainSupport(VkPhysicalDevice device, VkSurfaceKHR surface) const;
 };
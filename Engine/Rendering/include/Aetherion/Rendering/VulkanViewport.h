@@ -3,6 +3,7 @@
 #include <array>
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -12,6 +13,10 @@
 #include <vulkan/vulkan.h>
 
 #include "Aetherion/Assets/AssetRegistry.h"
+#include "Aetherion/Assets/TextureCooker.h"
+#include "Aetherion/Rendering/CpuPicker.h"
+#include "Aetherion/Rendering/GpuResourceCache.h"
+#include "Aetherion/Rendering/RenderGraph.h"
 #include "Aetherion/Rendering/RenderView.h"
 
 namespace Aetherion::Rendering {
@@ -21,7 +26,8 @@ class VulkanContext;
 namespace Aetherion::Rendering {
 class VulkanViewport {
 public:
-  static constexpr uint32_t kPassCount = 4;
+  static constexpr uint32_t kPassCount = 8;
+  static constexpr uint32_t kMaxShadowCascades = 4;
   enum class DebugViewMode : uint32_t {
     Final = 0,
     Normals = 1,
@@ -42,6 +48,12 @@ public:
     double cpuTotalMs = 0.0;
     double gpuTotalMs = 0.0;
     std::array<PassStats, kPassCount> passes{};
+    // Fraction of the swapchain resolution the scene pass rendered at.
+    float renderScale = 1.0f;
+    // Cached shadow cascades redrawn this frame and shadow caster draws across
+    // both atlases; both stay at zero for a static scene and camera.
+    uint32_t shadowCascadesRedrawn = 0;
+    uint32_t shadowCasterDraws = 0;
     bool valid = false;
   };
 
@@ -61,13 +73,24 @@ public:
   VulkanViewport &operator=(const VulkanViewport &) = delete;
 
   void Initialize(void *nativeHandle, int width, int height);
+  // Renders into offscreen images instead of a swapchain. Requires a
+  // VulkanContext initialized in headless mode (or any context when no
+  // surface is available).
+  void InitializeHeadless(int width, int height);
   void Resize(int width, int height);
   void RenderFrame(float deltaTimeSeconds, const RenderView &view);
   void Shutdown();
+  // Drops this viewport's references to changed assets. GPU invalidation
+  // itself is applied once per context via GpuResourceCache.
   void HandleAssetChanges(
       const std::vector<Assets::AssetRegistry::AssetChange> &changes);
 
   [[nodiscard]] bool IsReady() const noexcept { return m_ready; }
+  [[nodiscard]] bool IsHeadless() const noexcept { return m_headless; }
+  // Copies the most recently submitted headless frame into tightly packed
+  // RGBA8 (sRGB encoded). Waits for the device to go idle.
+  bool ReadbackLastFrame(std::vector<uint8_t> &rgba, uint32_t &width,
+                         uint32_t &height);
   void SetLoggingEnabled(bool enabled) noexcept { m_verboseLogging = enabled; }
 
   void SetDebugViewMode(DebugViewMode mode) noexcept { m_debugViewMode = mode; }
@@ -81,11 +104,76 @@ public:
     return m_lastPickResult;
   }
   void ClearPickResult() noexcept { m_lastPickResult.valid = false; }
+  // Immediate picks against the last submitted frame, answered on the CPU
+  // from instance bounds and mesh triangles instead of the picking pass.
+  [[nodiscard]] PickResult PickCpu(uint32_t x, uint32_t y);
+  // Entities with geometry inside the pixel rectangle spanned by two corners.
+  [[nodiscard]] std::vector<Core::EntityId>
+  PickRectCpu(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1);
 
   [[nodiscard]] FrameStats GetLastFrameStats() const noexcept {
     return m_lastFrameStats;
   }
 
+  // Dynamic resolution renders the scene pass into a scaled region of the
+  // scene target and lets the post-process pass upscale it. The scale follows
+  // measured GPU frame time, so it needs timestamp query support.
+  struct DynamicResolutionSettings {
+    bool enabled{false};
+    double targetGpuMs{14.0};
+    float minScale{0.5f};
+    float maxScale{1.0f};
+  };
+  void SetDynamicResolution(const DynamicResolutionSettings &settings) noexcept;
+  [[nodiscard]] DynamicResolutionSettings
+  GetDynamicResolution() const noexcept {
+    return m_dynamicResolution;
+  }
+  [[nodiscard]] float GetRenderScale() const noexcept { return m_renderScale; }
+
+  // Cascaded shadows for the primary directional light. Static casters live
+  // in a persistent atlas whose cascades are redrawn only when they are refit
+  // or the static scene changes; moving casters are drawn every frame into a
+  // smaller atlas that the lighting shader combines with the cached one.
+  struct ShadowSettings {
+    bool enabled{true};
+    uint32_t cascadeCount{kMaxShadowCascades};
+    // Shadows end this far from the camera (clamped to the far plane).
+    float maxDistance{60.0f};
+  };
+  void SetShadowSettings(const ShadowSettings &settings) noexcept;
+  [[nodiscard]] ShadowSettings GetShadowSettings() const noexcept {
+    return m_shadowSettings;
+  }
+
+  // Lays down scene depth with a position-only pass first, so the shaded
+  // opaque pass runs with an EQUAL depth test and shades each pixel once.
+  // Pays off once fragment shading dominates; off by default.
+  void SetDepthPrepassEnabled(bool enabled) noexcept {
+    m_depthPrepassEnabled = enabled;
+  }
+  [[nodiscard]] bool IsDepthPrepassEnabled() const noexcept {
+    return m_depthPrepassEnabled;
+  }
+
+  struct PresentSettings {
+    // Input-to-display budget that picks the present mode: FIFO when its
+    // queue of images fits, else MAILBOX, else IMMEDIATE if tearing is
+    // allowed. 0 keeps the default (MAILBOX when available, else FIFO).
+    double latencyTargetMs{0.0};
+    // Display refresh used to estimate each mode's latency.
+    double refreshRateHz{60.0};
+    bool allowTearing{false};
+  };
+  // Takes effect on the next swapchain recreation, which this requests.
+  void SetPresentSettings(const PresentSettings &settings) noexcept;
+  [[nodiscard]] PresentSettings GetPresentSettings() const noexcept {
+    return m_presentSettings;
+  }
+  [[nodiscard]] VkPresentModeKHR GetPresentMode() const noexcept {
+    return m_presentMode;
+  }
+
   // Camera control
   void SetCameraPosition(float x, float y, float z) noexcept;
   void SetCameraRotation(float yawDeg, float pitchDeg) noexcept;
@@ -129,14 +217,71 @@ private:
     Core::EntityId entityId{0};
     std::string meshId;
     std::string textureId;
+    // Projected diameter of the instance's bounds in pixels; drives which
+    // texture mips are streamed in.
+    float screenSize{0.0f};
+    // Casts into the cached shadow atlas rather than the per-frame one.
+    bool isStatic{true};
   };
 
-  struct GpuMesh {
-    VkBuffer vertexBuffer{VK_NULL_HANDLE};
-    VkDeviceMemory vertexMemory{VK_NULL_HANDLE};
-    VkBuffer indexBuffer{VK_NULL_HANDLE};
-    VkDeviceMemory indexMemory{VK_NULL_HANDLE};
-    uint32_t indexCount{0};
+  // One shadow cascade: a sphere around part of the view frustum, rendered
+  // orthographically from the light into one tile of the 2x2 atlases. The
+  // sphere is fitted with slack so small camera moves keep the cached tile.
+  struct ShadowCascade {
+    float center[3]{};
+    float radius{0.0f};
+    // Size of the view frustum slice the sphere was last fitted for.
+    float sliceRadius{0.0f};
+    float lightViewProj[16]{};
+    // World space to atlas uv and depth.
+    float worldToShadow[16]{};
+    bool valid{false};
+    bool staticDirty{true};
+  };
+
+  struct ShadowCamera {
+    float eye[3]{};
+    float right[3]{};
+    float up[3]{};
+    float forward[3]{};
+    // Half extents of the view at unit distance (perspective) or absolute
+    // (orthographic).
+    float halfWidth{1.0f};
+    float halfHeight{1.0f};
+    bool orthographic{false};
+    float nearPlane{0.1f};
+    float farPlane{100.0f};
+  };
+
+  using GpuMesh = Rendering::GpuMesh;
+
+  // Unit wireframes (box, sphere, capsule cap/body) drawn instanced per
+  // collider instead of being re-tessellated on the CPU every frame.
+  static constexpr uint32_t kWireframeTemplateCount = 4;
+
+  struct WireframeTemplate {
+    uint32_t firstVertex{0};
+    uint32_t vertexCount{0};
+  };
+
+  struct WireframeInstance {
+    float model[16];
+    float color[4];
+  };
+
+  // Persistently mapped, host-visible buffer owned by one frame in flight.
+  // Written front to back each frame and grown (never truncated) on demand.
+  struct DynamicGeometryBuffer {
+    VkBuffer buffer{VK_NULL_HANDLE};
+    VkDeviceMemory memory{VK_NULL_HANDLE};
+    void *mapped{nullptr};
+    VkDeviceSize capacity{0};
+    VkDeviceSize head{0};
+  };
+
+  struct DynamicRange {
+    VkDeviceSize offset{0};
+    uint32_t count{0};
   };
 
   struct GpuTexture {
@@ -148,6 +293,11 @@ private:
     VkDescriptorPool descriptorPool{VK_NULL_HANDLE};
     uint32_t width{0};
     uint32_t height{0};
+    uint32_t mipLevels{1};
+    uint32_t baseMip{0};
+    // Valid when the image is owned by the shared GpuResourceCache; only the
+    // descriptor set then belongs to this viewport.
+    GpuResourceCache::TextureHandle handle{};
   };
 
   std::shared_ptr<VulkanContext> m_context;
@@ -163,8 +313,29 @@ private:
   PickRequest m_pendingPick{};
   std::array<PickReadback, kMaxFramesInFlight> m_pickReadbacks{};
   PickResult m_lastPickResult{};
+  // Snapshot of the last submitted frame for CPU picks. The BVH is rebuilt
+  // lazily on the first pick after a new frame.
+  std::vector<DrawInstance> m_pickInstances;
+  float m_frameViewProj[16]{};
+  float m_pickViewProj[16]{};
+  CpuPicker m_cpuPicker;
+  bool m_cpuPickerDirty{true};
   FrameStats m_lastFrameStats{};
+  DynamicResolutionSettings m_dynamicResolution{};
+  float m_renderScale{1.0f};
+  // Smoothed GPU cost of a frame at full resolution, in ms.
+  double m_fullResGpuMs{0.0};
   std::array<FrameStats, kMaxFramesInFlight> m_frameStats{};
+  bool m_depthPrepassEnabled{false};
+  PresentSettings m_presentSettings{};
+  VkPresentModeKHR m_presentMode{VK_PRESENT_MODE_FIFO_KHR};
+  ShadowSettings m_shadowSettings{};
+  std::array<ShadowCascade, kMaxShadowCascades> m_shadowCascades{};
+  uint32_t m_shadowCascadeCount{0};
+  float m_shadowLightDir[3]{0.0f, -1.0f, 0.0f};
+  // Hash over every static caster; a change redraws all cached cascades.
+  uint64_t m_shadowStaticHash{0};
+  bool m_shadowHasDynamicCasters{false};
   std::array<VkQueryPool, kMaxFramesInFlight> m_queryPools{};
   float m_timestampPeriod{0.0f};
   bool m_timestampsSupported{false};
@@ -198,10 +369,22 @@ private:
 
   std::vector<VkImage> m_swapchainImages;
   std::vector<VkImageView> m_swapchainImageViews;
+  // Headless mode owns the "swapchain" images itself.
+  bool m_headless{false};
+  std::vector<VkDeviceMemory> m_offscreenMemories;
+  uint32_t m_lastImageIndex{UINT32_MAX};
 
   VkRenderPass m_sceneRenderPass{VK_NULL_HANDLE};
+  // Same attachments as the scene pass, but keeps the pre-pass depth.
+  VkRenderPass m_sceneLoadDepthRenderPass{VK_NULL_HANDLE};
+  VkRenderPass m_depthPrepassRenderPass{VK_NULL_HANDLE};
   VkRenderPass m_postProcessRenderPass{VK_NULL_HANDLE};
   VkRenderPass m_pickingRenderPass{VK_NULL_HANDLE};
+  // Depth-only shadow passes: the cached atlas keeps its contents and clears
+  // the cascades it redraws, the per-frame atlas is cleared as a whole.
+  VkRenderPass m_shadowRenderPass{VK_NULL_HANDLE};
+  VkRenderPass m_shadowCacheRenderPass{VK_NULL_HANDLE};
+  VkFormat m_shadowFormat{VK_FORMAT_UNDEFINED};
 
   VkDescriptorSetLayout m_descriptorSetLayout{VK_NULL_HANDLE};
   VkDescriptorSetLayout m_textureDescriptorSetLayout{VK_NULL_HANDLE};
@@ -217,28 +400,57 @@ private:
   VkPipeline m_pipeline{VK_NULL_HANDLE};
   VkPipeline m_linePipeline{VK_NULL_HANDLE};
   VkPipeline m_overlayPipeline{VK_NULL_HANDLE};
+  VkPipeline m_wireframePipeline{VK_NULL_HANDLE};
   VkPipeline m_pickingPipeline{VK_NULL_HANDLE};
   VkPipeline m_pickingPipelineUint{VK_NULL_HANDLE};
+  VkPipeline m_packedPipeline{VK_NULL_HANDLE};
+  VkPipeline m_packedPickingPipeline{VK_NULL_HANDLE};
+  VkPipeline m_packedPickingPipelineUint{VK_NULL_HANDLE};
   VkPipeline m_postProcessPipeline{VK_NULL_HANDLE};
   VkPipeline m_postProcessPipelineUint{VK_NULL_HANDLE};
+  VkPipeline m_shadowPipeline{VK_NULL_HANDLE};
+  VkPipeline m_packedShadowPipeline{VK_NULL_HANDLE};
+  VkPipeline m_depthPrepassPipeline{VK_NULL_HANDLE};
+  VkPipeline m_packedDepthPrepassPipeline{VK_NULL_HANDLE};
+  // Opaque shading after the pre-pass: EQUAL depth test, no depth writes.
+  VkPipeline m_depthEqualPipeline{VK_NULL_HANDLE};
+  VkPipeline m_packedDepthEqualPipeline{VK_NULL_HANDLE};
+  // {opaque, picking, depth-equal opaque} packed-vertex pipelines compiling
+  // in the background.
+  std::future<std::array<VkPipeline, 3>> m_packedPipelinesFuture;
 
   std::vector<VkFramebuffer> m_framebuffers;
   std::array<VkFramebuffer, kMaxFramesInFlight> m_sceneFramebuffers{};
   std::array<VkFramebuffer, kMaxFramesInFlight> m_pickingFramebuffers{};
+  std::array<VkFramebuffer, kMaxFramesInFlight> m_depthPrepassFramebuffers{};
+  std::array<VkFramebuffer, kMaxFramesInFlight> m_dynamicShadowFramebuffers{};
+
+  // Cached static shadow atlas; shared by every frame slot and imported into
+  // each graph.
+  VkImage m_shadowAtlas{VK_NULL_HANDLE};
+  VkDeviceMemory m_shadowAtlasMemory{VK_NULL_HANDLE};
+  VkImageView m_shadowAtlasView{VK_NULL_HANDLE};
+  VkFramebuffer m_shadowAtlasFramebuffer{VK_NULL_HANDLE};
+  VkImageLayout m_shadowAtlasLayout{VK_IMAGE_LAYOUT_UNDEFINED};
+  VkSampler m_shadowSampler{VK_NULL_HANDLE};
+
+  // One graph per frame slot: each owns that slot's scene and picking
+  // targets, so frames in flight never share transient memory.
+  struct GraphTargets {
+    RenderGraph::ResourceId sceneColor{RenderGraph::kInvalidResource};
+    RenderGraph::ResourceId sceneDepth{RenderGraph::kInvalidResource};
+    RenderGraph::ResourceId picking{RenderGraph::kInvalidResource};
+    RenderGraph::ResourceId pickingDepth{RenderGraph::kInvalidResource};
+    RenderGraph::ResourceId backbuffer{RenderGraph::kInvalidResource};
+    RenderGraph::ResourceId shadowAtlas{RenderGraph::kInvalidResource};
+    RenderGraph::ResourceId dynamicShadow{RenderGraph::kInvalidResource};
+  };
+  std::array<RenderGraph, kMaxFramesInFlight> m_renderGraphs;
+  GraphTargets m_graphTargets{};
+  // Inputs of the pass callbacks while RecordCommandBuffer() runs.
+  const std::vector<DrawInstance> *m_recordInstances{nullptr};
+  uint32_t m_recordImageIndex{0};
 
-  std::array<VkImage, kMaxFramesInFlight> m_sceneColorImages{};
-  std::array<VkDeviceMemory, kMaxFramesInFlight> m_sceneColorMemories{};
-  std::array<VkImageView, kMaxFramesInFlight> m_sceneColorViews{};
-  std::array<VkImage, kMaxFramesInFlight> m_sceneDepthImages{};
-  std::array<VkDeviceMemory, kMaxFramesInFlight> m_sceneDepthMemories{};
-  std::array<VkImageView, kMaxFramesInFlight> m_sceneDepthViews{};
-
-  std::array<VkImage, kMaxFramesInFlight> m_pickingImages{};
-  std::array<VkDeviceMemory, kMaxFramesInFlight> m_pickingMemories{};
-  std::array<VkImageView, kMaxFramesInFlight> m_pickingViews{};
-  std::array<VkImage, kMaxFramesInFlight> m_pickingDepthImages{};
-  std::array<VkDeviceMemory, kMaxFramesInFlight> m_pickingDepthMemories{};
-  std::array<VkImageView, kMaxFramesInFlight> m_pickingDepthViews{};
   std::array<VkBuffer, kMaxFramesInFlight> m_pickingReadbackBuffers{};
   std::array<VkDeviceMemory, kMaxFramesInFlight> m_pickingReadbackMemories{};
 
@@ -247,6 +459,8 @@ private:
 
   VkBuffer m_vertexBuffer{VK_NULL_HANDLE};
   VkDeviceMemory m_vertexMemory{VK_NULL_HANDLE};
+  VkBuffer m_positionBuffer{VK_NULL_HANDLE};
+  VkDeviceMemory m_positionMemory{VK_NULL_HANDLE};
   VkBuffer m_indexBuffer{VK_NULL_HANDLE};
   VkDeviceMemory m_indexMemory{VK_NULL_HANDLE};
   uint32_t m_defaultIndexCount{0};
@@ -254,17 +468,18 @@ private:
   VkBuffer m_lineVertexBuffer{VK_NULL_HANDLE};
   VkDeviceMemory m_lineVertexMemory{VK_NULL_HANDLE};
   uint32_t m_lineVertexCount{0};
-  VkBuffer m_selectionVertexBuffer{VK_NULL_HANDLE};
-  VkDeviceMemory m_selectionVertexMemory{VK_NULL_HANDLE};
-  uint32_t m_selectionVertexCount{0};
-  VkBuffer m_lightGizmoVertexBuffer{VK_NULL_HANDLE};
-  VkDeviceMemory m_lightGizmoVertexMemory{VK_NULL_HANDLE};
-  uint32_t m_lightGizmoVertexCount{0};
-  VkBuffer m_colliderVertexBuffer{VK_NULL_HANDLE};
-  VkDeviceMemory m_colliderVertexMemory{VK_NULL_HANDLE};
-  uint32_t m_colliderVertexCount{0};
+  VkBuffer m_wireframeTemplateBuffer{VK_NULL_HANDLE};
+  VkDeviceMemory m_wireframeTemplateMemory{VK_NULL_HANDLE};
+  std::array<WireframeTemplate, kWireframeTemplateCount> m_wireframeTemplates{};
+  std::array<DynamicGeometryBuffer, kMaxFramesInFlight> m_dynamicGeometry{};
+  DynamicRange m_selectionLines{};
+  DynamicRange m_lightGizmoLines{};
+  std::array<DynamicRange, kWireframeTemplateCount> m_colliderInstances{};
   VkSampler m_textureSampler{VK_NULL_HANDLE};
   VkSampler m_postProcessSampler{VK_NULL_HANDLE};
+  // Bilinear sampler for upscaling the scene target, independent of the
+  // picking format.
+  VkSampler m_sceneUpscaleSampler{VK_NULL_HANDLE};
   GpuTexture m_defaultTexture{};
   std::array<VkBuffer, kMaxFramesInFlight> m_uniformBuffers{};
   std::array<VkDeviceMemory, kMaxFramesInFlight> m_uniformMemories{};
@@ -275,13 +490,14 @@ private:
   std::vector<VkSemaphore> m_renderFinishedPerImage;
   std::vector<VkFence> m_inFlight;
   std::vector<VkFence> m_imagesInFlight;
-  std::unordered_map<std::string, GpuMesh> m_meshCache;
+  std::unordered_map<std::string, GpuResourceCache::MeshHandle> m_meshCache;
   std::unordered_set<std::string> m_missingMeshes;
   std::unordered_map<std::string, GpuTexture> m_textureCache;
   std::unordered_set<std::string> m_missingTextures;
 
   void CreateSurface(void *nativeHandle);
   void CreateSwapchain(int width, int height);
+  void CreateOffscreenTargets(int width, int height);
   void DestroySwapchain();
   void DestroySwapchainResources();
   void DestroyDeviceResources();
@@ -293,33 +509,55 @@ private:
   void CreateDescriptorSetLayout();
   void CreateMeshBuffers();
   void CreateLineBuffers();
-  void CreateSceneResources();
+  void CreateRenderGraphs();
   void CreatePickingResources();
   void CreateUniformBuffers();
   void CreateDescriptorPoolAndSets();
   void CreateTextureDescriptorPool();
   void CreateTextureResources();
   void CreatePipeline();
+  void CollectPackedPipelines(bool wait);
   void CreateFramebuffers();
   void UpdatePostProcessDescriptorSets();
+  void CreateShadowResources();
+  void DestroyShadowResources();
 
   void CreateCommandPoolAndBuffers();
   void RecordCommandBuffer(uint32_t imageIndex,
                            const std::vector<DrawInstance> &instances);
+  void RecordDepthPrepass(VkCommandBuffer cb,
+                          const std::vector<DrawInstance> &instances);
   void RecordOpaquePass(VkCommandBuffer cb,
                         const std::vector<DrawInstance> &instances);
   void RecordPickingPass(VkCommandBuffer cb,
                          const std::vector<DrawInstance> &instances);
+  void RecordPickReadbackPass(VkCommandBuffer cb);
+  void RecordShadowPass(VkCommandBuffer cb,
+                        const std::vector<DrawInstance> &instances,
+                        bool staticCasters);
+  bool EnsureCpuPicker();
   void RecordPostProcessPass(VkCommandBuffer cb, uint32_t imageIndex);
   void RecordOverlayPass(VkCommandBuffer cb);
   void UpdateUniformBuffer(uint32_t frameIndex, const RenderView &view);
+  void UpdateDynamicResolution(const FrameStats &stats);
+  void UpdateShadowCasters(const std::vector<DrawInstance> &instances);
+  // Refits the cascades for this frame's camera and light and returns how
+  // many are active (0 when shadows are off).
+  uint32_t UpdateShadowCascades(const ShadowCamera &camera, bool lightEnabled,
+                                const float lightDir[3]);
+  [[nodiscard]] VkExtent2D GetSceneRenderExtent() const noexcept;
   void UpdateSelectionBuffer(const std::vector<DrawInstance> &instances,
                              const RenderView &view);
   void UpdateLightGizmoBuffer(const RenderView &view);
   void UpdateColliderBuffer(const RenderView &view);
+  [[nodiscard]] VkDeviceSize WriteDynamicGeometry(const void *data,
+                                                  VkDeviceSize size);
+  void EnsureDynamicGeometryCapacity(DynamicGeometryBuffer &ring,
+                                     VkDeviceSize required);
+  void DestroyDynamicGeometry();
   void DestroyMeshCache();
   void DestroyTextureCache();
-  void DestroySceneResources();
+  void DestroyRenderGraphs();
   void DestroyPickingResources();
   void ProcessDeferredDeletions();
   void EnqueueDeletion(std::function<void()> &&callback,
@@ -334,17 +572,37 @@ private:
   void CreateSyncObjects();
   void CreateQueryPools();
   [[nodiscard]] std::vector<DrawInstance>
-  InstancesFromView(const RenderView &view, float timeSeconds) const;
+  InstancesFromView(const RenderView &view) const;
 
   [[nodiscard]] const GpuMesh *ResolveMesh(const std::string &assetId);
   [[nodiscard]] const GpuTexture *ResolveTexture(const std::string &assetId);
+  const GpuTexture *BindSharedTexture(const std::string &assetId,
+                                      GpuResourceCache::TextureHandle handle);
   GpuTexture CreateTextureFromPixels(const unsigned char *pixels,
                                      uint32_t width, uint32_t height);
+  GpuTexture CreateTextureFromCooked(const Assets::CookedTexture &cooked);
+  bool LoadCookedTexture(const std::string &assetId,
+                         const Assets::TextureMipRange &range,
+                         Assets::CookedTexture &cooked);
+  void UpdateTextureStreaming(const std::vector<DrawInstance> &instances);
+  void StreamTexture(const GpuResourceCache::StreamingWork &work);
+  [[nodiscard]] static GpuTextureImage
+  ToSharedImage(const GpuTexture &texture);
+  void AllocateTextureDescriptorSet(GpuTexture &texture);
+  void FreeTextureDescriptorSet(GpuTexture &texture, bool deferred);
+  void ReleaseTexture(GpuTexture &texture, bool deferred);
+  [[nodiscard]] GpuResourceCache *GetResourceCache() const;
   void TransitionImageLayout(VkImage image, VkFormat format,
-                             VkImageLayout oldLayout, VkImageLayout newLayout);
+                             VkImageLayout oldLayout, VkImageLayout newLayout,
+                             uint32_t mipLevels = 1);
   void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+  // Stages `data` into a new device-local vertex buffer.
+  void UploadVertexStream(const void *data, VkDeviceSize size,
+                          VkBuffer &buffer, VkDeviceMemory &memory);
   void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width,
                          uint32_t height);
+  void CopyBufferToImage(VkBuffer buffer, VkImage image,
+                         const std::vector<VkBufferImageCopy> &regions);
 
   [[nodiscard]] std::string ShaderPath(const char *filename) const;
   [[nodiscard]] std::vector<char> ReadFileBinary(const std::string &path) const;
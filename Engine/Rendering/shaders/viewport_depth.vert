@@ -0,0 +1,28 @@
+#version 450
+
+// Depth pre-pass. Fed from the position-only stream; must produce exactly the
+// depth viewport_triangle.vert does, since the opaque pass tests EQUAL.
+layout(location = 0) in vec4 aPos;
+
+// Only the leading member of the frame UBO is needed here.
+layout(set = 0, binding = 0) uniform FrameUBO
+{
+    mat4 uViewProj;
+} ubo;
+
+layout(push_constant) uniform InstancePC
+{
+    mat4 uModel;
+    vec4 uColor;
+    uint uEntityId;
+    uint uFlags;
+    vec2 uPad;
+} pc;
+
+invariant gl_Position;
+
+void main()
+{
+    vec4 worldPos = pc.uModel * vec4(aPos.xyz, 1.0);
+    gl_Position = ubo.uViewProj * worldPos;
+}
@@ -70,7 +70,13 @@ void main()
         return;
     }
 
-    vec3 color = texture(uScene, vUv).rgb;
+    // uMaterialParams.w is the dynamic resolution scale: the scene pass only
+    // covered the top-left region of uScene. Round like the CPU side and keep
+    // the bilinear footprint inside that region.
+    vec2 sceneSize = vec2(textureSize(uScene, 0));
+    vec2 renderExtent = max(floor(sceneSize * clamp(ubo.uMaterialParams.w, 0.0, 1.0) + 0.5), vec2(1.0));
+    vec2 sceneUv = clamp(vUv * renderExtent, vec2(0.5), renderExtent - vec2(0.5)) / sceneSize;
+    vec3 color = texture(uScene, sceneUv).rgb;
     if (debugMode == kDebugFinal)
     {
         float exposure = max(ubo.uFrameParams.y, 0.0001);
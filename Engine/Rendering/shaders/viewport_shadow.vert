@@ -0,0 +1,20 @@
+#version 450
+
+// Depth-only shadow caster. The model push constant already holds the
+// cascade's light view-projection (and, for packed meshes, the dequantize
+// transform), so positions go straight to clip space.
+layout(location = 0) in vec4 aPos;
+
+layout(push_constant) uniform InstancePC
+{
+    mat4 uModel;
+    vec4 uColor;
+    uint uEntityId;
+    uint uFlags;
+    vec2 uPad;
+} pc;
+
+void main()
+{
+    gl_Position = pc.uModel * vec4(aPos.xyz, 1.0);
+}
@@ -27,8 +27,15 @@ layout(set = 0, binding = 0) uniform FrameUBO
     vec4 uMaterialParams;
     vec4 uLightCounts;
     LightUniform uLights[kMaxLights];
+    mat4 uShadowMatrices[4];
+    vec4 uShadowParams;
+    vec4 uShadowTexelSizes;
 } ubo;
 
+// Cached static casters and this frame's moving casters, 2x2 cascade tiles.
+layout(set = 0, binding = 1) uniform sampler2DShadow uShadowStatic;
+layout(set = 0, binding = 2) uniform sampler2DShadow uShadowDynamic;
+
 layout(set = 1, binding = 0) uniform sampler2D uAlbedo;
 
 layout(push_constant) uniform InstancePC
@@ -90,6 +97,43 @@ float DistanceAttenuation(float distance, float range)
     return invDist * falloff * falloff;
 }
 
+float SampleShadow(sampler2DShadow atlas, vec3 coord)
+{
+    vec2 texel = 1.0 / vec2(textureSize(atlas, 0));
+    float sum = 0.0;
+    sum += texture(atlas, vec3(coord.xy + vec2(-0.5, -0.5) * texel, coord.z));
+    sum += texture(atlas, vec3(coord.xy + vec2(0.5, -0.5) * texel, coord.z));
+    sum += texture(atlas, vec3(coord.xy + vec2(-0.5, 0.5) * texel, coord.z));
+    sum += texture(atlas, vec3(coord.xy + vec2(0.5, 0.5) * texel, coord.z));
+    return sum * 0.25;
+}
+
+// Visibility of the primary directional light. Uses the first cascade whose
+// tile contains the point; beyond the last cascade everything is lit.
+float ShadowFactor(vec3 worldPos, vec3 n)
+{
+    int cascadeCount = int(ubo.uShadowParams.x + 0.5);
+    for (int i = 0; i < cascadeCount; ++i)
+    {
+        vec3 offsetPos = worldPos + n * ubo.uShadowTexelSizes[i] * ubo.uShadowParams.y;
+        vec4 coord = ubo.uShadowMatrices[i] * vec4(offsetPos, 1.0);
+        vec2 tileOrigin = vec2(float(i % 2), float(i / 2)) * 0.5;
+        vec2 local = (coord.xy - tileOrigin) * 2.0;
+        if (any(lessThan(local, vec2(0.02))) || any(greaterThan(local, vec2(0.98))) ||
+            coord.z > 1.0)
+        {
+            continue;
+        }
+        float visibility = SampleShadow(uShadowStatic, coord.xyz);
+        if (ubo.uShadowParams.z > 0.5)
+        {
+            visibility = min(visibility, SampleShadow(uShadowDynamic, coord.xyz));
+        }
+        return visibility;
+    }
+    return 1.0;
+}
+
 vec3 ApplyLight(vec3 l,
                 vec3 radiance,
                 float attenuation,
@@ -189,7 +233,7 @@ void main()
         vec3 l = normalize(-ubo.uLightDir.xyz);
         lighting += ApplyLight(l,
                                ubo.uLightColor.rgb,
-                               1.0,
+                               ShadowFactor(vWorldPos, n),
                                n,
                                v,
                                albedo,
@@ -205,9 +249,10 @@ void main()
         {
             LightUniform light = ubo.uLights[index++];
             vec3 l = normalize(-light.direction.xyz);
+            float shadow = (light.spot.z > 0.5) ? ShadowFactor(vWorldPos, n) : 1.0;
             lighting += ApplyLight(l,
                                    light.color.rgb,
-                                   1.0,
+                                   shadow,
                                    n,
                                    v,
                                    albedo,
@@ -1,7 +1,11 @@
 #version 450
 
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec3 aNormal;
+// Packed meshes feed UNORM16 positions (pre-scaled by the model matrix),
+// SNORM16 octahedral normal/tangent pairs, UNORM8 colors and half UVs.
+layout(constant_id = 0) const bool kPackedVertices = false;
+
+layout(location = 0) in vec4 aPos;
+layout(location = 1) in vec4 aNormal;
 layout(location = 2) in vec4 aColor;
 layout(location = 3) in vec2 aUv;
 
@@ -42,12 +46,27 @@ layout(location = 1) out vec3 vColor;
 layout(location = 2) out vec2 vUv;
 layout(location = 3) out vec3 vWorldPos;
 
+// Matches viewport_depth.vert bit for bit so the EQUAL test after a depth
+// pre-pass passes.
+invariant gl_Position;
+
+vec3 DecodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+    {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
 void main()
 {
-    vec4 worldPos = pc.uModel * vec4(aPos, 1.0);
+    vec3 localNormal = kPackedVertices ? DecodeOctahedral(aNormal.xy) : aNormal.xyz;
+    vec4 worldPos = pc.uModel * vec4(aPos.xyz, 1.0);
     gl_Position = ubo.uViewProj * worldPos;
     mat3 normalMat = mat3(transpose(inverse(pc.uModel)));
-    vNormal = normalize(normalMat * aNormal);
+    vNormal = normalize(normalMat * localNormal);
     vColor = aColor.rgb * pc.uColor.rgb;
     vUv = aUv;
     vWorldPos = worldPos.xyz;
@@ -0,0 +1,531 @@
+#include "Aetherion/Rendering/CpuPicker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+
+namespace Aetherion::Rendering {
+namespace {
+constexpr uint32_t kLeafSize = 4;
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+bool InvertMatrix(const float m[16], float out[16]) {
+  float inv[16];
+  inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] +
+           m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+  inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] +
+           m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] +
+           m[12] * m[7] * m[10];
+  inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] +
+           m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+  inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] +
+            m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] +
+            m[12] * m[6] * m[9];
+  inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] +
+           m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] +
+           m[13] * m[3] * m[10];
+  inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] +
+           m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+  inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] +
+           m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] +
+           m[12] * m[3] * m[9];
+  inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] +
+            m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+  inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] +
+           m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+  inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] -
+           m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+  inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] +
+            m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+  inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] +
+            m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] +
+            m[12] * m[2] * m[5];
+  inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] -
+           m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+  inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] +
+           m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+  inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] -
+            m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+  inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] +
+            m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+  const float det =
+      m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+  if (std::fabs(det) < 1e-12f) {
+    return false;
+  }
+  const float invDet = 1.0f / det;
+  for (int i = 0; i < 16; ++i) {
+    out[i] = inv[i] * invDet;
+  }
+  return true;
+}
+
+void TransformPoint(const float m[16], const float p[3], float out[3]) {
+  for (int r = 0; r < 3; ++r) {
+    out[r] = m[r] * p[0] + m[4 + r] * p[1] + m[8 + r] * p[2] + m[12 + r];
+  }
+}
+
+void TransformVector(const float m[16], const float v[3], float out[3]) {
+  for (int r = 0; r < 3; ++r) {
+    out[r] = m[r] * v[0] + m[4 + r] * v[1] + m[8 + r] * v[2];
+  }
+}
+
+// Entry distance of the ray into the box, clamped to 0 when the origin is
+// inside. Returns false when the ray misses the box or it lies behind.
+bool IntersectAabb(const float boundsMin[3], const float boundsMax[3],
+                   const float origin[3], const float direction[3],
+                   float &tNear) {
+  float t0 = 0.0f;
+  float t1 = kInfinity;
+  for (int axis = 0; axis < 3; ++axis) {
+    if (std::fabs(direction[axis]) < 1e-12f) {
+      if (origin[axis] < boundsMin[axis] || origin[axis] > boundsMax[axis]) {
+        return false;
+      }
+      continue;
+    }
+    const float inv = 1.0f / direction[axis];
+    float tA = (boundsMin[axis] - origin[axis]) * inv;
+    float tB = (boundsMax[axis] - origin[axis]) * inv;
+    if (tA > tB) {
+      std::swap(tA, tB);
+    }
+    t0 = std::max(t0, tA);
+    t1 = std::min(t1, tB);
+    if (t0 > t1) {
+      return false;
+    }
+  }
+  tNear = t0;
+  return true;
+}
+
+// Two-sided Moller-Trumbore.
+bool IntersectTriangle(const float origin[3], const float direction[3],
+                       const std::array<float, 3> &a,
+                       const std::array<float, 3> &b,
+                       const std::array<float, 3> &c, float &t) {
+  const float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+  const float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+  const float p[3] = {direction[1] * e2[2] - direction[2] * e2[1],
+                      direction[2] * e2[0] - direction[0] * e2[2],
+                      direction[0] * e2[1] - direction[1] * e2[0]};
+  const float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+  if (std::fabs(det) < 1e-12f) {
+    return false;
+  }
+  const float invDet = 1.0f / det;
+  const float s[3] = {origin[0] - a[0], origin[1] - a[1], origin[2] - a[2]};
+  const float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * invDet;
+  if (u < 0.0f || u > 1.0f) {
+    return false;
+  }
+  const float q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2],
+                      s[0] * e1[1] - s[1] * e1[0]};
+  const float v =
+      (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) *
+      invDet;
+  if (v < 0.0f || u + v > 1.0f) {
+    return false;
+  }
+  t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * invDet;
+  return t >= 0.0f;
+}
+
+float PlaneDistance(const float plane[4], const float p[3]) {
+  return plane[0] * p[0] + plane[1] * p[1] + plane[2] * p[2] + plane[3];
+}
+
+// Conservative: false only when the box is entirely behind one plane.
+bool AabbInsidePlanes(const float boundsMin[3], const float boundsMax[3],
+                      const float planes[6][4]) {
+  for (int i = 0; i < 6; ++i) {
+    const float p[3] = {planes[i][0] >= 0.0f ? boundsMax[0] : boundsMin[0],
+                        planes[i][1] >= 0.0f ? boundsMax[1] : boundsMin[1],
+                        planes[i][2] >= 0.0f ? boundsMax[2] : boundsMin[2]};
+    if (PlaneDistance(planes[i], p) < 0.0f) {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+void CpuPicker::Build(std::vector<Instance> instances,
+                      std::shared_ptr<const Assets::AssetRegistry> registry) {
+  Clear();
+  m_registry = std::move(registry);
+  m_instances.reserve(instances.size());
+  for (auto &instance : instances) {
+    Entry entry{};
+    entry.instance = std::move(instance);
+    if (!InvertMatrix(entry.instance.model, entry.inverseModel)) {
+      // Degenerate scale; nothing can be hit.
+      continue;
+    }
+
+    const auto &lo = entry.instance.boundsMin;
+    const auto &hi = entry.instance.boundsMax;
+    for (int axis = 0; axis < 3; ++axis) {
+      entry.worldMin[axis] = kInfinity;
+      entry.worldMax[axis] = -kInfinity;
+    }
+    for (int corner = 0; corner < 8; ++corner) {
+      const float local[3] = {(corner & 1) ? hi[0] : lo[0],
+                              (corner & 2) ? hi[1] : lo[1],
+                              (corner & 4) ? hi[2] : lo[2]};
+      float world[3];
+      TransformPoint(entry.instance.model, local, world);
+      for (int axis = 0; axis < 3; ++axis) {
+        entry.worldMin[axis] = std::min(entry.worldMin[axis], world[axis]);
+        entry.worldMax[axis] = std::max(entry.worldMax[axis], world[axis]);
+      }
+    }
+    m_instances.push_back(std::move(entry));
+  }
+
+  if (m_instances.empty()) {
+    return;
+  }
+  m_order.resize(m_instances.size());
+  for (uint32_t i = 0; i < m_order.size(); ++i) {
+    m_order[i] = i;
+  }
+  m_nodes.reserve(2 * m_instances.size() / kLeafSize + 1);
+  m_nodes.emplace_back();
+  BuildNode(0, 0, static_cast<uint32_t>(m_order.size()));
+}
+
+void CpuPicker::Clear() {
+  m_registry.reset();
+  m_instances.clear();
+  m_order.clear();
+  m_nodes.clear();
+}
+
+Assets::AssetRegistry::MeshDataHandle
+CpuPicker::FindMesh(const Entry &entry) const {
+  if (!m_registry || entry.instance.meshId.empty()) {
+    return nullptr;
+  }
+  // Only meshes already in memory; a pick never loads one.
+  return m_registry->GetMeshData(entry.instance.meshId);
+}
+
+void CpuPicker::BuildNode(uint32_t node, uint32_t begin, uint32_t end) {
+  float boundsMin[3] = {kInfinity, kInfinity, kInfinity};
+  float boundsMax[3] = {-kInfinity, -kInfinity, -kInfinity};
+  float centroidMin[3] = {kInfinity, kInfinity, kInfinity};
+  float centroidMax[3] = {-kInfinity, -kInfinity, -kInfinity};
+  for (uint32_t i = begin; i < end; ++i) {
+    const Entry &entry = m_instances[m_order[i]];
+    for (int axis = 0; axis < 3; ++axis) {
+      boundsMin[axis] = std::min(boundsMin[axis], entry.worldMin[axis]);
+      boundsMax[axis] = std::max(boundsMax[axis], entry.worldMax[axis]);
+      const float centroid =
+          0.5f * (entry.worldMin[axis] + entry.worldMax[axis]);
+      centroidMin[axis] = std::min(centroidMin[axis], centroid);
+      centroidMax[axis] = std::max(centroidMax[axis], centroid);
+    }
+  }
+  std::copy(boundsMin, boundsMin + 3, m_nodes[node].boundsMin);
+  std::copy(boundsMax, boundsMax + 3, m_nodes[node].boundsMax);
+
+  if (end - begin <= kLeafSize) {
+    m_nodes[node].first = begin;
+    m_nodes[node].count = end - begin;
+    return;
+  }
+
+  // Median split along the axis with the widest spread of centroids.
+  int axis = 0;
+  for (int candidate = 1; candidate < 3; ++candidate) {
+    if (centroidMax[candidate] - centroidMin[candidate] >
+        centroidMax[axis] - centroidMin[axis]) {
+      axis = candidate;
+    }
+  }
+  const uint32_t mid = begin + (end - begin) / 2;
+  std::nth_element(m_order.begin() + begin, m_order.begin() + mid,
+                   m_order.begin() + end, [&](uint32_t a, uint32_t b) {
+                     const Entry &ea = m_instances[a];
+                     const Entry &eb = m_instances[b];
+                     return ea.worldMin[axis] + ea.worldMax[axis] <
+                            eb.worldMin[axis] + eb.worldMax[axis];
+                   });
+
+  const uint32_t left = static_cast<uint32_t>(m_nodes.size());
+  m_nodes.emplace_back();
+  m_nodes.emplace_back();
+  m_nodes[node].first = left;
+  m_nodes[node].count = 0;
+  BuildNode(left, begin, mid);
+  BuildNode(left + 1, mid, end);
+}
+
+CpuPicker::Hit CpuPicker::Raycast(const float origin[3],
+                                  const float direction[3]) const {
+  Hit hit{};
+  const float length =
+      std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] +
+                direction[2] * direction[2]);
+  if (m_nodes.empty() || length <= 0.0f) {
+    return hit;
+  }
+  const float dir[3] = {direction[0] / length, direction[1] / length,
+                        direction[2] / length};
+
+  float best = kInfinity;
+  std::vector<uint32_t> stack;
+  stack.reserve(64);
+  stack.push_back(0);
+  while (!stack.empty()) {
+    const Node &node = m_nodes[stack.back()];
+    stack.pop_back();
+    float tNear = 0.0f;
+    if (!IntersectAabb(node.boundsMin, node.boundsMax, origin, dir, tNear) ||
+        tNear > best) {
+      continue;
+    }
+    if (node.count == 0) {
+      stack.push_back(node.first);
+      stack.push_back(node.first + 1);
+      continue;
+    }
+    for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+      const Entry &entry = m_instances[m_order[i]];
+      float t = 0.0f;
+      if (RefineRay(entry, origin, dir, t) && t < best) {
+        best = t;
+        hit.entityId = entry.instance.entityId;
+        hit.distance = t;
+        hit.valid = true;
+      }
+    }
+  }
+  return hit;
+}
+
+CpuPicker::Hit CpuPicker::RaycastNdc(const float viewProj[16], float ndcX,
+                                     float ndcY) const {
+  float inverse[16];
+  if (m_nodes.empty() || !InvertMatrix(viewProj, inverse)) {
+    return {};
+  }
+  float points[2][3];
+  for (int i = 0; i < 2; ++i) {
+    const float clip[4] = {ndcX, ndcY, static_cast<float>(i), 1.0f};
+    float out[4];
+    for (int r = 0; r < 4; ++r) {
+      out[r] = inverse[r] * clip[0] + inverse[4 + r] * clip[1] +
+               inverse[8 + r] * clip[2] + inverse[12 + r] * clip[3];
+    }
+    if (std::fabs(out[3]) < 1e-12f) {
+      return {};
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+      points[i][axis] = out[axis] / out[3];
+    }
+  }
+  const float direction[3] = {points[1][0] - points[0][0],
+                              points[1][1] - points[0][1],
+                              points[1][2] - points[0][2]};
+  return Raycast(points[0], direction);
+}
+
+bool CpuPicker::RefineRay(const Entry &entry, const float origin[3],
+                          const float direction[3], float &t) const {
+  float tNear = 0.0f;
+  if (!IntersectAabb(entry.worldMin, entry.worldMax, origin, direction,
+                     tNear)) {
+    return false;
+  }
+
+  // Affine maps keep the ray parameter, so hits in mesh space are directly
+  // comparable to world-space distances.
+  float localOrigin[3];
+  float localDir[3];
+  TransformPoint(entry.inverseModel, origin, localOrigin);
+  TransformVector(entry.inverseModel, direction, localDir);
+
+  const auto meshData = FindMesh(entry);
+  const auto *mesh = meshData.get();
+  if (!mesh || mesh->positions.empty()) {
+    float lo[3];
+    float hi[3];
+    for (int axis = 0; axis < 3; ++axis) {
+      lo[axis] = entry.instance.boundsMin[axis];
+      hi[axis] = entry.instance.boundsMax[axis];
+    }
+    return IntersectAabb(lo, hi, localOrigin, localDir, t);
+  }
+
+  const auto &positions = mesh->positions;
+  const size_t vertexCount = positions.size();
+  bool found = false;
+  float closest = kInfinity;
+  auto testTriangle = [&](size_t a, size_t b, size_t c) {
+    if (a >= vertexCount || b >= vertexCount || c >= vertexCount) {
+      return;
+    }
+    float triT = 0.0f;
+    if (IntersectTriangle(localOrigin, localDir, positions[a], positions[b],
+                          positions[c], triT) &&
+        triT < closest) {
+      closest = triT;
+      found = true;
+    }
+  };
+  if (!mesh->indices.empty()) {
+    for (size_t i = 0; i + 2 < mesh->indices.size(); i += 3) {
+      testTriangle(mesh->indices[i], mesh->indices[i + 1],
+                   mesh->indices[i + 2]);
+    }
+  } else {
+    for (size_t i = 0; i + 2 < vertexCount; i += 3) {
+      testTriangle(i, i + 1, i + 2);
+    }
+  }
+  if (found) {
+    t = closest;
+  }
+  return found;
+}
+
+std::vector<Core::EntityId> CpuPicker::SelectRect(const float viewProj[16],
+                                                  float minX, float minY,
+                                                  float maxX,
+                                                  float maxY) const {
+  std::vector<Core::EntityId> result;
+  if (m_nodes.empty()) {
+    return result;
+  }
+  if (minX > maxX) {
+    std::swap(minX, maxX);
+  }
+  if (minY > maxY) {
+    std::swap(minY, maxY);
+  }
+
+  // Clip-space half-spaces written as world-space planes. Rows of the
+  // column-major matrix give clip x, y, z and w; depth is in [0, w].
+  float rows[4][4];
+  for (int r = 0; r < 4; ++r) {
+    for (int c = 0; c < 4; ++c) {
+      rows[r][c] = viewProj[c * 4 + r];
+    }
+  }
+  float planes[6][4];
+  for (int c = 0; c < 4; ++c) {
+    planes[0][c] = rows[0][c] - minX * rows[3][c];
+    planes[1][c] = maxX * rows[3][c] - rows[0][c];
+    planes[2][c] = rows[1][c] - minY * rows[3][c];
+    planes[3][c] = maxY * rows[3][c] - rows[1][c];
+    planes[4][c] = rows[2][c];
+    planes[5][c] = rows[3][c] - rows[2][c];
+  }
+
+  std::vector<uint32_t> selected;
+  std::vector<uint32_t> stack;
+  stack.reserve(64);
+  stack.push_back(0);
+  while (!stack.empty()) {
+    const Node &node = m_nodes[stack.back()];
+    stack.pop_back();
+    if (!AabbInsidePlanes(node.boundsMin, node.boundsMax, planes)) {
+      continue;
+    }
+    if (node.count == 0) {
+      stack.push_back(node.first);
+      stack.push_back(node.first + 1);
+      continue;
+    }
+    for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+      const Entry &entry = m_instances[m_order[i]];
+      if (AabbInsidePlanes(entry.worldMin, entry.worldMax, planes) &&
+          RefineRect(entry, planes)) {
+        selected.push_back(m_order[i]);
+      }
+    }
+  }
+
+  std::sort(selected.begin(), selected.end());
+  std::unordered_set<Core::EntityId> seen;
+  for (uint32_t index : selected) {
+    const Core::EntityId id = m_instances[index].instance.entityId;
+    if (seen.insert(id).second) {
+      result.push_back(id);
+    }
+  }
+  return result;
+}
+
+bool CpuPicker::RefineRect(const Entry &entry,
+                           const float planes[6][4]) const {
+  // Pull the planes into mesh space (transpose(model) * plane) instead of
+  // transforming every vertex.
+  const float *m = entry.instance.model;
+  float local[6][4];
+  for (int i = 0; i < 6; ++i) {
+    for (int c = 0; c < 4; ++c) {
+      local[i][c] = planes[i][0] * m[c * 4] + planes[i][1] * m[c * 4 + 1] +
+                    planes[i][2] * m[c * 4 + 2] + planes[i][3] * m[c * 4 + 3];
+    }
+  }
+
+  // A shape counts as inside unless all of its points lie behind one plane.
+  // This can accept triangles just past a corner of the rectangle, which is
+  // fine for a selection marquee.
+  auto overlaps = [&](const auto &pointAt, size_t count) {
+    for (int i = 0; i < 6; ++i) {
+      bool allOutside = true;
+      for (size_t k = 0; k < count && allOutside; ++k) {
+        const std::array<float, 3> p = pointAt(k);
+        allOutside = PlaneDistance(local[i], p.data()) < 0.0f;
+      }
+      if (allOutside) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  const auto meshData = FindMesh(entry);
+  const auto *mesh = meshData.get();
+  if (!mesh || mesh->positions.empty()) {
+    const auto &lo = entry.instance.boundsMin;
+    const auto &hi = entry.instance.boundsMax;
+    return overlaps(
+        [&](size_t corner) {
+          return std::array<float, 3>{(corner & 1) ? hi[0] : lo[0],
+                                      (corner & 2) ? hi[1] : lo[1],
+                                      (corner & 4) ? hi[2] : lo[2]};
+        },
+        8);
+  }
+
+  const auto &positions = mesh->positions;
+  const size_t vertexCount = positions.size();
+  const size_t triangleCount = mesh->indices.empty()
+                                   ? vertexCount / 3
+                                   : mesh->indices.size() / 3;
+  for (size_t tri = 0; tri < triangleCount; ++tri) {
+    size_t v[3];
+    for (size_t k = 0; k < 3; ++k) {
+      v[k] = mesh->indices.empty() ? tri * 3 + k : mesh->indices[tri * 3 + k];
+    }
+    if (v[0] >= vertexCount || v[1] >= vertexCount || v[2] >= vertexCount) {
+      continue;
+    }
+    if (overlaps([&](size_t k) { return positions[v[k]]; }, 3)) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace Aetherion::Rendering
@@ -0,0 +1,565 @@
+#include "Aetherion/Rendering/GpuResourceCache.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+namespace Aetherion::Rendering {
+namespace {
+// Frames over which mip requests from all viewports are combined.
+constexpr uint64_t kRequestWindow = 8;
+} // namespace
+
+GpuResourceCache::~GpuResourceCache() { Shutdown(); }
+
+void GpuResourceCache::Initialize(VkDevice device, VkQueue queue,
+                                  std::mutex *queueMutex) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_device = device;
+  m_queue = queue;
+  m_queueMutex = queueMutex;
+}
+
+void GpuResourceCache::Shutdown() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  for (auto &batch : m_retireBatches) {
+    for (auto &callback : batch.callbacks) {
+      callback();
+    }
+    if (m_device != VK_NULL_HANDLE && batch.fence != VK_NULL_HANDLE) {
+      vkDestroyFence(m_device, batch.fence, nullptr);
+    }
+  }
+  m_retireBatches.clear();
+  for (auto &callback : m_pendingRetirements) {
+    callback();
+  }
+  m_pendingRetirements.clear();
+
+  // Keep the slots so generations keep counting up; handles held across a
+  // context restart then fail the generation check instead of aliasing.
+  for (uint32_t i = 0; i < m_meshes.slots.size(); ++i) {
+    if (m_meshes.slots[i].live) {
+      Destroy(m_meshes.slots[i].resource);
+      Evict(m_meshes, i);
+    }
+  }
+  for (uint32_t i = 0; i < m_textures.slots.size(); ++i) {
+    if (m_textures.slots[i].live) {
+      Destroy(m_textures.slots[i].resource);
+      Evict(m_textures, i);
+    }
+  }
+  // Evict() queued retirements for resources we just destroyed directly.
+  m_pendingRetirements.clear();
+
+  m_device = VK_NULL_HANDLE;
+  m_queue = VK_NULL_HANDLE;
+  m_queueMutex = nullptr;
+}
+
+GpuResourceCache::MeshHandle
+GpuResourceCache::AcquireMesh(const std::string &assetId) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  MeshHandle handle{};
+  handle.slot = Acquire(m_meshes, assetId);
+  if (handle.IsValid()) {
+    handle.generation = m_meshes.slots[handle.slot].generation;
+  }
+  return handle;
+}
+
+GpuResourceCache::TextureHandle
+GpuResourceCache::AcquireTexture(const std::string &assetId) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  TextureHandle handle{};
+  handle.slot = Acquire(m_textures, assetId);
+  if (handle.IsValid()) {
+    handle.generation = m_textures.slots[handle.slot].generation;
+  }
+  return handle;
+}
+
+GpuResourceCache::MeshHandle
+GpuResourceCache::InsertMesh(const std::string &assetId, const GpuMesh &mesh) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  MeshHandle handle{};
+  handle.slot = Insert(m_meshes, assetId, mesh);
+  handle.generation = m_meshes.slots[handle.slot].generation;
+  return handle;
+}
+
+GpuResourceCache::TextureHandle
+GpuResourceCache::InsertTexture(const std::string &assetId,
+                                const GpuTextureImage &texture,
+                                std::vector<VkDeviceSize> levelBytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  TextureHandle handle{};
+  handle.slot = Insert(m_textures, assetId, texture);
+  const auto &slot = m_textures.slots[handle.slot];
+  handle.generation = slot.generation;
+
+  // Only track the copy that actually became resident.
+  if (!levelBytes.empty() && slot.resource.image == texture.image) {
+    TextureStream stream{};
+    stream.floorMip =
+        FloorMip(texture, static_cast<uint32_t>(levelBytes.size()));
+    stream.levelBytes = std::move(levelBytes);
+    stream.windowStart = m_frame;
+    stream.lastUsedFrame = m_frame;
+    m_textureStreams[handle.slot] = std::move(stream);
+  }
+  return handle;
+}
+
+const GpuMesh *GpuResourceCache::GetMesh(MeshHandle handle) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return Get(m_meshes, handle.slot, handle.generation);
+}
+
+const GpuTextureImage *
+GpuResourceCache::GetTexture(TextureHandle handle) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return Get(m_textures, handle.slot, handle.generation);
+}
+
+void GpuResourceCache::ReleaseMesh(MeshHandle handle) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Release(m_meshes, handle.slot, handle.generation);
+}
+
+void GpuResourceCache::ReleaseTexture(TextureHandle handle) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Release(m_textures, handle.slot, handle.generation);
+}
+
+void GpuResourceCache::HandleAssetChanges(
+    const std::vector<Assets::AssetRegistry::AssetChange> &changes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto &change : changes) {
+    const bool invalidate =
+        change.kind == Assets::AssetRegistry::AssetChange::Kind::Removed ||
+        change.kind == Assets::AssetRegistry::AssetChange::Kind::Modified ||
+        change.kind == Assets::AssetRegistry::AssetChange::Kind::Moved;
+    if (!invalidate) {
+      continue;
+    }
+
+    if (change.type == Assets::AssetRegistry::AssetType::Mesh) {
+      Invalidate(m_meshes, change.id);
+    } else if (change.type == Assets::AssetRegistry::AssetType::Texture) {
+      Invalidate(m_textures, change.id);
+    }
+  }
+}
+
+void GpuResourceCache::CollectGarbage() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_device == VK_NULL_HANDLE) {
+    return;
+  }
+  ++m_frame;
+
+  // An empty submission signals its fence once everything submitted to the
+  // queue before it has finished, which covers every viewport's frames.
+  if (!m_pendingRetirements.empty()) {
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    RetireBatch batch{};
+    bool submitted = false;
+    if (vkCreateFence(m_device, &fenceInfo, nullptr, &batch.fence) ==
+        VK_SUCCESS) {
+      std::unique_lock<std::mutex> queueLock;
+      if (m_queueMutex) {
+        queueLock = std::unique_lock<std::mutex>(*m_queueMutex);
+      }
+      submitted =
+          vkQueueSubmit(m_queue, 0, nullptr, batch.fence) == VK_SUCCESS;
+    }
+    if (submitted) {
+      batch.callbacks = std::move(m_pendingRetirements);
+      m_pendingRetirements.clear();
+      m_retireBatches.push_back(std::move(batch));
+    } else if (batch.fence != VK_NULL_HANDLE) {
+      vkDestroyFence(m_device, batch.fence, nullptr);
+    }
+  }
+
+  for (auto it = m_retireBatches.begin(); it != m_retireBatches.end();) {
+    if (vkGetFenceStatus(m_device, it->fence) != VK_SUCCESS) {
+      ++it;
+      continue;
+    }
+    for (auto &callback : it->callbacks) {
+      callback();
+    }
+    vkDestroyFence(m_device, it->fence, nullptr);
+    it = m_retireBatches.erase(it);
+  }
+}
+
+GpuResourceCache::Stats GpuResourceCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Stats stats{};
+  stats.meshes = static_cast<uint32_t>(m_meshes.byAssetId.size());
+  stats.textures = static_cast<uint32_t>(m_textures.byAssetId.size());
+  for (const auto &slot : m_meshes.slots) {
+    stats.references += slot.live ? slot.refCount : 0;
+  }
+  for (const auto &slot : m_textures.slots) {
+    stats.references += slot.live ? slot.refCount : 0;
+  }
+  stats.pendingRetirements =
+      static_cast<uint32_t>(m_pendingRetirements.size());
+  for (const auto &batch : m_retireBatches) {
+    stats.pendingRetirements += static_cast<uint32_t>(batch.callbacks.size());
+  }
+  return stats;
+}
+
+void GpuResourceCache::SetTextureStreamingSettings(
+    const TextureStreamingSettings &settings) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_streamingSettings = settings;
+  for (auto &[index, stream] : m_textureStreams) {
+    stream.floorMip =
+        FloorMip(m_textures.slots[index].resource,
+                 static_cast<uint32_t>(stream.levelBytes.size()));
+  }
+}
+
+GpuResourceCache::TextureStreamingSettings
+GpuResourceCache::GetTextureStreamingSettings() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_streamingSettings;
+}
+
+GpuResourceCache::TextureStreamingStats
+GpuResourceCache::GetTextureStreamingStats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  TextureStreamingStats stats = m_streamingStats;
+  stats.budgetBytes = m_streamingSettings.budgetBytes;
+  stats.textures = static_cast<uint32_t>(m_textureStreams.size());
+  for (const auto &[index, stream] : m_textureStreams) {
+    const uint32_t baseMip = m_textures.slots[index].resource.baseMip;
+    const uint32_t wanted = WantedMip(stream);
+    stats.residentBytes += ResidentBytes(stream, baseMip);
+    stats.requestedBytes += ResidentBytes(stream, wanted);
+    stats.fullyResident += baseMip == 0 ? 1 : 0;
+    stats.pendingUpgrades += wanted < baseMip ? 1 : 0;
+  }
+  return stats;
+}
+
+void GpuResourceCache::RequestTextureMip(TextureHandle handle, uint32_t mip) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!Get(m_textures, handle.slot, handle.generation)) {
+    return;
+  }
+  auto it = m_textureStreams.find(handle.slot);
+  if (it == m_textureStreams.end()) {
+    return;
+  }
+
+  auto &stream = it->second;
+  if (m_frame - stream.windowStart >= kRequestWindow) {
+    // A window without any request leaves no demand behind.
+    stream.previousRequestedMip =
+        m_frame - stream.windowStart < 2 * kRequestWindow
+            ? stream.requestedMip
+            : UINT32_MAX;
+    stream.requestedMip = UINT32_MAX;
+    stream.windowStart = m_frame;
+  }
+  stream.requestedMip = std::min(stream.requestedMip, mip);
+  stream.lastUsedFrame = m_frame;
+}
+
+std::vector<GpuResourceCache::StreamingWork>
+GpuResourceCache::TakeStreamingWork() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<StreamingWork> work;
+  m_streamingStats.uploadsLastFrame = 0;
+  m_streamingStats.uploadedBytesLastFrame = 0;
+  if (!m_streamingSettings.enabled || m_device == VK_NULL_HANDLE) {
+    return work;
+  }
+
+  struct Candidate {
+    uint32_t slot{0};
+    uint32_t baseMip{0};
+    uint32_t wantedMip{0};
+    uint64_t lastUsedFrame{0};
+  };
+  std::vector<Candidate> upgrades;
+  std::vector<Candidate> demotions;
+  VkDeviceSize resident = 0;
+  for (const auto &[index, stream] : m_textureStreams) {
+    const auto &slot = m_textures.slots[index];
+    Candidate candidate{index, slot.resource.baseMip, WantedMip(stream),
+                        stream.lastUsedFrame};
+    resident += ResidentBytes(stream, candidate.baseMip);
+    if (candidate.wantedMip < candidate.baseMip) {
+      upgrades.push_back(candidate);
+    } else if (candidate.wantedMip > candidate.baseMip) {
+      demotions.push_back(candidate);
+    }
+  }
+
+  // Least recently used first for eviction, most recently used and furthest
+  // from its wanted level first for upgrades.
+  std::sort(demotions.begin(), demotions.end(),
+            [](const Candidate &a, const Candidate &b) {
+              return a.lastUsedFrame < b.lastUsedFrame;
+            });
+  std::sort(upgrades.begin(), upgrades.end(),
+            [](const Candidate &a, const Candidate &b) {
+              if (a.lastUsedFrame != b.lastUsedFrame) {
+                return a.lastUsedFrame > b.lastUsedFrame;
+              }
+              return a.baseMip - a.wantedMip > b.baseMip - b.wantedMip;
+            });
+
+  // Evicting mips means rebuilding the image without its top levels, which
+  // is a (small) upload of its own.
+  VkDeviceSize uploaded = 0;
+  size_t nextDemotion = 0;
+  auto evictOne = [&]() {
+    if (nextDemotion == demotions.size()) {
+      return false;
+    }
+    const auto &candidate = demotions[nextDemotion++];
+    const auto &stream = m_textureStreams[candidate.slot];
+    const VkDeviceSize after = ResidentBytes(stream, candidate.wantedMip);
+    resident -= ResidentBytes(stream, candidate.baseMip) - after;
+    uploaded += after;
+    work.push_back({m_textures.slots[candidate.slot].assetId,
+                    candidate.wantedMip});
+    ++m_streamingStats.evictions;
+    return true;
+  };
+
+  const VkDeviceSize budget = m_streamingSettings.budgetBytes;
+  while (resident > budget && evictOne()) {
+  }
+
+  for (const auto &candidate : upgrades) {
+    const auto &stream = m_textureStreams[candidate.slot];
+    const VkDeviceSize current = ResidentBytes(stream, candidate.baseMip);
+    uint32_t target = candidate.wantedMip;
+    while (target < candidate.baseMip) {
+      const VkDeviceSize growth = ResidentBytes(stream, target) - current;
+      if (resident + growth <= budget) {
+        break;
+      }
+      if (!evictOne()) {
+        ++target;
+      }
+    }
+    if (target >= candidate.baseMip) {
+      continue;
+    }
+
+    // The image is rebuilt with every resident level, so that is what moves
+    // over the bus. Always admit one upload so large textures still progress.
+    const VkDeviceSize cost = ResidentBytes(stream, target);
+    if (uploaded > 0 &&
+        uploaded + cost > m_streamingSettings.uploadBytesPerFrame) {
+      break;
+    }
+    resident += cost - current;
+    uploaded += cost;
+    work.push_back({m_textures.slots[candidate.slot].assetId, target});
+  }
+
+  m_streamingStats.uploadsLastFrame = static_cast<uint32_t>(work.size());
+  m_streamingStats.uploadedBytesLastFrame = uploaded;
+  m_streamingStats.totalUploads += work.size();
+  m_streamingStats.totalUploadedBytes += uploaded;
+  return work;
+}
+
+void GpuResourceCache::ReplaceTexture(const std::string &assetId,
+                                      const GpuTextureImage &texture) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_textures.byAssetId.find(assetId);
+  if (it == m_textures.byAssetId.end()) {
+    // Invalidated while the new image was being built.
+    Retire(texture);
+    return;
+  }
+  auto &slot = m_textures.slots[it->second];
+  Retire(slot.resource);
+  slot.resource = texture;
+}
+
+uint32_t GpuResourceCache::FloorMip(const GpuTextureImage &texture,
+                                    uint32_t levelCount) const {
+  uint32_t mip = 0;
+  uint32_t size = std::max(texture.width, texture.height);
+  while (mip + 1 < levelCount &&
+         size > m_streamingSettings.residentFloorSize) {
+    size = std::max(1u, size / 2);
+    ++mip;
+  }
+  return mip;
+}
+
+uint32_t GpuResourceCache::WantedMip(const TextureStream &stream) const {
+  if (m_frame - stream.lastUsedFrame > m_streamingSettings.idleFrames) {
+    return stream.floorMip;
+  }
+  const uint32_t requested =
+      std::min(stream.requestedMip, stream.previousRequestedMip);
+  return std::min(requested, stream.floorMip);
+}
+
+VkDeviceSize GpuResourceCache::ResidentBytes(const TextureStream &stream,
+                                             uint32_t baseMip) {
+  VkDeviceSize bytes = 0;
+  for (size_t level = baseMip; level < stream.levelBytes.size(); ++level) {
+    bytes += stream.levelBytes[level];
+  }
+  return bytes;
+}
+
+template <typename Resource>
+uint32_t GpuResourceCache::Acquire(Table<Resource> &table,
+                                   const std::string &assetId) {
+  auto it = table.byAssetId.find(assetId);
+  if (it == table.byAssetId.end()) {
+    return UINT32_MAX;
+  }
+  ++table.slots[it->second].refCount;
+  return it->second;
+}
+
+template <typename Resource>
+uint32_t GpuResourceCache::Insert(Table<Resource> &table,
+                                  const std::string &assetId,
+                                  const Resource &resource) {
+  if (auto it = table.byAssetId.find(assetId); it != table.byAssetId.end()) {
+    Retire(resource);
+    ++table.slots[it->second].refCount;
+    return it->second;
+  }
+
+  uint32_t index = 0;
+  if (!table.freeSlots.empty()) {
+    index = table.freeSlots.back();
+    table.freeSlots.pop_back();
+  } else {
+    index = static_cast<uint32_t>(table.slots.size());
+    table.slots.emplace_back();
+  }
+
+  auto &slot = table.slots[index];
+  slot.assetId = assetId;
+  slot.resource = resource;
+  slot.refCount = 1;
+  slot.live = true;
+  table.byAssetId.emplace(assetId, index);
+  return index;
+}
+
+template <typename Resource>
+const Resource *GpuResourceCache::Get(const Table<Resource> &table,
+                                      uint32_t slot,
+                                      uint32_t generation) const {
+  if (slot >= table.slots.size()) {
+    return nullptr;
+  }
+  const auto &entry = table.slots[slot];
+  if (!entry.live || entry.generation != generation) {
+    return nullptr;
+  }
+  return &entry.resource;
+}
+
+template <typename Resource>
+void GpuResourceCache::Release(Table<Resource> &table, uint32_t slot,
+                               uint32_t generation) {
+  if (slot >= table.slots.size()) {
+    return;
+  }
+  auto &entry = table.slots[slot];
+  if (!entry.live || entry.generation != generation || entry.refCount == 0) {
+    return;
+  }
+  if (--entry.refCount == 0) {
+    Evict(table, slot);
+  }
+}
+
+template <typename Resource>
+void GpuResourceCache::Invalidate(Table<Resource> &table,
+                                  const std::string &assetId) {
+  if (auto it = table.byAssetId.find(assetId); it != table.byAssetId.end()) {
+    Evict(table, it->second);
+  }
+}
+
+template <typename Resource>
+void GpuResourceCache::Evict(Table<Resource> &table, uint32_t slot) {
+  auto &entry = table.slots[slot];
+  Retire(entry.resource);
+  if constexpr (std::is_same_v<Resource, GpuTextureImage>) {
+    m_textureStreams.erase(slot);
+  }
+  table.byAssetId.erase(entry.assetId);
+  entry.assetId.clear();
+  entry.resource = {};
+  entry.refCount = 0;
+  entry.live = false;
+  ++entry.generation;
+  table.freeSlots.push_back(slot);
+}
+
+void GpuResourceCache::Retire(const GpuMesh &mesh) {
+  m_pendingRetirements.push_back([this, mesh]() { Destroy(mesh); });
+}
+
+void GpuResourceCache::Retire(const GpuTextureImage &texture) {
+  m_pendingRetirements.push_back([this, texture]() { Destroy(texture); });
+}
+
+void GpuResourceCache::Destroy(const GpuMesh &mesh) const {
+  if (m_device == VK_NULL_HANDLE) {
+    return;
+  }
+  if (mesh.vertexBuffer != VK_NULL_HANDLE) {
+    vkDestroyBuffer(m_device, mesh.vertexBuffer, nullptr);
+  }
+  if (mesh.vertexMemory != VK_NULL_HANDLE) {
+    vkFreeMemory(m_device, mesh.vertexMemory, nullptr);
+  }
+  if (mesh.indexBuffer != VK_NULL_HANDLE) {
+    vkDestroyBuffer(m_device, mesh.indexBuffer, nullptr);
+  }
+  if (mesh.indexMemory != VK_NULL_HANDLE) {
+    vkFreeMemory(m_device, mesh.indexMemory, nullptr);
+  }
+  if (mesh.positionBuffer != VK_NULL_HANDLE) {
+    vkDestroyBuffer(m_device, mesh.positionBuffer, nullptr);
+  }
+  if (mesh.positionMemory != VK_NULL_HANDLE) {
+    vkFreeMemory(m_device, mesh.positionMemory, nullptr);
+  }
+}
+
+void GpuResourceCache::Destroy(const GpuTextureImage &texture) const {
+  if (m_device == VK_NULL_HANDLE) {
+    return;
+  }
+  if (texture.view != VK_NULL_HANDLE) {
+    vkDestroyImageView(m_device, texture.view, nullptr);
+  }
+  if (texture.image != VK_NULL_HANDLE) {
+    vkDestroyImage(m_device, texture.image, nullptr);
+  }
+  if (texture.memory != VK_NULL_HANDLE) {
+    vkFreeMemory(m_device, texture.memory, nullptr);
+  }
+}
+} // namespace Aetherion::Rendering
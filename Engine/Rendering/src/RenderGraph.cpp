@@ -0,0 +1,544 @@
+#include "Aetherion/Rendering/RenderGraph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace Aetherion::Rendering {
+namespace {
+constexpr VkAccessFlags kWriteAccessMask =
+    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+struct AccessInfo {
+  VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+  VkPipelineStageFlags stages{0};
+  VkAccessFlags access{0};
+};
+
+AccessInfo Describe(RenderGraphAccess access, bool write) {
+  AccessInfo info{};
+  switch (access) {
+  case RenderGraphAccess::ColorAttachment:
+    info.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    info.stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    info.access = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+    if (write) {
+      info.access |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    }
+    break;
+  case RenderGraphAccess::DepthAttachment:
+    info.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    info.stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                  VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    info.access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    if (write) {
+      info.access |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    }
+    break;
+  case RenderGraphAccess::FragmentSampled:
+    info.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    info.stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    info.access = VK_ACCESS_SHADER_READ_BIT;
+    break;
+  case RenderGraphAccess::TransferSrc:
+    info.layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    info.access = VK_ACCESS_TRANSFER_READ_BIT;
+    break;
+  case RenderGraphAccess::TransferDst:
+    info.layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    info.access = VK_ACCESS_TRANSFER_WRITE_BIT;
+    break;
+  }
+  return info;
+}
+
+// Stages a barrier has to wait on; nothing recorded yet means top of pipe.
+VkPipelineStageFlags SourceStages(VkPipelineStageFlags stages) {
+  return stages != 0 ? stages
+                     : static_cast<VkPipelineStageFlags>(
+                           VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+}
+
+uint32_t FindDeviceLocalMemoryType(VkPhysicalDevice gpu, uint32_t typeBits) {
+  VkPhysicalDeviceMemoryProperties memProps{};
+  vkGetPhysicalDeviceMemoryProperties(gpu, &memProps);
+  for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i) {
+    if ((typeBits & (1u << i)) &&
+        (memProps.memoryTypes[i].propertyFlags &
+         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+      return i;
+    }
+  }
+  throw std::runtime_error("RenderGraph: no device-local memory type");
+}
+} // namespace
+
+void RenderGraph::PassBuilder::Read(ResourceId resource,
+                                    RenderGraphAccess access) {
+  m_graph.AddUse(m_pass, resource, access, true, false);
+}
+
+void RenderGraph::PassBuilder::Write(ResourceId resource,
+                                     RenderGraphAccess access) {
+  if (access == RenderGraphAccess::FragmentSampled ||
+      access == RenderGraphAccess::TransferSrc) {
+    throw std::runtime_error("RenderGraph: read-only access used as write");
+  }
+  m_graph.AddUse(m_pass, resource, access, false, true);
+}
+
+void RenderGraph::PassBuilder::ReadWrite(ResourceId resource,
+                                         RenderGraphAccess access) {
+  if (access == RenderGraphAccess::FragmentSampled ||
+      access == RenderGraphAccess::TransferSrc) {
+    throw std::runtime_error("RenderGraph: read-only access used as write");
+  }
+  m_graph.AddUse(m_pass, resource, access, true, true);
+}
+
+void RenderGraph::PassBuilder::SetSideEffects() {
+  m_graph.m_passes[m_pass].sideEffects = true;
+}
+
+RenderGraph::~RenderGraph() { Reset(); }
+
+RenderGraph::ResourceId RenderGraph::CreateImage(const ImageDesc &desc) {
+  Resource resource{};
+  resource.name = desc.name;
+  resource.desc = desc;
+  m_resources.push_back(std::move(resource));
+  return static_cast<ResourceId>(m_resources.size() - 1);
+}
+
+RenderGraph::ResourceId RenderGraph::ImportImage(const ImportDesc &desc) {
+  Resource resource{};
+  resource.name = desc.name;
+  resource.imported = true;
+  resource.desc.aspect = desc.aspect;
+  resource.initialStage = desc.initialStage;
+  resource.finalLayout = desc.finalLayout;
+  m_resources.push_back(std::move(resource));
+  return static_cast<ResourceId>(m_resources.size() - 1);
+}
+
+RenderGraph::PassId
+RenderGraph::AddPass(std::string name,
+                     const std::function<void(PassBuilder &)> &setup,
+                     std::function<void(VkCommandBuffer)> execute) {
+  if (m_compiled) {
+    throw std::runtime_error("RenderGraph: passes added after Compile()");
+  }
+  Pass pass{};
+  pass.name = std::move(name);
+  pass.execute = std::move(execute);
+  m_passes.push_back(std::move(pass));
+  const auto id = static_cast<PassId>(m_passes.size() - 1);
+  if (setup) {
+    PassBuilder builder(*this, id);
+    setup(builder);
+  }
+  return id;
+}
+
+void RenderGraph::AddUse(PassId pass, ResourceId resource,
+                         RenderGraphAccess access, bool read, bool write) {
+  if (resource >= m_resources.size()) {
+    throw std::runtime_error("RenderGraph: pass '" + m_passes[pass].name +
+                             "' uses an unknown resource");
+  }
+  auto &uses = m_passes[pass].uses;
+  for (const auto &use : uses) {
+    if (use.resource == resource) {
+      throw std::runtime_error("RenderGraph: pass '" + m_passes[pass].name +
+                               "' declares '" + m_resources[resource].name +
+                               "' twice");
+    }
+  }
+  uses.push_back({resource, access, read, write});
+}
+
+void RenderGraph::Compile(VkPhysicalDevice gpu, VkDevice device) {
+  DestroyGpuObjects();
+  m_device = device;
+
+  std::vector<uint32_t> first(m_resources.size(), UINT32_MAX);
+  std::vector<uint32_t> last(m_resources.size(), 0);
+  for (uint32_t p = 0; p < m_passes.size(); ++p) {
+    for (const auto &use : m_passes[p].uses) {
+      first[use.resource] = std::min(first[use.resource], p);
+      last[use.resource] = std::max(last[use.resource], p);
+    }
+  }
+
+  std::vector<ResourceId> transients;
+  std::vector<VkMemoryRequirements> requirements(m_resources.size());
+  for (ResourceId id = 0; id < m_resources.size(); ++id) {
+    Resource &resource = m_resources[id];
+    if (resource.imported || first[id] == UINT32_MAX) {
+      continue;
+    }
+
+    VkImageCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    info.imageType = VK_IMAGE_TYPE_2D;
+    info.extent = {resource.desc.extent.width, resource.desc.extent.height, 1};
+    info.mipLevels = 1;
+    info.arrayLayers = 1;
+    info.format = resource.desc.format;
+    info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    info.usage = resource.desc.usage;
+    info.samples = VK_SAMPLE_COUNT_1_BIT;
+    info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (vkCreateImage(device, &info, nullptr, &resource.image) != VK_SUCCESS) {
+      throw std::runtime_error("RenderGraph: failed to create image '" +
+                               resource.name + "'");
+    }
+    vkGetImageMemoryRequirements(device, resource.image, &requirements[id]);
+    transients.push_back(id);
+  }
+
+  // Largest first, so smaller images fall into blocks that are already big
+  // enough. Every member is bound at offset 0 of its block.
+  std::stable_sort(transients.begin(), transients.end(),
+                   [&](ResourceId a, ResourceId b) {
+                     return requirements[a].size > requirements[b].size;
+                   });
+  for (ResourceId id : transients) {
+    const auto &req = requirements[id];
+    uint32_t chosen = UINT32_MAX;
+    for (uint32_t b = 0; b < m_blocks.size() && chosen == UINT32_MAX; ++b) {
+      const MemoryBlock &block = m_blocks[b];
+      if ((block.memoryTypeBits & req.memoryTypeBits) == 0) {
+        continue;
+      }
+      const bool disjoint = std::all_of(
+          block.members.begin(), block.members.end(), [&](ResourceId other) {
+            return last[other] < first[id] || last[id] < first[other];
+          });
+      if (disjoint) {
+        chosen = b;
+      }
+    }
+    if (chosen == UINT32_MAX) {
+      m_blocks.push_back({});
+      m_blocks.back().memoryTypeBits = req.memoryTypeBits;
+      chosen = static_cast<uint32_t>(m_blocks.size() - 1);
+    }
+
+    MemoryBlock &block = m_blocks[chosen];
+    block.members.push_back(id);
+    block.size = std::max(block.size, req.size);
+    block.memoryTypeBits &= req.memoryTypeBits;
+    m_resources[id].block = chosen;
+    m_stats.unaliasedBytes += req.size;
+  }
+
+  for (auto &block : m_blocks) {
+    VkMemoryAllocateInfo alloc{};
+    alloc.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc.allocationSize = block.size;
+    alloc.memoryTypeIndex =
+        FindDeviceLocalMemoryType(gpu, block.memoryTypeBits);
+    if (vkAllocateMemory(device, &alloc, nullptr, &block.memory) !=
+        VK_SUCCESS) {
+      throw std::runtime_error("RenderGraph: failed to allocate memory");
+    }
+    m_stats.transientBytes += block.size;
+
+    for (ResourceId id : block.members) {
+      Resource &resource = m_resources[id];
+      vkBindImageMemory(device, resource.image, block.memory, 0);
+
+      VkImageViewCreateInfo view{};
+      view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+      view.image = resource.image;
+      view.viewType = VK_IMAGE_VIEW_TYPE_2D;
+      view.format = resource.desc.format;
+      view.subresourceRange.aspectMask = resource.desc.aspect;
+      view.subresourceRange.levelCount = 1;
+      view.subresourceRange.layerCount = 1;
+      if (vkCreateImageView(device, &view, nullptr, &resource.view) !=
+          VK_SUCCESS) {
+        throw std::runtime_error("RenderGraph: failed to create view for '" +
+                                 resource.name + "'");
+      }
+    }
+  }
+
+  m_stats.passes = static_cast<uint32_t>(m_passes.size());
+  m_stats.transientImages = static_cast<uint32_t>(transients.size());
+  m_stats.memoryBlocks = static_cast<uint32_t>(m_blocks.size());
+  m_compiled = true;
+}
+
+void RenderGraph::DestroyGpuObjects() {
+  if (m_device != VK_NULL_HANDLE) {
+    for (auto &resource : m_resources) {
+      if (resource.imported) {
+        continue;
+      }
+      if (resource.view != VK_NULL_HANDLE) {
+        vkDestroyImageView(m_device, resource.view, nullptr);
+      }
+      if (resource.image != VK_NULL_HANDLE) {
+        vkDestroyImage(m_device, resource.image, nullptr);
+      }
+    }
+    for (auto &block : m_blocks) {
+      if (block.memory != VK_NULL_HANDLE) {
+        vkFreeMemory(m_device, block.memory, nullptr);
+      }
+    }
+  }
+  for (auto &resource : m_resources) {
+    resource.image = VK_NULL_HANDLE;
+    resource.view = VK_NULL_HANDLE;
+    resource.block = UINT32_MAX;
+  }
+  m_blocks.clear();
+  m_stats = {};
+  m_compiled = false;
+}
+
+void RenderGraph::Reset() {
+  DestroyGpuObjects();
+  m_resources.clear();
+  m_passes.clear();
+  m_device = VK_NULL_HANDLE;
+}
+
+void RenderGraph::SetImportedImage(ResourceId resource, VkImage image,
+                                   VkImageView view,
+                                   VkImageLayout currentLayout) {
+  Resource &target = m_resources.at(resource);
+  if (!target.imported) {
+    throw std::runtime_error("RenderGraph: '" + target.name +
+                             "' is not an imported image");
+  }
+  target.image = image;
+  target.view = view;
+  target.importedLayout = currentLayout;
+}
+
+void RenderGraph::SetPassEnabled(PassId pass, bool enabled) {
+  m_passes.at(pass).enabled = enabled;
+}
+
+void RenderGraph::CullPasses(std::vector<bool> &live) const {
+  // Walk backwards: a pass survives when it has side effects, writes an
+  // imported image or writes something a surviving later pass reads.
+  live.assign(m_passes.size(), false);
+  std::vector<bool> demanded(m_resources.size(), false);
+  for (size_t p = m_passes.size(); p-- > 0;) {
+    const Pass &pass = m_passes[p];
+    if (!pass.enabled) {
+      continue;
+    }
+    bool needed = pass.sideEffects;
+    for (const auto &use : pass.uses) {
+      if (use.write &&
+          (m_resources[use.resource].imported || demanded[use.resource])) {
+        needed = true;
+      }
+    }
+    if (!needed) {
+      continue;
+    }
+    live[p] = true;
+    for (const auto &use : pass.uses) {
+      if (use.write) {
+        demanded[use.resource] = false;
+      }
+    }
+    for (const auto &use : pass.uses) {
+      if (use.read) {
+        demanded[use.resource] = true;
+      }
+    }
+  }
+}
+
+void RenderGraph::AppendBarrier(const Use &use, VkPipelineStageFlags &srcStages,
+                                VkPipelineStageFlags &dstStages,
+                                std::vector<VkImageMemoryBarrier> &barriers) {
+  Resource &resource = m_resources[use.resource];
+  const AccessInfo info = Describe(use.access, use.write);
+
+  VkImageLayout oldLayout = resource.layout;
+  VkPipelineStageFlags prevStages = resource.stages;
+  VkAccessFlags prevAccess = resource.accesses;
+  MemoryBlock *block =
+      resource.imported ? nullptr : &m_blocks[resource.block];
+  if (block && block->owner != use.resource) {
+    // The memory last held another image: its contents are dead, but its
+    // accesses still have to finish before this image takes over.
+    oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    prevStages = block->stages;
+    prevAccess = block->accesses;
+    block->owner = use.resource;
+  }
+
+  const bool prevWrote = (prevAccess & kWriteAccessMask) != 0;
+  const bool needsBarrier = oldLayout != info.layout || prevWrote ||
+                            (use.write && prevStages != 0);
+  if (needsBarrier) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = info.layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = resource.image;
+    barrier.subresourceRange.aspectMask = resource.desc.aspect;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.srcAccessMask = prevAccess & kWriteAccessMask;
+    barrier.dstAccessMask = info.access;
+    barriers.push_back(barrier);
+
+    srcStages |= SourceStages(prevStages);
+    dstStages |= info.stages;
+    resource.stages = info.stages;
+    resource.accesses = info.access;
+  } else {
+    // Read after read in the same layout; remember both readers so a later
+    // write waits for all of them.
+    resource.stages |= info.stages;
+    resource.accesses |= info.access;
+  }
+  resource.layout = info.layout;
+  if (block) {
+    block->stages = resource.stages;
+    block->accesses = resource.accesses;
+  }
+}
+
+void RenderGraph::Execute(VkCommandBuffer cb, VkQueryPool queryPool) {
+  if (!m_compiled) {
+    throw std::runtime_error("RenderGraph: Execute() before Compile()");
+  }
+
+  // Transients never carry contents across frames; the caller has waited for
+  // the previous use of this command buffer, so tracking starts from scratch.
+  for (auto &resource : m_resources) {
+    resource.layout =
+        resource.imported ? resource.importedLayout : VK_IMAGE_LAYOUT_UNDEFINED;
+    resource.stages = resource.imported ? resource.initialStage : 0;
+    resource.accesses = 0;
+  }
+  for (auto &block : m_blocks) {
+    block.owner = kInvalidResource;
+    block.stages = 0;
+    block.accesses = 0;
+  }
+
+  std::vector<bool> live;
+  CullPasses(live);
+  m_stats.executedPasses = 0;
+  m_stats.barriers = 0;
+
+  std::vector<VkImageMemoryBarrier> barriers;
+  for (uint32_t p = 0; p < m_passes.size(); ++p) {
+    Pass &pass = m_passes[p];
+    if (queryPool != VK_NULL_HANDLE) {
+      vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool,
+                          p * 2);
+    }
+    pass.executed = live[p];
+    pass.cpuMs = 0.0;
+    if (pass.executed) {
+      const auto cpuStart = std::chrono::steady_clock::now();
+      barriers.clear();
+      VkPipelineStageFlags srcStages = 0;
+      VkPipelineStageFlags dstStages = 0;
+      for (const auto &use : pass.uses) {
+        if (m_resources[use.resource].image == VK_NULL_HANDLE) {
+          throw std::runtime_error("RenderGraph: '" +
+                                   m_resources[use.resource].name +
+                                   "' has no image bound");
+        }
+        AppendBarrier(use, srcStages, dstStages, barriers);
+      }
+      if (!barriers.empty()) {
+        vkCmdPipelineBarrier(cb, srcStages, dstStages, 0, 0, nullptr, 0,
+                             nullptr, static_cast<uint32_t>(barriers.size()),
+                             barriers.data());
+        m_stats.barriers += static_cast<uint32_t>(barriers.size());
+      }
+      if (pass.execute) {
+        pass.execute(cb);
+      }
+      pass.cpuMs = std::chrono::duration<double, std::milli>(
+                       std::chrono::steady_clock::now() - cpuStart)
+                       .count();
+      ++m_stats.executedPasses;
+    }
+    if (queryPool != VK_NULL_HANDLE) {
+      vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool,
+                          p * 2 + 1);
+    }
+  }
+
+  barriers.clear();
+  VkPipelineStageFlags srcStages = 0;
+  for (auto &resource : m_resources) {
+    if (!resource.imported || resource.image == VK_NULL_HANDLE ||
+        resource.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED ||
+        resource.finalLayout == resource.layout) {
+      continue;
+    }
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = resource.layout;
+    barrier.newLayout = resource.finalLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = resource.image;
+    barrier.subresourceRange.aspectMask = resource.desc.aspect;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.srcAccessMask = resource.accesses & kWriteAccessMask;
+    barrier.dstAccessMask = 0;
+    barriers.push_back(barrier);
+    srcStages |= SourceStages(resource.stages);
+    resource.layout = resource.finalLayout;
+  }
+  if (!barriers.empty()) {
+    vkCmdPipelineBarrier(cb, srcStages, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         0, 0, nullptr, 0, nullptr,
+                         static_cast<uint32_t>(barriers.size()),
+                         barriers.data());
+    m_stats.barriers += static_cast<uint32_t>(barriers.size());
+  }
+}
+
+VkImage RenderGraph::GetImage(ResourceId resource) const {
+  return resource < m_resources.size() ? m_resources[resource].image
+                                       : VK_NULL_HANDLE;
+}
+
+VkImageView RenderGraph::GetImageView(ResourceId resource) const {
+  return resource < m_resources.size() ? m_resources[resource].view
+                                       : VK_NULL_HANDLE;
+}
+
+const std::string &RenderGraph::GetPassName(PassId pass) const {
+  return m_passes.at(pass).name;
+}
+
+double RenderGraph::GetPassCpuMs(PassId pass) const {
+  return pass < m_passes.size() ? m_passes[pass].cpuMs : 0.0;
+}
+
+bool RenderGraph::WasPassExecuted(PassId pass) const {
+  return pass < m_passes.size() && m_passes[pass].executed;
+}
+
+RenderGraph::Stats RenderGraph::GetStats() const { return m_stats; }
+} // namespace Aetherion::Rendering
@@ -0,0 +1,201 @@
+#include "Aetherion/Rendering/RenderThread.h"
+
+#include <exception>
+#include <utility>
+
+#include "Aetherion/Rendering/VulkanViewport.h"
+
+namespace Aetherion::Rendering {
+RenderThread::PauseScope &
+RenderThread::PauseScope::operator=(PauseScope &&other) noexcept {
+  if (this != &other) {
+    if (m_owner) {
+      m_owner->Resume();
+    }
+    m_owner = std::exchange(other.m_owner, nullptr);
+  }
+  return *this;
+}
+
+RenderThread::PauseScope::~PauseScope() {
+  if (m_owner) {
+    m_owner->Resume();
+  }
+}
+
+RenderThread::RenderThread(VulkanViewport &viewport) : m_viewport(viewport) {}
+
+RenderThread::~RenderThread() { Stop(); }
+
+void RenderThread::SetFrameCallback(
+    std::function<void(Clock::time_point)> callback) {
+  m_frameCallback = std::move(callback);
+}
+
+void RenderThread::Start() {
+  if (IsRunning()) {
+    return;
+  }
+  m_stopRequested.store(false, std::memory_order_release);
+  m_failed = false;
+  m_running.store(true, std::memory_order_release);
+  m_thread = std::thread([this] { Run(); });
+}
+
+void RenderThread::Stop() {
+  if (!m_thread.joinable()) {
+    return;
+  }
+  m_stopRequested.store(true, std::memory_order_release);
+  Wake();
+  m_thread.join();
+  m_running.store(false, std::memory_order_release);
+  // Anything posted while the thread wound down.
+  DrainCommands();
+}
+
+void RenderThread::PublishSnapshot() {
+  const uint32_t previous = m_middle.exchange(m_backIndex | kFreshBit,
+                                              std::memory_order_acq_rel);
+  m_backIndex = previous & kIndexMask;
+  if ((previous & kFreshBit) != 0) {
+    m_snapshotsDropped.fetch_add(1, std::memory_order_relaxed);
+  }
+  Wake();
+}
+
+bool RenderThread::ConsumeSnapshot() noexcept {
+  if ((m_middle.load(std::memory_order_relaxed) & kFreshBit) == 0) {
+    return false;
+  }
+  m_frontIndex =
+      m_middle.exchange(m_frontIndex, std::memory_order_acq_rel) & kIndexMask;
+  return true;
+}
+
+void RenderThread::Post(Command command) {
+  if (!command) {
+    return;
+  }
+  if (!IsRunning()) {
+    command(m_viewport);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_commandMutex);
+    m_commands.push_back(std::move(command));
+  }
+  Wake();
+}
+
+RenderThread::PauseScope RenderThread::Pause() {
+  if (!IsRunning() || std::this_thread::get_id() == m_thread.get_id()) {
+    return PauseScope{};
+  }
+  m_pauseRequests.fetch_add(1, std::memory_order_acq_rel);
+  Wake();
+  while (!m_paused.load(std::memory_order_acquire)) {
+    m_paused.wait(false, std::memory_order_acquire);
+  }
+  return PauseScope{this};
+}
+
+void RenderThread::Resume() noexcept {
+  if (m_pauseRequests.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  Wake();
+  // Wait for the thread to leave the pause, so a Pause() right after this
+  // cannot mistake the old acknowledgement for a new one.
+  while (m_paused.load(std::memory_order_acquire)) {
+    m_paused.wait(true, std::memory_order_acquire);
+  }
+}
+
+std::optional<std::string> RenderThread::TakeError() {
+  std::lock_guard<std::mutex> lock(m_errorMutex);
+  return std::exchange(m_error, std::nullopt);
+}
+
+RenderThread::Stats RenderThread::GetStats() const noexcept {
+  Stats stats{};
+  stats.framesRendered = m_framesRendered.load(std::memory_order_relaxed);
+  stats.snapshotsDropped = m_snapshotsDropped.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void RenderThread::Wake() noexcept {
+  m_wakeups.fetch_add(1, std::memory_order_acq_rel);
+  m_wakeups.notify_one();
+}
+
+void RenderThread::DrainCommands() {
+  std::vector<Command> commands;
+  {
+    std::lock_guard<std::mutex> lock(m_commandMutex);
+    commands.swap(m_commands);
+  }
+  for (auto &command : commands) {
+    try {
+      command(m_viewport);
+    } catch (const std::exception &ex) {
+      RecordError(ex.what());
+    }
+  }
+}
+
+void RenderThread::RecordError(std::string message) {
+  std::lock_guard<std::mutex> lock(m_errorMutex);
+  if (!m_error) {
+    m_error = std::move(message);
+  }
+}
+
+void RenderThread::Run() {
+  Clock::time_point lastFrame = Clock::now();
+  for (;;) {
+    // Read before checking for work: an event after this load changes the
+    // counter, so the wait below returns at once instead of missing it.
+    const uint32_t seen = m_wakeups.load(std::memory_order_acquire);
+
+    if (m_pauseRequests.load(std::memory_order_acquire) > 0) {
+      m_paused.store(true, std::memory_order_release);
+      m_paused.notify_all();
+      while (m_pauseRequests.load(std::memory_order_acquire) > 0) {
+        const uint32_t pausedSeen = m_wakeups.load(std::memory_order_acquire);
+        if (m_pauseRequests.load(std::memory_order_acquire) > 0) {
+          m_wakeups.wait(pausedSeen, std::memory_order_acquire);
+        }
+      }
+      m_paused.store(false, std::memory_order_release);
+      m_paused.notify_all();
+      continue;
+    }
+
+    DrainCommands();
+    if (m_stopRequested.load(std::memory_order_acquire)) {
+      break;
+    }
+
+    if (!m_failed && ConsumeSnapshot()) {
+      const Clock::time_point now = Clock::now();
+      const float deltaSeconds =
+          std::chrono::duration<float>(now - lastFrame).count();
+      lastFrame = now;
+      try {
+        m_viewport.RenderFrame(deltaSeconds, m_slots[m_frontIndex]);
+        m_framesRendered.fetch_add(1, std::memory_order_relaxed);
+        if (m_frameCallback) {
+          m_frameCallback(Clock::now());
+        }
+      } catch (const std::exception &ex) {
+        m_failed = true;
+        RecordError(ex.what());
+      }
+      continue;
+    }
+
+    m_wakeups.wait(seen, std::memory_order_acquire);
+  }
+}
+} // namespace Aetherion::Rendering
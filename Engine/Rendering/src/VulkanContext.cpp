@@ -1,4 +1,5 @@
 #include "Aetherion/Rendering/VulkanContext.h"
+#include "Aetherion/Rendering/GpuResourceCache.h"
 
 #ifdef __APPLE__
 #include <vulkan/vulkan_core.h>
@@ -8,6 +9,8 @@
 #endif
 
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <stdexcept>
 #include <set>
@@ -51,14 +54,17 @@ void VulkanContext::Log(LogSeverity severity, const std::string& message) const
     stream << message << std::endl;
 }
 
-VulkanContext::VulkanContext() = default;
+VulkanContext::VulkanContext()
+    : m_resourceCache(std::make_shared<GpuResourceCache>())
+{
+}
 
 VulkanContext::~VulkanContext()
 {
     Shutdown();
 }
 
-void VulkanContext::Initialize(bool enableValidation, bool enableLogging)
+void VulkanContext::Initialize(bool enableValidation, bool enableLogging, bool headless)
 {
     if (m_initialized)
     {
@@ -67,6 +73,7 @@ void VulkanContext::Initialize(bool enableValidation, bool enableLogging)
 
     m_enableValidation = enableValidation;
     m_enableLogging = enableLogging;
+    m_headless = headless;
 
     if (m_enableValidation && !CheckValidationLayerSupport())
     {
@@ -79,6 +86,8 @@ void VulkanContext::Initialize(bool enableValidation, bool enableLogging)
     SetupDebugMessenger();
     PickPhysicalDevice(VK_NULL_HANDLE);
     CreateLogicalDevice();
+    CreatePipelineCache();
+    m_resourceCache->Initialize(m_device, m_graphicsQueue, &m_queueMutex);
     LogDeviceInfo();
 
     m_initialized = true;
@@ -101,6 +110,13 @@ void VulkanContext::Shutdown()
     if (m_device != VK_NULL_HANDLE)
     {
         vkDeviceWaitIdle(m_device);
+        m_resourceCache->Shutdown();
+        if (m_pipelineCache != VK_NULL_HANDLE)
+        {
+            SavePipelineCache();
+            vkDestroyPipelineCache(m_device, m_pipelineCache, nullptr);
+            m_pipelineCache = VK_NULL_HANDLE;
+        }
         vkDestroyDevice(m_device, nullptr);
         m_device = VK_NULL_HANDLE;
     }
@@ -183,19 +199,24 @@ std::vector<const char*> VulkanContext::GetRequiredInstanceExtensions() const
 {
     std::vector<const char*> extensions;
 
-    // Required for creating a presentation surface + swapchain.
-    extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
-#ifdef _WIN32
-    extensions.push_back("VK_KHR_win32_surface");
+#ifdef __APPLE__
+    // MoltenVK (Vulkan-on-Metal) uses a portability subset.
+    extensions.push_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
 #endif
 
+    if (!m_headless)
+    {
+        // Required for creating a presentation surface + swapchain.
+        extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+#ifdef _WIN32
+        extensions.push_back("VK_KHR_win32_surface");
+#endif
 #ifdef __APPLE__
-    // MoltenVK (Vulkan-on-Metal) uses a portability subset and a macOS surface extension.
-    extensions.push_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
-    extensions.push_back(VK_EXT_METAL_SURFACE_EXTENSION_NAME);
-    // Keep MVK macOS surface as an additional option (some toolkits still expose an NSView handle).
-    extensions.push_back(VK_MVK_MACOS_SURFACE_EXTENSION_NAME);
+        extensions.push_back(VK_EXT_METAL_SURFACE_EXTENSION_NAME);
+        // Keep MVK macOS surface as an additional option (some toolkits still expose an NSView handle).
+        extensions.push_back(VK_MVK_MACOS_SURFACE_EXTENSION_NAME);
 #endif
+    }
 
     if (m_enableValidation)
     {
@@ -204,6 +225,20 @@ std::vector<const char*> VulkanContext::GetRequiredInstanceExtensions() const
     return extensions;
 }
 
+std::vector<const char*> VulkanContext::GetRequiredDeviceExtensions() const
+{
+    std::vector<const char*> extensions;
+    for (const auto* name : kDeviceExtensions)
+    {
+        if (m_headless && std::string_view(name) == VK_KHR_SWAPCHAIN_EXTENSION_NAME)
+        {
+            continue;
+        }
+        extensions.push_back(name);
+    }
+    return extensions;
+}
+
 VulkanContext::QueueFamilyIndices VulkanContext::FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface) const
 {
     QueueFamilyIndices indices{};
@@ -246,7 +281,7 @@ bool VulkanContext::CheckDeviceExtensionSupport(VkPhysicalDevice device) const
     std::vector<VkExtensionProperties> available(extensionCount);
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, available.data());
 
-    for (const auto* required : kDeviceExtensions)
+    for (const auto* required : GetRequiredDeviceExtensions())
     {
         const std::string requiredName(required);
         bool found = false;
@@ -441,6 +476,10 @@ void VulkanContext::CreateLogicalDevice()
     {
         features.samplerAnisotropy = VK_TRUE;
     }
+    if (m_physicalDeviceFeatures.textureCompressionBC)
+    {
+        features.textureCompressionBC = VK_TRUE;
+    }
     m_enabledFeatures = features;
 
     VkDeviceCreateInfo createInfo{};
@@ -448,8 +487,9 @@ void VulkanContext::CreateLogicalDevice()
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueInfos.size());
     createInfo.pQueueCreateInfos = queueInfos.data();
     createInfo.pEnabledFeatures = &features;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(kDeviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = kDeviceExtensions.data();
+    const auto deviceExtensions = GetRequiredDeviceExtensions();
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
     if (vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device) != VK_SUCCESS)
     {
@@ -460,6 +500,138 @@ void VulkanContext::CreateLogicalDevice()
     vkGetDeviceQueue(m_device, m_presentQueueFamilyIndex, 0, &m_presentQueue);
 }
 
+void VulkanContext::CreatePipelineCache()
+{
+    std::vector<char> initialData;
+    if (!m_pipelineCachePath.empty())
+    {
+        std::ifstream file(m_pipelineCachePath, std::ios::binary | std::ios::ate);
+        if (file)
+        {
+            const std::streamsize size = file.tellg();
+            if (size > 0)
+            {
+                initialData.resize(static_cast<size_t>(size));
+                file.seekg(0);
+                file.read(initialData.data(), size);
+                if (!file)
+                {
+                    initialData.clear();
+                }
+            }
+        }
+
+        std::string reason;
+        if (!initialData.empty() && !IsPipelineCacheCompatible(initialData, reason))
+        {
+            Log(LogSeverity::Warning,
+                "Discarding pipeline cache " + m_pipelineCachePath.string() + " (" + reason + ")");
+            initialData.clear();
+        }
+    }
+
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = initialData.size();
+    createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+    if (vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_pipelineCache) != VK_SUCCESS)
+    {
+        // The driver rejected the blob despite a valid header; fall back to an empty cache.
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+        if (vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_pipelineCache) != VK_SUCCESS)
+        {
+            m_pipelineCache = VK_NULL_HANDLE;
+            Log(LogSeverity::Warning, "Failed to create Vulkan pipeline cache; pipelines will not be cached.");
+            return;
+        }
+    }
+
+    if (!initialData.empty())
+    {
+        Log(LogSeverity::Info,
+            "Loaded pipeline cache " + m_pipelineCachePath.string() + " (" + std::to_string(initialData.size()) +
+                " bytes)");
+    }
+}
+
+bool VulkanContext::IsPipelineCacheCompatible(const std::vector<char>& data, std::string& reason) const
+{
+    // VkPipelineCacheHeaderVersionOne: headerSize, headerVersion, vendorID, deviceID, pipelineCacheUUID.
+    constexpr size_t kHeaderSize = 16 + VK_UUID_SIZE;
+    if (data.size() < kHeaderSize)
+    {
+        reason = "truncated header";
+        return false;
+    }
+
+    uint32_t header[4]{};
+    std::memcpy(header, data.data(), sizeof(header));
+    if (header[0] < kHeaderSize || header[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+    {
+        reason = "unknown header version";
+        return false;
+    }
+    if (header[2] != m_physicalDeviceProperties.vendorID || header[3] != m_physicalDeviceProperties.deviceID)
+    {
+        reason = "different GPU";
+        return false;
+    }
+    if (std::memcmp(data.data() + 16, m_physicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        reason = "different driver version";
+        return false;
+    }
+    return true;
+}
+
+void VulkanContext::SavePipelineCache() const
+{
+    if (m_pipelineCache == VK_NULL_HANDLE || m_device == VK_NULL_HANDLE || m_pipelineCachePath.empty())
+    {
+        return;
+    }
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(m_device, m_pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+    {
+        return;
+    }
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(m_device, m_pipelineCache, &size, data.data()) != VK_SUCCESS)
+    {
+        return;
+    }
+    data.resize(size);
+
+    // Write to a temporary file first so a crash mid-write never leaves a torn cache behind.
+    std::error_code ec;
+    std::filesystem::create_directories(m_pipelineCachePath.parent_path(), ec);
+    auto tempPath = m_pipelineCachePath;
+    tempPath += ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            Log(LogSeverity::Warning, "Failed to write pipeline cache " + tempPath.string());
+            return;
+        }
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file)
+        {
+            Log(LogSeverity::Warning, "Failed to write pipeline cache " + tempPath.string());
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, m_pipelineCachePath, ec);
+    if (ec)
+    {
+        Log(LogSeverity::Warning, "Failed to replace pipeline cache " + m_pipelineCachePath.string() + ": " + ec.message());
+        std::filesystem::remove(tempPath, ec);
+    }
+}
+
 VulkanContext::SwapchainSupportDetails VulkanContext::QuerySwapchainSupport(VkPhysicalDevice device, VkSurfaceKHR surface) const
 {
     SwapchainSupportDetails details{};
@@ -2,9 +2,8 @@
 
 #include "Aetherion/Assets/AssetRegistry.h"
 #include "Aetherion/Core/Math.h"
+#include "Aetherion/Rendering/GpuResourceCache.h"
 #include "Aetherion/Rendering/VulkanContext.h"
-#include "Aetherion/Scene/MeshRendererComponent.h"
-#include "Aetherion/Scene/TransformComponent.h"
 
 #include <algorithm>
 #include <array>
@@ -15,13 +14,14 @@
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <future>
+#include <limits>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 
 #include <iostream>
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb/stb_image.h"
 
 #ifdef _WIN32
 #ifndef NOMINMAX
@@ -52,6 +52,241 @@ struct Vertex {
   float uv[2];
 };
 
+// Compressed layout for meshes imported with `compressVertices`:
+// - pos: UNORM16 relative to the mesh bounds, w = tangent handedness
+// - normalTangent: SNORM16 octahedral normal (xy) and tangent (zw)
+// - color: UNORM8 RGBA
+// - uv: half floats
+struct PackedVertex {
+  uint16_t pos[4];
+  int16_t normalTangent[4];
+  uint8_t color[4];
+  uint16_t uv[2];
+};
+static_assert(sizeof(PackedVertex) == 24,
+              "PackedVertex must stay tightly packed");
+
+uint16_t QuantizeUnorm16(float value) {
+  const float clamped = std::clamp(value, 0.0f, 1.0f);
+  return static_cast<uint16_t>(std::lround(clamped * 65535.0f));
+}
+
+int16_t QuantizeSnorm16(float value) {
+  const float clamped = std::clamp(value, -1.0f, 1.0f);
+  return static_cast<int16_t>(std::lround(clamped * 32767.0f));
+}
+
+uint8_t QuantizeUnorm8(float value) {
+  const float clamped = std::clamp(value, 0.0f, 1.0f);
+  return static_cast<uint8_t>(std::lround(clamped * 255.0f));
+}
+
+uint16_t FloatToHalf(float value) {
+  uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint32_t sign = (bits >> 16) & 0x8000u;
+  const int32_t exponent =
+      static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+  uint32_t mantissa = bits & 0x7FFFFFu;
+
+  if (((bits >> 23) & 0xFFu) == 0xFFu) {
+    // Inf/NaN.
+    return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+  }
+  if (exponent >= 31) {
+    return static_cast<uint16_t>(sign | 0x7C00u);
+  }
+  if (exponent <= 0) {
+    if (exponent < -10) {
+      return static_cast<uint16_t>(sign);
+    }
+    mantissa |= 0x800000u;
+    const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+    uint32_t half = mantissa >> shift;
+    if ((mantissa >> (shift - 1)) & 1u) {
+      ++half;
+    }
+    return static_cast<uint16_t>(sign | half);
+  }
+
+  uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+  if (mantissa & 0x1000u) {
+    ++half; // Round to nearest; a carry into the exponent is still correct.
+  }
+  return static_cast<uint16_t>(sign | half);
+}
+
+// Octahedral mapping of a unit vector to [-1, 1]^2.
+std::array<float, 2> EncodeOctahedral(float x, float y, float z) {
+  const float invL1 = 1.0f / std::max(std::abs(x) + std::abs(y) + std::abs(z),
+                                      1e-8f);
+  float u = x * invL1;
+  float v = y * invL1;
+  if (z < 0.0f) {
+    const float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+    const float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+    u = foldedU;
+    v = foldedV;
+  }
+  return {u, v};
+}
+
+// Everything needed to build the packed-vertex pipelines on a worker thread.
+// Vulkan create-info structs hold pointers, so the job owns copies of all the
+// state they reference and wires the pointers up again in
+// BuildPackedPipelines.
+struct PackedPipelineJob {
+  VkDevice device{VK_NULL_HANDLE};
+  VkPipelineCache cache{VK_NULL_HANDLE};
+  VkPipelineLayout layout{VK_NULL_HANDLE};
+  VkRenderPass sceneRenderPass{VK_NULL_HANDLE};
+  VkRenderPass pickingRenderPass{VK_NULL_HANDLE};
+  std::vector<char> vertCode;
+  std::vector<char> fragCode;
+  std::vector<char> pickFragCode;
+  VkVertexInputBindingDescription binding{};
+  std::array<VkVertexInputAttributeDescription, 4> attrs{};
+  VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+  VkPipelineViewportStateCreateInfo viewportState{};
+  VkPipelineRasterizationStateCreateInfo raster{};
+  VkPipelineMultisampleStateCreateInfo msaa{};
+  VkPipelineColorBlendAttachmentState blendAttach{};
+  VkPipelineColorBlendStateCreateInfo blend{};
+  VkPipelineDepthStencilStateCreateInfo depth{};
+};
+
+// Returns {opaque, picking, depth-equal opaque} pipelines for PackedVertex
+// meshes. Pipeline caches are internally synchronized, so this can share the
+// context's cache with the render thread.
+std::array<VkPipeline, 3> BuildPackedPipelines(const PackedPipelineJob &job) {
+  std::array<VkShaderModule, 3> modules{};
+  const std::vector<char> *codes[] = {&job.vertCode, &job.fragCode,
+                                      &job.pickFragCode};
+  auto destroyModules = [&]() {
+    for (auto module : modules) {
+      if (module != VK_NULL_HANDLE) {
+        vkDestroyShaderModule(job.device, module, nullptr);
+      }
+    }
+  };
+  for (size_t i = 0; i < modules.size(); ++i) {
+    VkShaderModuleCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    info.codeSize = codes[i]->size();
+    info.pCode = reinterpret_cast<const uint32_t *>(codes[i]->data());
+    if (vkCreateShaderModule(job.device, &info, nullptr, &modules[i]) !=
+        VK_SUCCESS) {
+      destroyModules();
+      throw std::runtime_error("Failed to create packed shader module");
+    }
+  }
+
+  VkVertexInputBindingDescription packedBinding = job.binding;
+  packedBinding.stride = sizeof(PackedVertex);
+
+  std::array<VkVertexInputAttributeDescription, 4> packedAttrs = job.attrs;
+  packedAttrs[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+  packedAttrs[0].offset = offsetof(PackedVertex, pos);
+  packedAttrs[1].format = VK_FORMAT_R16G16B16A16_SNORM;
+  packedAttrs[1].offset = offsetof(PackedVertex, normalTangent);
+  packedAttrs[2].format = VK_FORMAT_R8G8B8A8_UNORM;
+  packedAttrs[2].offset = offsetof(PackedVertex, color);
+  packedAttrs[3].format = VK_FORMAT_R16G16_SFLOAT;
+  packedAttrs[3].offset = offsetof(PackedVertex, uv);
+
+  VkPipelineVertexInputStateCreateInfo packedVertexInput{};
+  packedVertexInput.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+  packedVertexInput.vertexBindingDescriptionCount = 1;
+  packedVertexInput.pVertexBindingDescriptions = &packedBinding;
+  packedVertexInput.vertexAttributeDescriptionCount =
+      static_cast<uint32_t>(packedAttrs.size());
+  packedVertexInput.pVertexAttributeDescriptions = packedAttrs.data();
+
+  // The vertex shader switches its decode path on specialization constant 0.
+  const VkBool32 packedVerticesEnabled = VK_TRUE;
+  VkSpecializationMapEntry packedEntry{};
+  packedEntry.constantID = 0;
+  packedEntry.offset = 0;
+  packedEntry.size = sizeof(VkBool32);
+  VkSpecializationInfo packedSpec{};
+  packedSpec.mapEntryCount = 1;
+  packedSpec.pMapEntries = &packedEntry;
+  packedSpec.dataSize = sizeof(VkBool32);
+  packedSpec.pData = &packedVerticesEnabled;
+
+  VkPipelineShaderStageCreateInfo packedVs{};
+  packedVs.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  packedVs.stage = VK_SHADER_STAGE_VERTEX_BIT;
+  packedVs.module = modules[0];
+  packedVs.pName = "main";
+  packedVs.pSpecializationInfo = &packedSpec;
+
+  VkPipelineShaderStageCreateInfo fs{};
+  fs.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  fs.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+  fs.module = modules[1];
+  fs.pName = "main";
+
+  VkPipelineShaderStageCreateInfo pickFs = fs;
+  pickFs.module = modules[2];
+
+  VkPipelineColorBlendStateCreateInfo blend = job.blend;
+  blend.pAttachments = &job.blendAttach;
+
+  VkDynamicState dynStates[] = {VK_DYNAMIC_STATE_VIEWPORT,
+                                VK_DYNAMIC_STATE_SCISSOR};
+  VkPipelineDynamicStateCreateInfo dyn{};
+  dyn.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+  dyn.dynamicStateCount = 2;
+  dyn.pDynamicStates = dynStates;
+
+  VkPipelineShaderStageCreateInfo packedStages[] = {packedVs, fs};
+  VkGraphicsPipelineCreateInfo packedPipe{};
+  packedPipe.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  packedPipe.stageCount = 2;
+  packedPipe.pStages = packedStages;
+  packedPipe.pVertexInputState = &packedVertexInput;
+  packedPipe.pInputAssemblyState = &job.inputAssembly;
+  packedPipe.pViewportState = &job.viewportState;
+  packedPipe.pRasterizationState = &job.raster;
+  packedPipe.pMultisampleState = &job.msaa;
+  packedPipe.pColorBlendState = &blend;
+  packedPipe.pDepthStencilState = &job.depth;
+  packedPipe.pDynamicState = &dyn;
+  packedPipe.layout = job.layout;
+  packedPipe.renderPass = job.sceneRenderPass;
+  packedPipe.subpass = 0;
+
+  VkPipelineShaderStageCreateInfo packedPickStages[] = {packedVs, pickFs};
+  VkGraphicsPipelineCreateInfo packedPickPipe = packedPipe;
+  packedPickPipe.pStages = packedPickStages;
+  packedPickPipe.renderPass = job.pickingRenderPass;
+
+  VkPipelineDepthStencilStateCreateInfo equalDepth = job.depth;
+  equalDepth.depthCompareOp = VK_COMPARE_OP_EQUAL;
+  equalDepth.depthWriteEnable = VK_FALSE;
+  VkGraphicsPipelineCreateInfo packedEqualPipe = packedPipe;
+  packedEqualPipe.pDepthStencilState = &equalDepth;
+
+  std::array<VkGraphicsPipelineCreateInfo, 3> infos = {
+      packedPipe, packedPickPipe, packedEqualPipe};
+  std::array<VkPipeline, 3> pipelines{};
+  const VkResult result = vkCreateGraphicsPipelines(
+      job.device, job.cache, static_cast<uint32_t>(infos.size()),
+      infos.data(), nullptr, pipelines.data());
+  destroyModules();
+  if (result != VK_SUCCESS) {
+    for (auto pipeline : pipelines) {
+      if (pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(job.device, pipeline, nullptr);
+      }
+    }
+    throw std::runtime_error("Failed to create packed vertex pipelines");
+  }
+  return pipelines;
+}
+
 // `VulkanViewport::kMaxLights` is private; mirror its value here locally.
 constexpr uint32_t kMaxLights = 8u;
 
@@ -73,16 +308,53 @@ struct alignas(16) FrameUniformObject {
   float materialParams[4];
   float lightCounts[4];
   LightUniform lights[kMaxLights];
+  // World to shadow atlas uv/depth per cascade.
+  float shadowMatrices[VulkanViewport::kMaxShadowCascades][16];
+  // x: active cascades (0 disables shadows), y: normal offset in texels,
+  // z: 1 when the dynamic atlas was drawn this frame.
+  float shadowParams[4];
+  // World-space size of one cached-atlas texel per cascade.
+  float shadowTexelSizes[4];
 };
 
 constexpr uint32_t kInstanceFlagUnlit = 1u;
+// Render graph passes, in the order they are added to each frame's graph.
 constexpr std::array<const char *, VulkanViewport::kPassCount> kPassNames = {
-    "Opaque",
-    "Picking",
-    "PostProcess",
-    "Overlay",
+    "ShadowStatic", "ShadowDynamic", "DepthPrepass", "Opaque",
+    "Picking",      "PickReadback",  "PostProcess",  "Overlay",
 };
+constexpr uint32_t kShadowStaticPass = 0;
+constexpr uint32_t kShadowDynamicPass = 1;
+constexpr uint32_t kDepthPrepassPass = 2;
+constexpr uint32_t kOpaquePass = 3;
+constexpr uint32_t kPickingPass = 4;
+constexpr uint32_t kPickReadbackPass = 5;
+constexpr uint32_t kPostProcessPass = 6;
+constexpr uint32_t kOverlayPass = 7;
 constexpr const char *kIconMeshId = "__editor_icon_quad";
+// Longest a frame blocks on its fence or on image acquisition before giving
+// up on the frame.
+constexpr uint64_t kFrameWaitTimeoutNs = 100'000'000ULL;
+
+// Both shadow atlases hold the cascades as a 2x2 grid of tiles. Moving casters
+// get half the resolution of the cached static ones to bound their cost.
+constexpr uint32_t kShadowAtlasTiles = 2;
+constexpr uint32_t kStaticShadowAtlasSize = 2048;
+constexpr uint32_t kDynamicShadowAtlasSize = 1024;
+// Casters up to this far towards the light from a cascade still shadow it.
+constexpr float kShadowCasterReach = 50.0f;
+// A cascade is refit with this much slack around its frustum slice, and kept
+// while the slice still fits inside.
+constexpr float kShadowCascadeSlack = 1.25f;
+
+constexpr uint32_t kWireframeBox = 0;
+constexpr uint32_t kWireframeSphere = 1;
+constexpr uint32_t kWireframeCapsuleCap = 2;
+constexpr uint32_t kWireframeCapsuleBody = 3;
+constexpr uint32_t kWireframeCircleSegments = 24;
+// Enough for the selection gizmo, light gizmos and a few hundred colliders
+// before the first grow.
+constexpr VkDeviceSize kDynamicGeometryInitialSize = 256 * 1024;
 
 uint32_t DecodeEntityIdFromRgba(const uint8_t *rgba) {
   return static_cast<uint32_t>(rgba[0]) |
@@ -105,18 +377,6 @@ void Mat4Scale(float out[16], float x, float y, float z) {
   Core::Math::Mat4Scale(out, x, y, z);
 }
 
-void Mat4RotationX(float out[16], float radians) {
-  Core::Math::Mat4RotationX(out, radians);
-}
-
-void Mat4RotationY(float out[16], float radians) {
-  Core::Math::Mat4RotationY(out, radians);
-}
-
-void Mat4RotationZ(float out[16], float radians) {
-  Core::Math::Mat4RotationZ(out, radians);
-}
-
 std::array<float, 3> Mat4TransformPoint(const float m[16],
                                         const std::array<float, 3> &p) {
   return {m[0] * p[0] + m[4] * p[1] + m[8] * p[2] + m[12],
@@ -215,6 +475,37 @@ bool FormatSupports(VkPhysicalDevice gpu, VkFormat format,
   return (props.optimalTilingFeatures & features) == features;
 }
 
+VkFormat ToVkFormat(const Assets::CookedTexture &texture) {
+  switch (texture.format) {
+  case Assets::TextureFormat::BC1:
+    return texture.srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK
+                        : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+  case Assets::TextureFormat::BC3:
+    return texture.srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+  case Assets::TextureFormat::BC5:
+    return VK_FORMAT_BC5_UNORM_BLOCK;
+  case Assets::TextureFormat::BC7:
+    return texture.srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+  case Assets::TextureFormat::RGBA8:
+    break;
+  }
+  return texture.srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+// Size of every level of the full chain, including levels not loaded.
+std::vector<VkDeviceSize> MipLevelBytes(const Assets::CookedTexture &texture) {
+  const auto levels =
+      texture.baseMip + static_cast<uint32_t>(texture.mips.size());
+  std::vector<VkDeviceSize> bytes;
+  bytes.reserve(levels);
+  for (uint32_t level = 0; level < levels; ++level) {
+    bytes.push_back(Assets::GetMipLevelSize(
+        texture.format, std::max(1u, texture.width >> level),
+        std::max(1u, texture.height >> level)));
+  }
+  return bytes;
+}
+
 VkFormat FindDepthFormat(VkPhysicalDevice gpu) {
   const VkFormat candidates[] = {VK_FORMAT_D32_SFLOAT,
                                  VK_FORMAT_D32_SFLOAT_S8_UINT,
@@ -230,6 +521,24 @@ VkFormat FindDepthFormat(VkPhysicalDevice gpu) {
   throw std::runtime_error("Failed to find suitable depth format");
 }
 
+// Depth-only and sampled with a compare sampler. D16 is required to support
+// both, so the loop always ends with a usable format.
+VkFormat FindShadowFormat(VkPhysicalDevice gpu) {
+  const VkFormatFeatureFlags needed =
+      VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT |
+      VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+  for (VkFormat format : {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D16_UNORM}) {
+    if (FormatSupports(gpu, format,
+                       needed |
+                           VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
+      return format;
+    }
+  }
+  return FormatSupports(gpu, VK_FORMAT_D32_SFLOAT, needed)
+             ? VK_FORMAT_D32_SFLOAT
+             : VK_FORMAT_D16_UNORM;
+}
+
 VkFormat FindSceneColorFormat(VkPhysicalDevice gpu) {
   const VkFormatFeatureFlags needed =
       VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT |
@@ -272,14 +581,15 @@ PickingFormatInfo FindPickingFormat(VkPhysicalDevice gpu) {
 void CreateImage(VkPhysicalDevice gpu, VkDevice device, uint32_t width,
                  uint32_t height, VkFormat format, VkImageTiling tiling,
                  VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
-                 VkImage &outImage, VkDeviceMemory &outMemory) {
+                 VkImage &outImage, VkDeviceMemory &outMemory,
+                 uint32_t mipLevels = 1) {
   VkImageCreateInfo imageInfo{};
   imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
   imageInfo.imageType = VK_IMAGE_TYPE_2D;
   imageInfo.extent.width = width;
   imageInfo.extent.height = height;
   imageInfo.extent.depth = 1;
-  imageInfo.mipLevels = 1;
+  imageInfo.mipLevels = mipLevels;
   imageInfo.arrayLayers = 1;
   imageInfo.format = format;
   imageInfo.tiling = tiling;
@@ -309,7 +619,7 @@ void CreateImage(VkPhysicalDevice gpu, VkDevice device, uint32_t width,
 }
 
 VkImageView CreateImageView(VkDevice device, VkImage image, VkFormat format,
-                            VkImageAspectFlags aspect) {
+                            VkImageAspectFlags aspect, uint32_t mipLevels = 1) {
   VkImageViewCreateInfo view{};
   view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
   view.image = image;
@@ -317,7 +627,7 @@ VkImageView CreateImageView(VkDevice device, VkImage image, VkFormat format,
   view.format = format;
   view.subresourceRange.aspectMask = aspect;
   view.subresourceRange.baseMipLevel = 0;
-  view.subresourceRange.levelCount = 1;
+  view.subresourceRange.levelCount = mipLevels;
   view.subresourceRange.baseArrayLayer = 0;
   view.subresourceRange.layerCount = 1;
 
@@ -376,11 +686,34 @@ ChooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &formats) {
                          : formats[0];
 }
 
-VkPresentModeKHR ChoosePresentMode(const std::vector<VkPresentModeKHR> &modes) {
-  for (auto m : modes) {
-    if (m == VK_PRESENT_MODE_MAILBOX_KHR) {
-      return m;
-    }
+// Rough input-to-display latency of each mode, in refresh intervals: FIFO
+// can have every other swapchain image queued ahead of a new frame, MAILBOX
+// replaces the queued frame and shows at the next vblank, IMMEDIATE shows at
+// once (and tears).
+VkPresentModeKHR
+ChoosePresentMode(const std::vector<VkPresentModeKHR> &modes,
+                  const VulkanViewport::PresentSettings &settings,
+                  uint32_t imageCount) {
+  auto supported = [&](VkPresentModeKHR mode) {
+    return std::find(modes.begin(), modes.end(), mode) != modes.end();
+  };
+  if (settings.latencyTargetMs <= 0.0) {
+    return supported(VK_PRESENT_MODE_MAILBOX_KHR) ? VK_PRESENT_MODE_MAILBOX_KHR
+                                                  : VK_PRESENT_MODE_FIFO_KHR;
+  }
+
+  const double refreshMs = 1000.0 / std::max(settings.refreshRateHz, 1.0);
+  const double fifoMs = static_cast<double>(imageCount) * refreshMs;
+  if (fifoMs <= settings.latencyTargetMs) {
+    return VK_PRESENT_MODE_FIFO_KHR;
+  }
+  if (supported(VK_PRESENT_MODE_MAILBOX_KHR) &&
+      (refreshMs <= settings.latencyTargetMs || !settings.allowTearing ||
+       !supported(VK_PRESENT_MODE_IMMEDIATE_KHR))) {
+    return VK_PRESENT_MODE_MAILBOX_KHR;
+  }
+  if (settings.allowTearing && supported(VK_PRESENT_MODE_IMMEDIATE_KHR)) {
+    return VK_PRESENT_MODE_IMMEDIATE_KHR;
   }
   return VK_PRESENT_MODE_FIFO_KHR;
 }
@@ -441,6 +774,33 @@ void VulkanViewport::Initialize(void *nativeHandle, int width, int height) {
   }
 }
 
+void VulkanViewport::InitializeHeadless(int width, int height) {
+  if (!m_context || !m_context->IsInitialized()) {
+    throw std::runtime_error("VulkanViewport: VulkanContext not initialized");
+  }
+
+  try {
+    m_headless = true;
+    m_nativeHandle = nullptr;
+    m_surfaceWidth = width;
+    m_surfaceHeight = height;
+    m_shutdown = false;
+
+    RecreateRenderer(width, height);
+    m_ready = true;
+    m_frameIndex = 0;
+    m_waitingForValidExtent = false;
+    m_timeSeconds = 0.0f;
+  } catch (const std::exception &ex) {
+    m_context->Log(
+        LogSeverity::Error,
+        std::string("VulkanViewport: headless initialization failed - ") +
+            ex.what());
+    Shutdown();
+    throw;
+  }
+}
+
 void VulkanViewport::Shutdown() {
   if (m_shutdown) {
     return;
@@ -454,6 +814,7 @@ void VulkanViewport::Shutdown() {
   m_timeSeconds = 0.0f;
   m_waitingForValidExtent = false;
   m_ready = false;
+  m_headless = false;
   m_nativeHandle = nullptr;
   m_surfaceWidth = 0;
   m_surfaceHeight = 0;
@@ -464,7 +825,7 @@ void VulkanViewport::Resize(int width, int height) {
   m_surfaceHeight = height;
 
   if (!m_context || !m_context->IsInitialized() ||
-      m_surface == VK_NULL_HANDLE) {
+      (m_surface == VK_NULL_HANDLE && !m_headless)) {
     return;
   }
 
@@ -501,7 +862,7 @@ void VulkanViewport::Resize(int width, int height) {
 
 void VulkanViewport::RenderFrame(float deltaTimeSeconds,
                                  const RenderView &view) {
-  if (!m_ready || m_swapchain == VK_NULL_HANDLE) {
+  if (!m_ready || (m_swapchain == VK_NULL_HANDLE && !m_headless)) {
     return;
   }
 
@@ -534,23 +895,20 @@ void VulkanViewport::RenderFrame(float deltaTimeSeconds,
   }
 
   m_timeSeconds += deltaTimeSeconds;
-  const auto instances = InstancesFromView(view, m_timeSeconds);
-  UpdateSelectionBuffer(instances, view);
-  UpdateLightGizmoBuffer(view);
-  UpdateColliderBuffer(view);
+  auto instances = InstancesFromView(view);
 
   VkDevice device = m_context->GetDevice();
   VkQueue graphicsQueue = m_context->GetGraphicsQueue();
   VkQueue presentQueue = m_context->GetPresentQueue();
 
   VkFence inFlight = m_inFlight[m_frameIndex];
-  // Wait for previous frame using this slot to complete.
-  // Use a short timeout to keep the UI responsive; if not ready, skip this
-  // frame.
+  // Wait for previous frame using this slot to complete. The caller paces
+  // frames, so block rather than drop the frame; the bound only keeps a hung
+  // GPU from freezing the UI. Headless rendering must not drop frames.
+  const uint64_t fenceTimeout = m_headless ? UINT64_MAX : kFrameWaitTimeoutNs;
   VkResult fenceWait =
-      vkWaitForFences(device, 1, &inFlight, VK_TRUE, 1'000'000ULL); // 1ms
+      vkWaitForFences(device, 1, &inFlight, VK_TRUE, fenceTimeout);
   if (fenceWait == VK_TIMEOUT) {
-    // Previous frame not done yet, skip to keep UI responsive.
     return;
   }
   if (fenceWait != VK_SUCCESS) {
@@ -558,6 +916,10 @@ void VulkanViewport::RenderFrame(float deltaTimeSeconds,
   }
 
   ProcessDeferredDeletions();
+  if (auto *cache = GetResourceCache()) {
+    cache->CollectGarbage();
+  }
+  UpdateTextureStreaming(instances);
 
   if (m_timestampsSupported && m_queryPools[m_frameIndex] != VK_NULL_HANDLE &&
       m_frameStats[m_frameIndex].valid) {
@@ -587,6 +949,7 @@ void VulkanViewport::RenderFrame(float deltaTimeSeconds,
       }
     }
     m_lastFrameStats = stats;
+    UpdateDynamicResolution(stats);
   }
 
   if (m_pickReadbacks[m_frameIndex].inFlight &&
@@ -613,10 +976,14 @@ void VulkanViewport::RenderFrame(float deltaTimeSeconds,
     m_pickReadbacks[m_frameIndex].inFlight = false;
   }
 
-  uint32_t imageIndex = 0;
-  VkResult acquire = vkAcquireNextImageKHR(device, m_swapchain, 1'000'000ULL,
-                                           m_imageAvailable[m_frameIndex],
-                                           VK_NULL_HANDLE, &imageIndex); // 1ms
+  // Headless targets are indexed by frame slot; there is nothing to acquire.
+  uint32_t imageIndex = m_frameIndex;
+  VkResult acquire = VK_SUCCESS;
+  if (!m_headless) {
+    acquire = vkAcquireNextImageKHR(device, m_swapchain, kFrameWaitTimeoutNs,
+                                    m_imageAvailable[m_frameIndex],
+                                    VK_NULL_HANDLE, &imageIndex);
+  }
   if (acquire == VK_TIMEOUT || acquire == VK_NOT_READY) {
     // Image not available, skip frame.
     return;
@@ -637,7 +1004,7 @@ void VulkanViewport::RenderFrame(float deltaTimeSeconds,
   }
 
   if (imageIndex >= m_imagesInFlight.size() ||
-      imageIndex >= m_renderFinishedPerImage.size()) {
+      (!m_headless && imageIndex >= m_renderFinishedPerImage.size())) {
     m_context->Log(
         LogSeverity::Error,
         "VulkanViewport: acquired image index out of range for sync objects");
@@ -658,10 +1025,20 @@ void VulkanViewport::RenderFrame(float deltaTimeSeconds,
   vkResetFences(device, 1, &inFlight);
   m_imagesInFlight[imageIndex] = inFlight;
 
+  CollectPackedPipelines(false);
+  UpdateShadowCasters(instances);
   UpdateUniformBuffer(m_frameIndex, view);
 
+  // The fence for this slot has signalled, so its line geometry ring can be
+  // rewritten from the start.
+  m_dynamicGeometry[m_frameIndex].head = 0;
+  UpdateSelectionBuffer(instances, view);
+  UpdateLightGizmoBuffer(view);
+  UpdateColliderBuffer(view);
+
   vkResetCommandBuffer(m_commandBuffers[m_frameIndex], 0);
   m_frameStats[m_frameIndex] = {};
+  m_frameStats[m_frameIndex].renderScale = m_renderScale;
   for (uint32_t i = 0; i < kPassCount; ++i) {
     m_frameStats[m_frameIndex].passes[i].name = kPassNames[i];
   }
@@ -672,22 +1049,27 @@ void VulkanViewport::RenderFrame(float deltaTimeSeconds,
       std::chrono::duration<double, std::milli>(cpuEnd - cpuStart).count();
 
   VkSemaphore waitSem = m_imageAvailable[m_frameIndex];
-  VkSemaphore signalSem = m_renderFinishedPerImage[imageIndex];
+  VkSemaphore signalSem =
+      m_headless ? VK_NULL_HANDLE : m_renderFinishedPerImage[imageIndex];
 
   VkPipelineStageFlags waitStage =
       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 
   VkSubmitInfo submit{};
   submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  submit.waitSemaphoreCount = 1;
+  submit.waitSemaphoreCount = m_headless ? 0 : 1;
   submit.pWaitSemaphores = &waitSem;
   submit.pWaitDstStageMask = &waitStage;
   submit.commandBufferCount = 1;
   submit.pCommandBuffers = &m_commandBuffers[m_frameIndex];
-  submit.signalSemaphoreCount = 1;
+  submit.signalSemaphoreCount = m_headless ? 0 : 1;
   submit.pSignalSemaphores = &signalSem;
 
-  const VkResult submitRes = vkQueueSubmit(graphicsQueue, 1, &submit, inFlight);
+  VkResult submitRes = VK_SUCCESS;
+  {
+    std::lock_guard<std::mutex> lock(m_context->GetQueueMutex());
+    submitRes = vkQueueSubmit(graphicsQueue, 1, &submit, inFlight);
+  }
   if (submitRes == VK_ERROR_DEVICE_LOST) {
     m_context->Log(
         LogSeverity::Error,
@@ -701,6 +1083,17 @@ void VulkanViewport::RenderFrame(float deltaTimeSeconds,
     throw std::runtime_error("vkQueueSubmit failed");
   }
   m_frameStats[m_frameIndex].valid = true;
+  m_lastImageIndex = imageIndex;
+  m_pickInstances = std::move(instances);
+  std::memcpy(m_pickViewProj, m_frameViewProj, sizeof(m_pickViewProj));
+  m_cpuPickerDirty = true;
+
+  if (m_headless) {
+    // Nothing to present; the image is left in TRANSFER_SRC layout so it can
+    // be read back.
+    m_frameIndex = (m_frameIndex + 1) % kMaxFramesInFlight;
+    return;
+  }
 
   VkPresentInfoKHR present{};
   present.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -710,7 +1103,11 @@ void VulkanViewport::RenderFrame(float deltaTimeSeconds,
   present.pSwapchains = &m_swapchain;
   present.pImageIndices = &imageIndex;
 
-  VkResult pres = vkQueuePresentKHR(presentQueue, &present);
+  VkResult pres = VK_SUCCESS;
+  {
+    std::lock_guard<std::mutex> lock(m_context->GetQueueMutex());
+    pres = vkQueuePresentKHR(presentQueue, &present);
+  }
   if (pres == VK_ERROR_OUT_OF_DATE_KHR || pres == VK_SUBOPTIMAL_KHR) {
     // Swapchain is out of date or suboptimal (e.g., window resized).
     // Mark for recreation and continue; next frame will handle it.
@@ -745,16 +1142,196 @@ void VulkanViewport::RequestPick(uint32_t x, uint32_t y) noexcept {
   m_pendingPick.y = y;
 }
 
+VulkanViewport::PickResult VulkanViewport::PickCpu(uint32_t x, uint32_t y) {
+  PickResult result{};
+  result.x = x;
+  result.y = y;
+  if (!EnsureCpuPicker()) {
+    return result;
+  }
+
+  // Same pixel the GPU readback would copy, mapped to its centre in NDC.
+  const uint32_t width = m_swapchainExtent.width;
+  const uint32_t height = m_swapchainExtent.height;
+  uint32_t pixelY = std::min(y, height - 1);
+  if (m_pickFlipY) {
+    pixelY = (height - 1) - pixelY;
+  }
+  const float ndcX =
+      2.0f * (static_cast<float>(std::min(x, width - 1)) + 0.5f) / width -
+      1.0f;
+  const float ndcY = 2.0f * (static_cast<float>(pixelY) + 0.5f) / height - 1.0f;
+
+  const CpuPicker::Hit hit = m_cpuPicker.RaycastNdc(m_pickViewProj, ndcX, ndcY);
+  result.entityId = hit.valid ? hit.entityId : 0;
+  result.valid = true;
+  return result;
+}
+
+std::vector<Core::EntityId> VulkanViewport::PickRectCpu(uint32_t x0,
+                                                        uint32_t y0,
+                                                        uint32_t x1,
+                                                        uint32_t y1) {
+  if (!EnsureCpuPicker()) {
+    return {};
+  }
+
+  const float width = static_cast<float>(m_swapchainExtent.width);
+  const float height = static_cast<float>(m_swapchainExtent.height);
+  float top = static_cast<float>(std::min(y0, y1));
+  float bottom = static_cast<float>(std::max(y0, y1)) + 1.0f;
+  if (m_pickFlipY) {
+    top = height - top;
+    bottom = height - bottom;
+  }
+  const float minX = 2.0f * static_cast<float>(std::min(x0, x1)) / width - 1.0f;
+  const float maxX =
+      2.0f * (static_cast<float>(std::max(x0, x1)) + 1.0f) / width - 1.0f;
+  return m_cpuPicker.SelectRect(m_pickViewProj, minX,
+                                2.0f * top / height - 1.0f, maxX,
+                                2.0f * bottom / height - 1.0f);
+}
+
+bool VulkanViewport::EnsureCpuPicker() {
+  if (m_swapchainExtent.width == 0 || m_swapchainExtent.height == 0) {
+    return false;
+  }
+  if (!m_cpuPickerDirty) {
+    return !m_cpuPicker.IsEmpty();
+  }
+
+  // The picker looks mesh data up per query, so registry reloads and
+  // evictions never leave it pointing at stale meshes.
+  std::vector<CpuPicker::Instance> pickInstances;
+  pickInstances.reserve(m_pickInstances.size());
+  for (const auto &draw : m_pickInstances) {
+    if (draw.entityId == 0) {
+      continue;
+    }
+    CpuPicker::Instance instance{};
+    instance.entityId = draw.entityId;
+    std::memcpy(instance.model, draw.constants.model, sizeof(instance.model));
+    // Built-in quad used for unresolved meshes and editor icons.
+    instance.boundsMin = {-0.5f, -0.5f, 0.0f};
+    instance.boundsMax = {0.5f, 0.5f, 0.0f};
+    if (!draw.meshId.empty() && draw.meshId != kIconMeshId &&
+        m_assetRegistry) {
+      Assets::AssetRegistry::MeshBounds bounds{};
+      if (m_assetRegistry->GetMeshBounds(draw.meshId, bounds)) {
+        instance.boundsMin = bounds.min;
+        instance.boundsMax = bounds.max;
+      }
+      instance.meshId = draw.meshId;
+    }
+    pickInstances.push_back(std::move(instance));
+  }
+  m_cpuPicker.Build(std::move(pickInstances), m_assetRegistry);
+  m_cpuPickerDirty = false;
+  return !m_cpuPicker.IsEmpty();
+}
+
+void VulkanViewport::SetDynamicResolution(
+    const DynamicResolutionSettings &settings) noexcept {
+  m_dynamicResolution = settings;
+  m_dynamicResolution.minScale =
+      std::clamp(m_dynamicResolution.minScale, 0.25f, 1.0f);
+  m_dynamicResolution.maxScale = std::clamp(
+      m_dynamicResolution.maxScale, m_dynamicResolution.minScale, 1.0f);
+  m_fullResGpuMs = 0.0;
+  m_renderScale = m_dynamicResolution.enabled
+                      ? std::clamp(m_renderScale, m_dynamicResolution.minScale,
+                                   m_dynamicResolution.maxScale)
+                      : 1.0f;
+}
+
+void VulkanViewport::SetShadowSettings(
+    const ShadowSettings &settings) noexcept {
+  m_shadowSettings = settings;
+  m_shadowSettings.cascadeCount =
+      std::clamp(m_shadowSettings.cascadeCount, 1u, kMaxShadowCascades);
+  m_shadowSettings.maxDistance = std::max(m_shadowSettings.maxDistance, 1.0f);
+  for (auto &cascade : m_shadowCascades) {
+    cascade.valid = false;
+    cascade.staticDirty = true;
+  }
+}
+
+void VulkanViewport::SetPresentSettings(
+    const PresentSettings &settings) noexcept {
+  if (settings.latencyTargetMs == m_presentSettings.latencyTargetMs &&
+      settings.refreshRateHz == m_presentSettings.refreshRateHz &&
+      settings.allowTearing == m_presentSettings.allowTearing) {
+    return;
+  }
+  m_presentSettings = settings;
+  m_needsSwapchainRecreate = true;
+}
+
+void VulkanViewport::UpdateDynamicResolution(const FrameStats &stats) {
+  if (!m_dynamicResolution.enabled) {
+    m_renderScale = 1.0f;
+    return;
+  }
+  if (!stats.valid || stats.gpuTotalMs <= 0.0) {
+    return;
+  }
+
+  // The scene pass dominates and scales with pixel count, so normalize the
+  // measurement to full resolution using the scale that frame rendered at.
+  // Rising costs are tracked quickly, falling ones slowly.
+  const double scale = std::max(0.05, static_cast<double>(stats.renderScale));
+  const double fullResMs = stats.gpuTotalMs / (scale * scale);
+  if (m_fullResGpuMs <= 0.0) {
+    m_fullResGpuMs = fullResMs;
+  } else {
+    const double alpha = fullResMs > m_fullResGpuMs ? 0.5 : 0.1;
+    m_fullResGpuMs += alpha * (fullResMs - m_fullResGpuMs);
+  }
+
+  const double targetMs = std::max(0.1, m_dynamicResolution.targetGpuMs);
+  const float desired = std::clamp(
+      static_cast<float>(std::sqrt(targetMs / m_fullResGpuMs)),
+      m_dynamicResolution.minScale, m_dynamicResolution.maxScale);
+  // Small corrections are ignored so the image does not shimmer; drops are
+  // applied faster than recoveries.
+  const float delta = desired - m_renderScale;
+  if (std::fabs(delta) < 0.02f) {
+    return;
+  }
+  m_renderScale = std::clamp(m_renderScale + std::clamp(delta, -0.1f, 0.02f),
+                             m_dynamicResolution.minScale,
+                             m_dynamicResolution.maxScale);
+  if (m_verboseLogging && std::fabs(delta) >= 0.1f) {
+    m_context->Log(LogSeverity::Info,
+                   "VulkanViewport: render scale " +
+                       std::to_string(m_renderScale) + " (GPU " +
+                       std::to_string(stats.gpuTotalMs) + " ms)");
+  }
+}
+
+VkExtent2D VulkanViewport::GetSceneRenderExtent() const noexcept {
+  // Must round like viewport_postprocess.frag, which recomputes the extent
+  // from the scale to find the rendered region.
+  auto scaled = [this](uint32_t size) {
+    return std::max(1u, static_cast<uint32_t>(
+                            static_cast<float>(size) * m_renderScale + 0.5f));
+  };
+  return {scaled(m_swapchainExtent.width), scaled(m_swapchainExtent.height)};
+}
+
 void VulkanViewport::RecreateRenderer(int width, int height) {
   // Wait for any in-flight work to complete before destroying resources.
   if (m_context && m_context->IsInitialized()) {
+    std::lock_guard<std::mutex> lock(m_context->GetQueueMutex());
     vkDeviceWaitIdle(m_context->GetDevice());
   }
 
   DestroyDeviceResources();
 
   try {
-    m_context->EnsureSurfaceCompatibility(m_surface);
+    if (!m_headless) {
+      m_context->EnsureSurfaceCompatibility(m_surface);
+    }
 
 #ifdef __APPLE__
     UpdateMetalLayerSize(width, height);
@@ -770,11 +1347,12 @@ void VulkanViewport::RecreateRenderer(int width, int height) {
     CreateDescriptorPoolAndSets();
     CreateTextureDescriptorPool();
     CreateTextureResources();
-    CreateSceneResources();
+    CreateRenderGraphs();
     CreatePickingResources();
     CreatePipeline();
     CreateFramebuffers();
     UpdatePostProcessDescriptorSets();
+    CreateShadowResources();
     CreateSyncObjects();
     CreateQueryPools();
 
@@ -788,7 +1366,7 @@ void VulkanViewport::RecreateRenderer(int width, int height) {
 }
 
 bool VulkanViewport::TryRecoverSwapchain() {
-  if (m_surface == VK_NULL_HANDLE || !m_context ||
+  if ((m_surface == VK_NULL_HANDLE && !m_headless) || !m_context ||
       !m_context->IsInitialized()) {
     m_ready = false;
     return false;
@@ -818,6 +1396,7 @@ void VulkanViewport::DestroyDeviceResources() {
                         : VK_NULL_HANDLE;
 
   if (device != VK_NULL_HANDLE) {
+    std::lock_guard<std::mutex> lock(m_context->GetQueueMutex());
     vkDeviceWaitIdle(device);
   }
 
@@ -863,6 +1442,14 @@ void VulkanViewport::DestroyDeviceResources() {
     vkFreeMemory(device, m_vertexMemory, nullptr);
   }
   m_vertexMemory = VK_NULL_HANDLE;
+  if (device != VK_NULL_HANDLE && m_positionBuffer != VK_NULL_HANDLE) {
+    vkDestroyBuffer(device, m_positionBuffer, nullptr);
+  }
+  m_positionBuffer = VK_NULL_HANDLE;
+  if (device != VK_NULL_HANDLE && m_positionMemory != VK_NULL_HANDLE) {
+    vkFreeMemory(device, m_positionMemory, nullptr);
+  }
+  m_positionMemory = VK_NULL_HANDLE;
 
   if (device != VK_NULL_HANDLE && m_iconMesh.vertexBuffer != VK_NULL_HANDLE) {
     vkDestroyBuffer(device, m_iconMesh.vertexBuffer, nullptr);
@@ -876,6 +1463,14 @@ void VulkanViewport::DestroyDeviceResources() {
   if (device != VK_NULL_HANDLE && m_iconMesh.indexMemory != VK_NULL_HANDLE) {
     vkFreeMemory(device, m_iconMesh.indexMemory, nullptr);
   }
+  if (device != VK_NULL_HANDLE &&
+      m_iconMesh.positionBuffer != VK_NULL_HANDLE) {
+    vkDestroyBuffer(device, m_iconMesh.positionBuffer, nullptr);
+  }
+  if (device != VK_NULL_HANDLE &&
+      m_iconMesh.positionMemory != VK_NULL_HANDLE) {
+    vkFreeMemory(device, m_iconMesh.positionMemory, nullptr);
+  }
   m_iconMesh = {};
 
   if (device != VK_NULL_HANDLE && m_lineVertexBuffer != VK_NULL_HANDLE) {
@@ -888,35 +1483,19 @@ void VulkanViewport::DestroyDeviceResources() {
   m_lineVertexMemory = VK_NULL_HANDLE;
   m_lineVertexCount = 0;
 
-  if (device != VK_NULL_HANDLE && m_selectionVertexBuffer != VK_NULL_HANDLE) {
-    vkDestroyBuffer(device, m_selectionVertexBuffer, nullptr);
-  }
-  m_selectionVertexBuffer = VK_NULL_HANDLE;
-  if (device != VK_NULL_HANDLE && m_selectionVertexMemory != VK_NULL_HANDLE) {
-    vkFreeMemory(device, m_selectionVertexMemory, nullptr);
-  }
-  m_selectionVertexMemory = VK_NULL_HANDLE;
-  m_selectionVertexCount = 0;
-
-  if (device != VK_NULL_HANDLE && m_lightGizmoVertexBuffer != VK_NULL_HANDLE) {
-    vkDestroyBuffer(device, m_lightGizmoVertexBuffer, nullptr);
+  if (device != VK_NULL_HANDLE &&
+      m_wireframeTemplateBuffer != VK_NULL_HANDLE) {
+    vkDestroyBuffer(device, m_wireframeTemplateBuffer, nullptr);
   }
-  m_lightGizmoVertexBuffer = VK_NULL_HANDLE;
-  if (device != VK_NULL_HANDLE && m_lightGizmoVertexMemory != VK_NULL_HANDLE) {
-    vkFreeMemory(device, m_lightGizmoVertexMemory, nullptr);
+  m_wireframeTemplateBuffer = VK_NULL_HANDLE;
+  if (device != VK_NULL_HANDLE &&
+      m_wireframeTemplateMemory != VK_NULL_HANDLE) {
+    vkFreeMemory(device, m_wireframeTemplateMemory, nullptr);
   }
-  m_lightGizmoVertexMemory = VK_NULL_HANDLE;
-  m_lightGizmoVertexCount = 0;
+  m_wireframeTemplateMemory = VK_NULL_HANDLE;
+  m_wireframeTemplates = {};
 
-  if (device != VK_NULL_HANDLE && m_colliderVertexBuffer != VK_NULL_HANDLE) {
-    vkDestroyBuffer(device, m_colliderVertexBuffer, nullptr);
-  }
-  m_colliderVertexBuffer = VK_NULL_HANDLE;
-  if (device != VK_NULL_HANDLE && m_colliderVertexMemory != VK_NULL_HANDLE) {
-    vkFreeMemory(device, m_colliderVertexMemory, nullptr);
-  }
-  m_colliderVertexMemory = VK_NULL_HANDLE;
-  m_colliderVertexCount = 0;
+  DestroyDynamicGeometry();
 
   for (auto &pool : m_descriptorPools) {
     if (device != VK_NULL_HANDLE && pool != VK_NULL_HANDLE) {
@@ -963,6 +1542,11 @@ void VulkanViewport::DestroyDeviceResources() {
   }
   m_postProcessSampler = VK_NULL_HANDLE;
 
+  if (device != VK_NULL_HANDLE && m_sceneUpscaleSampler != VK_NULL_HANDLE) {
+    vkDestroySampler(device, m_sceneUpscaleSampler, nullptr);
+  }
+  m_sceneUpscaleSampler = VK_NULL_HANDLE;
+
   for (auto &pool : m_queryPools) {
     if (device != VK_NULL_HANDLE && pool != VK_NULL_HANDLE) {
       vkDestroyQueryPool(device, pool, nullptr);
@@ -999,24 +1583,10 @@ void VulkanViewport::DestroyDeviceResources() {
 }
 
 void VulkanViewport::DestroyMeshCache() {
-  VkDevice device = (m_context && m_context->IsInitialized())
-                        ? m_context->GetDevice()
-                        : VK_NULL_HANDLE;
-  for (auto &entry : m_meshCache) {
-    auto &mesh = entry.second;
-    if (device != VK_NULL_HANDLE && mesh.vertexBuffer != VK_NULL_HANDLE) {
-      vkDestroyBuffer(device, mesh.vertexBuffer, nullptr);
-    }
-    if (device != VK_NULL_HANDLE && mesh.vertexMemory != VK_NULL_HANDLE) {
-      vkFreeMemory(device, mesh.vertexMemory, nullptr);
-    }
-    if (device != VK_NULL_HANDLE && mesh.indexBuffer != VK_NULL_HANDLE) {
-      vkDestroyBuffer(device, mesh.indexBuffer, nullptr);
-    }
-    if (device != VK_NULL_HANDLE && mesh.indexMemory != VK_NULL_HANDLE) {
-      vkFreeMemory(device, mesh.indexMemory, nullptr);
+  if (auto *cache = GetResourceCache()) {
+    for (const auto &entry : m_meshCache) {
+      cache->ReleaseMesh(entry.second);
     }
-    mesh = {};
   }
   m_meshCache.clear();
   m_missingMeshes.clear();
@@ -1048,48 +1618,17 @@ void VulkanViewport::DestroyTextureCache() {
   destroyTexture(m_defaultTexture);
 
   for (auto &entry : m_textureCache) {
-    destroyTexture(entry.second);
+    ReleaseTexture(entry.second, false);
   }
   m_textureCache.clear();
   m_missingTextures.clear();
 }
 
-void VulkanViewport::DestroySceneResources() {
-  VkDevice device = (m_context && m_context->IsInitialized())
-                        ? m_context->GetDevice()
-                        : VK_NULL_HANDLE;
-
-  for (uint32_t i = 0; i < kMaxFramesInFlight; ++i) {
-    if (device != VK_NULL_HANDLE && m_sceneColorViews[i] != VK_NULL_HANDLE) {
-      vkDestroyImageView(device, m_sceneColorViews[i], nullptr);
-    }
-    m_sceneColorViews[i] = VK_NULL_HANDLE;
-
-    if (device != VK_NULL_HANDLE && m_sceneColorImages[i] != VK_NULL_HANDLE) {
-      vkDestroyImage(device, m_sceneColorImages[i], nullptr);
-    }
-    m_sceneColorImages[i] = VK_NULL_HANDLE;
-
-    if (device != VK_NULL_HANDLE && m_sceneColorMemories[i] != VK_NULL_HANDLE) {
-      vkFreeMemory(device, m_sceneColorMemories[i], nullptr);
-    }
-    m_sceneColorMemories[i] = VK_NULL_HANDLE;
-
-    if (device != VK_NULL_HANDLE && m_sceneDepthViews[i] != VK_NULL_HANDLE) {
-      vkDestroyImageView(device, m_sceneDepthViews[i], nullptr);
-    }
-    m_sceneDepthViews[i] = VK_NULL_HANDLE;
-
-    if (device != VK_NULL_HANDLE && m_sceneDepthImages[i] != VK_NULL_HANDLE) {
-      vkDestroyImage(device, m_sceneDepthImages[i], nullptr);
-    }
-    m_sceneDepthImages[i] = VK_NULL_HANDLE;
-
-    if (device != VK_NULL_HANDLE && m_sceneDepthMemories[i] != VK_NULL_HANDLE) {
-      vkFreeMemory(device, m_sceneDepthMemories[i], nullptr);
-    }
-    m_sceneDepthMemories[i] = VK_NULL_HANDLE;
+void VulkanViewport::DestroyRenderGraphs() {
+  for (auto &graph : m_renderGraphs) {
+    graph.Reset();
   }
+  m_graphTargets = {};
 }
 
 void VulkanViewport::DestroyPickingResources() {
@@ -1110,40 +1649,57 @@ void VulkanViewport::DestroyPickingResources() {
     }
     m_pickingReadbackMemories[i] = VK_NULL_HANDLE;
     m_pickReadbacks[i] = {};
+  }
 
-    if (device != VK_NULL_HANDLE && m_pickingViews[i] != VK_NULL_HANDLE) {
-      vkDestroyImageView(device, m_pickingViews[i], nullptr);
-    }
-    m_pickingViews[i] = VK_NULL_HANDLE;
+  m_lastPickResult.valid = false;
+  m_pickInstances.clear();
+  m_cpuPicker.Clear();
+  m_cpuPickerDirty = true;
+}
 
-    if (device != VK_NULL_HANDLE && m_pickingImages[i] != VK_NULL_HANDLE) {
-      vkDestroyImage(device, m_pickingImages[i], nullptr);
-    }
-    m_pickingImages[i] = VK_NULL_HANDLE;
+void VulkanViewport::DestroyShadowResources() {
+  VkDevice device = (m_context && m_context->IsInitialized())
+                        ? m_context->GetDevice()
+                        : VK_NULL_HANDLE;
 
-    if (device != VK_NULL_HANDLE && m_pickingMemories[i] != VK_NULL_HANDLE) {
-      vkFreeMemory(device, m_pickingMemories[i], nullptr);
+  for (auto &framebuffer : m_dynamicShadowFramebuffers) {
+    if (device != VK_NULL_HANDLE && framebuffer != VK_NULL_HANDLE) {
+      vkDestroyFramebuffer(device, framebuffer, nullptr);
     }
-    m_pickingMemories[i] = VK_NULL_HANDLE;
+    framebuffer = VK_NULL_HANDLE;
+  }
 
-    if (device != VK_NULL_HANDLE && m_pickingDepthViews[i] != VK_NULL_HANDLE) {
-      vkDestroyImageView(device, m_pickingDepthViews[i], nullptr);
-    }
-    m_pickingDepthViews[i] = VK_NULL_HANDLE;
+  if (device != VK_NULL_HANDLE && m_shadowAtlasFramebuffer != VK_NULL_HANDLE) {
+    vkDestroyFramebuffer(device, m_shadowAtlasFramebuffer, nullptr);
+  }
+  m_shadowAtlasFramebuffer = VK_NULL_HANDLE;
 
-    if (device != VK_NULL_HANDLE && m_pickingDepthImages[i] != VK_NULL_HANDLE) {
-      vkDestroyImage(device, m_pickingDepthImages[i], nullptr);
-    }
-    m_pickingDepthImages[i] = VK_NULL_HANDLE;
+  if (device != VK_NULL_HANDLE && m_shadowAtlasView != VK_NULL_HANDLE) {
+    vkDestroyImageView(device, m_shadowAtlasView, nullptr);
+  }
+  m_shadowAtlasView = VK_NULL_HANDLE;
 
-    if (device != VK_NULL_HANDLE &&
-        m_pickingDepthMemories[i] != VK_NULL_HANDLE) {
-      vkFreeMemory(device, m_pickingDepthMemories[i], nullptr);
-    }
-    m_pickingDepthMemories[i] = VK_NULL_HANDLE;
+  if (device != VK_NULL_HANDLE && m_shadowAtlas != VK_NULL_HANDLE) {
+    vkDestroyImage(device, m_shadowAtlas, nullptr);
   }
+  m_shadowAtlas = VK_NULL_HANDLE;
 
-  m_lastPickResult.valid = false;
+  if (device != VK_NULL_HANDLE && m_shadowAtlasMemory != VK_NULL_HANDLE) {
+    vkFreeMemory(device, m_shadowAtlasMemory, nullptr);
+  }
+  m_shadowAtlasMemory = VK_NULL_HANDLE;
+
+  if (device != VK_NULL_HANDLE && m_shadowSampler != VK_NULL_HANDLE) {
+    vkDestroySampler(device, m_shadowSampler, nullptr);
+  }
+  m_shadowSampler = VK_NULL_HANDLE;
+
+  m_shadowAtlasLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  m_shadowCascadeCount = 0;
+  for (auto &cascade : m_shadowCascades) {
+    cascade.valid = false;
+    cascade.staticDirty = true;
+  }
 }
 
 void VulkanViewport::ProcessDeferredDeletions() {
@@ -1193,71 +1749,12 @@ void VulkanViewport::HandleAssetChanges(
   if (changes.empty()) {
     return;
   }
+  m_cpuPickerDirty = true;
 
-  VkDevice device = (m_context && m_context->IsInitialized())
-                        ? m_context->GetDevice()
-                        : VK_NULL_HANDLE;
-  if (device == VK_NULL_HANDLE) {
-    return;
-  }
-
-  auto destroyMesh = [this, device](GpuMesh &mesh) {
-    if (mesh.vertexBuffer == VK_NULL_HANDLE &&
-        mesh.indexBuffer == VK_NULL_HANDLE) {
-      mesh = {};
-      return;
-    }
-    VkBuffer vertexBuffer = mesh.vertexBuffer;
-    VkDeviceMemory vertexMemory = mesh.vertexMemory;
-    VkBuffer indexBuffer = mesh.indexBuffer;
-    VkDeviceMemory indexMemory = mesh.indexMemory;
-    EnqueueDeletion(
-        [device, vertexBuffer, vertexMemory, indexBuffer, indexMemory]() {
-          if (device != VK_NULL_HANDLE && vertexBuffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(device, vertexBuffer, nullptr);
-          }
-          if (device != VK_NULL_HANDLE && vertexMemory != VK_NULL_HANDLE) {
-            vkFreeMemory(device, vertexMemory, nullptr);
-          }
-          if (device != VK_NULL_HANDLE && indexBuffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(device, indexBuffer, nullptr);
-          }
-          if (device != VK_NULL_HANDLE && indexMemory != VK_NULL_HANDLE) {
-            vkFreeMemory(device, indexMemory, nullptr);
-          }
-        });
-    mesh = {};
-  };
-
-  auto destroyTexture = [this, device](GpuTexture &texture) {
-    if (texture.image == VK_NULL_HANDLE && texture.view == VK_NULL_HANDLE) {
-      texture = {};
-      return;
-    }
-    VkImage image = texture.image;
-    VkDeviceMemory memory = texture.memory;
-    VkImageView view = texture.view;
-    VkDescriptorSet descriptorSet = texture.descriptorSet;
-    VkDescriptorPool descriptorPool = texture.descriptorPool;
-    EnqueueDeletion(
-        [device, image, memory, view, descriptorSet, descriptorPool]() {
-          if (device != VK_NULL_HANDLE && descriptorSet != VK_NULL_HANDLE &&
-              descriptorPool != VK_NULL_HANDLE) {
-            vkFreeDescriptorSets(device, descriptorPool, 1, &descriptorSet);
-          }
-          if (device != VK_NULL_HANDLE && view != VK_NULL_HANDLE) {
-            vkDestroyImageView(device, view, nullptr);
-          }
-          if (device != VK_NULL_HANDLE && image != VK_NULL_HANDLE) {
-            vkDestroyImage(device, image, nullptr);
-          }
-          if (device != VK_NULL_HANDLE && memory != VK_NULL_HANDLE) {
-            vkFreeMemory(device, memory, nullptr);
-          }
-        });
-    texture = {};
-  };
-
+  // Buffers and images are invalidated once in the shared cache; here we only
+  // drop this viewport's references and descriptor sets so the next resolve
+  // picks up the new data.
+  auto *cache = GetResourceCache();
   for (const auto &change : changes) {
     const bool invalidate =
         change.kind == Assets::AssetRegistry::AssetChange::Kind::Removed ||
@@ -1269,14 +1766,20 @@ void VulkanViewport::HandleAssetChanges(
 
     if (change.type == Assets::AssetRegistry::AssetType::Mesh) {
       if (auto it = m_meshCache.find(change.id); it != m_meshCache.end()) {
-        destroyMesh(it->second);
+        if (cache) {
+          cache->ReleaseMesh(it->second);
+        }
         m_meshCache.erase(it);
       }
       m_missingMeshes.erase(change.id);
+      // Cached shadows may hold the old geometry.
+      for (auto &cascade : m_shadowCascades) {
+        cascade.staticDirty = true;
+      }
     } else if (change.type == Assets::AssetRegistry::AssetType::Texture) {
       if (auto it = m_textureCache.find(change.id);
           it != m_textureCache.end()) {
-        destroyTexture(it->second);
+        ReleaseTexture(it->second, true);
         m_textureCache.erase(it);
       }
       m_missingTextures.erase(change.id);
@@ -1285,6 +1788,9 @@ void VulkanViewport::HandleAssetChanges(
 }
 
 void VulkanViewport::DestroySwapchainResources() {
+  // A background compile may still reference the layout and render passes.
+  CollectPackedPipelines(true);
+
   VkDevice device = (m_context && m_context->IsInitialized())
                         ? m_context->GetDevice()
                         : VK_NULL_HANDLE;
@@ -1310,6 +1816,13 @@ void VulkanViewport::DestroySwapchainResources() {
     fb = VK_NULL_HANDLE;
   }
 
+  for (auto &fb : m_depthPrepassFramebuffers) {
+    if (device != VK_NULL_HANDLE && fb != VK_NULL_HANDLE) {
+      vkDestroyFramebuffer(device, fb, nullptr);
+    }
+    fb = VK_NULL_HANDLE;
+  }
+
   if (device != VK_NULL_HANDLE && m_pipeline != VK_NULL_HANDLE) {
     vkDestroyPipeline(device, m_pipeline, nullptr);
   }
@@ -1325,6 +1838,11 @@ void VulkanViewport::DestroySwapchainResources() {
   }
   m_overlayPipeline = VK_NULL_HANDLE;
 
+  if (device != VK_NULL_HANDLE && m_wireframePipeline != VK_NULL_HANDLE) {
+    vkDestroyPipeline(device, m_wireframePipeline, nullptr);
+  }
+  m_wireframePipeline = VK_NULL_HANDLE;
+
   if (device != VK_NULL_HANDLE && m_pickingPipeline != VK_NULL_HANDLE) {
     vkDestroyPipeline(device, m_pickingPipeline, nullptr);
   }
@@ -1335,6 +1853,22 @@ void VulkanViewport::DestroySwapchainResources() {
   }
   m_pickingPipelineUint = VK_NULL_HANDLE;
 
+  if (device != VK_NULL_HANDLE && m_packedPipeline != VK_NULL_HANDLE) {
+    vkDestroyPipeline(device, m_packedPipeline, nullptr);
+  }
+  m_packedPipeline = VK_NULL_HANDLE;
+
+  if (device != VK_NULL_HANDLE && m_packedPickingPipeline != VK_NULL_HANDLE) {
+    vkDestroyPipeline(device, m_packedPickingPipeline, nullptr);
+  }
+  m_packedPickingPipeline = VK_NULL_HANDLE;
+
+  if (device != VK_NULL_HANDLE &&
+      m_packedPickingPipelineUint != VK_NULL_HANDLE) {
+    vkDestroyPipeline(device, m_packedPickingPipelineUint, nullptr);
+  }
+  m_packedPickingPipelineUint = VK_NULL_HANDLE;
+
   if (device != VK_NULL_HANDLE && m_postProcessPipeline != VK_NULL_HANDLE) {
     vkDestroyPipeline(device, m_postProcessPipeline, nullptr);
   }
@@ -1345,7 +1879,26 @@ void VulkanViewport::DestroySwapchainResources() {
   }
   m_postProcessPipelineUint = VK_NULL_HANDLE;
 
-  if (device != VK_NULL_HANDLE && m_pipelineLayout != VK_NULL_HANDLE) {
+  if (device != VK_NULL_HANDLE && m_shadowPipeline != VK_NULL_HANDLE) {
+    vkDestroyPipeline(device, m_shadowPipeline, nullptr);
+  }
+  m_shadowPipeline = VK_NULL_HANDLE;
+
+  if (device != VK_NULL_HANDLE && m_packedShadowPipeline != VK_NULL_HANDLE) {
+    vkDestroyPipeline(device, m_packedShadowPipeline, nullptr);
+  }
+  m_packedShadowPipeline = VK_NULL_HANDLE;
+
+  for (VkPipeline *pipeline :
+       {&m_depthPrepassPipeline, &m_packedDepthPrepassPipeline,
+        &m_depthEqualPipeline, &m_packedDepthEqualPipeline}) {
+    if (device != VK_NULL_HANDLE && *pipeline != VK_NULL_HANDLE) {
+      vkDestroyPipeline(device, *pipeline, nullptr);
+    }
+    *pipeline = VK_NULL_HANDLE;
+  }
+
+  if (device != VK_NULL_HANDLE && m_pipelineLayout != VK_NULL_HANDLE) {
     vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
   }
   m_pipelineLayout = VK_NULL_HANDLE;
@@ -1356,7 +1909,8 @@ void VulkanViewport::DestroySwapchainResources() {
   }
   m_postProcessPipelineLayout = VK_NULL_HANDLE;
 
-  DestroySceneResources();
+  DestroyShadowResources();
+  DestroyRenderGraphs();
   DestroyPickingResources();
 
   if (device != VK_NULL_HANDLE && m_sceneRenderPass != VK_NULL_HANDLE) {
@@ -1374,6 +1928,27 @@ void VulkanViewport::DestroySwapchainResources() {
   }
   m_pickingRenderPass = VK_NULL_HANDLE;
 
+  if (device != VK_NULL_HANDLE && m_shadowRenderPass != VK_NULL_HANDLE) {
+    vkDestroyRenderPass(device, m_shadowRenderPass, nullptr);
+  }
+  m_shadowRenderPass = VK_NULL_HANDLE;
+
+  if (device != VK_NULL_HANDLE &&
+      m_sceneLoadDepthRenderPass != VK_NULL_HANDLE) {
+    vkDestroyRenderPass(device, m_sceneLoadDepthRenderPass, nullptr);
+  }
+  m_sceneLoadDepthRenderPass = VK_NULL_HANDLE;
+
+  if (device != VK_NULL_HANDLE && m_depthPrepassRenderPass != VK_NULL_HANDLE) {
+    vkDestroyRenderPass(device, m_depthPrepassRenderPass, nullptr);
+  }
+  m_depthPrepassRenderPass = VK_NULL_HANDLE;
+
+  if (device != VK_NULL_HANDLE && m_shadowCacheRenderPass != VK_NULL_HANDLE) {
+    vkDestroyRenderPass(device, m_shadowCacheRenderPass, nullptr);
+  }
+  m_shadowCacheRenderPass = VK_NULL_HANDLE;
+
   DestroySwapchain();
 }
 
@@ -1503,6 +2078,11 @@ void VulkanViewport::CreateSurface(void *nativeHandle) {
 }
 
 void VulkanViewport::CreateSwapchain(int width, int height) {
+  if (m_headless) {
+    CreateOffscreenTargets(width, height);
+    return;
+  }
+
   auto support = m_context->QuerySwapchainSupport(m_surface);
   if (support.formats.empty() || support.presentModes.empty()) {
     m_swapchain = VK_NULL_HANDLE;
@@ -1517,7 +2097,6 @@ void VulkanViewport::CreateSwapchain(int width, int height) {
 
   const VkSurfaceCapabilitiesKHR &caps = support.capabilities;
   VkSurfaceFormatKHR surfaceFormat = ChooseSurfaceFormat(support.formats);
-  VkPresentModeKHR presentMode = ChoosePresentMode(support.presentModes);
   VkExtent2D extent = ChooseExtent(caps, width, height);
 
   if (extent.width == 0 || extent.height == 0) {
@@ -1549,6 +2128,9 @@ void VulkanViewport::CreateSwapchain(int width, int height) {
   if (caps.maxImageCount > 0 && imageCount > caps.maxImageCount) {
     imageCount = caps.maxImageCount;
   }
+  const VkPresentModeKHR presentMode =
+      ChoosePresentMode(support.presentModes, m_presentSettings, imageCount);
+  m_presentMode = presentMode;
 
   VkSwapchainCreateInfoKHR create{};
   create.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -1658,6 +2240,50 @@ void VulkanViewport::CreateSwapchain(int width, int height) {
   m_imagesInFlight.assign(m_swapchainImages.size(), VK_NULL_HANDLE);
 }
 
+void VulkanViewport::CreateOffscreenTargets(int width, int height) {
+  if (width <= 0 || height <= 0) {
+    m_swapchainExtent = {0, 0};
+    throw std::runtime_error("VulkanViewport: offscreen extent is zero");
+  }
+
+  VkDevice device = m_context->GetDevice();
+  VkPhysicalDevice gpu = m_context->GetPhysicalDevice();
+
+  // RGBA rather than the BGRA a surface usually prefers, so readback needs no
+  // swizzle. sRGB keeps the output identical to the presented image.
+  m_swapchainFormat = VK_FORMAT_R8G8B8A8_SRGB;
+  m_swapchainExtent = {static_cast<uint32_t>(width),
+                       static_cast<uint32_t>(height)};
+  m_sceneColorFormat = FindSceneColorFormat(gpu);
+  const auto pickInfo = FindPickingFormat(gpu);
+  m_pickingFormat = pickInfo.format;
+  m_pickingFormatIsUint = pickInfo.isUint;
+
+  if (m_verboseLogging) {
+    m_context->Log(LogSeverity::Info,
+                   "VulkanViewport: creating offscreen targets " +
+                       std::to_string(width) + "x" + std::to_string(height));
+  }
+
+  m_swapchainImages.assign(kMaxFramesInFlight, VK_NULL_HANDLE);
+  m_offscreenMemories.assign(kMaxFramesInFlight, VK_NULL_HANDLE);
+  m_swapchainImageViews.assign(kMaxFramesInFlight, VK_NULL_HANDLE);
+  for (uint32_t i = 0; i < kMaxFramesInFlight; ++i) {
+    CreateImage(gpu, device, m_swapchainExtent.width, m_swapchainExtent.height,
+                m_swapchainFormat, VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_swapchainImages[i],
+                m_offscreenMemories[i]);
+    m_swapchainImageViews[i] =
+        CreateImageView(device, m_swapchainImages[i], m_swapchainFormat,
+                        VK_IMAGE_ASPECT_COLOR_BIT);
+  }
+
+  m_imagesInFlight.assign(m_swapchainImages.size(), VK_NULL_HANDLE);
+  m_lastImageIndex = UINT32_MAX;
+}
+
 void VulkanViewport::DestroySwapchain() {
   VkDevice device = (m_context && m_context->IsInitialized())
                         ? m_context->GetDevice()
@@ -1669,7 +2295,23 @@ void VulkanViewport::DestroySwapchain() {
     }
   }
   m_swapchainImageViews.clear();
+
+  // Offscreen images are owned by the viewport; swapchain images are not.
+  if (!m_offscreenMemories.empty()) {
+    for (auto image : m_swapchainImages) {
+      if (device != VK_NULL_HANDLE && image != VK_NULL_HANDLE) {
+        vkDestroyImage(device, image, nullptr);
+      }
+    }
+    for (auto memory : m_offscreenMemories) {
+      if (device != VK_NULL_HANDLE && memory != VK_NULL_HANDLE) {
+        vkFreeMemory(device, memory, nullptr);
+      }
+    }
+    m_offscreenMemories.clear();
+  }
   m_swapchainImages.clear();
+  m_lastImageIndex = UINT32_MAX;
 
   for (auto sem : m_renderFinishedPerImage) {
     if (sem != VK_NULL_HANDLE) {
@@ -1693,6 +2335,8 @@ void VulkanViewport::CreateRenderPass() {
     m_depthFormat = FindDepthFormat(m_context->GetPhysicalDevice());
   }
 
+  // Attachments stay in their attachment layouts across each render pass; the
+  // render graph records the transitions and barriers between passes.
   VkAttachmentDescription sceneColor{};
   sceneColor.format = m_sceneColorFormat;
   sceneColor.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -1700,8 +2344,8 @@ void VulkanViewport::CreateRenderPass() {
   sceneColor.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
   sceneColor.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
   sceneColor.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-  sceneColor.initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-  sceneColor.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  sceneColor.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  sceneColor.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
   VkAttachmentReference sceneColorRef{};
   sceneColorRef.attachment = 0;
@@ -1727,24 +2371,6 @@ void VulkanViewport::CreateRenderPass() {
   sceneSubpass.pColorAttachments = &sceneColorRef;
   sceneSubpass.pDepthStencilAttachment = &sceneDepthRef;
 
-  VkSubpassDependency sceneDepBegin{};
-  sceneDepBegin.srcSubpass = VK_SUBPASS_EXTERNAL;
-  sceneDepBegin.dstSubpass = 0;
-  sceneDepBegin.srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-  sceneDepBegin.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-  sceneDepBegin.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
-                               VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-  sceneDepBegin.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
-                                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
-  VkSubpassDependency sceneDepEnd{};
-  sceneDepEnd.srcSubpass = 0;
-  sceneDepEnd.dstSubpass = VK_SUBPASS_EXTERNAL;
-  sceneDepEnd.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  sceneDepEnd.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-  sceneDepEnd.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-  sceneDepEnd.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
   VkRenderPassCreateInfo sceneRp{};
   sceneRp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
   std::array<VkAttachmentDescription, 2> sceneAttachments = {sceneColor,
@@ -1753,15 +2379,43 @@ void VulkanViewport::CreateRenderPass() {
   sceneRp.pAttachments = sceneAttachments.data();
   sceneRp.subpassCount = 1;
   sceneRp.pSubpasses = &sceneSubpass;
-  std::array<VkSubpassDependency, 2> sceneDeps = {sceneDepBegin, sceneDepEnd};
-  sceneRp.dependencyCount = static_cast<uint32_t>(sceneDeps.size());
-  sceneRp.pDependencies = sceneDeps.data();
 
   if (vkCreateRenderPass(device, &sceneRp, nullptr, &m_sceneRenderPass) !=
       VK_SUCCESS) {
     throw std::runtime_error("Failed to create scene render pass");
   }
 
+  // After a depth pre-pass the opaque pass keeps the depth it laid down, and
+  // stores it so later passes can read it too.
+  sceneAttachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+  sceneAttachments[1].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  if (vkCreateRenderPass(device, &sceneRp, nullptr,
+                         &m_sceneLoadDepthRenderPass) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create scene load-depth render pass");
+  }
+
+  VkAttachmentDescription prepassDepth = sceneDepth;
+  prepassDepth.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+  VkAttachmentReference prepassDepthRef = sceneDepthRef;
+  prepassDepthRef.attachment = 0;
+
+  VkSubpassDescription prepassSubpass{};
+  prepassSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  prepassSubpass.pDepthStencilAttachment = &prepassDepthRef;
+
+  VkRenderPassCreateInfo prepassRp{};
+  prepassRp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+  prepassRp.attachmentCount = 1;
+  prepassRp.pAttachments = &prepassDepth;
+  prepassRp.subpassCount = 1;
+  prepassRp.pSubpasses = &prepassSubpass;
+
+  if (vkCreateRenderPass(device, &prepassRp, nullptr,
+                         &m_depthPrepassRenderPass) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create depth pre-pass render pass");
+  }
+
   VkAttachmentDescription postColor{};
   postColor.format = m_swapchainFormat;
   postColor.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -1769,8 +2423,8 @@ void VulkanViewport::CreateRenderPass() {
   postColor.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
   postColor.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
   postColor.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-  postColor.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  postColor.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+  postColor.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  postColor.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
   VkAttachmentReference postColorRef{};
   postColorRef.attachment = 0;
@@ -1781,22 +2435,12 @@ void VulkanViewport::CreateRenderPass() {
   postSubpass.colorAttachmentCount = 1;
   postSubpass.pColorAttachments = &postColorRef;
 
-  VkSubpassDependency postDep{};
-  postDep.srcSubpass = VK_SUBPASS_EXTERNAL;
-  postDep.dstSubpass = 0;
-  postDep.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  postDep.srcAccessMask = 0;
-  postDep.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  postDep.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
   VkRenderPassCreateInfo postRp{};
   postRp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
   postRp.attachmentCount = 1;
   postRp.pAttachments = &postColor;
   postRp.subpassCount = 1;
   postRp.pSubpasses = &postSubpass;
-  postRp.dependencyCount = 1;
-  postRp.pDependencies = &postDep;
 
   if (vkCreateRenderPass(device, &postRp, nullptr, &m_postProcessRenderPass) !=
       VK_SUCCESS) {
@@ -1810,7 +2454,7 @@ void VulkanViewport::CreateRenderPass() {
   pickColor.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
   pickColor.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
   pickColor.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-  pickColor.initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  pickColor.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
   pickColor.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
   VkAttachmentReference pickColorRef{};
@@ -1824,13 +2468,6 @@ void VulkanViewport::CreateRenderPass() {
   pickSubpass.pColorAttachments = &pickColorRef;
   pickSubpass.pDepthStencilAttachment = &pickDepthRef;
 
-  VkSubpassDependency pickDep = sceneDepBegin;
-  pickDep.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  pickDep.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
-                         VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-  pickDep.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
-                          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
   VkRenderPassCreateInfo pickRp{};
   pickRp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
   std::array<VkAttachmentDescription, 2> pickAttachments = {pickColor,
@@ -1839,13 +2476,52 @@ void VulkanViewport::CreateRenderPass() {
   pickRp.pAttachments = pickAttachments.data();
   pickRp.subpassCount = 1;
   pickRp.pSubpasses = &pickSubpass;
-  pickRp.dependencyCount = 1;
-  pickRp.pDependencies = &pickDep;
 
   if (vkCreateRenderPass(device, &pickRp, nullptr, &m_pickingRenderPass) !=
       VK_SUCCESS) {
     throw std::runtime_error("Failed to create picking render pass");
   }
+
+  if (m_shadowFormat == VK_FORMAT_UNDEFINED) {
+    m_shadowFormat = FindShadowFormat(m_context->GetPhysicalDevice());
+  }
+
+  VkAttachmentDescription shadowDepth{};
+  shadowDepth.format = m_shadowFormat;
+  shadowDepth.samples = VK_SAMPLE_COUNT_1_BIT;
+  shadowDepth.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+  shadowDepth.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  shadowDepth.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  shadowDepth.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  shadowDepth.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+  shadowDepth.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+  VkAttachmentReference shadowDepthRef{};
+  shadowDepthRef.attachment = 0;
+  shadowDepthRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+  VkSubpassDescription shadowSubpass{};
+  shadowSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  shadowSubpass.pDepthStencilAttachment = &shadowDepthRef;
+
+  VkRenderPassCreateInfo shadowRp{};
+  shadowRp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+  shadowRp.attachmentCount = 1;
+  shadowRp.pAttachments = &shadowDepth;
+  shadowRp.subpassCount = 1;
+  shadowRp.pSubpasses = &shadowSubpass;
+
+  if (vkCreateRenderPass(device, &shadowRp, nullptr, &m_shadowRenderPass) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Failed to create shadow render pass");
+  }
+
+  // Only the cascades being redrawn are cleared, inside the pass.
+  shadowDepth.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+  if (vkCreateRenderPass(device, &shadowRp, nullptr,
+                         &m_shadowCacheRenderPass) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create shadow cache render pass");
+  }
 }
 
 void VulkanViewport::CreateDescriptorSetLayout() {
@@ -1855,10 +2531,22 @@ void VulkanViewport::CreateDescriptorSetLayout() {
   ubo.descriptorCount = 1;
   ubo.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
+  // Cached and per-frame shadow atlases, sampled with depth compare.
+  VkDescriptorSetLayoutBinding staticShadow{};
+  staticShadow.binding = 1;
+  staticShadow.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  staticShadow.descriptorCount = 1;
+  staticShadow.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  VkDescriptorSetLayoutBinding dynamicShadow = staticShadow;
+  dynamicShadow.binding = 2;
+
+  std::array<VkDescriptorSetLayoutBinding, 3> frameBindings = {
+      ubo, staticShadow, dynamicShadow};
   VkDescriptorSetLayoutCreateInfo info{};
   info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-  info.bindingCount = 1;
-  info.pBindings = &ubo;
+  info.bindingCount = static_cast<uint32_t>(frameBindings.size());
+  info.pBindings = frameBindings.data();
 
   if (vkCreateDescriptorSetLayout(m_context->GetDevice(), &info, nullptr,
                                   &m_descriptorSetLayout) != VK_SUCCESS) {
@@ -1997,6 +2685,14 @@ void VulkanViewport::CreateMeshBuffers() {
   }
   m_defaultIndexCount = static_cast<uint32_t>(indices.size());
 
+  // The default quad and the icon quad share their positions.
+  std::array<float, vertices.size() * 3> positions{};
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    std::memcpy(&positions[i * 3], vertices[i].pos, sizeof(Vertex::pos));
+  }
+  UploadVertexStream(positions.data(), sizeof(positions), m_positionBuffer,
+                     m_positionMemory);
+
   m_iconMesh = {};
   const std::array<Vertex, 4> iconVertices = {
       Vertex{{-0.5f, -0.5f, 0.0f},
@@ -2064,6 +2760,9 @@ void VulkanViewport::CreateMeshBuffers() {
                  m_iconMesh.indexMemory);
     CopyBuffer(iconStagingIndex, m_iconMesh.indexBuffer, iconIndexSize);
     m_iconMesh.indexCount = static_cast<uint32_t>(iconIndices.size());
+
+    UploadVertexStream(positions.data(), sizeof(positions),
+                       m_iconMesh.positionBuffer, m_iconMesh.positionMemory);
   } catch (...) {
     if (iconStagingVertex != VK_NULL_HANDLE) {
       vkDestroyBuffer(device, iconStagingVertex, nullptr);
@@ -2161,40 +2860,184 @@ void VulkanViewport::CreateLineBuffers() {
   std::memcpy(vData, vertices.data(), sizeof(Vertex) * vertices.size());
   vkUnmapMemory(device, m_lineVertexMemory);
 
-  const size_t maxSelectionVerts = 128;
-  CreateBuffer(gpu, device, sizeof(Vertex) * maxSelectionVerts,
-               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-               m_selectionVertexBuffer, m_selectionVertexMemory);
-  m_selectionVertexCount = 0;
+  // Unit wireframe templates, white so the per-instance color shows through.
+  std::vector<Vertex> wireframe;
+  const float white[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+  auto addLine = [&](float ax, float ay, float az, float bx, float by,
+                     float bz) {
+    wireframe.push_back(Vertex{{ax, ay, az},
+                               {0.0f, 1.0f, 0.0f},
+                               {white[0], white[1], white[2], white[3]},
+                               {0.0f, 0.0f}});
+    wireframe.push_back(Vertex{{bx, by, bz},
+                               {0.0f, 1.0f, 0.0f},
+                               {white[0], white[1], white[2], white[3]},
+                               {0.0f, 0.0f}});
+  };
+  // Arc in the plane spanned by axes (u, v) of a unit circle, as
+  // `segments` line segments from `startAngle` over `sweep` radians.
+  auto addArc = [&](int u, int v, float startAngle, float sweep,
+                    uint32_t segments) {
+    for (uint32_t i = 0; i < segments; ++i) {
+      const float a0 = startAngle + sweep * static_cast<float>(i) /
+                                        static_cast<float>(segments);
+      const float a1 = startAngle + sweep * static_cast<float>(i + 1) /
+                                        static_cast<float>(segments);
+      float p0[3] = {0.0f, 0.0f, 0.0f};
+      float p1[3] = {0.0f, 0.0f, 0.0f};
+      p0[u] = std::cos(a0);
+      p0[v] = std::sin(a0);
+      p1[u] = std::cos(a1);
+      p1[v] = std::sin(a1);
+      addLine(p0[0], p0[1], p0[2], p1[0], p1[1], p1[2]);
+    }
+  };
+  auto beginTemplate = [&](uint32_t id) {
+    m_wireframeTemplates[id].firstVertex =
+        static_cast<uint32_t>(wireframe.size());
+  };
+  auto endTemplate = [&](uint32_t id) {
+    m_wireframeTemplates[id].vertexCount =
+        static_cast<uint32_t>(wireframe.size()) -
+        m_wireframeTemplates[id].firstVertex;
+  };
 
-  // Light gizmo buffer: support multiple lights with line gizmos.
-  const size_t maxLightGizmoVerts = kMaxLights * 96;
-  CreateBuffer(gpu, device, sizeof(Vertex) * maxLightGizmoVerts,
-               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+  constexpr float kTwoPi = 6.28318530718f;
+  constexpr float kPi = 3.14159265359f;
+
+  // Box spanning [-1, 1] on every axis.
+  beginTemplate(kWireframeBox);
+  for (int i = 0; i < 4; ++i) {
+    const float a = (i & 1) ? 1.0f : -1.0f;
+    const float b = (i & 2) ? 1.0f : -1.0f;
+    addLine(-1.0f, a, b, 1.0f, a, b);
+    addLine(a, -1.0f, b, a, 1.0f, b);
+    addLine(a, b, -1.0f, a, b, 1.0f);
+  }
+  endTemplate(kWireframeBox);
+
+  // Sphere: three great circles.
+  beginTemplate(kWireframeSphere);
+  addArc(0, 1, 0.0f, kTwoPi, kWireframeCircleSegments);
+  addArc(0, 2, 0.0f, kTwoPi, kWireframeCircleSegments);
+  addArc(1, 2, 0.0f, kTwoPi, kWireframeCircleSegments);
+  endTemplate(kWireframeSphere);
+
+  // Capsule cap: rim circle plus two upper half arcs. Mirrored in Y for the
+  // bottom cap.
+  beginTemplate(kWireframeCapsuleCap);
+  addArc(0, 2, 0.0f, kTwoPi, kWireframeCircleSegments);
+  addArc(0, 1, 0.0f, kPi, kWireframeCircleSegments / 2);
+  addArc(2, 1, 0.0f, kPi, kWireframeCircleSegments / 2);
+  endTemplate(kWireframeCapsuleCap);
+
+  // Capsule body: four vertical lines between the cap rims.
+  beginTemplate(kWireframeCapsuleBody);
+  addLine(1.0f, -1.0f, 0.0f, 1.0f, 1.0f, 0.0f);
+  addLine(-1.0f, -1.0f, 0.0f, -1.0f, 1.0f, 0.0f);
+  addLine(0.0f, -1.0f, 1.0f, 0.0f, 1.0f, 1.0f);
+  addLine(0.0f, -1.0f, -1.0f, 0.0f, 1.0f, -1.0f);
+  endTemplate(kWireframeCapsuleBody);
+
+  const VkDeviceSize wireframeSize = sizeof(Vertex) * wireframe.size();
+  CreateBuffer(gpu, device, wireframeSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-               m_lightGizmoVertexBuffer, m_lightGizmoVertexMemory);
-  m_lightGizmoVertexCount = 0;
+               m_wireframeTemplateBuffer, m_wireframeTemplateMemory);
+
+  void *wData = nullptr;
+  vkMapMemory(device, m_wireframeTemplateMemory, 0, wireframeSize, 0, &wData);
+  std::memcpy(wData, wireframe.data(), static_cast<size_t>(wireframeSize));
+  vkUnmapMemory(device, m_wireframeTemplateMemory);
+
+  for (auto &ring : m_dynamicGeometry) {
+    EnsureDynamicGeometryCapacity(ring, kDynamicGeometryInitialSize);
+  }
+  m_selectionLines = {};
+  m_lightGizmoLines = {};
+  m_colliderInstances = {};
+}
+
+void VulkanViewport::EnsureDynamicGeometryCapacity(DynamicGeometryBuffer &ring,
+                                                   VkDeviceSize required) {
+  if (ring.buffer != VK_NULL_HANDLE && ring.capacity >= required) {
+    return;
+  }
+
+  VkDeviceSize capacity =
+      std::max<VkDeviceSize>(ring.capacity, kDynamicGeometryInitialSize);
+  while (capacity < required) {
+    capacity *= 2;
+  }
 
-  // Collider debug buffer: support many colliders with wireframe shapes.
-  // Box: 24 verts, Sphere: ~96 verts, Capsule: ~128 verts
-  const size_t maxColliderVerts = 256 * 128; // Up to 256 colliders
-  CreateBuffer(gpu, device, sizeof(Vertex) * maxColliderVerts,
+  VkDevice device = m_context->GetDevice();
+  DynamicGeometryBuffer grown{};
+  CreateBuffer(m_context->GetPhysicalDevice(), device, capacity,
                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-               m_colliderVertexBuffer, m_colliderVertexMemory);
-  m_colliderVertexCount = 0;
+               grown.buffer, grown.memory);
+  if (vkMapMemory(device, grown.memory, 0, VK_WHOLE_SIZE, 0, &grown.mapped) !=
+      VK_SUCCESS) {
+    vkDestroyBuffer(device, grown.buffer, nullptr);
+    vkFreeMemory(device, grown.memory, nullptr);
+    throw std::runtime_error("Failed to map dynamic geometry buffer");
+  }
+  grown.capacity = capacity;
+  grown.head = ring.head;
+
+  // Ranges already written this frame keep their offsets. The old buffer's
+  // frame fence has been waited on, so it can be released immediately.
+  if (ring.buffer != VK_NULL_HANDLE) {
+    if (ring.head > 0) {
+      std::memcpy(grown.mapped, ring.mapped, static_cast<size_t>(ring.head));
+    }
+    vkUnmapMemory(device, ring.memory);
+    vkDestroyBuffer(device, ring.buffer, nullptr);
+    vkFreeMemory(device, ring.memory, nullptr);
+  }
+  ring = grown;
+}
+
+VkDeviceSize VulkanViewport::WriteDynamicGeometry(const void *data,
+                                                  VkDeviceSize size) {
+  auto &ring = m_dynamicGeometry[m_frameIndex];
+  // Keep every range aligned for both Vertex and WireframeInstance reads.
+  const VkDeviceSize offset = (ring.head + 15) & ~VkDeviceSize{15};
+  EnsureDynamicGeometryCapacity(ring, offset + size);
+  std::memcpy(static_cast<char *>(ring.mapped) + offset, data,
+              static_cast<size_t>(size));
+  ring.head = offset + size;
+  return offset;
+}
+
+void VulkanViewport::DestroyDynamicGeometry() {
+  VkDevice device = (m_context && m_context->IsInitialized())
+                        ? m_context->GetDevice()
+                        : VK_NULL_HANDLE;
+  for (auto &ring : m_dynamicGeometry) {
+    if (device != VK_NULL_HANDLE && ring.mapped != nullptr) {
+      vkUnmapMemory(device, ring.memory);
+    }
+    if (device != VK_NULL_HANDLE && ring.buffer != VK_NULL_HANDLE) {
+      vkDestroyBuffer(device, ring.buffer, nullptr);
+    }
+    if (device != VK_NULL_HANDLE && ring.memory != VK_NULL_HANDLE) {
+      vkFreeMemory(device, ring.memory, nullptr);
+    }
+    ring = {};
+  }
+  m_selectionLines = {};
+  m_lightGizmoLines = {};
+  m_colliderInstances = {};
 }
 
-void VulkanViewport::CreateSceneResources() {
+void VulkanViewport::CreateRenderGraphs() {
   if (!m_context || !m_context->IsInitialized()) {
     return;
   }
 
-  DestroySceneResources();
+  DestroyRenderGraphs();
 
   if (m_swapchainExtent.width == 0 || m_swapchainExtent.height == 0) {
     return;
@@ -2209,37 +3052,164 @@ void VulkanViewport::CreateSceneResources() {
   if (m_sceneColorFormat == VK_FORMAT_UNDEFINED) {
     m_sceneColorFormat = FindSceneColorFormat(gpu);
   }
+  if (m_pickingFormat == VK_FORMAT_UNDEFINED) {
+    const auto pickInfo = FindPickingFormat(gpu);
+    m_pickingFormat = pickInfo.format;
+    m_pickingFormatIsUint = pickInfo.isUint;
+  }
+  if (m_shadowFormat == VK_FORMAT_UNDEFINED) {
+    m_shadowFormat = FindShadowFormat(gpu);
+  }
 
-  for (uint32_t i = 0; i < kMaxFramesInFlight; ++i) {
-    CreateImage(gpu, device, m_swapchainExtent.width, m_swapchainExtent.height,
-                m_sceneColorFormat, VK_IMAGE_TILING_OPTIMAL,
-                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
-                    VK_IMAGE_USAGE_SAMPLED_BIT,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_sceneColorImages[i],
-                m_sceneColorMemories[i]);
+  VkImageAspectFlags depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+  if (HasStencilComponent(m_depthFormat)) {
+    depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+  }
 
-    m_sceneColorViews[i] =
-        CreateImageView(device, m_sceneColorImages[i], m_sceneColorFormat,
-                        VK_IMAGE_ASPECT_COLOR_BIT);
-    TransitionImageLayout(m_sceneColorImages[i], m_sceneColorFormat,
-                          VK_IMAGE_LAYOUT_UNDEFINED,
-                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  using Access = RenderGraphAccess;
+  for (auto &graph : m_renderGraphs) {
+    auto createImage = [&](const char *name, VkFormat format,
+                           VkImageUsageFlags usage, VkImageAspectFlags aspect) {
+      RenderGraph::ImageDesc desc{};
+      desc.name = name;
+      desc.format = format;
+      desc.extent = m_swapchainExtent;
+      desc.usage = usage;
+      desc.aspect = aspect;
+      return graph.CreateImage(desc);
+    };
 
-    CreateImage(gpu, device, m_swapchainExtent.width, m_swapchainExtent.height,
-                m_depthFormat, VK_IMAGE_TILING_OPTIMAL,
-                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_sceneDepthImages[i],
-                m_sceneDepthMemories[i]);
+    GraphTargets targets{};
+    targets.sceneColor = createImage(
+        "SceneColor", m_sceneColorFormat,
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_IMAGE_ASPECT_COLOR_BIT);
+    targets.sceneDepth =
+        createImage("SceneDepth", m_depthFormat,
+                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, depthAspect);
+    targets.picking = createImage("Picking", m_pickingFormat,
+                                  VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                      VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                      VK_IMAGE_USAGE_SAMPLED_BIT,
+                                  VK_IMAGE_ASPECT_COLOR_BIT);
+    targets.pickingDepth =
+        createImage("PickingDepth", m_depthFormat,
+                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, depthAspect);
+
+    RenderGraph::ImportDesc backbuffer{};
+    backbuffer.name = "Backbuffer";
+    // The stage RenderFrame() waits on the image-available semaphore at.
+    backbuffer.initialStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    backbuffer.finalLayout = m_headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+                                        : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    targets.backbuffer = graph.ImportImage(backbuffer);
+
+    RenderGraph::ImportDesc shadowAtlas{};
+    shadowAtlas.name = "StaticShadowAtlas";
+    shadowAtlas.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    // The previous frame may still be sampling it, or drawing into it.
+    shadowAtlas.initialStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                               VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    shadowAtlas.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    targets.shadowAtlas = graph.ImportImage(shadowAtlas);
+
+    RenderGraph::ImageDesc dynamicShadow{};
+    dynamicShadow.name = "DynamicShadowAtlas";
+    dynamicShadow.format = m_shadowFormat;
+    dynamicShadow.extent = {kDynamicShadowAtlasSize, kDynamicShadowAtlasSize};
+    dynamicShadow.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                          VK_IMAGE_USAGE_SAMPLED_BIT;
+    dynamicShadow.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    targets.dynamicShadow = graph.CreateImage(dynamicShadow);
+
+    graph.AddPass(
+        kPassNames[kShadowStaticPass],
+        [&](RenderGraph::PassBuilder &pass) {
+          pass.Write(targets.shadowAtlas, Access::DepthAttachment);
+        },
+        [this](VkCommandBuffer cb) {
+          RecordShadowPass(cb, *m_recordInstances, true);
+        });
+    graph.AddPass(
+        kPassNames[kShadowDynamicPass],
+        [&](RenderGraph::PassBuilder &pass) {
+          pass.Write(targets.dynamicShadow, Access::DepthAttachment);
+        },
+        [this](VkCommandBuffer cb) {
+          RecordShadowPass(cb, *m_recordInstances, false);
+        });
+    // Later consumers of scene depth (Hi-Z, depth-based picking) can declare
+    // reads on sceneDepth after this pass.
+    graph.AddPass(
+        kPassNames[kDepthPrepassPass],
+        [&](RenderGraph::PassBuilder &pass) {
+          pass.Write(targets.sceneDepth, Access::DepthAttachment);
+        },
+        [this](VkCommandBuffer cb) {
+          RecordDepthPrepass(cb, *m_recordInstances);
+        });
+    graph.AddPass(
+        kPassNames[kOpaquePass],
+        [&](RenderGraph::PassBuilder &pass) {
+          pass.Write(targets.sceneColor, Access::ColorAttachment);
+          // Loads the pre-pass depth when that pass is enabled.
+          pass.ReadWrite(targets.sceneDepth, Access::DepthAttachment);
+          // Bound unconditionally; the shader skips them with shadows off.
+          pass.Read(targets.shadowAtlas, Access::FragmentSampled);
+          pass.Read(targets.dynamicShadow, Access::FragmentSampled);
+        },
+        [this](VkCommandBuffer cb) {
+          RecordOpaquePass(cb, *m_recordInstances);
+        });
+    graph.AddPass(
+        kPassNames[kPickingPass],
+        [&](RenderGraph::PassBuilder &pass) {
+          pass.Write(targets.picking, Access::ColorAttachment);
+          pass.Write(targets.pickingDepth, Access::DepthAttachment);
+        },
+        [this](VkCommandBuffer cb) {
+          RecordPickingPass(cb, *m_recordInstances);
+        });
+    graph.AddPass(
+        kPassNames[kPickReadbackPass],
+        [&](RenderGraph::PassBuilder &pass) {
+          pass.Read(targets.picking, Access::TransferSrc);
+          pass.SetSideEffects();
+        },
+        [this](VkCommandBuffer cb) { RecordPickReadbackPass(cb); });
+    graph.AddPass(
+        kPassNames[kPostProcessPass],
+        [&](RenderGraph::PassBuilder &pass) {
+          pass.Read(targets.sceneColor, Access::FragmentSampled);
+          // Bound unconditionally; only sampled in the EntityId debug view.
+          pass.Read(targets.picking, Access::FragmentSampled);
+          pass.Write(targets.backbuffer, Access::ColorAttachment);
+        },
+        [this](VkCommandBuffer cb) {
+          RecordPostProcessPass(cb, m_recordImageIndex);
+        });
+    // Declares no outputs yet, so the graph culls it every frame.
+    graph.AddPass(kPassNames[kOverlayPass], {},
+                  [this](VkCommandBuffer cb) { RecordOverlayPass(cb); });
 
-    VkImageAspectFlags aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
-    if (HasStencilComponent(m_depthFormat)) {
-      aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    if (graph.GetPassCount() != kPassCount) {
+      throw std::runtime_error("Render graph pass count mismatch");
     }
-    m_sceneDepthViews[i] =
-        CreateImageView(device, m_sceneDepthImages[i], m_depthFormat, aspect);
-    TransitionImageLayout(m_sceneDepthImages[i], m_depthFormat,
-                          VK_IMAGE_LAYOUT_UNDEFINED,
-                          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+    graph.Compile(gpu, device);
+    // Every slot declares the same resources, so the ids are shared.
+    m_graphTargets = targets;
+  }
+
+  if (m_verboseLogging) {
+    const auto stats = m_renderGraphs[0].GetStats();
+    m_context->Log(
+        LogSeverity::Info,
+        "VulkanViewport: render graph placed " +
+            std::to_string(stats.transientImages) + " transient images in " +
+            std::to_string(stats.memoryBlocks) + " allocations (" +
+            std::to_string(stats.transientBytes >> 10) + " KiB, " +
+            std::to_string(stats.unaliasedBytes >> 10) +
+            " KiB without aliasing) per frame");
   }
 }
 
@@ -2254,49 +3224,11 @@ void VulkanViewport::CreatePickingResources() {
     return;
   }
 
+  // The picking targets themselves are render graph transients; only the
+  // host-visible readback buffers live here.
   VkDevice device = m_context->GetDevice();
   VkPhysicalDevice gpu = m_context->GetPhysicalDevice();
-
-  if (m_pickingFormat == VK_FORMAT_UNDEFINED) {
-    const auto pickInfo = FindPickingFormat(gpu);
-    m_pickingFormat = pickInfo.format;
-    m_pickingFormatIsUint = pickInfo.isUint;
-  }
-  if (m_depthFormat == VK_FORMAT_UNDEFINED) {
-    m_depthFormat = FindDepthFormat(gpu);
-  }
-
   for (uint32_t i = 0; i < kMaxFramesInFlight; ++i) {
-    CreateImage(gpu, device, m_swapchainExtent.width, m_swapchainExtent.height,
-                m_pickingFormat, VK_IMAGE_TILING_OPTIMAL,
-                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
-                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
-                    VK_IMAGE_USAGE_SAMPLED_BIT,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_pickingImages[i],
-                m_pickingMemories[i]);
-
-    m_pickingViews[i] = CreateImageView(
-        device, m_pickingImages[i], m_pickingFormat, VK_IMAGE_ASPECT_COLOR_BIT);
-    TransitionImageLayout(m_pickingImages[i], m_pickingFormat,
-                          VK_IMAGE_LAYOUT_UNDEFINED,
-                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-    CreateImage(gpu, device, m_swapchainExtent.width, m_swapchainExtent.height,
-                m_depthFormat, VK_IMAGE_TILING_OPTIMAL,
-                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_pickingDepthImages[i],
-                m_pickingDepthMemories[i]);
-
-    VkImageAspectFlags aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
-    if (HasStencilComponent(m_depthFormat)) {
-      aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
-    }
-    m_pickingDepthViews[i] =
-        CreateImageView(device, m_pickingDepthImages[i], m_depthFormat, aspect);
-    TransitionImageLayout(m_pickingDepthImages[i], m_depthFormat,
-                          VK_IMAGE_LAYOUT_UNDEFINED,
-                          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-
     CreateBuffer(gpu, device, sizeof(uint32_t),
                  VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
@@ -2337,7 +3269,9 @@ void VulkanViewport::CreateDescriptorPoolAndSets() {
     poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     poolSizes[0].descriptorCount = 1;
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = 2;
+    // Two shadow atlases in the frame set, scene and picking in the
+    // post-process set.
+    poolSizes[1].descriptorCount = 4;
 
     VkDescriptorPoolCreateInfo pool{};
     pool.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -2440,7 +3374,7 @@ void VulkanViewport::CreateTextureResources() {
   sampler.compareEnable = VK_FALSE;
   sampler.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
   sampler.minLod = 0.0f;
-  sampler.maxLod = 0.0f;
+  sampler.maxLod = VK_LOD_CLAMP_NONE;
 
   if (m_context && m_context->IsSamplerAnisotropyEnabled()) {
     sampler.anisotropyEnable = VK_TRUE;
@@ -2454,6 +3388,17 @@ void VulkanViewport::CreateTextureResources() {
   }
 
   VkSamplerCreateInfo postSampler = sampler;
+  postSampler.maxLod = 0.0f;
+  postSampler.anisotropyEnable = VK_FALSE;
+  postSampler.maxAnisotropy = 1.0f;
+  postSampler.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  postSampler.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  postSampler.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  if (vkCreateSampler(device, &postSampler, nullptr, &m_sceneUpscaleSampler) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Failed to create scene upscale sampler");
+  }
+
   if (m_pickingFormatIsUint) {
     postSampler.magFilter = VK_FILTER_NEAREST;
     postSampler.minFilter = VK_FILTER_NEAREST;
@@ -2469,26 +3414,35 @@ void VulkanViewport::CreateTextureResources() {
 
   const unsigned char white[4] = {255, 255, 255, 255};
   m_defaultTexture = CreateTextureFromPixels(white, 1, 1);
+  AllocateTextureDescriptorSet(m_defaultTexture);
 }
 
 void VulkanViewport::CreatePipeline() {
+  // The picking target format is fixed per device, so only the matching
+  // picking/post-process variants are ever bound; skip building the others.
   auto vert = ReadFileBinary(ShaderPath("viewport_triangle.vert.spv"));
   auto frag = ReadFileBinary(ShaderPath("viewport_triangle.frag.spv"));
-  auto pickFrag = ReadFileBinary(ShaderPath("viewport_picking.frag.spv"));
-  auto pickFragUint =
-      ReadFileBinary(ShaderPath("viewport_picking_uint.frag.spv"));
+  auto wireVert = ReadFileBinary(ShaderPath("viewport_wireframe.vert.spv"));
+  auto shadowVert = ReadFileBinary(ShaderPath("viewport_shadow.vert.spv"));
+  auto depthVert = ReadFileBinary(ShaderPath("viewport_depth.vert.spv"));
+  auto pickFrag = ReadFileBinary(
+      ShaderPath(m_pickingFormatIsUint ? "viewport_picking_uint.frag.spv"
+                                       : "viewport_picking.frag.spv"));
   auto postVert = ReadFileBinary(ShaderPath("viewport_postprocess.vert.spv"));
-  auto postFrag = ReadFileBinary(ShaderPath("viewport_postprocess.frag.spv"));
-  auto postFragUint =
-      ReadFileBinary(ShaderPath("viewport_postprocess_uint.frag.spv"));
+  auto postFrag = ReadFileBinary(
+      ShaderPath(m_pickingFormatIsUint ? "viewport_postprocess_uint.frag.spv"
+                                       : "viewport_postprocess.frag.spv"));
 
   VkShaderModule vertModule = CreateShaderModule(vert);
   VkShaderModule fragModule = CreateShaderModule(frag);
+  VkShaderModule wireVertModule = CreateShaderModule(wireVert);
+  VkShaderModule shadowVertModule = CreateShaderModule(shadowVert);
+  VkShaderModule depthVertModule = CreateShaderModule(depthVert);
   VkShaderModule pickFragModule = CreateShaderModule(pickFrag);
-  VkShaderModule pickFragUintModule = CreateShaderModule(pickFragUint);
   VkShaderModule postVertModule = CreateShaderModule(postVert);
   VkShaderModule postFragModule = CreateShaderModule(postFrag);
-  VkShaderModule postFragUintModule = CreateShaderModule(postFragUint);
+
+  const VkPipelineCache pipelineCache = m_context->GetPipelineCache();
 
   VkPipelineShaderStageCreateInfo vs{};
   vs.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -2631,17 +3585,31 @@ void VulkanViewport::CreatePipeline() {
   pipe.renderPass = m_sceneRenderPass;
   pipe.subpass = 0;
 
-  if (vkCreateGraphicsPipelines(m_context->GetDevice(), VK_NULL_HANDLE, 1,
+  if (vkCreateGraphicsPipelines(m_context->GetDevice(), pipelineCache, 1,
                                 &pipe, nullptr, &m_pipeline) != VK_SUCCESS) {
     throw std::runtime_error("Failed to create graphics pipeline");
   }
 
+  // Shades only the fragments the depth pre-pass kept. Both passes compute
+  // gl_Position identically (invariant), so EQUAL is exact.
+  VkPipelineDepthStencilStateCreateInfo equalDepth = depth;
+  equalDepth.depthCompareOp = VK_COMPARE_OP_EQUAL;
+  equalDepth.depthWriteEnable = VK_FALSE;
+
+  VkGraphicsPipelineCreateInfo equalPipe = pipe;
+  equalPipe.pDepthStencilState = &equalDepth;
+  if (vkCreateGraphicsPipelines(m_context->GetDevice(), pipelineCache, 1,
+                                &equalPipe, nullptr,
+                                &m_depthEqualPipeline) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create depth-equal pipeline");
+  }
+
   VkPipelineInputAssemblyStateCreateInfo lineInput = inputAssembly;
   lineInput.topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
 
   VkGraphicsPipelineCreateInfo linePipe = pipe;
   linePipe.pInputAssemblyState = &lineInput;
-  if (vkCreateGraphicsPipelines(m_context->GetDevice(), VK_NULL_HANDLE, 1,
+  if (vkCreateGraphicsPipelines(m_context->GetDevice(), pipelineCache, 1,
                                 &linePipe, nullptr,
                                 &m_linePipeline) != VK_SUCCESS) {
     throw std::runtime_error("Failed to create line pipeline");
@@ -2653,34 +3621,172 @@ void VulkanViewport::CreatePipeline() {
 
   VkGraphicsPipelineCreateInfo overlayPipe = linePipe;
   overlayPipe.pDepthStencilState = &overlayDepth;
-  if (vkCreateGraphicsPipelines(m_context->GetDevice(), VK_NULL_HANDLE, 1,
+  if (vkCreateGraphicsPipelines(m_context->GetDevice(), pipelineCache, 1,
                                 &overlayPipe, nullptr,
                                 &m_overlayPipeline) != VK_SUCCESS) {
     throw std::runtime_error("Failed to create overlay pipeline");
   }
 
+  // Instanced unit wireframes: template vertices in binding 0, one
+  // WireframeInstance (mat4 + color) per instance in binding 1.
+  std::array<VkVertexInputBindingDescription, 2> wireBindings{};
+  wireBindings[0] = binding;
+  wireBindings[1].binding = 1;
+  wireBindings[1].stride = sizeof(WireframeInstance);
+  wireBindings[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+  std::array<VkVertexInputAttributeDescription, 9> wireAttrs{};
+  for (size_t i = 0; i < attrs.size(); ++i) {
+    wireAttrs[i] = attrs[i];
+  }
+  for (uint32_t column = 0; column < 4; ++column) {
+    auto &attr = wireAttrs[attrs.size() + column];
+    attr.location = 4 + column;
+    attr.binding = 1;
+    attr.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    attr.offset = static_cast<uint32_t>(offsetof(WireframeInstance, model) +
+                                        sizeof(float) * 4 * column);
+  }
+  wireAttrs[8].location = 8;
+  wireAttrs[8].binding = 1;
+  wireAttrs[8].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+  wireAttrs[8].offset = offsetof(WireframeInstance, color);
+
+  VkPipelineVertexInputStateCreateInfo wireVertexInput = vertexInput;
+  wireVertexInput.vertexBindingDescriptionCount =
+      static_cast<uint32_t>(wireBindings.size());
+  wireVertexInput.pVertexBindingDescriptions = wireBindings.data();
+  wireVertexInput.vertexAttributeDescriptionCount =
+      static_cast<uint32_t>(wireAttrs.size());
+  wireVertexInput.pVertexAttributeDescriptions = wireAttrs.data();
+
+  VkPipelineShaderStageCreateInfo wireVs = vs;
+  wireVs.module = wireVertModule;
+  VkPipelineShaderStageCreateInfo wireStages[] = {wireVs, fs};
+  VkGraphicsPipelineCreateInfo wirePipe = overlayPipe;
+  wirePipe.pStages = wireStages;
+  wirePipe.pVertexInputState = &wireVertexInput;
+  if (vkCreateGraphicsPipelines(m_context->GetDevice(), pipelineCache, 1,
+                                &wirePipe, nullptr,
+                                &m_wireframePipeline) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create wireframe pipeline");
+  }
+
   VkPipelineShaderStageCreateInfo pickFs = fs;
   pickFs.module = pickFragModule;
   VkPipelineShaderStageCreateInfo pickStages[] = {vs, pickFs};
   VkGraphicsPipelineCreateInfo pickPipe = pipe;
   pickPipe.pStages = pickStages;
   pickPipe.renderPass = m_pickingRenderPass;
-  if (vkCreateGraphicsPipelines(m_context->GetDevice(), VK_NULL_HANDLE, 1,
+  VkPipeline &pickingPipeline =
+      m_pickingFormatIsUint ? m_pickingPipelineUint : m_pickingPipeline;
+  if (vkCreateGraphicsPipelines(m_context->GetDevice(), pipelineCache, 1,
                                 &pickPipe, nullptr,
-                                &m_pickingPipeline) != VK_SUCCESS) {
+                                &pickingPipeline) != VK_SUCCESS) {
     throw std::runtime_error("Failed to create picking pipeline");
   }
 
-  VkPipelineShaderStageCreateInfo pickFsUint = fs;
-  pickFsUint.module = pickFragUintModule;
-  VkPipelineShaderStageCreateInfo pickStagesUint[] = {vs, pickFsUint};
-  VkGraphicsPipelineCreateInfo pickPipeUint = pickPipe;
-  pickPipeUint.pStages = pickStagesUint;
-  if (vkCreateGraphicsPipelines(m_context->GetDevice(), VK_NULL_HANDLE, 1,
-                                &pickPipeUint, nullptr,
-                                &m_pickingPipelineUint) != VK_SUCCESS) {
-    throw std::runtime_error("Failed to create uint picking pipeline");
-  }
+  // Depth-only passes read the position-only stream: float3 for regular
+  // meshes, UNORM16x4 for packed ones. Only the vertex layout differs, so the
+  // packed variants are cheap enough to build here rather than with the async
+  // packed pipelines.
+  VkVertexInputBindingDescription positionBinding = binding;
+  positionBinding.stride = sizeof(Vertex::pos);
+  VkVertexInputAttributeDescription positionAttr = attrs[0];
+  positionAttr.offset = 0;
+
+  VkPipelineVertexInputStateCreateInfo positionInput = vertexInput;
+  positionInput.pVertexBindingDescriptions = &positionBinding;
+  positionInput.vertexAttributeDescriptionCount = 1;
+  positionInput.pVertexAttributeDescriptions = &positionAttr;
+
+  VkVertexInputBindingDescription packedPositionBinding = binding;
+  packedPositionBinding.stride = sizeof(PackedVertex::pos);
+  VkVertexInputAttributeDescription packedPositionAttr = positionAttr;
+  packedPositionAttr.format = VK_FORMAT_R16G16B16A16_UNORM;
+
+  VkPipelineVertexInputStateCreateInfo packedPositionInput = positionInput;
+  packedPositionInput.pVertexBindingDescriptions = &packedPositionBinding;
+  packedPositionInput.pVertexAttributeDescriptions = &packedPositionAttr;
+
+  VkPipelineColorBlendStateCreateInfo depthOnlyBlend = blend;
+  depthOnlyBlend.attachmentCount = 0;
+  depthOnlyBlend.pAttachments = nullptr;
+
+  VkPipelineShaderStageCreateInfo depthVs = vs;
+  depthVs.module = depthVertModule;
+
+  VkGraphicsPipelineCreateInfo prepassPipe = pipe;
+  prepassPipe.stageCount = 1;
+  prepassPipe.pStages = &depthVs;
+  prepassPipe.pVertexInputState = &positionInput;
+  prepassPipe.pColorBlendState = &depthOnlyBlend;
+  prepassPipe.renderPass = m_depthPrepassRenderPass;
+  if (vkCreateGraphicsPipelines(m_context->GetDevice(), pipelineCache, 1,
+                                &prepassPipe, nullptr,
+                                &m_depthPrepassPipeline) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create depth pre-pass pipeline");
+  }
+
+  prepassPipe.pVertexInputState = &packedPositionInput;
+  if (vkCreateGraphicsPipelines(m_context->GetDevice(), pipelineCache, 1,
+                                &prepassPipe, nullptr,
+                                &m_packedDepthPrepassPipeline) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create packed depth pre-pass pipeline");
+  }
+
+  VkPipelineShaderStageCreateInfo shadowVs = vs;
+  shadowVs.module = shadowVertModule;
+
+  VkPipelineRasterizationStateCreateInfo shadowRaster = raster;
+  shadowRaster.depthBiasEnable = VK_TRUE;
+  shadowRaster.depthBiasConstantFactor = 1.25f;
+  shadowRaster.depthBiasSlopeFactor = 1.75f;
+
+  VkPipelineDepthStencilStateCreateInfo shadowDepth = depth;
+  shadowDepth.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+  VkGraphicsPipelineCreateInfo shadowPipe = pipe;
+  shadowPipe.stageCount = 1;
+  shadowPipe.pStages = &shadowVs;
+  shadowPipe.pVertexInputState = &positionInput;
+  shadowPipe.pRasterizationState = &shadowRaster;
+  shadowPipe.pColorBlendState = &depthOnlyBlend;
+  shadowPipe.pDepthStencilState = &shadowDepth;
+  shadowPipe.renderPass = m_shadowRenderPass;
+  if (vkCreateGraphicsPipelines(m_context->GetDevice(), pipelineCache, 1,
+                                &shadowPipe, nullptr,
+                                &m_shadowPipeline) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create shadow pipeline");
+  }
+
+  shadowPipe.pVertexInputState = &packedPositionInput;
+  if (vkCreateGraphicsPipelines(m_context->GetDevice(), pipelineCache, 1,
+                                &shadowPipe, nullptr,
+                                &m_packedShadowPipeline) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create packed shadow pipeline");
+  }
+
+  // Packed-vertex variants are only needed once a compressed mesh shows up,
+  // so they are compiled off the render thread and picked up in RenderFrame.
+  PackedPipelineJob job{};
+  job.device = m_context->GetDevice();
+  job.cache = pipelineCache;
+  job.layout = m_pipelineLayout;
+  job.sceneRenderPass = m_sceneRenderPass;
+  job.pickingRenderPass = m_pickingRenderPass;
+  job.vertCode = std::move(vert);
+  job.fragCode = std::move(frag);
+  job.pickFragCode = std::move(pickFrag);
+  job.binding = binding;
+  job.attrs = attrs;
+  job.inputAssembly = inputAssembly;
+  job.viewportState = viewportState;
+  job.raster = raster;
+  job.msaa = msaa;
+  job.blendAttach = blendAttach;
+  job.blend = blend;
+  job.depth = depth;
 
   VkPipelineShaderStageCreateInfo postVs{};
   postVs.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -2737,30 +3843,50 @@ void VulkanViewport::CreatePipeline() {
   postPipe.renderPass = m_postProcessRenderPass;
   postPipe.subpass = 0;
 
-  if (vkCreateGraphicsPipelines(m_context->GetDevice(), VK_NULL_HANDLE, 1,
+  VkPipeline &postProcessPipeline = m_pickingFormatIsUint
+                                        ? m_postProcessPipelineUint
+                                        : m_postProcessPipeline;
+  if (vkCreateGraphicsPipelines(m_context->GetDevice(), pipelineCache, 1,
                                 &postPipe, nullptr,
-                                &m_postProcessPipeline) != VK_SUCCESS) {
+                                &postProcessPipeline) != VK_SUCCESS) {
     throw std::runtime_error("Failed to create postprocess pipeline");
   }
 
-  VkPipelineShaderStageCreateInfo postFsUint = postFs;
-  postFsUint.module = postFragUintModule;
-  VkPipelineShaderStageCreateInfo postStagesUint[] = {postVs, postFsUint};
-  VkGraphicsPipelineCreateInfo postPipeUint = postPipe;
-  postPipeUint.pStages = postStagesUint;
-  if (vkCreateGraphicsPipelines(m_context->GetDevice(), VK_NULL_HANDLE, 1,
-                                &postPipeUint, nullptr,
-                                &m_postProcessPipelineUint) != VK_SUCCESS) {
-    throw std::runtime_error("Failed to create uint postprocess pipeline");
-  }
-
-  vkDestroyShaderModule(m_context->GetDevice(), postFragUintModule, nullptr);
   vkDestroyShaderModule(m_context->GetDevice(), postFragModule, nullptr);
   vkDestroyShaderModule(m_context->GetDevice(), postVertModule, nullptr);
-  vkDestroyShaderModule(m_context->GetDevice(), pickFragUintModule, nullptr);
   vkDestroyShaderModule(m_context->GetDevice(), pickFragModule, nullptr);
+  vkDestroyShaderModule(m_context->GetDevice(), depthVertModule, nullptr);
+  vkDestroyShaderModule(m_context->GetDevice(), shadowVertModule, nullptr);
+  vkDestroyShaderModule(m_context->GetDevice(), wireVertModule, nullptr);
   vkDestroyShaderModule(m_context->GetDevice(), fragModule, nullptr);
   vkDestroyShaderModule(m_context->GetDevice(), vertModule, nullptr);
+
+  m_packedPipelinesFuture = std::async(
+      std::launch::async,
+      [job = std::move(job)]() { return BuildPackedPipelines(job); });
+}
+
+void VulkanViewport::CollectPackedPipelines(bool wait) {
+  if (!m_packedPipelinesFuture.valid()) {
+    return;
+  }
+  if (!wait && m_packedPipelinesFuture.wait_for(std::chrono::seconds(0)) !=
+                   std::future_status::ready) {
+    return;
+  }
+
+  try {
+    const auto pipelines = m_packedPipelinesFuture.get();
+    m_packedPipeline = pipelines[0];
+    (m_pickingFormatIsUint ? m_packedPickingPipelineUint
+                           : m_packedPickingPipeline) = pipelines[1];
+    m_packedDepthEqualPipeline = pipelines[2];
+  } catch (const std::exception &ex) {
+    m_context->Log(LogSeverity::Error,
+                   std::string("VulkanViewport: packed pipeline compile "
+                               "failed; compressed meshes will not draw - ") +
+                       ex.what());
+  }
 }
 
 void VulkanViewport::CreateFramebuffers() {
@@ -2786,6 +3912,12 @@ void VulkanViewport::CreateFramebuffers() {
       fb = VK_NULL_HANDLE;
     }
   }
+  for (auto &fb : m_depthPrepassFramebuffers) {
+    if (fb != VK_NULL_HANDLE) {
+      vkDestroyFramebuffer(device, fb, nullptr);
+      fb = VK_NULL_HANDLE;
+    }
+  }
 
   m_framebuffers.resize(m_swapchainImageViews.size());
   for (size_t i = 0; i < m_swapchainImageViews.size(); ++i) {
@@ -2807,8 +3939,10 @@ void VulkanViewport::CreateFramebuffers() {
   }
 
   for (uint32_t i = 0; i < kMaxFramesInFlight; ++i) {
-    VkImageView sceneAttachments[] = {m_sceneColorViews[i],
-                                      m_sceneDepthViews[i]};
+    const RenderGraph &graph = m_renderGraphs[i];
+    VkImageView sceneAttachments[] = {
+        graph.GetImageView(m_graphTargets.sceneColor),
+        graph.GetImageView(m_graphTargets.sceneDepth)};
     VkFramebufferCreateInfo sceneFb{};
     sceneFb.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
     sceneFb.renderPass = m_sceneRenderPass;
@@ -2822,7 +3956,18 @@ void VulkanViewport::CreateFramebuffers() {
       throw std::runtime_error("Failed to create scene framebuffer");
     }
 
-    VkImageView pickAttachments[] = {m_pickingViews[i], m_pickingDepthViews[i]};
+    VkFramebufferCreateInfo prepassFb = sceneFb;
+    prepassFb.renderPass = m_depthPrepassRenderPass;
+    prepassFb.attachmentCount = 1;
+    prepassFb.pAttachments = &sceneAttachments[1];
+    if (vkCreateFramebuffer(device, &prepassFb, nullptr,
+                            &m_depthPrepassFramebuffers[i]) != VK_SUCCESS) {
+      throw std::runtime_error("Failed to create depth pre-pass framebuffer");
+    }
+
+    VkImageView pickAttachments[] = {
+        graph.GetImageView(m_graphTargets.picking),
+        graph.GetImageView(m_graphTargets.pickingDepth)};
     VkFramebufferCreateInfo pickFb{};
     pickFb.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
     pickFb.renderPass = m_pickingRenderPass;
@@ -2844,7 +3989,8 @@ void VulkanViewport::UpdatePostProcessDescriptorSets() {
   }
 
   VkDevice device = m_context->GetDevice();
-  if (m_postProcessSampler == VK_NULL_HANDLE) {
+  if (m_postProcessSampler == VK_NULL_HANDLE ||
+      m_sceneUpscaleSampler == VK_NULL_HANDLE) {
     return;
   }
 
@@ -2852,19 +3998,22 @@ void VulkanViewport::UpdatePostProcessDescriptorSets() {
     if (m_postProcessDescriptorSets[i] == VK_NULL_HANDLE) {
       continue;
     }
-    if (m_sceneColorViews[i] == VK_NULL_HANDLE ||
-        m_pickingViews[i] == VK_NULL_HANDLE) {
+    const VkImageView sceneView =
+        m_renderGraphs[i].GetImageView(m_graphTargets.sceneColor);
+    const VkImageView pickingView =
+        m_renderGraphs[i].GetImageView(m_graphTargets.picking);
+    if (sceneView == VK_NULL_HANDLE || pickingView == VK_NULL_HANDLE) {
       continue;
     }
 
     VkDescriptorImageInfo sceneInfo{};
-    sceneInfo.sampler = m_postProcessSampler;
-    sceneInfo.imageView = m_sceneColorViews[i];
+    sceneInfo.sampler = m_sceneUpscaleSampler;
+    sceneInfo.imageView = sceneView;
     sceneInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
     VkDescriptorImageInfo pickInfo{};
     pickInfo.sampler = m_postProcessSampler;
-    pickInfo.imageView = m_pickingViews[i];
+    pickInfo.imageView = pickingView;
     pickInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
     std::array<VkWriteDescriptorSet, 2> writes{};
@@ -2887,6 +4036,101 @@ void VulkanViewport::UpdatePostProcessDescriptorSets() {
   }
 }
 
+void VulkanViewport::CreateShadowResources() {
+  VkDevice device = m_context->GetDevice();
+  VkPhysicalDevice gpu = m_context->GetPhysicalDevice();
+
+  // The cached atlas outlives the frame graphs' transients, so it is owned
+  // here and imported into every graph.
+  CreateImage(gpu, device, kStaticShadowAtlasSize, kStaticShadowAtlasSize,
+              m_shadowFormat, VK_IMAGE_TILING_OPTIMAL,
+              VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                  VK_IMAGE_USAGE_SAMPLED_BIT,
+              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_shadowAtlas,
+              m_shadowAtlasMemory);
+  m_shadowAtlasView = CreateImageView(device, m_shadowAtlas, m_shadowFormat,
+                                      VK_IMAGE_ASPECT_DEPTH_BIT);
+  m_shadowAtlasLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  for (auto &cascade : m_shadowCascades) {
+    cascade.valid = false;
+    cascade.staticDirty = true;
+  }
+
+  VkFramebufferCreateInfo atlasFb{};
+  atlasFb.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+  atlasFb.renderPass = m_shadowCacheRenderPass;
+  atlasFb.attachmentCount = 1;
+  atlasFb.pAttachments = &m_shadowAtlasView;
+  atlasFb.width = kStaticShadowAtlasSize;
+  atlasFb.height = kStaticShadowAtlasSize;
+  atlasFb.layers = 1;
+  if (vkCreateFramebuffer(device, &atlasFb, nullptr,
+                          &m_shadowAtlasFramebuffer) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create shadow atlas framebuffer");
+  }
+
+  // Depth compare sampling; outside the atlas counts as lit.
+  VkSamplerCreateInfo sampler{};
+  sampler.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+  const VkFilter filter =
+      FormatSupports(gpu, m_shadowFormat,
+                     VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+          ? VK_FILTER_LINEAR
+          : VK_FILTER_NEAREST;
+  sampler.magFilter = filter;
+  sampler.minFilter = filter;
+  sampler.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  sampler.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+  sampler.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+  sampler.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+  sampler.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+  sampler.compareEnable = VK_TRUE;
+  sampler.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+  sampler.minLod = 0.0f;
+  sampler.maxLod = 0.0f;
+  if (vkCreateSampler(device, &sampler, nullptr, &m_shadowSampler) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Failed to create shadow sampler");
+  }
+
+  for (uint32_t i = 0; i < kMaxFramesInFlight; ++i) {
+    VkImageView dynamicView =
+        m_renderGraphs[i].GetImageView(m_graphTargets.dynamicShadow);
+    VkFramebufferCreateInfo dynamicFb = atlasFb;
+    dynamicFb.renderPass = m_shadowRenderPass;
+    dynamicFb.pAttachments = &dynamicView;
+    dynamicFb.width = kDynamicShadowAtlasSize;
+    dynamicFb.height = kDynamicShadowAtlasSize;
+    if (vkCreateFramebuffer(device, &dynamicFb, nullptr,
+                            &m_dynamicShadowFramebuffers[i]) != VK_SUCCESS) {
+      throw std::runtime_error("Failed to create dynamic shadow framebuffer");
+    }
+
+    if (m_descriptorSets[i] == VK_NULL_HANDLE) {
+      continue;
+    }
+    std::array<VkDescriptorImageInfo, 2> images{};
+    images[0].sampler = m_shadowSampler;
+    images[0].imageView = m_shadowAtlasView;
+    images[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    images[1] = images[0];
+    images[1].imageView = dynamicView;
+
+    std::array<VkWriteDescriptorSet, 2> writes{};
+    for (uint32_t binding = 0; binding < writes.size(); ++binding) {
+      writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      writes[binding].dstSet = m_descriptorSets[i];
+      writes[binding].dstBinding = binding + 1;
+      writes[binding].descriptorType =
+          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+      writes[binding].descriptorCount = 1;
+      writes[binding].pImageInfo = &images[binding];
+    }
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()),
+                           writes.data(), 0, nullptr);
+  }
+}
+
 void VulkanViewport::CreateCommandPoolAndBuffers() {
   VkCommandPoolCreateInfo pool{};
   pool.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -2923,93 +4167,220 @@ void VulkanViewport::RecordCommandBuffer(
     throw std::runtime_error("vkBeginCommandBuffer failed");
   }
 
+  VkQueryPool queryPool = VK_NULL_HANDLE;
   if (m_timestampsSupported && m_queryPools[m_frameIndex] != VK_NULL_HANDLE) {
-    vkCmdResetQueryPool(cb, m_queryPools[m_frameIndex], 0, kPassCount * 2);
-  }
-
-  auto recordPass = [&](uint32_t passIndex, auto &&fn) {
-    if (m_timestampsSupported && m_queryPools[m_frameIndex] != VK_NULL_HANDLE) {
-      vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                          m_queryPools[m_frameIndex], passIndex * 2);
-    }
-    const auto cpuStart = std::chrono::steady_clock::now();
-    fn();
-    const auto cpuEnd = std::chrono::steady_clock::now();
-    m_frameStats[m_frameIndex].passes[passIndex].cpuMs =
-        std::chrono::duration<double, std::milli>(cpuEnd - cpuStart).count();
-    if (m_timestampsSupported && m_queryPools[m_frameIndex] != VK_NULL_HANDLE) {
-      vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                          m_queryPools[m_frameIndex], passIndex * 2 + 1);
-    }
-  };
-
-  recordPass(0, [&]() { RecordOpaquePass(cb, instances); });
-
-  const bool needsPicking =
-      m_pendingPick.pending || m_debugViewMode == DebugViewMode::EntityId;
-  recordPass(1, [&]() {
-    if (needsPicking) {
-      RecordPickingPass(cb, instances);
-    }
-  });
+    queryPool = m_queryPools[m_frameIndex];
+    vkCmdResetQueryPool(cb, queryPool, 0, kPassCount * 2);
+  }
+
+  RenderGraph &graph = m_renderGraphs[m_frameIndex];
+  graph.SetImportedImage(m_graphTargets.backbuffer,
+                         m_swapchainImages[imageIndex],
+                         m_swapchainImageViews[imageIndex]);
+  // The picking pass only survives when something consumes it: a pending
+  // pick (through the readback pass) or the EntityId debug view.
+  graph.SetPassEnabled(kPickingPass,
+                       m_pendingPick.pending ||
+                           m_debugViewMode == DebugViewMode::EntityId);
+  graph.SetPassEnabled(kPickReadbackPass, m_pendingPick.pending);
+  graph.SetPassEnabled(kDepthPrepassPass, m_depthPrepassEnabled);
+
+  // Static casters are only redrawn into the cached atlas for cascades that
+  // were refit or whose casters changed; moving casters are drawn every frame
+  // into the smaller per-frame atlas, and only when there are any.
+  graph.SetImportedImage(m_graphTargets.shadowAtlas, m_shadowAtlas,
+                         m_shadowAtlasView, m_shadowAtlasLayout);
+  bool staticShadowsDirty = false;
+  for (uint32_t i = 0; i < m_shadowCascadeCount; ++i) {
+    staticShadowsDirty = staticShadowsDirty || m_shadowCascades[i].staticDirty;
+  }
+  graph.SetPassEnabled(kShadowStaticPass, staticShadowsDirty);
+  graph.SetPassEnabled(kShadowDynamicPass,
+                       m_shadowCascadeCount > 0 && m_shadowHasDynamicCasters);
+
+  m_recordInstances = &instances;
+  m_recordImageIndex = imageIndex;
+  graph.Execute(cb, queryPool);
+  m_recordInstances = nullptr;
+  m_shadowAtlasLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-  recordPass(2, [&]() { RecordPostProcessPass(cb, imageIndex); });
-  recordPass(3, [&]() { RecordOverlayPass(cb); });
+  for (uint32_t i = 0; i < kPassCount; ++i) {
+    m_frameStats[m_frameIndex].passes[i].cpuMs = graph.GetPassCpuMs(i);
+  }
 
   if (vkEndCommandBuffer(cb) != VK_SUCCESS) {
     throw std::runtime_error("vkEndCommandBuffer failed");
   }
 }
 
-void VulkanViewport::RecordOpaquePass(
+void VulkanViewport::RecordDepthPrepass(
     VkCommandBuffer cb, const std::vector<DrawInstance> &instances) {
-  VkClearValue clear[2]{};
-  clear[0].color = {{0.02f, 0.02f, 0.02f, 1.0f}};
-  clear[1].depthStencil = {1.0f, 0};
+  VkClearValue clear{};
+  clear.depthStencil = {1.0f, 0};
+
+  const VkExtent2D renderExtent = GetSceneRenderExtent();
 
   VkRenderPassBeginInfo rp{};
   rp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-  rp.renderPass = m_sceneRenderPass;
-  rp.framebuffer = m_sceneFramebuffers[m_frameIndex];
+  rp.renderPass = m_depthPrepassRenderPass;
+  rp.framebuffer = m_depthPrepassFramebuffers[m_frameIndex];
   rp.renderArea.offset = {0, 0};
-  rp.renderArea.extent = m_swapchainExtent;
-  rp.clearValueCount = 2;
-  rp.pClearValues = clear;
+  rp.renderArea.extent = renderExtent;
+  rp.clearValueCount = 1;
+  rp.pClearValues = &clear;
 
   vkCmdBeginRenderPass(cb, &rp, VK_SUBPASS_CONTENTS_INLINE);
 
   VkViewport viewport{};
   viewport.x = 0.0f;
   viewport.y = 0.0f;
-  viewport.width = static_cast<float>(m_swapchainExtent.width);
-  viewport.height = static_cast<float>(m_swapchainExtent.height);
+  viewport.width = static_cast<float>(renderExtent.width);
+  viewport.height = static_cast<float>(renderExtent.height);
   viewport.minDepth = 0.0f;
   viewport.maxDepth = 1.0f;
   vkCmdSetViewport(cb, 0, 1, &viewport);
 
   VkRect2D scissor{};
   scissor.offset = {0, 0};
-  scissor.extent = m_swapchainExtent;
+  scissor.extent = renderExtent;
   vkCmdSetScissor(cb, 0, 1, &scissor);
 
-  const VkDeviceSize offsets[] = {0};
+  // Only the frame UBO is read; textures stay unbound.
   const VkDescriptorSet uboSet = m_descriptorSets[m_frameIndex];
-  VkDescriptorSet boundTextureSet = VK_NULL_HANDLE;
-  if (m_defaultTexture.descriptorSet != VK_NULL_HANDLE) {
-    VkDescriptorSet sets[] = {uboSet, m_defaultTexture.descriptorSet};
-    vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            m_pipelineLayout, 0, 2, sets, 0, nullptr);
-    boundTextureSet = m_defaultTexture.descriptorSet;
-  }
+  vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          m_pipelineLayout, 0, 1, &uboSet, 0, nullptr);
 
-  InstancePushConstants baseConstants{};
-  Mat4Identity(baseConstants.model);
-  baseConstants.color[0] = 1.0f;
-  baseConstants.color[1] = 1.0f;
-  baseConstants.color[2] = 1.0f;
-  baseConstants.color[3] = 1.0f;
+  const VkDeviceSize offsets[] = {0};
+  vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    m_depthPrepassPipeline);
+  VkPipeline boundPipeline = m_depthPrepassPipeline;
+  VkBuffer boundVertex = VK_NULL_HANDLE;
+  VkBuffer boundIndex = VK_NULL_HANDLE;
 
-  if (m_linePipeline != VK_NULL_HANDLE &&
+  // Draws exactly what RecordOpaquePass draws, with the same transforms, so
+  // its EQUAL test finds every surface.
+  if (instances.empty()) {
+    InstancePushConstants defaultQuad{};
+    Mat4Scale(defaultQuad.model, 0.8f, 0.8f, 1.0f);
+    vkCmdPushConstants(cb, m_pipelineLayout,
+                       VK_SHADER_STAGE_VERTEX_BIT |
+                           VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(InstancePushConstants), &defaultQuad);
+    vkCmdBindVertexBuffers(cb, 0, 1, &m_positionBuffer, offsets);
+    vkCmdBindIndexBuffer(cb, m_indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdDrawIndexed(cb, m_defaultIndexCount, 1, 0, 0, 0);
+  }
+
+  for (const auto &instance : instances) {
+    const GpuMesh *mesh = ResolveMesh(instance.meshId);
+    VkBuffer vertexBuffer = m_positionBuffer;
+    VkBuffer indexBuffer = m_indexBuffer;
+    uint32_t indexCount = m_defaultIndexCount;
+    VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+    bool packed = false;
+
+    if (mesh && mesh->positionBuffer != VK_NULL_HANDLE &&
+        mesh->indexBuffer != VK_NULL_HANDLE && mesh->indexCount > 0) {
+      if (mesh->packed && m_packedDepthEqualPipeline == VK_NULL_HANDLE) {
+        // The opaque pass cannot shade it yet either.
+        continue;
+      }
+      vertexBuffer = mesh->positionBuffer;
+      indexBuffer = mesh->indexBuffer;
+      indexCount = mesh->indexCount;
+      indexType = mesh->indexType;
+      packed = mesh->packed;
+    }
+
+    const VkPipeline pipeline =
+        packed ? m_packedDepthPrepassPipeline : m_depthPrepassPipeline;
+    if (pipeline != boundPipeline) {
+      vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+      boundPipeline = pipeline;
+    }
+    if (vertexBuffer != boundVertex || indexBuffer != boundIndex) {
+      vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, offsets);
+      vkCmdBindIndexBuffer(cb, indexBuffer, 0, indexType);
+      boundVertex = vertexBuffer;
+      boundIndex = indexBuffer;
+    }
+
+    InstancePushConstants constants = instance.constants;
+    if (packed) {
+      Mat4Mul(constants.model, instance.constants.model, mesh->dequantize);
+    }
+    vkCmdPushConstants(cb, m_pipelineLayout,
+                       VK_SHADER_STAGE_VERTEX_BIT |
+                           VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(InstancePushConstants), &constants);
+    vkCmdDrawIndexed(cb, indexCount, 1, 0, 0, 0);
+  }
+
+  vkCmdEndRenderPass(cb);
+}
+
+void VulkanViewport::RecordOpaquePass(
+    VkCommandBuffer cb, const std::vector<DrawInstance> &instances) {
+  VkClearValue clear[2]{};
+  clear[0].color = {{0.02f, 0.02f, 0.02f, 1.0f}};
+  clear[1].depthStencil = {1.0f, 0};
+
+  // With dynamic resolution only the top-left region of the scene target is
+  // rendered; the post-process pass upscales it.
+  const VkExtent2D renderExtent = GetSceneRenderExtent();
+
+  // After a depth pre-pass only the nearest surface passes the EQUAL test, so
+  // each pixel is shaded once.
+  const bool depthPrepass = m_depthPrepassEnabled;
+  const VkPipeline meshPipeline =
+      depthPrepass ? m_depthEqualPipeline : m_pipeline;
+  const VkPipeline packedMeshPipeline =
+      depthPrepass ? m_packedDepthEqualPipeline : m_packedPipeline;
+
+  VkRenderPassBeginInfo rp{};
+  rp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+  rp.renderPass =
+      depthPrepass ? m_sceneLoadDepthRenderPass : m_sceneRenderPass;
+  rp.framebuffer = m_sceneFramebuffers[m_frameIndex];
+  rp.renderArea.offset = {0, 0};
+  rp.renderArea.extent = renderExtent;
+  rp.clearValueCount = 2;
+  rp.pClearValues = clear;
+
+  vkCmdBeginRenderPass(cb, &rp, VK_SUBPASS_CONTENTS_INLINE);
+
+  VkViewport viewport{};
+  viewport.x = 0.0f;
+  viewport.y = 0.0f;
+  viewport.width = static_cast<float>(renderExtent.width);
+  viewport.height = static_cast<float>(renderExtent.height);
+  viewport.minDepth = 0.0f;
+  viewport.maxDepth = 1.0f;
+  vkCmdSetViewport(cb, 0, 1, &viewport);
+
+  VkRect2D scissor{};
+  scissor.offset = {0, 0};
+  scissor.extent = renderExtent;
+  vkCmdSetScissor(cb, 0, 1, &scissor);
+
+  const VkDeviceSize offsets[] = {0};
+  const VkDescriptorSet uboSet = m_descriptorSets[m_frameIndex];
+  VkDescriptorSet boundTextureSet = VK_NULL_HANDLE;
+  if (m_defaultTexture.descriptorSet != VK_NULL_HANDLE) {
+    VkDescriptorSet sets[] = {uboSet, m_defaultTexture.descriptorSet};
+    vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            m_pipelineLayout, 0, 2, sets, 0, nullptr);
+    boundTextureSet = m_defaultTexture.descriptorSet;
+  }
+
+  InstancePushConstants baseConstants{};
+  Mat4Identity(baseConstants.model);
+  baseConstants.color[0] = 1.0f;
+  baseConstants.color[1] = 1.0f;
+  baseConstants.color[2] = 1.0f;
+  baseConstants.color[3] = 1.0f;
+
+  if (m_linePipeline != VK_NULL_HANDLE &&
       m_lineVertexBuffer != VK_NULL_HANDLE && m_lineVertexCount > 0) {
     baseConstants.flags = kInstanceFlagUnlit;
     vkCmdPushConstants(cb, m_pipelineLayout,
@@ -3021,7 +4392,8 @@ void VulkanViewport::RecordOpaquePass(
     vkCmdDraw(cb, m_lineVertexCount, 1, 0, 0);
   }
 
-  vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+  vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, meshPipeline);
+  VkPipeline boundPipeline = meshPipeline;
 
   if (!instances.empty()) {
     bool hasBoundMesh = false;
@@ -3045,27 +4417,45 @@ void VulkanViewport::RecordOpaquePass(
       VkBuffer vertexBuffer = m_vertexBuffer;
       VkBuffer indexBuffer = m_indexBuffer;
       uint32_t indexCount = m_defaultIndexCount;
+      VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+      bool packed = false;
 
       if (mesh && mesh->vertexBuffer != VK_NULL_HANDLE &&
           mesh->indexBuffer != VK_NULL_HANDLE && mesh->indexCount > 0) {
+        if (mesh->packed && packedMeshPipeline == VK_NULL_HANDLE) {
+          // Packed variant is still compiling; draw it once it lands.
+          continue;
+        }
         vertexBuffer = mesh->vertexBuffer;
         indexBuffer = mesh->indexBuffer;
         indexCount = mesh->indexCount;
+        indexType = mesh->indexType;
+        packed = mesh->packed;
+      }
+
+      const VkPipeline pipeline = packed ? packedMeshPipeline : meshPipeline;
+      if (pipeline != boundPipeline) {
+        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        boundPipeline = pipeline;
       }
 
       if (!hasBoundMesh || vertexBuffer != boundVertex ||
           indexBuffer != boundIndex) {
         vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, offsets);
-        vkCmdBindIndexBuffer(cb, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdBindIndexBuffer(cb, indexBuffer, 0, indexType);
         hasBoundMesh = true;
         boundVertex = vertexBuffer;
         boundIndex = indexBuffer;
       }
 
+      InstancePushConstants constants = instance.constants;
+      if (packed) {
+        Mat4Mul(constants.model, instance.constants.model, mesh->dequantize);
+      }
       vkCmdPushConstants(cb, m_pipelineLayout,
                          VK_SHADER_STAGE_VERTEX_BIT |
                              VK_SHADER_STAGE_FRAGMENT_BIT,
-                         0, sizeof(InstancePushConstants), &instance.constants);
+                         0, sizeof(InstancePushConstants), &constants);
       vkCmdDrawIndexed(cb, indexCount, 1, 0, 0, 0);
     }
   } else {
@@ -3094,8 +4484,9 @@ void VulkanViewport::RecordOpaquePass(
     vkCmdDrawIndexed(cb, m_defaultIndexCount, 1, 0, 0, 0);
   }
 
-  if (m_overlayPipeline != VK_NULL_HANDLE &&
-      m_selectionVertexBuffer != VK_NULL_HANDLE && m_selectionVertexCount > 0) {
+  const VkBuffer dynamicBuffer = m_dynamicGeometry[m_frameIndex].buffer;
+  if (m_overlayPipeline != VK_NULL_HANDLE && dynamicBuffer != VK_NULL_HANDLE &&
+      m_selectionLines.count > 0) {
     baseConstants.flags = kInstanceFlagUnlit;
     vkCmdPushConstants(cb, m_pipelineLayout,
                        VK_SHADER_STAGE_VERTEX_BIT |
@@ -3109,34 +4500,48 @@ void VulkanViewport::RecordOpaquePass(
                               m_pipelineLayout, 0, 2, sets, 0, nullptr);
       boundTextureSet = m_defaultTexture.descriptorSet;
     }
-    vkCmdBindVertexBuffers(cb, 0, 1, &m_selectionVertexBuffer, offsets);
-    vkCmdDraw(cb, m_selectionVertexCount, 1, 0, 0);
-  }
-
-  if (m_overlayPipeline != VK_NULL_HANDLE &&
-      m_lightGizmoVertexBuffer != VK_NULL_HANDLE &&
-      m_lightGizmoVertexCount > 0) {
-    baseConstants.flags = kInstanceFlagUnlit;
-    vkCmdPushConstants(cb, m_pipelineLayout,
-                       VK_SHADER_STAGE_VERTEX_BIT |
-                           VK_SHADER_STAGE_FRAGMENT_BIT,
-                       0, sizeof(InstancePushConstants), &baseConstants);
-    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, m_overlayPipeline);
-    vkCmdBindVertexBuffers(cb, 0, 1, &m_lightGizmoVertexBuffer, offsets);
-    vkCmdDraw(cb, m_lightGizmoVertexCount, 1, 0, 0);
+    vkCmdBindVertexBuffers(cb, 0, 1, &dynamicBuffer, &m_selectionLines.offset);
+    vkCmdDraw(cb, m_selectionLines.count, 1, 0, 0);
   }
 
-  // Render collider debug wireframes
-  if (m_overlayPipeline != VK_NULL_HANDLE &&
-      m_colliderVertexBuffer != VK_NULL_HANDLE && m_colliderVertexCount > 0) {
+  if (m_overlayPipeline != VK_NULL_HANDLE && dynamicBuffer != VK_NULL_HANDLE &&
+      m_lightGizmoLines.count > 0) {
     baseConstants.flags = kInstanceFlagUnlit;
     vkCmdPushConstants(cb, m_pipelineLayout,
                        VK_SHADER_STAGE_VERTEX_BIT |
                            VK_SHADER_STAGE_FRAGMENT_BIT,
                        0, sizeof(InstancePushConstants), &baseConstants);
     vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, m_overlayPipeline);
-    vkCmdBindVertexBuffers(cb, 0, 1, &m_colliderVertexBuffer, offsets);
-    vkCmdDraw(cb, m_colliderVertexCount, 1, 0, 0);
+    vkCmdBindVertexBuffers(cb, 0, 1, &dynamicBuffer, &m_lightGizmoLines.offset);
+    vkCmdDraw(cb, m_lightGizmoLines.count, 1, 0, 0);
+  }
+
+  // Render collider debug wireframes: one instanced draw per unit template.
+  if (m_wireframePipeline != VK_NULL_HANDLE &&
+      m_wireframeTemplateBuffer != VK_NULL_HANDLE &&
+      dynamicBuffer != VK_NULL_HANDLE) {
+    bool boundWireframe = false;
+    for (uint32_t id = 0; id < kWireframeTemplateCount; ++id) {
+      const DynamicRange &range = m_colliderInstances[id];
+      const WireframeTemplate &shape = m_wireframeTemplates[id];
+      if (range.count == 0 || shape.vertexCount == 0) {
+        continue;
+      }
+      if (!boundWireframe) {
+        baseConstants.flags = kInstanceFlagUnlit;
+        vkCmdPushConstants(cb, m_pipelineLayout,
+                           VK_SHADER_STAGE_VERTEX_BIT |
+                               VK_SHADER_STAGE_FRAGMENT_BIT,
+                           0, sizeof(InstancePushConstants), &baseConstants);
+        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          m_wireframePipeline);
+        boundWireframe = true;
+      }
+      const VkBuffer buffers[] = {m_wireframeTemplateBuffer, dynamicBuffer};
+      const VkDeviceSize bufferOffsets[] = {0, range.offset};
+      vkCmdBindVertexBuffers(cb, 0, 2, buffers, bufferOffsets);
+      vkCmdDraw(cb, shape.vertexCount, range.count, shape.firstVertex, 0);
+    }
   }
 
   vkCmdEndRenderPass(cb);
@@ -3144,12 +4549,6 @@ void VulkanViewport::RecordOpaquePass(
 
 void VulkanViewport::RecordPickingPass(
     VkCommandBuffer cb, const std::vector<DrawInstance> &instances) {
-  if (instances.empty()) {
-    if (!m_pendingPick.pending && m_debugViewMode != DebugViewMode::EntityId) {
-      return;
-    }
-  }
-
   VkClearValue clear[2]{};
   clear[0].color = {{0.0f, 0.0f, 0.0f, 0.0f}};
   clear[1].depthStencil = {1.0f, 0};
@@ -3190,7 +4589,11 @@ void VulkanViewport::RecordPickingPass(
 
   VkPipeline pickPipeline =
       m_pickingFormatIsUint ? m_pickingPipelineUint : m_pickingPipeline;
+  VkPipeline packedPickPipeline = m_pickingFormatIsUint
+                                      ? m_packedPickingPipelineUint
+                                      : m_packedPickingPipeline;
   vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pickPipeline);
+  VkPipeline boundPipeline = pickPipeline;
 
   bool hasBoundMesh = false;
   VkBuffer boundVertex = VK_NULL_HANDLE;
@@ -3200,130 +4603,253 @@ void VulkanViewport::RecordPickingPass(
     VkBuffer vertexBuffer = m_vertexBuffer;
     VkBuffer indexBuffer = m_indexBuffer;
     uint32_t indexCount = m_defaultIndexCount;
+    VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+    bool packed = false;
 
     if (mesh && mesh->vertexBuffer != VK_NULL_HANDLE &&
         mesh->indexBuffer != VK_NULL_HANDLE && mesh->indexCount > 0) {
+      if (mesh->packed && packedPickPipeline == VK_NULL_HANDLE) {
+        continue;
+      }
       vertexBuffer = mesh->vertexBuffer;
       indexBuffer = mesh->indexBuffer;
       indexCount = mesh->indexCount;
+      indexType = mesh->indexType;
+      packed = mesh->packed;
+    }
+
+    const VkPipeline pipeline = packed ? packedPickPipeline : pickPipeline;
+    if (pipeline != boundPipeline) {
+      vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+      boundPipeline = pipeline;
     }
 
     if (!hasBoundMesh || vertexBuffer != boundVertex ||
         indexBuffer != boundIndex) {
       vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, offsets);
-      vkCmdBindIndexBuffer(cb, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+      vkCmdBindIndexBuffer(cb, indexBuffer, 0, indexType);
       hasBoundMesh = true;
       boundVertex = vertexBuffer;
       boundIndex = indexBuffer;
     }
 
+    InstancePushConstants constants = instance.constants;
+    if (packed) {
+      Mat4Mul(constants.model, instance.constants.model, mesh->dequantize);
+    }
     vkCmdPushConstants(cb, m_pipelineLayout,
                        VK_SHADER_STAGE_VERTEX_BIT |
                            VK_SHADER_STAGE_FRAGMENT_BIT,
-                       0, sizeof(InstancePushConstants), &instance.constants);
+                       0, sizeof(InstancePushConstants), &constants);
     vkCmdDrawIndexed(cb, indexCount, 1, 0, 0, 0);
   }
 
   vkCmdEndRenderPass(cb);
+}
+
+void VulkanViewport::RecordPickReadbackPass(VkCommandBuffer cb) {
+  if (m_pickingReadbackBuffers[m_frameIndex] == VK_NULL_HANDLE) {
+    return;
+  }
+
+  uint32_t pickX = m_pendingPick.x;
+  uint32_t pickY = m_pendingPick.y;
+  if (m_swapchainExtent.width > 0) {
+    pickX = std::min(pickX, m_swapchainExtent.width - 1);
+  }
+  if (m_swapchainExtent.height > 0) {
+    pickY = std::min(pickY, m_swapchainExtent.height - 1);
+  }
+  if (m_pickFlipY && m_swapchainExtent.height > 0) {
+    pickY = (m_swapchainExtent.height - 1) - pickY;
+  }
+
+  VkBufferImageCopy region{};
+  region.bufferOffset = 0;
+  region.bufferRowLength = 0;
+  region.bufferImageHeight = 0;
+  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  region.imageSubresource.mipLevel = 0;
+  region.imageSubresource.baseArrayLayer = 0;
+  region.imageSubresource.layerCount = 1;
+  region.imageOffset = {static_cast<int32_t>(pickX),
+                        static_cast<int32_t>(pickY), 0};
+  region.imageExtent = {1, 1, 1};
+  vkCmdCopyImageToBuffer(
+      cb, m_renderGraphs[m_frameIndex].GetImage(m_graphTargets.picking),
+      VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+      m_pickingReadbackBuffers[m_frameIndex], 1, &region);
+
+  m_pickReadbacks[m_frameIndex].inFlight = true;
+  m_pickReadbacks[m_frameIndex].x = m_pendingPick.x;
+  m_pickReadbacks[m_frameIndex].y = m_pendingPick.y;
+  m_pendingPick.pending = false;
+}
+
+void VulkanViewport::RecordShadowPass(
+    VkCommandBuffer cb, const std::vector<DrawInstance> &instances,
+    bool staticCasters) {
+  const uint32_t atlasSize =
+      staticCasters ? kStaticShadowAtlasSize : kDynamicShadowAtlasSize;
+  const uint32_t tileSize = atlasSize / kShadowAtlasTiles;
 
-  const bool needsSampling = (m_debugViewMode == DebugViewMode::EntityId);
-  const bool needsReadback = m_pendingPick.pending;
-
-  if (needsReadback || needsSampling) {
-    VkImageMemoryBarrier toTransfer{};
-    toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    toTransfer.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    toTransfer.newLayout = needsReadback
-                               ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-                               : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    toTransfer.image = m_pickingImages[m_frameIndex];
-    toTransfer.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    toTransfer.subresourceRange.baseMipLevel = 0;
-    toTransfer.subresourceRange.levelCount = 1;
-    toTransfer.subresourceRange.baseArrayLayer = 0;
-    toTransfer.subresourceRange.layerCount = 1;
-    toTransfer.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    toTransfer.dstAccessMask =
-        needsReadback ? VK_ACCESS_TRANSFER_READ_BIT : VK_ACCESS_SHADER_READ_BIT;
-
-    vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                         needsReadback ? VK_PIPELINE_STAGE_TRANSFER_BIT
-                                       : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                         0, 0, nullptr, 0, nullptr, 1, &toTransfer);
-  }
-
-  if (needsReadback &&
-      m_pickingReadbackBuffers[m_frameIndex] != VK_NULL_HANDLE) {
-    uint32_t pickX = m_pendingPick.x;
-    uint32_t pickY = m_pendingPick.y;
-    if (m_swapchainExtent.width > 0) {
-      pickX = std::min(pickX, m_swapchainExtent.width - 1);
-    }
-    if (m_swapchainExtent.height > 0) {
-      pickY = std::min(pickY, m_swapchainExtent.height - 1);
-    }
-    if (m_pickFlipY && m_swapchainExtent.height > 0) {
-      pickY = (m_swapchainExtent.height - 1) - pickY;
+  VkClearValue clear{};
+  clear.depthStencil = {1.0f, 0};
+
+  // The cached atlas is loaded so untouched cascades keep their depth.
+  VkRenderPassBeginInfo rp{};
+  rp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+  rp.renderPass = staticCasters ? m_shadowCacheRenderPass : m_shadowRenderPass;
+  rp.framebuffer = staticCasters ? m_shadowAtlasFramebuffer
+                                 : m_dynamicShadowFramebuffers[m_frameIndex];
+  rp.renderArea.offset = {0, 0};
+  rp.renderArea.extent = {atlasSize, atlasSize};
+  rp.clearValueCount = 1;
+  rp.pClearValues = &clear;
+
+  vkCmdBeginRenderPass(cb, &rp, VK_SUBPASS_CONTENTS_INLINE);
+
+  const VkDeviceSize offsets[] = {0};
+  VkPipeline boundPipeline = VK_NULL_HANDLE;
+  VkBuffer boundVertex = VK_NULL_HANDLE;
+  VkBuffer boundIndex = VK_NULL_HANDLE;
+  FrameStats &stats = m_frameStats[m_frameIndex];
+
+  for (uint32_t c = 0; c < m_shadowCascadeCount; ++c) {
+    ShadowCascade &cascade = m_shadowCascades[c];
+    if (staticCasters && !cascade.staticDirty) {
+      continue;
     }
 
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = {static_cast<int32_t>(pickX),
-                          static_cast<int32_t>(pickY), 0};
-    region.imageExtent = {1, 1, 1};
-    vkCmdCopyImageToBuffer(cb, m_pickingImages[m_frameIndex],
-                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                           m_pickingReadbackBuffers[m_frameIndex], 1, &region);
-
-    VkImageMemoryBarrier toSample{};
-    toSample.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    toSample.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    toSample.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    toSample.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    toSample.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    toSample.image = m_pickingImages[m_frameIndex];
-    toSample.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    toSample.subresourceRange.baseMipLevel = 0;
-    toSample.subresourceRange.levelCount = 1;
-    toSample.subresourceRange.baseArrayLayer = 0;
-    toSample.subresourceRange.layerCount = 1;
-    toSample.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    toSample.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr,
-                         0, nullptr, 1, &toSample);
-
-    m_pickReadbacks[m_frameIndex].inFlight = true;
-    m_pickReadbacks[m_frameIndex].x = m_pendingPick.x;
-    m_pickReadbacks[m_frameIndex].y = m_pendingPick.y;
-    m_pendingPick.pending = false;
-  } else if (needsSampling) {
-    VkImageMemoryBarrier toSample{};
-    toSample.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    toSample.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    toSample.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    toSample.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    toSample.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    toSample.image = m_pickingImages[m_frameIndex];
-    toSample.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    toSample.subresourceRange.baseMipLevel = 0;
-    toSample.subresourceRange.levelCount = 1;
-    toSample.subresourceRange.baseArrayLayer = 0;
-    toSample.subresourceRange.layerCount = 1;
-    toSample.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    toSample.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr,
-                         0, nullptr, 1, &toSample);
+    VkRect2D tile{};
+    tile.offset = {static_cast<int32_t>((c % kShadowAtlasTiles) * tileSize),
+                   static_cast<int32_t>((c / kShadowAtlasTiles) * tileSize)};
+    tile.extent = {tileSize, tileSize};
+    if (staticCasters) {
+      VkClearAttachment clearTile{};
+      clearTile.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+      clearTile.clearValue = clear;
+      VkClearRect clearRect{};
+      clearRect.rect = tile;
+      clearRect.baseArrayLayer = 0;
+      clearRect.layerCount = 1;
+      vkCmdClearAttachments(cb, 1, &clearTile, 1, &clearRect);
+    }
+
+    VkViewport viewport{};
+    viewport.x = static_cast<float>(tile.offset.x);
+    viewport.y = static_cast<float>(tile.offset.y);
+    viewport.width = static_cast<float>(tileSize);
+    viewport.height = static_cast<float>(tileSize);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(cb, 0, 1, &viewport);
+    vkCmdSetScissor(cb, 0, 1, &tile);
+
+    // The light projection is orthographic, so bounds are culled directly in
+    // its clip space.
+    const float depthRange = 2.0f * cascade.radius + kShadowCasterReach;
+    bool complete = true;
+    for (const auto &instance : instances) {
+      if (instance.isStatic != staticCasters ||
+          instance.meshId == kIconMeshId ||
+          (instance.constants.flags & kInstanceFlagUnlit) != 0) {
+        continue;
+      }
+
+      const float *model = instance.constants.model;
+      float center[3] = {0.0f, 0.0f, 0.0f};
+      float radius = 0.87f;
+      Assets::AssetRegistry::MeshBounds bounds{};
+      if (m_assetRegistry &&
+          m_assetRegistry->GetMeshBounds(instance.meshId, bounds)) {
+        center[0] = bounds.center[0];
+        center[1] = bounds.center[1];
+        center[2] = bounds.center[2];
+        radius = bounds.radius;
+      }
+      float scale = 0.0f;
+      for (int column = 0; column < 3; ++column) {
+        const float *axis = model + column * 4;
+        scale = std::max(scale, std::sqrt(axis[0] * axis[0] +
+                                          axis[1] * axis[1] +
+                                          axis[2] * axis[2]));
+      }
+      float world[3];
+      for (int i = 0; i < 3; ++i) {
+        world[i] = model[i] * center[0] + model[4 + i] * center[1] +
+                   model[8 + i] * center[2] + model[12 + i];
+      }
+      const float *lvp = cascade.lightViewProj;
+      float clip[3];
+      for (int i = 0; i < 3; ++i) {
+        clip[i] = lvp[i] * world[0] + lvp[4 + i] * world[1] +
+                  lvp[8 + i] * world[2] + lvp[12 + i];
+      }
+      const float extent = radius * scale / cascade.radius;
+      const float depthExtent = radius * scale / depthRange;
+      if (std::abs(clip[0]) - extent > 1.0f ||
+          std::abs(clip[1]) - extent > 1.0f || clip[2] + depthExtent < 0.0f ||
+          clip[2] - depthExtent > 1.0f) {
+        continue;
+      }
+
+      const GpuMesh *mesh = ResolveMesh(instance.meshId);
+      VkBuffer vertexBuffer = m_positionBuffer;
+      VkBuffer indexBuffer = m_indexBuffer;
+      uint32_t indexCount = m_defaultIndexCount;
+      VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+      bool packed = false;
+      if (mesh && mesh->positionBuffer != VK_NULL_HANDLE &&
+          mesh->indexBuffer != VK_NULL_HANDLE && mesh->indexCount > 0) {
+        vertexBuffer = mesh->positionBuffer;
+        indexBuffer = mesh->indexBuffer;
+        indexCount = mesh->indexCount;
+        indexType = mesh->indexType;
+        packed = mesh->packed;
+      } else if (!instance.meshId.empty() &&
+                 m_missingMeshes.count(instance.meshId) == 0) {
+        // Still loading; the opaque pass draws the placeholder quad, and the
+        // cached tile is redrawn once the mesh lands.
+        complete = false;
+      }
+
+      const VkPipeline pipeline =
+          packed ? m_packedShadowPipeline : m_shadowPipeline;
+      if (pipeline != boundPipeline) {
+        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        boundPipeline = pipeline;
+      }
+      if (vertexBuffer != boundVertex || indexBuffer != boundIndex) {
+        vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, offsets);
+        vkCmdBindIndexBuffer(cb, indexBuffer, 0, indexType);
+        boundVertex = vertexBuffer;
+        boundIndex = indexBuffer;
+      }
+
+      InstancePushConstants constants = instance.constants;
+      if (packed) {
+        float dequantized[16];
+        Mat4Mul(dequantized, model, mesh->dequantize);
+        Mat4Mul(constants.model, lvp, dequantized);
+      } else {
+        Mat4Mul(constants.model, lvp, model);
+      }
+      vkCmdPushConstants(cb, m_pipelineLayout,
+                         VK_SHADER_STAGE_VERTEX_BIT |
+                             VK_SHADER_STAGE_FRAGMENT_BIT,
+                         0, sizeof(InstancePushConstants), &constants);
+      vkCmdDrawIndexed(cb, indexCount, 1, 0, 0, 0);
+      ++stats.shadowCasterDraws;
+    }
+
+    if (staticCasters) {
+      cascade.staticDirty = !complete;
+      ++stats.shadowCascadesRedrawn;
+    }
   }
+
+  vkCmdEndRenderPass(cb);
 }
 
 void VulkanViewport::RecordPostProcessPass(VkCommandBuffer cb,
@@ -3389,6 +4915,7 @@ void VulkanViewport::UpdateUniformBuffer(uint32_t frameIndex,
   float eyeZ = 0.0f;
   float nearPlane = 0.1f;
   float farPlane = 100.0f;
+  ShadowCamera shadowCamera{};
   const bool useSceneCamera = view.camera.enabled;
   if (useSceneCamera) {
     nearPlane = view.camera.nearClip;
@@ -3399,10 +4926,15 @@ void VulkanViewport::UpdateUniformBuffer(uint32_t frameIndex,
       const float halfWidth = halfHeight * aspect;
       Mat4Ortho(proj, -halfWidth, halfWidth, -halfHeight, halfHeight, nearPlane,
                 farPlane);
+      shadowCamera.orthographic = true;
+      shadowCamera.halfWidth = halfWidth;
+      shadowCamera.halfHeight = halfHeight;
     } else {
       const float fovRad =
           view.camera.verticalFov * (3.14159265358979323846f / 180.0f);
       Mat4Perspective(proj, fovRad, aspect, nearPlane, farPlane);
+      shadowCamera.halfHeight = std::tan(fovRad * 0.5f);
+      shadowCamera.halfWidth = shadowCamera.halfHeight * aspect;
     }
 
     eyeX = view.camera.position[0];
@@ -3418,6 +4950,9 @@ void VulkanViewport::UpdateUniformBuffer(uint32_t frameIndex,
   } else {
     Mat4Perspective(proj, 60.0f * (3.14159265358979323846f / 180.0f), aspect,
                     nearPlane, farPlane);
+    shadowCamera.halfHeight =
+        std::tan(30.0f * (3.14159265358979323846f / 180.0f));
+    shadowCamera.halfWidth = shadowCamera.halfHeight * aspect;
 
     // Calculate camera position based on orbit parameters
     const float yawRad = m_cameraYawDeg * (3.14159265358979323846f / 180.0f);
@@ -3441,6 +4976,7 @@ void VulkanViewport::UpdateUniformBuffer(uint32_t frameIndex,
 
   FrameUniformObject ubo{};
   std::memcpy(ubo.viewProj, viewProj, sizeof(viewProj));
+  std::memcpy(m_frameViewProj, viewProj, sizeof(viewProj));
 
   RenderDirectionalLight primaryDirectional = view.directionalLight;
   if (!primaryDirectional.enabled) {
@@ -3491,6 +5027,35 @@ void VulkanViewport::UpdateUniformBuffer(uint32_t frameIndex,
   ubo.ambientColor[2] = primaryDirectional.ambientColor[2];
   ubo.ambientColor[3] = 0.0f;
 
+  // The view matrix rows are the camera basis; -z looks forward.
+  shadowCamera.eye[0] = eyeX;
+  shadowCamera.eye[1] = eyeY;
+  shadowCamera.eye[2] = eyeZ;
+  for (int i = 0; i < 3; ++i) {
+    shadowCamera.right[i] = viewMat[i * 4 + 0];
+    shadowCamera.up[i] = viewMat[i * 4 + 1];
+    shadowCamera.forward[i] = -viewMat[i * 4 + 2];
+  }
+  shadowCamera.nearPlane = nearPlane;
+  shadowCamera.farPlane = farPlane;
+  const uint32_t cascadeCount = UpdateShadowCascades(
+      shadowCamera, primaryDirectional.enabled && intensity > 0.0f, lightDir);
+  for (uint32_t i = 0; i < cascadeCount; ++i) {
+    const ShadowCascade &cascade = m_shadowCascades[i];
+    std::memcpy(ubo.shadowMatrices[i], cascade.worldToShadow,
+                sizeof(cascade.worldToShadow));
+    ubo.shadowTexelSizes[i] = 2.0f * cascade.radius /
+                              static_cast<float>(kStaticShadowAtlasSize /
+                                                 kShadowAtlasTiles);
+  }
+  ubo.shadowParams[0] = static_cast<float>(cascadeCount);
+  ubo.shadowParams[1] = 1.5f;
+  ubo.shadowParams[2] =
+      (cascadeCount > 0 && m_shadowHasDynamicCasters) ? 1.0f : 0.0f;
+  ubo.shadowParams[3] = 0.0f;
+  // Only the light the cascades were built for is shadowed.
+  bool shadowLightAssigned = cascadeCount == 0;
+
   std::vector<RenderLight> lights = view.lights;
   if (lights.empty() && primaryDirectional.enabled) {
     RenderLight fallback{};
@@ -3557,6 +5122,12 @@ void VulkanViewport::UpdateUniformBuffer(uint32_t frameIndex,
     }
     dst.spot[2] = 0.0f;
     dst.spot[3] = 0.0f;
+    if (!shadowLightAssigned && light.type == RenderLightType::Directional &&
+        dir[0] * lightDir[0] + dir[1] * lightDir[1] + dir[2] * lightDir[2] >
+            0.9999f) {
+      dst.spot[2] = 1.0f;
+      shadowLightAssigned = true;
+    }
 
     ++totalCount;
     return true;
@@ -3601,127 +5172,201 @@ void VulkanViewport::UpdateUniformBuffer(uint32_t frameIndex,
   ubo.materialParams[0] = metallic;
   ubo.materialParams[1] = roughness;
   ubo.materialParams[2] = IsSrgbFormat(m_swapchainFormat) ? 1.0f : 0.0f;
-  ubo.materialParams[3] = 0.0f;
+  // Read by the post-process pass to find the rendered region.
+  ubo.materialParams[3] = m_renderScale;
 
   std::memcpy(m_uniformMapped[frameIndex], &ubo, sizeof(ubo));
 }
 
-void VulkanViewport::UpdateSelectionBuffer(
-    const std::vector<DrawInstance> &instances, const RenderView &view) {
-  m_selectionVertexCount = 0;
-  if (view.selectedEntityId == 0 || m_selectionVertexMemory == VK_NULL_HANDLE) {
-    return;
-  }
+void VulkanViewport::UpdateShadowCasters(
+    const std::vector<DrawInstance> &instances) {
+  // FNV-1a over everything that shapes the cached atlas; any change to the
+  // static casters invalidates every cached cascade.
+  uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](const void *data, size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+  };
 
-  const Core::EntityId selectedId = view.selectedEntityId;
-  const DrawInstance *selected = nullptr;
+  bool dynamicCasters = false;
   for (const auto &instance : instances) {
-    if (instance.entityId == selectedId) {
-      selected = &instance;
-      break;
+    if (instance.meshId == kIconMeshId ||
+        (instance.constants.flags & kInstanceFlagUnlit) != 0) {
+      continue;
     }
-  }
-
-  std::array<float, 16> model{};
-  bool hasModel = false;
-  std::string meshId;
-  if (selected) {
-    std::memcpy(model.data(), selected->constants.model,
-                sizeof(selected->constants.model));
-    hasModel = true;
-    meshId = selected->meshId;
-  }
-
-  if (meshId.empty()) {
-    auto meshIt = view.meshes.find(selectedId);
-    if (meshIt != view.meshes.end() && meshIt->second) {
-      meshId = meshIt->second->GetMeshAssetId();
+    if (!instance.isStatic) {
+      dynamicCasters = true;
+      continue;
     }
+    mix(&instance.entityId, sizeof(instance.entityId));
+    mix(instance.meshId.data(), instance.meshId.size());
+    mix(instance.constants.model, sizeof(instance.constants.model));
   }
 
-  if (!hasModel) {
-    auto transformIt = view.transforms.find(selectedId);
-    if (transformIt == view.transforms.end() ||
-        transformIt->second == nullptr) {
-      return;
+  m_shadowHasDynamicCasters = dynamicCasters;
+  if (hash != m_shadowStaticHash) {
+    m_shadowStaticHash = hash;
+    for (auto &cascade : m_shadowCascades) {
+      cascade.staticDirty = true;
     }
+  }
+}
 
-    std::unordered_map<Core::EntityId, std::array<float, 16>> worldCache;
-    auto modelFor = [&](auto &&self,
-                        Core::EntityId id) -> const std::array<float, 16> & {
-      auto cached = worldCache.find(id);
-      if (cached != worldCache.end()) {
-        return cached->second;
+uint32_t VulkanViewport::UpdateShadowCascades(const ShadowCamera &camera,
+                                              bool lightEnabled,
+                                              const float lightDir[3]) {
+  m_shadowCascadeCount = 0;
+  if (!m_shadowSettings.enabled || !lightEnabled ||
+      m_shadowAtlas == VK_NULL_HANDLE) {
+    return 0;
+  }
+
+  if (Vec3Dot(lightDir, m_shadowLightDir) < 0.9999f) {
+    std::memcpy(m_shadowLightDir, lightDir, sizeof(m_shadowLightDir));
+    for (auto &cascade : m_shadowCascades) {
+      cascade.valid = false;
+    }
+  }
+
+  // Light basis as Mat4LookAt builds it, so snapped centers line up with the
+  // atlas texels.
+  const float upHint[3] = {0.0f, std::abs(lightDir[1]) > 0.99f ? 0.0f : 1.0f,
+                           std::abs(lightDir[1]) > 0.99f ? 1.0f : 0.0f};
+  float lightRight[3];
+  Vec3Cross(lightRight, lightDir, upHint);
+  Vec3Normalize(lightRight);
+  float lightUp[3];
+  Vec3Cross(lightUp, lightRight, lightDir);
+
+  const uint32_t count = m_shadowSettings.cascadeCount;
+  const float nearPlane = std::max(camera.nearPlane, 0.01f);
+  const float farPlane =
+      std::max(nearPlane + 0.01f,
+               std::min(camera.farPlane, m_shadowSettings.maxDistance));
+  // Practical split scheme: mostly logarithmic, blended with uniform so the
+  // first cascade does not get too thin.
+  constexpr float kSplitLambda = 0.75f;
+  float splitNear = nearPlane;
+  for (uint32_t i = 0; i < count; ++i) {
+    const float t = static_cast<float>(i + 1) / static_cast<float>(count);
+    const float logSplit = nearPlane * std::pow(farPlane / nearPlane, t);
+    const float uniformSplit = nearPlane + (farPlane - nearPlane) * t;
+    const float splitFar =
+        kSplitLambda * logSplit + (1.0f - kSplitLambda) * uniformSplit;
+
+    // Bounding sphere of the slice's corners; its radius only depends on the
+    // projection, so camera moves alone never change it.
+    float corners[8][3];
+    float desired[3] = {0.0f, 0.0f, 0.0f};
+    for (uint32_t corner = 0; corner < 8; ++corner) {
+      const float distance = (corner & 4u) ? splitFar : splitNear;
+      const float scale = camera.orthographic ? 1.0f : distance;
+      const float x = ((corner & 1u) ? 1.0f : -1.0f) * camera.halfWidth * scale;
+      const float y =
+          ((corner & 2u) ? 1.0f : -1.0f) * camera.halfHeight * scale;
+      for (int axis = 0; axis < 3; ++axis) {
+        corners[corner][axis] = camera.eye[axis] +
+                                camera.forward[axis] * distance +
+                                camera.right[axis] * x + camera.up[axis] * y;
+        desired[axis] += corners[corner][axis] / 8.0f;
       }
-
-      std::array<float, 16> identity{};
-      Mat4Identity(identity.data());
-      auto it = view.transforms.find(id);
-      if (it == view.transforms.end() || it->second == nullptr) {
-        return worldCache.emplace(id, identity).first->second;
+    }
+    float sliceRadius = 0.0f;
+    for (const auto &corner : corners) {
+      const float d[3] = {corner[0] - desired[0], corner[1] - desired[1],
+                          corner[2] - desired[2]};
+      sliceRadius = std::max(sliceRadius, std::sqrt(Vec3Dot(d, d)));
+    }
+    splitNear = splitFar;
+
+    ShadowCascade &cascade = m_shadowCascades[i];
+    const float offset[3] = {desired[0] - cascade.center[0],
+                             desired[1] - cascade.center[1],
+                             desired[2] - cascade.center[2]};
+    const bool keep =
+        cascade.valid &&
+        std::abs(cascade.sliceRadius - sliceRadius) <= 0.01f * sliceRadius &&
+        std::sqrt(Vec3Dot(offset, offset)) + sliceRadius <= cascade.radius;
+    if (!keep) {
+      cascade.sliceRadius = sliceRadius;
+      cascade.radius = sliceRadius * kShadowCascadeSlack;
+      // Snap to the coarser dynamic texel grid, which the static grid divides.
+      const float texel = 2.0f * cascade.radius /
+                          static_cast<float>(kDynamicShadowAtlasSize /
+                                             kShadowAtlasTiles);
+      const float x = std::floor(Vec3Dot(desired, lightRight) / texel) * texel;
+      const float y = std::floor(Vec3Dot(desired, lightUp) / texel) * texel;
+      const float z = Vec3Dot(desired, lightDir);
+      for (int axis = 0; axis < 3; ++axis) {
+        cascade.center[axis] = lightRight[axis] * x + lightUp[axis] * y +
+                               lightDir[axis] * z;
       }
 
-      const auto *transform = it->second;
-      const float radiansX =
-          transform->GetRotationXDegrees() * (3.14159265358979323846f / 180.0f);
-      const float radiansY =
-          transform->GetRotationYDegrees() * (3.14159265358979323846f / 180.0f);
-      const float radiansZ =
-          transform->GetRotationZDegrees() * (3.14159265358979323846f / 180.0f);
-
-      float t[16];
-      Mat4Translation(t, transform->GetPositionX(), transform->GetPositionY(),
-                      transform->GetPositionZ());
-
-      float rx[16];
-      float ry[16];
-      float rz[16];
-      float rzy[16];
-      float r[16];
-      Mat4RotationX(rx, radiansX);
-      Mat4RotationY(ry, radiansY);
-      Mat4RotationZ(rz, radiansZ);
-      Mat4Mul(rzy, rz, ry);
-      Mat4Mul(r, rzy, rx);
-
-      float s[16];
-      Mat4Scale(s, transform->GetScaleX(), transform->GetScaleY(),
-                transform->GetScaleZ());
-
-      float tr[16];
-      Mat4Mul(tr, t, r);
-
-      float localModel[16];
-      Mat4Mul(localModel, tr, s);
-
-      if (transform->HasParent()) {
-        const auto &parentModel = self(self, transform->GetParentId());
-        float world[16];
-        Mat4Mul(world, parentModel.data(), localModel);
-        std::array<float, 16> stored{};
-        std::memcpy(stored.data(), world, sizeof(world));
-        return worldCache.emplace(id, stored).first->second;
-      }
+      const float back = cascade.radius + kShadowCasterReach;
+      const float eye[3] = {cascade.center[0] - lightDir[0] * back,
+                            cascade.center[1] - lightDir[1] * back,
+                            cascade.center[2] - lightDir[2] * back};
+      float lightView[16];
+      Mat4LookAt(lightView, eye, cascade.center, upHint);
+      float lightProj[16];
+      Mat4Ortho(lightProj, -cascade.radius, cascade.radius, -cascade.radius,
+                cascade.radius, 0.0f, back + cascade.radius);
+      Mat4Mul(cascade.lightViewProj, lightProj, lightView);
+
+      // Clip space to this cascade's tile of the atlas; depth is unchanged.
+      float tileBias[16];
+      Mat4Identity(tileBias);
+      const float tileScale = 0.5f / static_cast<float>(kShadowAtlasTiles);
+      tileBias[0] = tileScale;
+      tileBias[5] = tileScale;
+      tileBias[12] = tileScale + static_cast<float>(i % kShadowAtlasTiles) /
+                                     static_cast<float>(kShadowAtlasTiles);
+      tileBias[13] = tileScale + static_cast<float>(i / kShadowAtlasTiles) /
+                                     static_cast<float>(kShadowAtlasTiles);
+      Mat4Mul(cascade.worldToShadow, tileBias, cascade.lightViewProj);
+
+      cascade.valid = true;
+      cascade.staticDirty = true;
+    }
+  }
+
+  m_shadowCascadeCount = count;
+  return count;
+}
 
-      std::array<float, 16> stored{};
-      std::memcpy(stored.data(), localModel, sizeof(localModel));
-      return worldCache.emplace(id, stored).first->second;
-    };
+void VulkanViewport::UpdateSelectionBuffer(
+    const std::vector<DrawInstance> &instances, const RenderView &view) {
+  m_selectionLines = {};
+  if (view.selectedEntityId == 0 ||
+      m_dynamicGeometry[m_frameIndex].buffer == VK_NULL_HANDLE) {
+    return;
+  }
 
-    const auto &world = modelFor(modelFor, selectedId);
-    std::memcpy(model.data(), world.data(), sizeof(world));
-    hasModel = true;
+  const Core::EntityId selectedId = view.selectedEntityId;
+  const DrawInstance *selected = nullptr;
+  for (const auto &instance : instances) {
+    if (instance.entityId == selectedId) {
+      selected = &instance;
+      break;
+    }
   }
 
-  if (!hasModel) {
+  if (!selected) {
     return;
   }
 
+  std::array<float, 16> model{};
+  std::memcpy(model.data(), selected->constants.model,
+              sizeof(selected->constants.model));
+  const std::string &meshId = selected->meshId;
+
   std::vector<Vertex> vertices;
-  vertices.reserve(128); // Reserved size in CreateLineBuffers
+  vertices.reserve(128);
 
   if (!meshId.empty() && m_assetRegistry) {
-    const auto *meshData = m_assetRegistry->LoadMeshData(meshId);
+    const auto meshData = m_assetRegistry->LoadMeshData(meshId);
     if (meshData) {
       // 1. Bounding Box
       const std::array<float, 3> minV = meshData->boundsMin;
@@ -3860,20 +5505,17 @@ void VulkanViewport::UpdateSelectionBuffer(
   addArrow(yDir, green);
   addArrow(zDir, blue);
 
-  void *data = nullptr;
   if (!vertices.empty()) {
-    vkMapMemory(m_context->GetDevice(), m_selectionVertexMemory, 0,
-                sizeof(Vertex) * vertices.size(), 0, &data);
-    std::memcpy(data, vertices.data(), sizeof(Vertex) * vertices.size());
-    vkUnmapMemory(m_context->GetDevice(), m_selectionVertexMemory);
-
-    m_selectionVertexCount = static_cast<uint32_t>(vertices.size());
+    m_selectionLines.offset = WriteDynamicGeometry(
+        vertices.data(), sizeof(Vertex) * vertices.size());
+    m_selectionLines.count = static_cast<uint32_t>(vertices.size());
   }
 }
 
 void VulkanViewport::UpdateLightGizmoBuffer(const RenderView &view) {
-  m_lightGizmoVertexCount = 0;
-  if (!view.showEditorIcons || m_lightGizmoVertexMemory == VK_NULL_HANDLE) {
+  m_lightGizmoLines = {};
+  if (!view.showEditorIcons ||
+      m_dynamicGeometry[m_frameIndex].buffer == VK_NULL_HANDLE) {
     return;
   }
 
@@ -4063,40 +5705,19 @@ void VulkanViewport::UpdateLightGizmoBuffer(const RenderView &view) {
     return;
   }
 
-  void *data = nullptr;
-  vkMapMemory(m_context->GetDevice(), m_lightGizmoVertexMemory, 0,
-              sizeof(Vertex) * vertices.size(), 0, &data);
-  std::memcpy(data, vertices.data(), sizeof(Vertex) * vertices.size());
-  vkUnmapMemory(m_context->GetDevice(), m_lightGizmoVertexMemory);
-
-  m_lightGizmoVertexCount = static_cast<uint32_t>(vertices.size());
+  m_lightGizmoLines.offset =
+      WriteDynamicGeometry(vertices.data(), sizeof(Vertex) * vertices.size());
+  m_lightGizmoLines.count = static_cast<uint32_t>(vertices.size());
 }
 
 void VulkanViewport::UpdateColliderBuffer(const RenderView &view) {
-  m_colliderVertexCount = 0;
-  if (!view.showColliders || m_colliderVertexMemory == VK_NULL_HANDLE) {
-    return;
-  }
-
-  if (view.colliders.empty()) {
+  m_colliderInstances = {};
+  if (!view.showColliders || view.colliders.empty() ||
+      m_dynamicGeometry[m_frameIndex].buffer == VK_NULL_HANDLE) {
     return;
   }
 
-  std::vector<Vertex> vertices;
-  vertices.reserve(view.colliders.size() * 128);
-
-  const float normal[3] = {0.0f, 1.0f, 0.0f};
-
-  auto addLine = [&](const float a[3], const float b[3], const float color[4]) {
-    vertices.push_back(Vertex{{a[0], a[1], a[2]},
-                              {normal[0], normal[1], normal[2]},
-                              {color[0], color[1], color[2], color[3]},
-                              {0.0f, 0.0f}});
-    vertices.push_back(Vertex{{b[0], b[1], b[2]},
-                              {normal[0], normal[1], normal[2]},
-                              {color[0], color[1], color[2], color[3]},
-                              {0.0f, 0.0f}});
-  };
+  std::array<std::vector<WireframeInstance>, kWireframeTemplateCount> batches;
 
   auto transformPoint = [](const float m[16], float x, float y,
                            float z) -> std::array<float, 3> {
@@ -4105,56 +5726,27 @@ void VulkanViewport::UpdateColliderBuffer(const RenderView &view) {
             m[2] * x + m[6] * y + m[10] * z + m[14]};
   };
 
-  auto addCircle = [&](const float center[3], const float right[3],
-                       const float up[3], float radius, const float color[4],
-                       int segments = 24) {
-    constexpr float kTwoPi = 6.28318530718f;
-    for (int i = 0; i < segments; ++i) {
-      float a0 = static_cast<float>(i) * kTwoPi / static_cast<float>(segments);
-      float a1 =
-          static_cast<float>(i + 1) * kTwoPi / static_cast<float>(segments);
-      float p0[3] = {center[0] + std::cos(a0) * radius * right[0] +
-                         std::sin(a0) * radius * up[0],
-                     center[1] + std::cos(a0) * radius * right[1] +
-                         std::sin(a0) * radius * up[1],
-                     center[2] + std::cos(a0) * radius * right[2] +
-                         std::sin(a0) * radius * up[2]};
-      float p1[3] = {center[0] + std::cos(a1) * radius * right[0] +
-                         std::sin(a1) * radius * up[0],
-                     center[1] + std::cos(a1) * radius * right[1] +
-                         std::sin(a1) * radius * up[1],
-                     center[2] + std::cos(a1) * radius * right[2] +
-                         std::sin(a1) * radius * up[2]};
-      addLine(p0, p1, color);
-    }
+  // Origin + scaled orthonormal basis, for shapes whose radius only follows
+  // the X scale of the collider's world matrix.
+  auto addPlaced = [&](uint32_t templateId, const std::array<float, 3> &origin,
+                       const float axes[3][3], float sx, float sy, float sz,
+                       const float color[4]) {
+    WireframeInstance instance{};
+    const float scales[3] = {sx, sy, sz};
+    for (int c = 0; c < 3; ++c) {
+      instance.model[c * 4 + 0] = axes[c][0] * scales[c];
+      instance.model[c * 4 + 1] = axes[c][1] * scales[c];
+      instance.model[c * 4 + 2] = axes[c][2] * scales[c];
+      instance.model[c * 4 + 3] = 0.0f;
+    }
+    instance.model[12] = origin[0];
+    instance.model[13] = origin[1];
+    instance.model[14] = origin[2];
+    instance.model[15] = 1.0f;
+    std::memcpy(instance.color, color, sizeof(instance.color));
+    batches[templateId].push_back(instance);
   };
 
-  auto addHalfCircle =
-      [&](const float center[3], const float right[3], const float up[3],
-          float radius, const float color[4], bool topHalf, int segments = 12) {
-        constexpr float kPi = 3.14159265359f;
-        float startAngle = topHalf ? 0.0f : kPi;
-        for (int i = 0; i < segments; ++i) {
-          float a0 = startAngle +
-                     static_cast<float>(i) * kPi / static_cast<float>(segments);
-          float a1 = startAngle + static_cast<float>(i + 1) * kPi /
-                                      static_cast<float>(segments);
-          float p0[3] = {center[0] + std::cos(a0) * radius * right[0] +
-                             std::sin(a0) * radius * up[0],
-                         center[1] + std::cos(a0) * radius * right[1] +
-                             std::sin(a0) * radius * up[1],
-                         center[2] + std::cos(a0) * radius * right[2] +
-                             std::sin(a0) * radius * up[2]};
-          float p1[3] = {center[0] + std::cos(a1) * radius * right[0] +
-                             std::sin(a1) * radius * up[0],
-                         center[1] + std::cos(a1) * radius * right[1] +
-                             std::sin(a1) * radius * up[1],
-                         center[2] + std::cos(a1) * radius * right[2] +
-                             std::sin(a1) * radius * up[2]};
-          addLine(p0, p1, color);
-        }
-      };
-
   for (const auto &collider : view.colliders) {
     // Color based on type: trigger=yellow, static=green, dynamic=cyan
     float color[4];
@@ -4181,136 +5773,75 @@ void VulkanViewport::UpdateColliderBuffer(const RenderView &view) {
     const float oz = collider.offset[2];
 
     if (collider.shapeType == 0) {
-      // Box: 12 edges
-      const float hx = collider.halfExtents[0];
-      const float hy = collider.halfExtents[1];
-      const float hz = collider.halfExtents[2];
-
-      // 8 corners in local space (with offset)
-      std::array<std::array<float, 3>, 8> corners = {{
-          {{ox - hx, oy - hy, oz - hz}},
-          {{ox + hx, oy - hy, oz - hz}},
-          {{ox + hx, oy + hy, oz - hz}},
-          {{ox - hx, oy + hy, oz - hz}},
-          {{ox - hx, oy - hy, oz + hz}},
-          {{ox + hx, oy - hy, oz + hz}},
-          {{ox + hx, oy + hy, oz + hz}},
-          {{ox - hx, oy + hy, oz + hz}},
-      }};
-
-      // Transform to world space
-      std::array<std::array<float, 3>, 8> worldCorners;
-      for (size_t i = 0; i < 8; ++i) {
-        worldCorners[i] =
-            transformPoint(m, corners[i][0], corners[i][1], corners[i][2]);
-      }
+      // Box: world * translate(offset) * scale(halfExtents) on the unit cube.
+      float offset[16];
+      float extents[16];
+      float local[16];
+      Mat4Translation(offset, ox, oy, oz);
+      Mat4Scale(extents, collider.halfExtents[0], collider.halfExtents[1],
+                collider.halfExtents[2]);
+      Mat4Mul(local, offset, extents);
+
+      WireframeInstance instance{};
+      Mat4Mul(instance.model, m, local);
+      std::memcpy(instance.color, color, sizeof(instance.color));
+      batches[kWireframeBox].push_back(instance);
+      continue;
+    }
 
-      // 12 edges
-      constexpr std::array<std::pair<int, int>, 12> edges = {{{0, 1},
-                                                              {1, 2},
-                                                              {2, 3},
-                                                              {3, 0},
-                                                              {4, 5},
-                                                              {5, 6},
-                                                              {6, 7},
-                                                              {7, 4},
-                                                              {0, 4},
-                                                              {1, 5},
-                                                              {2, 6},
-                                                              {3, 7}}};
+    if (collider.shapeType != 1 && collider.shapeType != 2) {
+      continue;
+    }
 
-      for (const auto &edge : edges) {
-        addLine(worldCorners[edge.first].data(),
-                worldCorners[edge.second].data(), color);
+    float axes[3][3];
+    const float fallback[3][3] = {
+        {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    for (int c = 0; c < 3; ++c) {
+      const float len = std::sqrt(m[c * 4 + 0] * m[c * 4 + 0] +
+                                  m[c * 4 + 1] * m[c * 4 + 1] +
+                                  m[c * 4 + 2] * m[c * 4 + 2]);
+      for (int r = 0; r < 3; ++r) {
+        axes[c][r] = len > 1e-6f ? m[c * 4 + r] / len : fallback[c][r];
       }
-    } else if (collider.shapeType == 1) {
-      // Sphere: 3 circles
-      float center[3];
-      auto c = transformPoint(m, ox, oy, oz);
-      center[0] = c[0];
-      center[1] = c[1];
-      center[2] = c[2];
-
-      // Extract scale from matrix (approximate)
-      float scaleX = std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
-      float radius = collider.radius * scaleX;
-
-      // XY circle
-      float rightXY[3] = {1.0f, 0.0f, 0.0f};
-      float upXY[3] = {0.0f, 1.0f, 0.0f};
-      addCircle(center, rightXY, upXY, radius, color);
-
-      // XZ circle
-      float rightXZ[3] = {1.0f, 0.0f, 0.0f};
-      float upXZ[3] = {0.0f, 0.0f, 1.0f};
-      addCircle(center, rightXZ, upXZ, radius, color);
-
-      // YZ circle
-      float rightYZ[3] = {0.0f, 1.0f, 0.0f};
-      float upYZ[3] = {0.0f, 0.0f, 1.0f};
-      addCircle(center, rightYZ, upYZ, radius, color);
-    } else if (collider.shapeType == 2) {
-      // Capsule: cylinder + hemispheres
-      float halfHeight = collider.height * 0.5f;
-      float radius = collider.radius;
-
-      // Top and bottom centers
-      auto topCenter = transformPoint(m, ox, oy + halfHeight, oz);
-      auto bottomCenter = transformPoint(m, ox, oy - halfHeight, oz);
-
-      // Extract scale from matrix
-      float scaleX = std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
-      float scaledRadius = radius * scaleX;
-
-      // Circles at top and bottom
-      float rightXZ[3] = {1.0f, 0.0f, 0.0f};
-      float upXZ[3] = {0.0f, 0.0f, 1.0f};
-      addCircle(topCenter.data(), rightXZ, upXZ, scaledRadius, color);
-      addCircle(bottomCenter.data(), rightXZ, upXZ, scaledRadius, color);
-
-      // Vertical lines connecting circles
-      for (int i = 0; i < 4; ++i) {
-        float angle = static_cast<float>(i) * 1.5708f;
-        float dx = std::cos(angle) * scaledRadius;
-        float dz = std::sin(angle) * scaledRadius;
-        float top[3] = {topCenter[0] + dx, topCenter[1], topCenter[2] + dz};
-        float bottom[3] = {bottomCenter[0] + dx, bottomCenter[1],
-                           bottomCenter[2] + dz};
-        addLine(top, bottom, color);
-      }
-
-      // Hemisphere arcs
-      float rightYZ[3] = {0.0f, 1.0f, 0.0f};
-      float upYZ[3] = {0.0f, 0.0f, 1.0f};
-      float rightXY[3] = {1.0f, 0.0f, 0.0f};
-      float upXY[3] = {0.0f, 1.0f, 0.0f};
-
-      addHalfCircle(topCenter.data(), rightXY, upXY, scaledRadius, color, true);
-      addHalfCircle(topCenter.data(), upXZ, upXY, scaledRadius, color, true);
-      addHalfCircle(bottomCenter.data(), rightXY, upXY, scaledRadius, color,
-                    false);
-      addHalfCircle(bottomCenter.data(), upXZ, upXY, scaledRadius, color,
-                    false);
     }
-  }
+    // Extract scale from matrix (approximate)
+    const float scaleX = std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+    const float radius = collider.radius * scaleX;
 
-  if (vertices.empty()) {
-    return;
-  }
+    if (collider.shapeType == 1) {
+      addPlaced(kWireframeSphere, transformPoint(m, ox, oy, oz), axes, radius,
+                radius, radius, color);
+      continue;
+    }
 
-  // Cap to buffer size
-  const size_t maxVerts = 256 * 128;
-  if (vertices.size() > maxVerts) {
-    vertices.resize(maxVerts);
+    // Capsule: caps at both ends of the segment plus the connecting body.
+    const float halfHeight = collider.height * 0.5f;
+    const auto top = transformPoint(m, ox, oy + halfHeight, oz);
+    const auto bottom = transformPoint(m, ox, oy - halfHeight, oz);
+    const std::array<float, 3> center = {(top[0] + bottom[0]) * 0.5f,
+                                         (top[1] + bottom[1]) * 0.5f,
+                                         (top[2] + bottom[2]) * 0.5f};
+    const float dx = top[0] - bottom[0];
+    const float dy = top[1] - bottom[1];
+    const float dz = top[2] - bottom[2];
+    const float worldHalfHeight = 0.5f * std::sqrt(dx * dx + dy * dy + dz * dz);
+
+    addPlaced(kWireframeCapsuleCap, top, axes, radius, radius, radius, color);
+    addPlaced(kWireframeCapsuleCap, bottom, axes, radius, -radius, radius,
+              color);
+    addPlaced(kWireframeCapsuleBody, center, axes, radius, worldHalfHeight,
+              radius, color);
+  }
+
+  for (uint32_t id = 0; id < kWireframeTemplateCount; ++id) {
+    const auto &batch = batches[id];
+    if (batch.empty()) {
+      continue;
+    }
+    m_colliderInstances[id].offset = WriteDynamicGeometry(
+        batch.data(), sizeof(WireframeInstance) * batch.size());
+    m_colliderInstances[id].count = static_cast<uint32_t>(batch.size());
   }
-
-  void *data = nullptr;
-  vkMapMemory(m_context->GetDevice(), m_colliderVertexMemory, 0,
-              sizeof(Vertex) * vertices.size(), 0, &data);
-  std::memcpy(data, vertices.data(), sizeof(Vertex) * vertices.size());
-  vkUnmapMemory(m_context->GetDevice(), m_colliderVertexMemory);
-
-  m_colliderVertexCount = static_cast<uint32_t>(vertices.size());
 }
 
 void VulkanViewport::SetCameraPosition(float x, float y, float z) noexcept {
@@ -4409,112 +5940,85 @@ void VulkanViewport::UpdateMetalLayerSize(int width, int height) {
 #endif
 
 std::vector<VulkanViewport::DrawInstance>
-VulkanViewport::InstancesFromView(const RenderView &view,
-                                  float timeSeconds) const {
+VulkanViewport::InstancesFromView(const RenderView &view) const {
   std::vector<DrawInstance> instances;
   instances.reserve(view.instances.size());
 
-  // Optimization: Avoid copying maps if possible by using pointers
-  const std::unordered_map<Core::EntityId, const Scene::TransformComponent *>
-      *transformLookupPtr = &view.transforms;
-  std::unordered_map<Core::EntityId, const Scene::TransformComponent *>
-      localTransformLookup;
-
-  if (view.transforms.empty()) {
-    // View didn't provide pre-built map, so build it locally
-    for (const auto &instance : view.instances) {
-      if (instance.transform) {
-        localTransformLookup.emplace(instance.entityId, instance.transform);
-      }
-    }
-    transformLookupPtr = &localTransformLookup;
-  }
-  const auto &transformLookup = *transformLookupPtr;
-
-  const std::unordered_map<Core::EntityId, const Scene::MeshRendererComponent *>
-      *meshLookupPtr = &view.meshes;
-  std::unordered_map<Core::EntityId, const Scene::MeshRendererComponent *>
-      localMeshLookup;
-
-  if (view.meshes.empty()) {
-    for (const auto &instance : view.instances) {
-      if (instance.mesh) {
-        localMeshLookup.emplace(instance.entityId, instance.mesh);
-      }
-    }
-    meshLookupPtr = &localMeshLookup;
-  }
-  const auto &meshLookup = *meshLookupPtr;
-
-  std::unordered_map<Core::EntityId, std::array<float, 16>> worldCache;
-  auto modelFor = [&](auto &&self,
-                      Core::EntityId id) -> const std::array<float, 16> & {
-    auto cached = worldCache.find(id);
-    if (cached != worldCache.end()) {
-      return cached->second;
-    }
-
-    std::array<float, 16> identity{};
-    Core::Math::Mat4Identity(identity.data());
-
-    auto it = transformLookup.find(id);
-    if (it == transformLookup.end() || it->second == nullptr) {
-      return worldCache.emplace(id, identity).first->second;
-    }
-
-    const auto *transform = it->second;
-    const auto meshIt = meshLookup.find(id);
-    const float spinDeg =
-        (meshIt != meshLookup.end() && meshIt->second)
-            ? meshIt->second->GetRotationSpeedDegPerSec() * timeSeconds
-            : 0.0f;
-
-    const float radiansX =
-        transform->GetRotationXDegrees() * Core::Math::DegToRad;
-    const float radiansY =
-        transform->GetRotationYDegrees() * Core::Math::DegToRad;
-    const float radiansZ =
-        (transform->GetRotationZDegrees() + spinDeg) * Core::Math::DegToRad;
-
-    float localModel[16];
-    Core::Math::Mat4Compose(
-        localModel, transform->GetPositionX(), transform->GetPositionY(),
-        transform->GetPositionZ(), radiansX, radiansY, radiansZ,
-        transform->GetScaleX(), transform->GetScaleY(), transform->GetScaleZ());
-
-    if (transform->HasParent()) {
-      const auto &parentModel = self(self, transform->GetParentId());
-      float world[16];
-      Core::Math::Mat4Mul(world, parentModel.data(), localModel);
-      std::array<float, 16> stored{};
-      std::memcpy(stored.data(), world, sizeof(world));
-      return worldCache.emplace(id, stored).first->second;
+  // Streaming feedback uses the same camera as UpdateUniformBuffer:
+  // `pixelScale` turns a world-space size into pixels (perspective: at unit
+  // distance).
+  const float viewportHeight =
+      static_cast<float>(std::max(1u, GetSceneRenderExtent().height));
+  float streamEye[3] = {0.0f, 0.0f, 0.0f};
+  float pixelScale = 0.0f;
+  bool orthographic = false;
+  if (view.camera.enabled) {
+    streamEye[0] = view.camera.position[0];
+    streamEye[1] = view.camera.position[1];
+    streamEye[2] = view.camera.position[2];
+    if (view.camera.projectionType == 1) {
+      orthographic = true;
+      pixelScale =
+          viewportHeight / std::max(0.01f, view.camera.orthographicSize);
+    } else {
+      const float fovRad =
+          view.camera.verticalFov * (3.14159265358979323846f / 180.0f);
+      pixelScale = viewportHeight / (2.0f * std::tan(fovRad * 0.5f));
     }
-
-    std::array<float, 16> stored{};
-    std::memcpy(stored.data(), localModel, sizeof(localModel));
-    return worldCache.emplace(id, stored).first->second;
+  } else {
+    const float yawRad = m_cameraYawDeg * (3.14159265358979323846f / 180.0f);
+    const float pitchRad =
+        m_cameraPitchDeg * (3.14159265358979323846f / 180.0f);
+    const float distance = std::max(0.01f, m_cameraDistance * m_cameraZoom);
+    streamEye[0] =
+        m_cameraX + distance * std::cos(pitchRad) * std::sin(yawRad);
+    streamEye[1] = m_cameraY + distance * std::sin(pitchRad);
+    streamEye[2] =
+        m_cameraZ + distance * std::cos(pitchRad) * std::cos(yawRad);
+    // The orbit camera uses a fixed 60 degree vertical FOV.
+    pixelScale = viewportHeight /
+                 (2.0f * std::tan(30.0f * (3.14159265358979323846f / 180.0f)));
+  }
+
+  auto projectedSize = [&](const float model[16], const std::string &meshId) {
+    float center[3] = {0.0f, 0.0f, 0.0f};
+    float radius = 1.0f;
+    Assets::AssetRegistry::MeshBounds bounds{};
+    if (m_assetRegistry && m_assetRegistry->GetMeshBounds(meshId, bounds)) {
+      center[0] = bounds.center[0];
+      center[1] = bounds.center[1];
+      center[2] = bounds.center[2];
+      radius = bounds.radius;
+    }
+
+    float scale = 0.0f;
+    for (int column = 0; column < 3; ++column) {
+      const float *axis = model + column * 4;
+      scale = std::max(scale, std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] +
+                                        axis[2] * axis[2]));
+    }
+    const float diameter = 2.0f * radius * scale;
+    if (orthographic) {
+      return diameter * pixelScale;
+    }
+
+    float offset[3];
+    for (int i = 0; i < 3; ++i) {
+      offset[i] = model[i] * center[0] + model[4 + i] * center[1] +
+                  model[8 + i] * center[2] + model[12 + i] - streamEye[i];
+    }
+    // Distance to the nearest point of the bounds; a camera inside them needs
+    // full resolution.
+    const float distance =
+        std::sqrt(offset[0] * offset[0] + offset[1] * offset[1] +
+                  offset[2] * offset[2]) -
+        radius * scale;
+    return diameter * pixelScale / std::max(distance, 0.01f);
   };
 
   auto appendInstances = [&](const std::vector<RenderInstance> &source) {
     for (const auto &instance : source) {
-      const Scene::TransformComponent *transform = instance.transform;
-      if (!transform) {
-        auto it = transformLookup.find(instance.entityId);
-        if (it != transformLookup.end()) {
-          transform = it->second;
-        }
-      }
-
-      const Scene::MeshRendererComponent *mesh = instance.mesh;
-      if (!mesh) {
-        auto it = meshLookup.find(instance.entityId);
-        if (it != meshLookup.end()) {
-          mesh = it->second;
-        }
-      }
-
-      if (!transform && !instance.hasModel) {
+      if (!instance.hasModel) {
         continue;
       }
 
@@ -4523,36 +6027,19 @@ VulkanViewport::InstancesFromView(const RenderView &view,
       draw.constants.entityId = static_cast<uint32_t>(instance.entityId);
       draw.constants.flags = 0;
 
-      if (instance.hasModel) {
-        std::memcpy(draw.constants.model, instance.model,
-                    sizeof(draw.constants.model));
-      } else {
-        const auto &model = modelFor(modelFor, instance.entityId);
-        std::memcpy(draw.constants.model, model.data(),
-                    sizeof(draw.constants.model));
-      }
-
-      if (mesh) {
-        const auto color = mesh->GetColor();
-        draw.constants.color[0] = color[0];
-        draw.constants.color[1] = color[1];
-        draw.constants.color[2] = color[2];
-        draw.constants.color[3] = 1.0f;
-      } else {
-        draw.constants.color[0] = 1.0f;
-        draw.constants.color[1] = 1.0f;
-        draw.constants.color[2] = 1.0f;
-        draw.constants.color[3] = 1.0f;
-      }
+      std::memcpy(draw.constants.model, instance.model,
+                  sizeof(draw.constants.model));
+      draw.constants.color[0] = instance.color[0];
+      draw.constants.color[1] = instance.color[1];
+      draw.constants.color[2] = instance.color[2];
+      draw.constants.color[3] = 1.0f;
 
       draw.meshId = instance.meshAssetId;
-      if (draw.meshId.empty() && mesh) {
-        draw.meshId = mesh->GetMeshAssetId();
-      }
       draw.textureId = instance.albedoTextureId;
-      if (draw.textureId.empty() && mesh) {
-        draw.textureId = mesh->GetAlbedoTextureId();
+      if (!draw.textureId.empty()) {
+        draw.screenSize = projectedSize(draw.constants.model, draw.meshId);
       }
+      draw.isStatic = instance.isStatic;
 
       instances.push_back(std::move(draw));
     }
@@ -4692,16 +6179,31 @@ VulkanViewport::ResolveMesh(const std::string &assetId) {
     return (m_iconMesh.vertexBuffer != VK_NULL_HANDLE) ? &m_iconMesh : nullptr;
   }
 
+  auto *cache = GetResourceCache();
+  if (!cache) {
+    return nullptr;
+  }
+
   auto cached = m_meshCache.find(assetId);
   if (cached != m_meshCache.end()) {
-    return &cached->second;
+    if (const auto *mesh = cache->GetMesh(cached->second)) {
+      return mesh;
+    }
+    // Invalidated through another viewport or the editor; re-resolve below.
+    m_meshCache.erase(cached);
+  }
+
+  // Another viewport may already have uploaded this mesh.
+  if (const auto shared = cache->AcquireMesh(assetId); shared.IsValid()) {
+    m_meshCache.emplace(assetId, shared);
+    return cache->GetMesh(shared);
   }
 
   if (!m_assetRegistry) {
     return nullptr;
   }
 
-  const auto *meshData = m_assetRegistry->LoadMeshData(assetId);
+  const auto meshData = m_assetRegistry->LoadMeshData(assetId);
   if (!meshData || meshData->positions.empty()) {
     if (m_missingMeshes.emplace(assetId).second && m_context) {
       m_context->Log(
@@ -4725,9 +6227,40 @@ VulkanViewport::ResolveMesh(const std::string &assetId) {
     indexSource = &generatedIndices;
   }
 
+  const size_t vertexCount = meshData->positions.size();
+  const bool packed = meshData->compressedVertices;
+
+  // Packed positions are quantized inside a cube spanning the largest bounds
+  // axis so the dequantize scale stays uniform and the shader's normal matrix
+  // does not need to know about it.
+  std::array<float, 3> quantMin{0.0f, 0.0f, 0.0f};
+  float quantExtent = 1.0f;
+  if (packed) {
+    std::array<float, 3> quantMax = meshData->positions.front();
+    quantMin = meshData->positions.front();
+    for (const auto &pos : meshData->positions) {
+      for (int axis = 0; axis < 3; ++axis) {
+        quantMin[axis] = std::min(quantMin[axis], pos[axis]);
+        quantMax[axis] = std::max(quantMax[axis], pos[axis]);
+      }
+    }
+    quantExtent =
+        std::max({quantMax[0] - quantMin[0], quantMax[1] - quantMin[1],
+                  quantMax[2] - quantMin[2]});
+    if (!(quantExtent > 0.0f)) {
+      quantExtent = 1.0f;
+    }
+  }
+
   std::vector<Vertex> vertices;
-  vertices.reserve(meshData->positions.size());
-  for (size_t i = 0; i < meshData->positions.size(); ++i) {
+  std::vector<PackedVertex> packedVertices;
+  if (packed) {
+    packedVertices.reserve(vertexCount);
+  } else {
+    vertices.reserve(vertexCount);
+  }
+  const float invQuantExtent = 1.0f / quantExtent;
+  for (size_t i = 0; i < vertexCount; ++i) {
     const auto &pos = meshData->positions[i];
     float r = 1.0f, g = 1.0f, b = 1.0f, a = 1.0f;
     if (i < meshData->colors.size()) {
@@ -4750,8 +6283,49 @@ VulkanViewport::ResolveMesh(const std::string &assetId) {
       v = meshData->uvs[i][1];
     }
 
-    vertices.push_back(
-        Vertex{{pos[0], pos[1], pos[2]}, {nx, ny, nz}, {r, g, b, a}, {u, v}});
+    if (!packed) {
+      vertices.push_back(
+          Vertex{{pos[0], pos[1], pos[2]}, {nx, ny, nz}, {r, g, b, a}, {u, v}});
+      continue;
+    }
+
+    float tx = 1.0f, ty = 0.0f, tz = 0.0f, tw = 1.0f;
+    if (i < meshData->tangents.size()) {
+      tx = meshData->tangents[i][0];
+      ty = meshData->tangents[i][1];
+      tz = meshData->tangents[i][2];
+      tw = meshData->tangents[i][3];
+    }
+
+    const auto normalOct = EncodeOctahedral(nx, ny, nz);
+    const auto tangentOct = EncodeOctahedral(tx, ty, tz);
+    PackedVertex vertex{};
+    vertex.pos[0] = QuantizeUnorm16((pos[0] - quantMin[0]) * invQuantExtent);
+    vertex.pos[1] = QuantizeUnorm16((pos[1] - quantMin[1]) * invQuantExtent);
+    vertex.pos[2] = QuantizeUnorm16((pos[2] - quantMin[2]) * invQuantExtent);
+    vertex.pos[3] = tw < 0.0f ? 0u : 65535u;
+    vertex.normalTangent[0] = QuantizeSnorm16(normalOct[0]);
+    vertex.normalTangent[1] = QuantizeSnorm16(normalOct[1]);
+    vertex.normalTangent[2] = QuantizeSnorm16(tangentOct[0]);
+    vertex.normalTangent[3] = QuantizeSnorm16(tangentOct[1]);
+    vertex.color[0] = QuantizeUnorm8(r);
+    vertex.color[1] = QuantizeUnorm8(g);
+    vertex.color[2] = QuantizeUnorm8(b);
+    vertex.color[3] = QuantizeUnorm8(a);
+    vertex.uv[0] = FloatToHalf(u);
+    vertex.uv[1] = FloatToHalf(v);
+    packedVertices.push_back(vertex);
+  }
+
+  // Every index fits in 16 bits when the vertex count does.
+  std::vector<uint16_t> shortIndices;
+  const bool useShortIndices =
+      vertexCount <= std::numeric_limits<uint16_t>::max();
+  if (useShortIndices) {
+    shortIndices.reserve(indexSource->size());
+    for (uint32_t index : *indexSource) {
+      shortIndices.push_back(static_cast<uint16_t>(index));
+    }
   }
 
   VkDevice device = m_context->GetDevice();
@@ -4763,9 +6337,20 @@ VulkanViewport::ResolveMesh(const std::string &assetId) {
   VkBuffer stagingIndexBuffer = VK_NULL_HANDLE;
   VkDeviceMemory stagingIndexMemory = VK_NULL_HANDLE;
   try {
-    const VkDeviceSize vertexSize = sizeof(Vertex) * vertices.size();
+    const void *vertexSource =
+        packed ? static_cast<const void *>(packedVertices.data())
+               : static_cast<const void *>(vertices.data());
+    const VkDeviceSize vertexSize =
+        static_cast<VkDeviceSize>(packed ? sizeof(PackedVertex)
+                                         : sizeof(Vertex)) *
+        static_cast<VkDeviceSize>(vertexCount);
+    const void *indexData =
+        useShortIndices ? static_cast<const void *>(shortIndices.data())
+                        : static_cast<const void *>(indexSource->data());
     const VkDeviceSize indexSize =
-        sizeof(std::uint32_t) * static_cast<VkDeviceSize>(indexSource->size());
+        static_cast<VkDeviceSize>(useShortIndices ? sizeof(std::uint16_t)
+                                                  : sizeof(std::uint32_t)) *
+        static_cast<VkDeviceSize>(indexSource->size());
 
     CreateBuffer(gpu, device, vertexSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
@@ -4774,7 +6359,7 @@ VulkanViewport::ResolveMesh(const std::string &assetId) {
 
     void *vData = nullptr;
     vkMapMemory(device, stagingVertexMemory, 0, vertexSize, 0, &vData);
-    std::memcpy(vData, vertices.data(), static_cast<size_t>(vertexSize));
+    std::memcpy(vData, vertexSource, static_cast<size_t>(vertexSize));
     vkUnmapMemory(device, stagingVertexMemory);
 
     CreateBuffer(gpu, device, vertexSize,
@@ -4796,7 +6381,7 @@ VulkanViewport::ResolveMesh(const std::string &assetId) {
 
     void *iData = nullptr;
     vkMapMemory(device, stagingIndexMemory, 0, indexSize, 0, &iData);
-    std::memcpy(iData, indexSource->data(), static_cast<size_t>(indexSize));
+    std::memcpy(iData, indexData, static_cast<size_t>(indexSize));
     vkUnmapMemory(device, stagingIndexMemory);
 
     CreateBuffer(gpu, device, indexSize,
@@ -4811,7 +6396,33 @@ VulkanViewport::ResolveMesh(const std::string &assetId) {
     stagingIndexBuffer = VK_NULL_HANDLE;
     stagingIndexMemory = VK_NULL_HANDLE;
 
+    // Position-only stream for the depth pre-pass and shadow passes.
+    if (packed) {
+      std::vector<std::array<uint16_t, 4>> packedPositions(vertexCount);
+      for (size_t i = 0; i < vertexCount; ++i) {
+        std::memcpy(packedPositions[i].data(), packedVertices[i].pos,
+                    sizeof(PackedVertex::pos));
+      }
+      UploadVertexStream(packedPositions.data(),
+                         sizeof(PackedVertex::pos) * vertexCount,
+                         mesh.positionBuffer, mesh.positionMemory);
+    } else {
+      UploadVertexStream(meshData->positions.data(),
+                         sizeof(Vertex::pos) * vertexCount,
+                         mesh.positionBuffer, mesh.positionMemory);
+    }
+
     mesh.indexCount = static_cast<uint32_t>(indexSource->size());
+    mesh.indexType =
+        useShortIndices ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    mesh.packed = packed;
+    if (packed) {
+      float translation[16];
+      float scale[16];
+      Mat4Translation(translation, quantMin[0], quantMin[1], quantMin[2]);
+      Mat4Scale(scale, quantExtent, quantExtent, quantExtent);
+      Mat4Mul(mesh.dequantize, translation, scale);
+    }
   } catch (const std::exception &ex) {
     if (stagingVertexBuffer != VK_NULL_HANDLE) {
       vkDestroyBuffer(device, stagingVertexBuffer, nullptr);
@@ -4837,6 +6448,12 @@ VulkanViewport::ResolveMesh(const std::string &assetId) {
     if (mesh.indexMemory != VK_NULL_HANDLE) {
       vkFreeMemory(device, mesh.indexMemory, nullptr);
     }
+    if (mesh.positionBuffer != VK_NULL_HANDLE) {
+      vkDestroyBuffer(device, mesh.positionBuffer, nullptr);
+    }
+    if (mesh.positionMemory != VK_NULL_HANDLE) {
+      vkFreeMemory(device, mesh.positionMemory, nullptr);
+    }
 
     if (m_context) {
       m_context->Log(LogSeverity::Error,
@@ -4845,16 +6462,15 @@ VulkanViewport::ResolveMesh(const std::string &assetId) {
     return nullptr;
   }
 
-  auto [it, inserted] = m_meshCache.emplace(assetId, std::move(mesh));
-  if (!inserted) {
-    it->second = std::move(mesh);
-  }
-  return &it->second;
+  const auto handle = cache->InsertMesh(assetId, mesh);
+  m_meshCache[assetId] = handle;
+  return cache->GetMesh(handle);
 }
 
 void VulkanViewport::TransitionImageLayout(VkImage image, VkFormat format,
                                            VkImageLayout oldLayout,
-                                           VkImageLayout newLayout) {
+                                           VkImageLayout newLayout,
+                                           uint32_t mipLevels) {
   if (m_commandPool == VK_NULL_HANDLE) {
     throw std::runtime_error(
         "VulkanViewport: command pool missing for texture upload");
@@ -4894,7 +6510,7 @@ void VulkanViewport::TransitionImageLayout(VkImage image, VkFormat format,
   }
   barrier.subresourceRange.aspectMask = aspectMask;
   barrier.subresourceRange.baseMipLevel = 0;
-  barrier.subresourceRange.levelCount = 1;
+  barrier.subresourceRange.levelCount = mipLevels;
   barrier.subresourceRange.baseArrayLayer = 0;
   barrier.subresourceRange.layerCount = 1;
 
@@ -4940,8 +6556,11 @@ void VulkanViewport::TransitionImageLayout(VkImage image, VkFormat format,
   submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
   submit.commandBufferCount = 1;
   submit.pCommandBuffers = &cmd;
-  vkQueueSubmit(m_context->GetGraphicsQueue(), 1, &submit, VK_NULL_HANDLE);
-  vkQueueWaitIdle(m_context->GetGraphicsQueue());
+  {
+    std::lock_guard<std::mutex> lock(m_context->GetQueueMutex());
+    vkQueueSubmit(m_context->GetGraphicsQueue(), 1, &submit, VK_NULL_HANDLE);
+    vkQueueWaitIdle(m_context->GetGraphicsQueue());
+  }
 
   vkFreeCommandBuffers(m_context->GetDevice(), m_commandPool, 1, &cmd);
 }
@@ -4982,19 +6601,77 @@ void VulkanViewport::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer,
   submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
   submit.commandBufferCount = 1;
   submit.pCommandBuffers = &cmd;
-  vkQueueSubmit(m_context->GetGraphicsQueue(), 1, &submit, VK_NULL_HANDLE);
-  vkQueueWaitIdle(m_context->GetGraphicsQueue());
+  {
+    std::lock_guard<std::mutex> lock(m_context->GetQueueMutex());
+    vkQueueSubmit(m_context->GetGraphicsQueue(), 1, &submit, VK_NULL_HANDLE);
+    vkQueueWaitIdle(m_context->GetGraphicsQueue());
+  }
 
   vkFreeCommandBuffers(m_context->GetDevice(), m_commandPool, 1, &cmd);
 }
 
-void VulkanViewport::CopyBufferToImage(VkBuffer buffer, VkImage image,
-                                       uint32_t width, uint32_t height) {
-  if (m_commandPool == VK_NULL_HANDLE) {
-    throw std::runtime_error(
-        "VulkanViewport: command pool missing for texture copy");
+void VulkanViewport::UploadVertexStream(const void *data, VkDeviceSize size,
+                                        VkBuffer &buffer,
+                                        VkDeviceMemory &memory) {
+  VkDevice device = m_context->GetDevice();
+  VkPhysicalDevice gpu = m_context->GetPhysicalDevice();
+
+  VkBuffer staging = VK_NULL_HANDLE;
+  VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+  try {
+    CreateBuffer(gpu, device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                     VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                 staging, stagingMemory);
+
+    void *mapped = nullptr;
+    vkMapMemory(device, stagingMemory, 0, size, 0, &mapped);
+    std::memcpy(mapped, data, static_cast<size_t>(size));
+    vkUnmapMemory(device, stagingMemory);
+
+    CreateBuffer(
+        gpu, device, size,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, memory);
+    CopyBuffer(staging, buffer, size);
+  } catch (...) {
+    if (staging != VK_NULL_HANDLE) {
+      vkDestroyBuffer(device, staging, nullptr);
+    }
+    if (stagingMemory != VK_NULL_HANDLE) {
+      vkFreeMemory(device, stagingMemory, nullptr);
+    }
+    throw;
+  }
+  vkDestroyBuffer(device, staging, nullptr);
+  vkFreeMemory(device, stagingMemory, nullptr);
+}
+
+bool VulkanViewport::ReadbackLastFrame(std::vector<uint8_t> &rgba,
+                                       uint32_t &width, uint32_t &height) {
+  if (!m_headless || !m_ready || m_commandPool == VK_NULL_HANDLE ||
+      m_lastImageIndex >= m_swapchainImages.size()) {
+    return false;
+  }
+
+  VkDevice device = m_context->GetDevice();
+  VkPhysicalDevice gpu = m_context->GetPhysicalDevice();
+  {
+    std::lock_guard<std::mutex> lock(m_context->GetQueueMutex());
+    vkDeviceWaitIdle(device);
   }
 
+  width = m_swapchainExtent.width;
+  height = m_swapchainExtent.height;
+  const VkDeviceSize size = static_cast<VkDeviceSize>(width) * height * 4;
+
+  VkBuffer staging = VK_NULL_HANDLE;
+  VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+  CreateBuffer(gpu, device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+               staging, stagingMemory);
+
   VkCommandBufferAllocateInfo alloc{};
   alloc.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
   alloc.commandPool = m_commandPool;
@@ -5002,9 +6679,10 @@ void VulkanViewport::CopyBufferToImage(VkBuffer buffer, VkImage image,
   alloc.commandBufferCount = 1;
 
   VkCommandBuffer cmd = VK_NULL_HANDLE;
-  if (vkAllocateCommandBuffers(m_context->GetDevice(), &alloc, &cmd) !=
-      VK_SUCCESS) {
-    throw std::runtime_error("Failed to allocate texture copy command buffer");
+  if (vkAllocateCommandBuffers(device, &alloc, &cmd) != VK_SUCCESS) {
+    vkDestroyBuffer(device, staging, nullptr);
+    vkFreeMemory(device, stagingMemory, nullptr);
+    throw std::runtime_error("Failed to allocate readback command buffer");
   }
 
   VkCommandBufferBeginInfo begin{};
@@ -5012,6 +6690,48 @@ void VulkanViewport::CopyBufferToImage(VkBuffer buffer, VkImage image,
   begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
   vkBeginCommandBuffer(cmd, &begin);
 
+  VkBufferImageCopy region{};
+  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  region.imageSubresource.mipLevel = 0;
+  region.imageSubresource.baseArrayLayer = 0;
+  region.imageSubresource.layerCount = 1;
+  region.imageOffset = {0, 0, 0};
+  region.imageExtent = {width, height, 1};
+  vkCmdCopyImageToBuffer(cmd, m_swapchainImages[m_lastImageIndex],
+                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging, 1,
+                         &region);
+
+  vkEndCommandBuffer(cmd);
+
+  VkSubmitInfo submit{};
+  submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submit.commandBufferCount = 1;
+  submit.pCommandBuffers = &cmd;
+  {
+    std::lock_guard<std::mutex> lock(m_context->GetQueueMutex());
+    vkQueueSubmit(m_context->GetGraphicsQueue(), 1, &submit, VK_NULL_HANDLE);
+    vkQueueWaitIdle(m_context->GetGraphicsQueue());
+  }
+
+  vkFreeCommandBuffers(device, m_commandPool, 1, &cmd);
+
+  rgba.resize(static_cast<size_t>(size));
+  void *mapped = nullptr;
+  const bool ok = vkMapMemory(device, stagingMemory, 0, size, 0, &mapped) ==
+                      VK_SUCCESS &&
+                  mapped;
+  if (ok) {
+    std::memcpy(rgba.data(), mapped, static_cast<size_t>(size));
+    vkUnmapMemory(device, stagingMemory);
+  }
+
+  vkDestroyBuffer(device, staging, nullptr);
+  vkFreeMemory(device, stagingMemory, nullptr);
+  return ok;
+}
+
+void VulkanViewport::CopyBufferToImage(VkBuffer buffer, VkImage image,
+                                       uint32_t width, uint32_t height) {
   VkBufferImageCopy region{};
   region.bufferOffset = 0;
   region.bufferRowLength = 0;
@@ -5022,8 +6742,37 @@ void VulkanViewport::CopyBufferToImage(VkBuffer buffer, VkImage image,
   region.imageSubresource.layerCount = 1;
   region.imageOffset = {0, 0, 0};
   region.imageExtent = {width, height, 1};
+  CopyBufferToImage(buffer, image, std::vector<VkBufferImageCopy>{region});
+}
+
+void VulkanViewport::CopyBufferToImage(
+    VkBuffer buffer, VkImage image,
+    const std::vector<VkBufferImageCopy> &regions) {
+  if (m_commandPool == VK_NULL_HANDLE) {
+    throw std::runtime_error(
+        "VulkanViewport: command pool missing for texture copy");
+  }
+
+  VkCommandBufferAllocateInfo alloc{};
+  alloc.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  alloc.commandPool = m_commandPool;
+  alloc.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  alloc.commandBufferCount = 1;
+
+  VkCommandBuffer cmd = VK_NULL_HANDLE;
+  if (vkAllocateCommandBuffers(m_context->GetDevice(), &alloc, &cmd) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Failed to allocate texture copy command buffer");
+  }
+
+  VkCommandBufferBeginInfo begin{};
+  begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(cmd, &begin);
+
   vkCmdCopyBufferToImage(cmd, buffer, image,
-                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         static_cast<uint32_t>(regions.size()), regions.data());
 
   vkEndCommandBuffer(cmd);
 
@@ -5031,8 +6780,11 @@ void VulkanViewport::CopyBufferToImage(VkBuffer buffer, VkImage image,
   submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
   submit.commandBufferCount = 1;
   submit.pCommandBuffers = &cmd;
-  vkQueueSubmit(m_context->GetGraphicsQueue(), 1, &submit, VK_NULL_HANDLE);
-  vkQueueWaitIdle(m_context->GetGraphicsQueue());
+  {
+    std::lock_guard<std::mutex> lock(m_context->GetQueueMutex());
+    vkQueueSubmit(m_context->GetGraphicsQueue(), 1, &submit, VK_NULL_HANDLE);
+    vkQueueWaitIdle(m_context->GetGraphicsQueue());
+  }
 
   vkFreeCommandBuffers(m_context->GetDevice(), m_commandPool, 1, &cmd);
 }
@@ -5080,6 +6832,89 @@ VulkanViewport::CreateTextureFromPixels(const unsigned char *pixels,
 
   texture.view =
       CreateImageView(device, texture.image, format, VK_IMAGE_ASPECT_COLOR_BIT);
+  return texture;
+}
+
+VulkanViewport::GpuTexture
+VulkanViewport::CreateTextureFromCooked(const Assets::CookedTexture &cooked) {
+  VkDevice device = m_context->GetDevice();
+  VkPhysicalDevice gpu = m_context->GetPhysicalDevice();
+
+  const VkFormat format = ToVkFormat(cooked);
+  if (!FormatSupports(gpu, format,
+                      VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+                          VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
+    throw std::runtime_error("texture format not supported by the device");
+  }
+
+  const VkDeviceSize dataSize = static_cast<VkDeviceSize>(cooked.data.size());
+  VkBuffer stagingBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+  CreateBuffer(gpu, device, dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+               stagingBuffer, stagingMemory);
+
+  void *data = nullptr;
+  vkMapMemory(device, stagingMemory, 0, dataSize, 0, &data);
+  std::memcpy(data, cooked.data.data(), cooked.data.size());
+  vkUnmapMemory(device, stagingMemory);
+
+  const auto mipLevels = static_cast<uint32_t>(cooked.mips.size());
+  std::vector<VkBufferImageCopy> regions;
+  regions.reserve(cooked.mips.size());
+  for (uint32_t level = 0; level < mipLevels; ++level) {
+    const auto &mip = cooked.mips[level];
+    VkBufferImageCopy region{};
+    region.bufferOffset = static_cast<VkDeviceSize>(mip.offset);
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = level;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = {mip.width, mip.height, 1};
+    regions.push_back(region);
+  }
+
+  // `cooked` may start below level 0 when streaming; the image only holds the
+  // loaded levels while width/height keep describing the full chain.
+  GpuTexture texture{};
+  texture.width = cooked.width;
+  texture.height = cooked.height;
+  texture.mipLevels = mipLevels;
+  texture.baseMip = cooked.baseMip;
+  try {
+    CreateImage(gpu, device, cooked.mips[0].width, cooked.mips[0].height,
+                format, VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, texture.image,
+                texture.memory, mipLevels);
+    TransitionImageLayout(texture.image, format, VK_IMAGE_LAYOUT_UNDEFINED,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+    CopyBufferToImage(stagingBuffer, texture.image, regions);
+    TransitionImageLayout(texture.image, format,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels);
+    texture.view = CreateImageView(device, texture.image, format,
+                                   VK_IMAGE_ASPECT_COLOR_BIT, mipLevels);
+  } catch (...) {
+    vkDestroyBuffer(device, stagingBuffer, nullptr);
+    vkFreeMemory(device, stagingMemory, nullptr);
+    if (texture.image != VK_NULL_HANDLE) {
+      vkDestroyImage(device, texture.image, nullptr);
+    }
+    if (texture.memory != VK_NULL_HANDLE) {
+      vkFreeMemory(device, texture.memory, nullptr);
+    }
+    throw;
+  }
+
+  vkDestroyBuffer(device, stagingBuffer, nullptr);
+  vkFreeMemory(device, stagingMemory, nullptr);
+  return texture;
+}
+
+void VulkanViewport::AllocateTextureDescriptorSet(GpuTexture &texture) {
+  VkDevice device = m_context->GetDevice();
   texture.sampler = m_textureSampler;
 
   if (m_textureDescriptorPools.empty() ||
@@ -5125,8 +6960,44 @@ VulkanViewport::CreateTextureFromPixels(const unsigned char *pixels,
   write.pImageInfo = &imageInfo;
 
   vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
 
-  return texture;
+void VulkanViewport::FreeTextureDescriptorSet(GpuTexture &texture,
+                                              bool deferred) {
+  VkDevice device = (m_context && m_context->IsInitialized())
+                        ? m_context->GetDevice()
+                        : VK_NULL_HANDLE;
+  VkDescriptorSet descriptorSet = texture.descriptorSet;
+  VkDescriptorPool descriptorPool = texture.descriptorPool;
+  if (device != VK_NULL_HANDLE && descriptorSet != VK_NULL_HANDLE &&
+      descriptorPool != VK_NULL_HANDLE) {
+    auto freeSet = [device, descriptorSet, descriptorPool]() {
+      vkFreeDescriptorSets(device, descriptorPool, 1, &descriptorSet);
+    };
+    // The set may still be bound by one of our frames in flight.
+    if (deferred) {
+      EnqueueDeletion(freeSet);
+    } else {
+      freeSet();
+    }
+  }
+  texture.descriptorSet = VK_NULL_HANDLE;
+  texture.descriptorPool = VK_NULL_HANDLE;
+}
+
+void VulkanViewport::ReleaseTexture(GpuTexture &texture, bool deferred) {
+  FreeTextureDescriptorSet(texture, deferred);
+  if (auto *cache = GetResourceCache()) {
+    cache->ReleaseTexture(texture.handle);
+  }
+  texture = {};
+}
+
+GpuResourceCache *VulkanViewport::GetResourceCache() const {
+  if (!m_context || !m_context->IsInitialized()) {
+    return nullptr;
+  }
+  return m_context->GetResourceCache().get();
 }
 
 const VulkanViewport::GpuTexture *
@@ -5139,25 +7010,82 @@ VulkanViewport::ResolveTexture(const std::string &assetId) {
     return &m_defaultTexture;
   }
 
+  auto *cache = GetResourceCache();
+  if (!cache) {
+    return &m_defaultTexture;
+  }
+
   auto cached = m_textureCache.find(assetId);
   if (cached != m_textureCache.end()) {
-    return &cached->second;
+    const auto *image = cache->GetTexture(cached->second.handle);
+    if (image && image->view == cached->second.view) {
+      return &cached->second;
+    }
+    if (image) {
+      // Streaming swapped in a different mip range under the same handle;
+      // the old set may still be bound by a frame in flight.
+      const auto handle = cached->second.handle;
+      FreeTextureDescriptorSet(cached->second, true);
+      m_textureCache.erase(cached);
+      return BindSharedTexture(assetId, handle);
+    }
+    ReleaseTexture(cached->second, true);
+    m_textureCache.erase(cached);
   }
 
-  if (!m_assetRegistry) {
+  // Reuse an image another viewport already uploaded; only the descriptor set
+  // is per viewport.
+  if (const auto shared = cache->AcquireTexture(assetId); shared.IsValid()) {
+    return BindSharedTexture(assetId, shared);
+  }
+
+  // Streamed textures start with their small mips only and are refined by
+  // UpdateTextureStreaming() once their on-screen size is known.
+  const auto streaming = cache->GetTextureStreamingSettings();
+  Assets::TextureMipRange range{};
+  if (streaming.enabled) {
+    range.maxSize = streaming.residentFloorSize;
+  }
+  Assets::CookedTexture cooked{};
+  if (!LoadCookedTexture(assetId, range, cooked)) {
     return &m_defaultTexture;
   }
 
+  GpuTexture texture{};
+  try {
+    texture = CreateTextureFromCooked(cooked);
+  } catch (const std::exception &ex) {
+    if (m_context) {
+      m_context->Log(LogSeverity::Error,
+                     std::string("Texture upload failed: ") + ex.what());
+    }
+    return &m_defaultTexture;
+  }
+
+  return BindSharedTexture(
+      assetId, cache->InsertTexture(assetId, ToSharedImage(texture),
+                                    streaming.enabled
+                                        ? MipLevelBytes(cooked)
+                                        : std::vector<VkDeviceSize>{}));
+}
+
+bool VulkanViewport::LoadCookedTexture(const std::string &assetId,
+                                       const Assets::TextureMipRange &range,
+                                       Assets::CookedTexture &cooked) {
+  if (!m_assetRegistry) {
+    return false;
+  }
+
+  // Runs on the render thread, so read the published snapshot rather than
+  // the registry's live entries.
+  const auto snapshot = m_assetRegistry->GetSnapshot();
   std::filesystem::path sourcePath;
-  if (const auto *entry = m_assetRegistry->FindEntry(assetId)) {
+  if (const auto *entry = snapshot->Find(assetId)) {
     sourcePath = entry->path;
   } else {
     sourcePath = std::filesystem::path(assetId);
-    if (!sourcePath.is_absolute()) {
-      const auto root = m_assetRegistry->GetRootPath();
-      if (!root.empty()) {
-        sourcePath = root / sourcePath;
-      }
+    if (!sourcePath.is_absolute() && !snapshot->rootPath.empty()) {
+      sourcePath = snapshot->rootPath / sourcePath;
     }
   }
 
@@ -5168,43 +7096,138 @@ VulkanViewport::ResolveTexture(const std::string &assetId) {
                      "VulkanViewport: texture asset not found '" + assetId +
                          "'");
     }
-    return &m_defaultTexture;
+    return false;
   }
 
-  int width = 0;
-  int height = 0;
-  int channels = 0;
-  stbi_uc *pixels = stbi_load(sourcePath.string().c_str(), &width, &height,
-                              &channels, STBI_rgb_alpha);
-  if (!pixels || width <= 0 || height <= 0) {
+  // Cooked containers carry the full mip chain, block-compressed when the
+  // device samples BCn, so warm loads skip image decode entirely.
+  Assets::TextureCookSettings cookSettings{};
+  cookSettings.compression = m_context->IsTextureCompressionBCEnabled()
+                                 ? Assets::TextureCompression::Auto
+                                 : Assets::TextureCompression::None;
+  std::string cookError;
+  if (!Assets::LoadOrCookTexture(sourcePath,
+                                 *m_assetRegistry->GetDerivedDataCache(),
+                                 cookSettings, cooked, &cookError, range)) {
     if (m_missingTextures.emplace(assetId).second && m_context) {
       m_context->Log(LogSeverity::Warning,
                      "VulkanViewport: failed to load texture '" + assetId +
-                         "'");
+                         "' (" + cookError + ")");
     }
-    if (pixels) {
-      stbi_image_free(pixels);
+    return false;
+  }
+  return true;
+}
+
+void VulkanViewport::UpdateTextureStreaming(
+    const std::vector<DrawInstance> &instances) {
+  auto *cache = GetResourceCache();
+  if (!cache || !cache->GetTextureStreamingSettings().enabled) {
+    return;
+  }
+
+  // The finest level any instance needs: one texel per pixel of its
+  // projected size.
+  std::unordered_map<const GpuTexture *, uint32_t> requests;
+  for (const auto &instance : instances) {
+    if (instance.textureId.empty()) {
+      continue;
+    }
+    const GpuTexture *texture = ResolveTexture(instance.textureId);
+    if (!texture || !texture->handle.IsValid()) {
+      continue;
     }
+    const float texels =
+        static_cast<float>(std::max(texture->width, texture->height));
+    const float pixels = std::max(instance.screenSize, 1.0f);
+    const uint32_t mip =
+        texels > pixels
+            ? static_cast<uint32_t>(std::floor(std::log2(texels / pixels)))
+            : 0u;
+    auto [it, inserted] = requests.emplace(texture, mip);
+    if (!inserted) {
+      it->second = std::min(it->second, mip);
+    }
+  }
+  for (const auto &[texture, mip] : requests) {
+    cache->RequestTextureMip(texture->handle, mip);
+  }
+
+  for (const auto &work : cache->TakeStreamingWork()) {
+    StreamTexture(work);
+  }
+}
+
+void VulkanViewport::StreamTexture(
+    const GpuResourceCache::StreamingWork &work) {
+  auto *cache = GetResourceCache();
+  Assets::TextureMipRange range{};
+  range.firstMip = work.targetMip;
+  Assets::CookedTexture cooked{};
+  if (!cache || !LoadCookedTexture(work.assetId, range, cooked)) {
+    return;
+  }
+
+  GpuTexture texture{};
+  try {
+    texture = CreateTextureFromCooked(cooked);
+  } catch (const std::exception &ex) {
+    if (m_context) {
+      m_context->Log(LogSeverity::Error,
+                     std::string("Texture streaming failed: ") + ex.what());
+    }
+    return;
+  }
+
+  // Every viewport holding this texture picks up the new view in
+  // ResolveTexture() and rebuilds its descriptor set.
+  cache->ReplaceTexture(work.assetId, ToSharedImage(texture));
+}
+
+GpuTextureImage VulkanViewport::ToSharedImage(const GpuTexture &texture) {
+  GpuTextureImage image{};
+  image.image = texture.image;
+  image.memory = texture.memory;
+  image.view = texture.view;
+  image.width = texture.width;
+  image.height = texture.height;
+  image.mipLevels = texture.mipLevels;
+  image.baseMip = texture.baseMip;
+  return image;
+}
+
+const VulkanViewport::GpuTexture *
+VulkanViewport::BindSharedTexture(const std::string &assetId,
+                                  GpuResourceCache::TextureHandle handle) {
+  auto *cache = GetResourceCache();
+  const GpuTextureImage *image = cache ? cache->GetTexture(handle) : nullptr;
+  if (!image) {
     return &m_defaultTexture;
   }
 
+  // The cache owns the image; copies here are non-owning.
   GpuTexture texture{};
+  texture.image = image->image;
+  texture.view = image->view;
+  texture.width = image->width;
+  texture.height = image->height;
+  texture.mipLevels = image->mipLevels;
+  texture.baseMip = image->baseMip;
+  texture.handle = handle;
   try {
-    texture = CreateTextureFromPixels(pixels, static_cast<uint32_t>(width),
-                                      static_cast<uint32_t>(height));
+    AllocateTextureDescriptorSet(texture);
   } catch (const std::exception &ex) {
     if (m_context) {
       m_context->Log(LogSeverity::Error,
                      std::string("Texture upload failed: ") + ex.what());
     }
-    stbi_image_free(pixels);
+    cache->ReleaseTexture(handle);
     return &m_defaultTexture;
   }
-  stbi_image_free(pixels);
 
-  auto [it, inserted] = m_textureCache.emplace(assetId, std::move(texture));
+  auto [it, inserted] = m_textureCache.emplace(assetId, texture);
   if (!inserted) {
-    it->second = std::move(texture);
+    it->second = texture;
   }
   return &it->second;
 }
@@ -1,11 +1,11 @@
 #pragma once
 
-#include <chrono>
 #include <string>
 #include <memory>
 #include <vector>
 
 #include "Aetherion/Runtime/EngineContext.h"
+#include "Aetherion/Runtime/FramePacer.h"
 #include "Aetherion/Runtime/RuntimeSystem.h"
 
 namespace Aetherion::Scene
@@ -15,6 +15,8 @@ class Scene;
 
 namespace Aetherion::Runtime
 {
+class FrameWorker;
+
 class EngineApplication
 {
 public:
@@ -24,7 +26,7 @@ public:
     EngineApplication(const EngineApplication&) = delete;
     EngineApplication& operator=(const EngineApplication&) = delete;
 
-    void Initialize(bool enableValidationLayers, bool enableVerboseLogging);
+    void Initialize(bool enableValidationLayers, bool enableVerboseLogging, bool headless = false);
     void Shutdown();
 
     void Run();
@@ -45,6 +47,18 @@ public:
 
     [[nodiscard]] std::shared_ptr<EngineContext> GetContext() const noexcept;
 
+    // Run() waits on the pacer between ticks; hosts that drive Tick() from
+    // their own loop can use it to schedule the next call.
+    [[nodiscard]] FramePacer& GetFramePacer() noexcept { return m_framePacer; }
+    [[nodiscard]] const FramePacer& GetFramePacer() const noexcept { return m_framePacer; }
+
+    // Overlaps per-frame systems (render extraction of the last captured
+    // state) with the fixed steps simulating the next one. Rendered views lag
+    // the simulation by one state; frames cost max(sim, extraction) instead
+    // of their sum.
+    void SetPipelinedExtraction(bool enabled);
+    [[nodiscard]] bool IsPipelinedExtraction() const noexcept { return m_pipelinedExtraction; }
+
     [[nodiscard]] std::shared_ptr<Scene::Scene> GetActiveScene() const noexcept;
     void SetActiveScene(std::shared_ptr<Scene::Scene> scene);
     [[nodiscard]] bool IsValidationEnabled() const noexcept { return m_enableValidationLayers; }
@@ -55,7 +69,9 @@ private:
     std::shared_ptr<EngineContext> m_context;
     std::shared_ptr<Scene::Scene> m_activeScene;
     std::vector<std::shared_ptr<IRuntimeSystem>> m_runtimeSystems;
-    std::chrono::steady_clock::time_point m_lastFrameTime{};
+    FramePacer m_framePacer;
+    std::unique_ptr<FrameWorker> m_extractionWorker;
+    bool m_pipelinedExtraction{true};
     bool m_running{false};
     bool m_enableValidationLayers{true};
     bool m_enableVerboseLogging{true};
@@ -66,8 +82,9 @@ private:
 
     void DebugPrint(const std::string& message, bool isError = false) const;
     void RegisterPlaceholderSystems();
-    void UpdateRuntimeSystems(float deltaTime);
-    void UpdateSceneSystems(float deltaTime);
+    void UpdateRuntimeSystems(const FramePacer::FrameTiming& timing);
+    void UpdateSceneSystems(const FramePacer::FrameTiming& timing);
+    void CaptureTransforms(const FramePacer::FrameTiming& timing);
     void ProcessInput();
     void PumpEvents();
 };
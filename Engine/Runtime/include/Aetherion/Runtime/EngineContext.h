@@ -12,7 +12,8 @@ class VulkanContext;
 
 namespace Aetherion::Assets {
 class AssetRegistry;
-}
+class VirtualFileSystem;
+} // namespace Aetherion::Assets
 
 namespace Aetherion::Physics {
 class PhysicsWorld;
@@ -27,6 +28,8 @@ class ScriptingRuntimeStub;
 }
 
 namespace Aetherion::Runtime {
+class TransformBuffer;
+
 class EngineContext {
 public:
   EngineContext();
@@ -38,6 +41,9 @@ public:
   void SetProjectName(std::string name);
   [[nodiscard]] const std::string &GetProjectName() const noexcept;
 
+  void SetPaths(Core::EnginePaths paths);
+  [[nodiscard]] const Core::EnginePaths &GetPaths() const noexcept;
+
   void SetVulkanContext(std::shared_ptr<Rendering::VulkanContext> context);
   [[nodiscard]] std::shared_ptr<Rendering::VulkanContext>
   GetVulkanContext() const noexcept;
@@ -46,10 +52,22 @@ public:
   [[nodiscard]] std::shared_ptr<Rendering::RenderView>
   GetRenderView() const noexcept;
 
+  // Transforms of the last simulated states; render extraction reads these
+  // instead of the live scene.
+  void SetTransformBuffer(std::shared_ptr<TransformBuffer> transforms);
+  [[nodiscard]] std::shared_ptr<TransformBuffer>
+  GetTransformBuffer() const noexcept;
+
   void SetAssetRegistry(std::shared_ptr<Assets::AssetRegistry> registry);
   [[nodiscard]] std::shared_ptr<Assets::AssetRegistry>
   GetAssetRegistry() const noexcept;
 
+  // Content (loose files and mounted archives). Null reads straight from
+  // disk.
+  void SetFileSystem(std::shared_ptr<Assets::VirtualFileSystem> fileSystem);
+  [[nodiscard]] std::shared_ptr<Assets::VirtualFileSystem>
+  GetFileSystem() const noexcept;
+
   void SetPhysicsSystem(std::shared_ptr<Physics::PhysicsWorld> physics);
   [[nodiscard]] std::shared_ptr<Physics::PhysicsWorld>
   GetPhysicsSystem() const noexcept;
@@ -78,19 +96,32 @@ public:
     return requested;
   }
 
+  // Fraction of a fixed step the frame lies past the last simulated state,
+  // for blending rendered transforms between steps.
+  void SetInterpolationAlpha(float alpha) noexcept {
+    m_interpolationAlpha = alpha;
+  }
+  [[nodiscard]] float GetInterpolationAlpha() const noexcept {
+    return m_interpolationAlpha;
+  }
+
   // EngineContext owns shared references to service singletons. Providers
   // remain alive until replaced or cleared by Set* methods or during
   // EngineApplication::Shutdown().
 private:
   std::string m_projectName;
+  Core::EnginePaths m_paths;
   std::shared_ptr<Rendering::VulkanContext> m_vulkanContext;
   std::shared_ptr<Rendering::RenderView> m_renderView;
+  std::shared_ptr<TransformBuffer> m_transformBuffer;
   std::shared_ptr<Assets::AssetRegistry> m_assetRegistry;
+  std::shared_ptr<Assets::VirtualFileSystem> m_fileSystem;
   std::shared_ptr<Physics::PhysicsWorld> m_physicsSystem;
   std::shared_ptr<Audio::AudioEngineStub> m_audioSystem;
   std::shared_ptr<Scripting::ScriptingRuntimeStub> m_scriptingRuntime;
   bool m_simulationPlaying{false};
   bool m_simulationPaused{false};
   bool m_stepOnceRequested{false};
+  float m_interpolationAlpha{0.0f};
 };
 } // namespace Aetherion::Runtime
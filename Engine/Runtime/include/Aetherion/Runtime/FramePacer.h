@@ -0,0 +1,120 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace Aetherion::Runtime {
+// Paces the main loop. Frames start on fixed deadlines (sleeping rather than
+// spinning until them), the simulation advances in fixed steps with an
+// interpolation factor for whatever falls between two steps, and frame times
+// and input-to-present latencies are kept for percentile stats.
+class FramePacer {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Settings {
+    // Frame deadlines per second; 0 runs unthrottled.
+    double targetFrameRate{60.0};
+    double fixedStepSeconds{1.0 / 60.0};
+    // Steps run per frame at most. Longer hitches drop the remainder instead
+    // of letting the simulation spiral.
+    uint32_t maxStepsPerFrame{5};
+    // OS sleeps overshoot; the last part of a wait yields instead.
+    double spinMs{1.0};
+    // Frames (and presents) kept for the percentiles.
+    uint32_t historySize{240};
+  };
+
+  struct FrameTiming {
+    uint64_t frameIndex{0};
+    // Wall time since the previous frame started.
+    double deltaSeconds{0.0};
+    // Fixed steps to simulate this frame, each `fixedStepSeconds` long.
+    uint32_t fixedSteps{0};
+    double fixedStepSeconds{0.0};
+    // Where the frame falls between the last two simulated states, 0..1.
+    double alpha{0.0};
+  };
+
+  struct Percentiles {
+    double p50{0.0};
+    double p95{0.0};
+    double p99{0.0};
+    double max{0.0};
+  };
+
+  struct Stats {
+    Percentiles frameMs;
+    double meanFrameMs{0.0};
+    uint32_t frameSamples{0};
+    // From the oldest input a frame picked up to that frame's present.
+    Percentiles latencyMs;
+    uint32_t latencySamples{0};
+    uint64_t droppedSteps{0};
+  };
+
+  FramePacer();
+  explicit FramePacer(const Settings &settings);
+  ~FramePacer();
+
+  FramePacer(const FramePacer &) = delete;
+  FramePacer &operator=(const FramePacer &) = delete;
+
+  void SetSettings(const Settings &settings);
+  [[nodiscard]] const Settings &GetSettings() const noexcept {
+    return m_settings;
+  }
+  void SetTargetFrameRate(double framesPerSecond) noexcept;
+
+  // Starts a frame: measures the delta, advances the fixed-step accumulator
+  // and schedules the next deadline.
+  FrameTiming BeginFrame(Clock::time_point now = Clock::now());
+  [[nodiscard]] const FrameTiming &GetLastTiming() const noexcept {
+    return m_timing;
+  }
+
+  // Blocks until the next deadline; returns at once when unthrottled or late.
+  void WaitForNextFrame();
+  [[nodiscard]] Clock::duration
+  TimeUntilNextFrame(Clock::time_point now = Clock::now()) const noexcept;
+
+  // Input events mark the oldest unpresented input; the present of the first
+  // frame started after it closes the measurement.
+  void MarkInput(Clock::time_point when = Clock::now()) noexcept;
+  void MarkPresented(Clock::time_point when = Clock::now());
+
+  [[nodiscard]] Stats GetStats() const;
+  void ResetStats();
+
+private:
+  // Fixed-size ring of samples.
+  struct History {
+    std::vector<double> samples;
+    size_t next{0};
+    size_t count{0};
+
+    void Push(double value, size_t capacity);
+    [[nodiscard]] Percentiles Compute(double *mean) const;
+  };
+
+  void SleepUntil(Clock::time_point deadline);
+
+  Settings m_settings;
+  FrameTiming m_timing;
+  Clock::time_point m_lastFrameStart{};
+  Clock::time_point m_nextDeadline{};
+  double m_accumulator{0.0};
+  uint64_t m_droppedSteps{0};
+
+  bool m_inputPending{false};
+  Clock::time_point m_inputTime{};
+
+  History m_frameMs;
+  History m_latencyMs;
+
+  // High-resolution waitable timer on Windows, where plain sleeps round up
+  // to the scheduler tick.
+  void *m_waitTimer{nullptr};
+};
+} // namespace Aetherion::Runtime
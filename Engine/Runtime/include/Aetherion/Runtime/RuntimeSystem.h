@@ -19,5 +19,12 @@ public:
     virtual void Initialize(EngineContext& context) = 0;
     virtual void Tick(EngineContext& context, float deltaTime) = 0;
     virtual void Shutdown(EngineContext& context) = 0;
+
+    // Fixed-step systems tick once per simulation step with the step length;
+    // the rest tick once per frame with the frame delta. With pipelined
+    // extraction, per-frame systems run on a worker while the fixed steps of
+    // the same frame run, so they must take transforms from the context's
+    // TransformBuffer rather than from the scene.
+    [[nodiscard]] virtual bool IsFixedStep() const { return false; }
 };
 } // namespace Aetherion::Runtime
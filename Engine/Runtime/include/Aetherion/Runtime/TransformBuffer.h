@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+#include "Aetherion/Core/Types.h"
+
+namespace Aetherion::Scene {
+class Scene;
+}
+
+namespace Aetherion::Runtime {
+// Transforms of the last two simulated states, copied out of the scene so
+// render extraction can read them while the simulation already writes the
+// next state. Capturing fills the older buffer and flips; readers blend the
+// previous and current state by the frame's interpolation alpha.
+//
+// Capture and reads must not overlap. The engine captures between frames,
+// after the extraction reading the buffer has been joined.
+class TransformBuffer {
+public:
+  struct Entry {
+    // World matrix of the parent chain (identity for roots), column-major.
+    std::array<float, 16> parentWorld{};
+    std::array<float, 3> position{};
+    std::array<float, 3> rotationDegrees{};
+    std::array<float, 3> scale{};
+  };
+
+  struct State {
+    std::unordered_map<Core::EntityId, Entry> entries;
+    uint64_t serial{0};
+  };
+
+  // Starts a new state: the current one becomes the previous one and the
+  // scene is copied into the freed buffer.
+  void Advance(const Scene::Scene &scene);
+  // Re-copies the scene into the current state, keeping the previous one.
+  // Used on frames without a simulation step, where only edits can change
+  // transforms.
+  void Refresh(const Scene::Scene &scene);
+  void Clear();
+
+  [[nodiscard]] const State &GetCurrent() const noexcept {
+    return m_states[m_current];
+  }
+  [[nodiscard]] const State &GetPrevious() const noexcept {
+    return m_states[m_current ^ 1u];
+  }
+  [[nodiscard]] bool Contains(Core::EntityId id) const {
+    return GetCurrent().entries.count(id) != 0;
+  }
+
+  // World matrix of `id` between the previous (alpha 0) and current
+  // (alpha 1) state, with `extraRotationZDegrees` added to the local Z
+  // rotation. Entities that did not exist in the previous state use the
+  // current one. Returns false when the entity has no captured transform.
+  bool Interpolate(Core::EntityId id, float alpha, float out[16],
+                   float extraRotationZDegrees = 0.0f) const;
+
+private:
+  void Capture(const Scene::Scene &scene, State &state);
+
+  std::array<State, 2> m_states;
+  uint32_t m_current{0};
+  uint64_t m_serial{0};
+};
+} // namespace Aetherion::Runtime
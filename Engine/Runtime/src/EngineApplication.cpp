@@ -4,14 +4,19 @@
 #include <array>
 #include <cctype>
 #include <cmath>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <filesystem>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 
 #ifdef _WIN32
 #ifndef NOMINMAX
@@ -29,6 +34,7 @@
 #endif
 
 #include "Aetherion/Assets/AssetRegistry.h"
+#include "Aetherion/Assets/VirtualFileSystem.h"
 #include "Aetherion/Audio/AudioPlaceholder.h"
 #include "Aetherion/Core/Math.h"
 #include "Aetherion/Core/String.h"
@@ -47,6 +53,7 @@
 #include "Aetherion/Scene/SceneSerializer.h"
 #include "Aetherion/Scene/System.h"
 #include "Aetherion/Scene/TransformComponent.h"
+#include "Aetherion/Runtime/TransformBuffer.h"
 #include "Aetherion/Scripting/ScriptingPlaceholder.h"
 
 namespace Aetherion::Runtime {
@@ -132,6 +139,42 @@ std::filesystem::path ResolveAssetsRoot() {
   return std::filesystem::path("assets");
 }
 
+// The `.apak` archives directly inside the content directory, by name; later
+// names are mounted later and so win over earlier ones (e.g. `patch_*.apak`
+// over `content.apak`).
+std::vector<std::filesystem::path>
+FindContentArchives(const std::filesystem::path &content) {
+  std::vector<std::filesystem::path> archives;
+  std::error_code ec;
+  for (std::filesystem::directory_iterator it(content, ec), end;
+       !ec && it != end; it.increment(ec)) {
+    if (it->is_regular_file(ec) &&
+        Core::String::ToLower(it->path().extension().string()) == ".apak") {
+      archives.push_back(it->path());
+    }
+  }
+  std::sort(archives.begin(), archives.end());
+  return archives;
+}
+
+Core::EnginePaths ResolveEnginePaths() {
+  Core::EnginePaths paths;
+  paths.content = ResolveAssetsRoot();
+
+  std::error_code ec;
+  auto absoluteContent = std::filesystem::absolute(paths.content, ec);
+  paths.root = ec ? paths.content.parent_path()
+                  : absoluteContent.parent_path();
+
+  if (const char *env = std::getenv("AETHERION_CACHE_DIR")) {
+    paths.cache = env;
+  }
+  if (paths.cache.empty()) {
+    paths.cache = paths.root / "cache";
+  }
+  return paths;
+}
+
 std::string BoolToOnOff(bool value) { return value ? "on" : "off"; }
 
 void Mat4Identity(float out[16]) { Core::Math::Mat4Identity(out); }
@@ -161,14 +204,16 @@ void Mat4Scale(float out[16], float x, float y, float z) {
 }
 
 std::array<float, 16>
-BuildLocalMatrix(const Scene::TransformComponent &transform) {
+BuildLocalMatrix(const Scene::TransformComponent &transform,
+                 float extraRotationZDegrees = 0.0f) {
   float local[16];
   Core::Math::Mat4Compose(
       local, transform.GetPositionX(), transform.GetPositionY(),
       transform.GetPositionZ(),
       transform.GetRotationXDegrees() * Core::Math::DegToRad,
       transform.GetRotationYDegrees() * Core::Math::DegToRad,
-      transform.GetRotationZDegrees() * Core::Math::DegToRad,
+      (transform.GetRotationZDegrees() + extraRotationZDegrees) *
+          Core::Math::DegToRad,
       transform.GetScaleX(), transform.GetScaleY(), transform.GetScaleZ());
 
   std::array<float, 16> out{};
@@ -176,8 +221,11 @@ BuildLocalMatrix(const Scene::TransformComponent &transform) {
   return out;
 }
 
+// `extraRotationZDegrees` is added to the entity's own Z rotation, not to its
+// parents'.
 std::array<float, 16> GetWorldMatrix(const Scene::Scene &scene,
-                                     Core::EntityId id) {
+                                     Core::EntityId id,
+                                     float extraRotationZDegrees = 0.0f) {
   auto entity = scene.FindEntityById(id);
   if (!entity) {
     std::array<float, 16> identity{};
@@ -192,7 +240,7 @@ std::array<float, 16> GetWorldMatrix(const Scene::Scene &scene,
     return identity;
   }
 
-  auto local = BuildLocalMatrix(*transform);
+  auto local = BuildLocalMatrix(*transform, extraRotationZDegrees);
   if (!transform->HasParent()) {
     return local;
   }
@@ -231,6 +279,8 @@ public:
     return "PhysicsRuntimeSystem";
   }
 
+  [[nodiscard]] bool IsFixedStep() const override { return true; }
+
   void Initialize(EngineContext &context) override {
     m_context = &context;
     EnsurePhysicsSystem();
@@ -324,6 +374,8 @@ public:
     return "SceneSystemDispatcher";
   }
 
+  [[nodiscard]] bool IsFixedStep() const override { return true; }
+
   void Initialize(EngineContext &context) override {
     m_context = &context;
     ConfigureSceneSystems();
@@ -422,11 +474,13 @@ private:
     }
 
     auto registry = m_context ? m_context->GetAssetRegistry() : nullptr;
+    // Transforms come from the captured states only: with pipelined
+    // extraction the scene's transforms are being simulated meanwhile.
+    const auto transforms = m_context->GetTransformBuffer();
+    const float alpha = m_context->GetInterpolationAlpha();
 
     view->instances.clear();
     view->batches.clear();
-    view->transforms.clear();
-    view->meshes.clear();
     view->directionalLight = Rendering::RenderDirectionalLight{};
     view->lights.clear();
     view->camera = Rendering::RenderCamera{};
@@ -453,26 +507,20 @@ private:
         continue;
       }
 
-      auto transform = entity->GetComponent<Scene::TransformComponent>();
-      if (transform) {
-        view->transforms.emplace(entity->GetId(), transform.get());
+      bool hasWorld = false;
+      std::array<float, 16> world{};
+      if (transforms) {
+        hasWorld =
+            transforms->Interpolate(entity->GetId(), alpha, world.data());
+      } else if (entity->GetComponent<Scene::TransformComponent>()) {
+        world = GetWorldMatrix(*scene, entity->GetId());
+        hasWorld = true;
       }
 
       auto mesh = entity->GetComponent<Scene::MeshRendererComponent>();
-      if (mesh) {
-        view->meshes.emplace(entity->GetId(), mesh.get());
-      }
-
-      bool hasWorld = false;
-      std::array<float, 16> world{};
 
       auto light = entity->GetComponent<Scene::LightComponent>();
-      if (light && transform) {
-        if (!hasWorld) {
-          world = GetWorldMatrix(*scene, entity->GetId());
-          hasWorld = true;
-        }
-
+      if (light && hasWorld) {
         Rendering::RenderLight renderLight{};
         renderLight.entityId = entity->GetId();
         renderLight.enabled = light->IsEnabled();
@@ -569,12 +617,7 @@ private:
       }
 
       auto camera = entity->GetComponent<Scene::CameraComponent>();
-      if (camera && transform) {
-        if (!hasWorld) {
-          world = GetWorldMatrix(*scene, entity->GetId());
-          hasWorld = true;
-        }
-
+      if (camera && hasWorld) {
         Rendering::RenderCamera candidate{};
         candidate.enabled = true;
         candidate.position[0] = world[12];
@@ -619,12 +662,7 @@ private:
 
       // Collect colliders for debug visualization
       auto collider = entity->GetComponent<Scene::ColliderComponent>();
-      if (collider && transform) {
-        if (!hasWorld) {
-          world = GetWorldMatrix(*scene, entity->GetId());
-          hasWorld = true;
-        }
-
+      if (collider && hasWorld) {
         Rendering::RenderCollider renderCollider{};
         renderCollider.entityId = entity->GetId();
         renderCollider.shapeType =
@@ -656,14 +694,12 @@ private:
         view->colliders.push_back(renderCollider);
       }
 
-      if (!transform || !mesh || !mesh->IsVisible()) {
+      if (!hasWorld || !mesh || !mesh->IsVisible()) {
         continue;
       }
 
       Rendering::RenderInstance instance{};
       instance.entityId = entity->GetId();
-      instance.transform = transform.get();
-      instance.mesh = mesh.get();
       instance.meshAssetId = mesh->GetMeshAssetId();
       if (registry && !instance.meshAssetId.empty()) {
         if (const auto *entry = registry->FindEntry(instance.meshAssetId)) {
@@ -693,14 +729,41 @@ private:
           }
         }
       }
-      instance.hasModel = false;
+      // The render thread draws the view while the scene keeps changing, so
+      // the instance carries its model matrix (including the spin) and color
+      // instead of pointers to the components.
+      const float spinDeg = mesh->GetRotationSpeedDegPerSec() * m_timeSeconds;
+      if (spinDeg == 0.0f) {
+        std::memcpy(instance.model, world.data(), sizeof(instance.model));
+      } else if (transforms) {
+        (void)transforms->Interpolate(entity->GetId(), alpha, instance.model,
+                                      spinDeg);
+      } else {
+        const auto model = GetWorldMatrix(*scene, entity->GetId(), spinDeg);
+        std::memcpy(instance.model, model.data(), sizeof(instance.model));
+      }
+      instance.hasModel = true;
+      const auto color = mesh->GetColor();
+      instance.color[0] = color[0];
+      instance.color[1] = color[1];
+      instance.color[2] = color[2];
+      // Anything the simulation or the spin animation moves is redrawn into
+      // the dynamic shadow map every frame instead of the cached one.
+      if (const auto rigidbody =
+              entity->GetComponent<Scene::RigidbodyComponent>()) {
+        instance.isStatic = rigidbody->GetMotionType() ==
+                            Scene::RigidbodyComponent::MotionType::Static;
+      }
+      if (mesh->GetRotationSpeedDegPerSec() != 0.0f) {
+        instance.isStatic = false;
+      }
       view->instances.push_back(instance);
 
       size_t batchIndex = 0;
-      auto found = batchLookup.find(instance.mesh);
+      auto found = batchLookup.find(mesh.get());
       if (found == batchLookup.end()) {
         batchIndex = view->batches.size();
-        batchLookup.emplace(instance.mesh, batchIndex);
+        batchLookup.emplace(mesh.get(), batchIndex);
         view->batches.emplace_back();
       } else {
         batchIndex = found->second;
@@ -730,6 +793,77 @@ private:
 };
 } // namespace
 
+// Runs one job at a time on a thread kept for the engine's lifetime, so the
+// per-frame handoff does not start a thread every frame.
+class FrameWorker {
+public:
+  FrameWorker() : m_thread([this] { Run(); }) {}
+
+  ~FrameWorker() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+  }
+
+  FrameWorker(const FrameWorker &) = delete;
+  FrameWorker &operator=(const FrameWorker &) = delete;
+
+  // The previous job must have been waited for.
+  void Submit(std::function<void()> job) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_job = std::move(job);
+      m_done = false;
+    }
+    m_cv.notify_all();
+  }
+
+  // Blocks until the submitted job finished and rethrows what it threw.
+  void Wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_done; });
+    if (m_error) {
+      std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+  }
+
+private:
+  void Run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+      m_cv.wait(lock, [this] { return m_stop || m_job; });
+      if (m_stop) {
+        return;
+      }
+
+      auto job = std::move(m_job);
+      m_job = nullptr;
+      lock.unlock();
+      std::exception_ptr error;
+      try {
+        job();
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      m_error = error;
+      m_done = true;
+      m_cv.notify_all();
+    }
+  }
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::function<void()> m_job;
+  std::exception_ptr m_error;
+  bool m_done{true};
+  bool m_stop{false};
+  std::thread m_thread;
+};
+
 EngineApplication::EngineApplication()
     : m_context(std::make_shared<EngineContext>()) {
   // TODO: Load project metadata and configure context.
@@ -738,7 +872,7 @@ EngineApplication::EngineApplication()
 EngineApplication::~EngineApplication() = default;
 
 void EngineApplication::Initialize(bool enableValidationLayers,
-                                   bool enableVerboseLogging) {
+                                   bool enableVerboseLogging, bool headless) {
   if (m_initialized) {
     DebugPrint("Engine already initialized. Restarting...");
     Shutdown();
@@ -753,11 +887,17 @@ void EngineApplication::Initialize(bool enableValidationLayers,
   m_enableVerboseLogging = enableVerboseLogging;
   DebugPrint("Initializing engine (validation=" +
              BoolToOnOff(m_enableValidationLayers) +
-             ", verbose logging=" + BoolToOnOff(m_enableVerboseLogging) + ")");
+             ", verbose logging=" + BoolToOnOff(m_enableVerboseLogging) +
+             ", headless=" + BoolToOnOff(headless) + ")");
+
+  const Core::EnginePaths paths = ResolveEnginePaths();
+  m_context->SetPaths(paths);
 
   auto vulkanContext = std::make_shared<Rendering::VulkanContext>();
+  vulkanContext->SetPipelineCachePath(paths.cache / "pipeline_cache.bin");
   try {
-    vulkanContext->Initialize(m_enableValidationLayers, m_enableVerboseLogging);
+    vulkanContext->Initialize(m_enableValidationLayers, m_enableVerboseLogging,
+                              headless);
   } catch (const std::exception &ex) {
     DebugPrint(std::string("Vulkan initialization failed: ") + ex.what(), true);
     throw std::runtime_error(std::string("Failed to initialize Vulkan: ") +
@@ -767,6 +907,7 @@ void EngineApplication::Initialize(bool enableValidationLayers,
 
   m_context->SetVulkanContext(vulkanContext);
   m_context->SetRenderView(std::make_shared<Rendering::RenderView>());
+  m_context->SetTransformBuffer(std::make_shared<TransformBuffer>());
   m_context->SetAssetRegistry(std::make_shared<Assets::AssetRegistry>());
   m_context->SetPhysicsSystem(std::make_shared<Physics::PhysicsWorld>());
   m_context->SetAudioSystem(std::make_shared<Audio::AudioEngineStub>());
@@ -774,12 +915,32 @@ void EngineApplication::Initialize(bool enableValidationLayers,
       std::make_shared<Scripting::ScriptingRuntimeStub>());
   m_context->SetProjectName("Aetherion");
 
-  const std::filesystem::path assetsRoot = ResolveAssetsRoot();
+  const std::filesystem::path &assetsRoot = paths.content;
   DebugPrint("Resolved assets root: " + assetsRoot.string());
+  // Loose files are mounted above the archives, so an edited file takes
+  // effect without repacking.
+  auto fileSystem = std::make_shared<Assets::VirtualFileSystem>();
+  for (const auto &archive : FindContentArchives(assetsRoot)) {
+    if (fileSystem->MountArchive(archive) != 0) {
+      DebugPrint("Mounted archive: " + archive.string());
+    } else {
+      DebugPrint("Failed to mount archive: " + archive.string(), true);
+    }
+  }
+  fileSystem->MountDirectory(assetsRoot, {}, 1);
+  m_context->SetFileSystem(fileSystem);
+
   if (const auto assets = m_context->GetAssetRegistry()) {
+    assets->SetCacheRoot(paths.cache);
+    assets->SetFileSystem(fileSystem);
     assets->Scan(assetsRoot.string());
+    const auto &scan = assets->GetLastScanStats();
     DebugPrint("Asset scan complete: " + assets->GetRootPath().string() + " (" +
-               std::to_string(assets->GetEntries().size()) + " assets)");
+               std::to_string(assets->GetEntries().size()) + " assets, " +
+               std::to_string(static_cast<int>(scan.milliseconds)) + " ms, " +
+               std::to_string(scan.sidecarsParsed) + " sidecars read, " +
+               (scan.indexFromDisk ? "warm" : "cold") + " index, " +
+               std::to_string(scan.threads) + " threads)");
   }
   if (const auto physics = m_context->GetPhysicsSystem()) {
     physics->Initialize();
@@ -811,7 +972,7 @@ void EngineApplication::Initialize(bool enableValidationLayers,
   RegisterPlaceholderSystems();
 
   m_running = true;
-  m_lastFrameTime = std::chrono::steady_clock::now();
+  m_framePacer.ResetStats();
   m_initialized = true;
   DebugPrint("Engine initialized. Entering main loop.");
 }
@@ -819,6 +980,7 @@ void EngineApplication::Initialize(bool enableValidationLayers,
 void EngineApplication::Shutdown() {
   DebugPrint("Shutting down engine...");
   m_running = false;
+  m_extractionWorker.reset();
   if (m_context) {
     m_context->SetSimulationState(false, false);
   }
@@ -850,16 +1012,36 @@ void EngineApplication::Shutdown() {
       physics->Shutdown();
       DebugPrint("Physics placeholder shut down.");
     }
+    if (const auto assets = m_context->GetAssetRegistry()) {
+      const auto ddc = assets->GetDerivedDataCache()->GetStats();
+      DebugPrint("Derived-data cache: " + std::to_string(ddc.hits) +
+                 " hits, " + std::to_string(ddc.misses) + " misses, " +
+                 std::to_string(ddc.evictions) + " evictions, " +
+                 std::to_string(ddc.entries) + " entries (" +
+                 std::to_string(ddc.bytes / (1024 * 1024)) + " MB), " +
+                 std::to_string(ddc.sourcesHashed) + " sources hashed");
+      const auto memory = assets->GetMemoryStats();
+      DebugPrint("Mesh data: " +
+                 std::to_string(memory.meshData.bytes / (1024 * 1024)) +
+                 " MB in " + std::to_string(memory.meshData.entries) +
+                 " meshes (" + std::to_string(memory.meshData.pinnedEntries) +
+                 " pinned), " + std::to_string(memory.meshDataHits) +
+                 " hits, " + std::to_string(memory.meshDataMisses) +
+                 " loads (" + std::to_string(memory.meshLoadsShared) +
+                 " shared), " + std::to_string(memory.meshDataEvictions) +
+                 " evictions");
+    }
     m_context->SetAssetRegistry(nullptr);
+    m_context->SetFileSystem(nullptr);
     m_context->SetPhysicsSystem(nullptr);
     m_context->SetAudioSystem(nullptr);
     m_context->SetScriptingRuntime(nullptr);
     m_context->SetRenderView(nullptr);
+    m_context->SetTransformBuffer(nullptr);
   }
 
   m_activeScene.reset();
   m_context.reset();
-  m_lastFrameTime = {};
   m_sceneSystemsConfigured = false;
   m_initialized = false;
 }
@@ -867,7 +1049,7 @@ void EngineApplication::Shutdown() {
 void EngineApplication::Run() {
   while (m_running) {
     Tick();
-    std::this_thread::yield();
+    m_framePacer.WaitForNextFrame();
   }
 }
 
@@ -885,17 +1067,19 @@ void EngineApplication::Tick() {
     s_loggedFirstTick = true;
   }
 
-  const auto now = std::chrono::steady_clock::now();
-  const float deltaTime =
-      std::chrono::duration<float>(now - m_lastFrameTime).count();
-  m_lastFrameTime = now;
+  const FramePacer::FrameTiming timing = m_framePacer.BeginFrame();
 
   ProcessInput();
   PumpEvents();
 
-  UpdateRuntimeSystems(deltaTime);
+  // Outside of a running simulation nothing advances between steps; render
+  // the latest state (edits included) as is.
+  const bool simulating = m_simulationPlaying && !m_simulationPaused;
+  m_context->SetInterpolationAlpha(
+      simulating ? static_cast<float>(timing.alpha) : 1.0f);
+  UpdateRuntimeSystems(timing);
   if (m_runtimeSystems.empty()) {
-    UpdateSceneSystems(deltaTime);
+    UpdateSceneSystems(timing);
   }
 }
 
@@ -915,6 +1099,13 @@ void EngineApplication::RegisterSystem(std::shared_ptr<IRuntimeSystem> system) {
   }
 }
 
+void EngineApplication::SetPipelinedExtraction(bool enabled) {
+  m_pipelinedExtraction = enabled;
+  if (!enabled) {
+    m_extractionWorker.reset();
+  }
+}
+
 void EngineApplication::SetSimulationPlaying(bool playing) {
   m_simulationPlaying = playing;
   if (!m_simulationPlaying) {
@@ -975,6 +1166,14 @@ void EngineApplication::SetActiveScene(std::shared_ptr<Scene::Scene> scene) {
 }
 
 void EngineApplication::RegisterPlaceholderSystems() {
+  // The render view system builds its first view from the buffer right away.
+  if (const auto transforms = m_context ? m_context->GetTransformBuffer()
+                                        : nullptr) {
+    transforms->Clear();
+    if (m_activeScene) {
+      transforms->Refresh(*m_activeScene);
+    }
+  }
   RegisterSystem(std::make_shared<PhysicsRuntimeSystem>(m_activeScene));
   RegisterSystem(std::make_shared<SceneSystemDispatcher>(m_activeScene));   
   RegisterSystem(std::make_shared<RenderViewSystem>(m_activeScene));        
@@ -982,15 +1181,82 @@ void EngineApplication::RegisterPlaceholderSystems() {
   // TODO: Register systems with the engine once rendering/physics/audio exist.
 }
 
-void EngineApplication::UpdateRuntimeSystems(float deltaTime) {
-  for (const auto &system : m_runtimeSystems) {
-    if (system) {
-      system->Tick(*m_context, deltaTime);
+void EngineApplication::UpdateRuntimeSystems(
+    const FramePacer::FrameTiming &timing) {
+  const auto stepSeconds = static_cast<float>(timing.fixedStepSeconds);
+  auto runFixedSteps = [&] {
+    for (uint32_t step = 0; step < timing.fixedSteps; ++step) {
+      for (const auto &system : m_runtimeSystems) {
+        if (system && system->IsFixedStep()) {
+          system->Tick(*m_context, stepSeconds);
+        }
+      }
     }
+  };
+
+  const auto frameSeconds = static_cast<float>(timing.deltaSeconds);
+  auto runFrameSystems = [&] {
+    for (const auto &system : m_runtimeSystems) {
+      if (system && !system->IsFixedStep()) {
+        system->Tick(*m_context, frameSeconds);
+      }
+    }
+  };
+
+  if (!m_pipelinedExtraction || !m_context->GetTransformBuffer()) {
+    // Fixed-step systems catch up on every step first, so per-frame systems
+    // (the render view) see the latest simulated state.
+    runFixedSteps();
+    CaptureTransforms(timing);
+    runFrameSystems();
+    return;
+  }
+
+  // Per-frame systems extract the state captured last frame on the worker
+  // while this thread simulates the next one; the fixed steps write the
+  // scene transforms, extraction only reads the transform buffer. Both are
+  // joined before the buffer is captured again or the host touches the scene.
+  if (!m_extractionWorker) {
+    m_extractionWorker = std::make_unique<FrameWorker>();
+  }
+  m_extractionWorker->Submit(runFrameSystems);
+  try {
+    runFixedSteps();
+  } catch (...) {
+    try {
+      m_extractionWorker->Wait();
+    } catch (...) {
+    }
+    throw;
+  }
+  m_extractionWorker->Wait();
+  CaptureTransforms(timing);
+}
+
+void EngineApplication::CaptureTransforms(
+    const FramePacer::FrameTiming &timing) {
+  const auto transforms = m_context->GetTransformBuffer();
+  if (!transforms) {
+    return;
+  }
+  if (!m_activeScene) {
+    transforms->Clear();
+    return;
+  }
+
+  // A frame without steps keeps the previous state to blend from; editor
+  // changes still land in the current one. After several steps in one frame
+  // the previous state predates all of them, so hitches blend over more than
+  // one step.
+  if (timing.fixedSteps > 0) {
+    transforms->Advance(*m_activeScene);
+  } else {
+    transforms->Refresh(*m_activeScene);
   }
 }
 
-void EngineApplication::UpdateSceneSystems(float deltaTime) {
+void EngineApplication::UpdateSceneSystems(
+    const FramePacer::FrameTiming &timing) {
   if (!m_activeScene) {
     return;
   }
@@ -1004,9 +1270,12 @@ void EngineApplication::UpdateSceneSystems(float deltaTime) {
     m_sceneSystemsConfigured = true;
   }
 
-  for (const auto &system : m_activeScene->GetSystems()) {
-    if (system) {
-      system->Update(*m_activeScene, deltaTime);
+  const auto stepSeconds = static_cast<float>(timing.fixedStepSeconds);
+  for (uint32_t step = 0; step < timing.fixedSteps; ++step) {
+    for (const auto &system : m_activeScene->GetSystems()) {
+      if (system) {
+        system->Update(*m_activeScene, stepSeconds);
+      }
     }
   }
 }
@@ -1,6 +1,7 @@
 #include "Aetherion/Runtime/EngineContext.h"
 
 #include "Aetherion/Assets/AssetRegistry.h"
+#include "Aetherion/Assets/VirtualFileSystem.h"
 #include "Aetherion/Audio/AudioPlaceholder.h"
 #include "Aetherion/Physics/PhysicsWorld.h"
 #include "Aetherion/Rendering/RenderView.h"
@@ -21,6 +22,14 @@ const std::string &EngineContext::GetProjectName() const noexcept {
   return m_projectName;
 }
 
+void EngineContext::SetPaths(Core::EnginePaths paths) {
+  m_paths = std::move(paths);
+}
+
+const Core::EnginePaths &EngineContext::GetPaths() const noexcept {
+  return m_paths;
+}
+
 void EngineContext::SetVulkanContext(
     std::shared_ptr<Rendering::VulkanContext> context) {
   m_vulkanContext = std::move(context);
@@ -40,6 +49,16 @@ EngineContext::GetRenderView() const noexcept {
   return m_renderView;
 }
 
+void EngineContext::SetTransformBuffer(
+    std::shared_ptr<TransformBuffer> transforms) {
+  m_transformBuffer = std::move(transforms);
+}
+
+std::shared_ptr<TransformBuffer>
+EngineContext::GetTransformBuffer() const noexcept {
+  return m_transformBuffer;
+}
+
 void EngineContext::SetAssetRegistry(
     std::shared_ptr<Assets::AssetRegistry> registry) {
   m_assetRegistry = std::move(registry);
@@ -50,6 +69,16 @@ EngineContext::GetAssetRegistry() const noexcept {
   return m_assetRegistry;
 }
 
+void EngineContext::SetFileSystem(
+    std::shared_ptr<Assets::VirtualFileSystem> fileSystem) {
+  m_fileSystem = std::move(fileSystem);
+}
+
+std::shared_ptr<Assets::VirtualFileSystem>
+EngineContext::GetFileSystem() const noexcept {
+  return m_fileSystem;
+}
+
 void EngineContext::SetPhysicsSystem(
     std::shared_ptr<Physics::PhysicsWorld> physics) {
   m_physicsSystem = std::move(physics);
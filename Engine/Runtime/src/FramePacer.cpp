@@ -0,0 +1,231 @@
+#include "Aetherion/Runtime/FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+namespace Aetherion::Runtime {
+namespace {
+FramePacer::Clock::duration ToDuration(double seconds) {
+  return std::chrono::duration_cast<FramePacer::Clock::duration>(
+      std::chrono::duration<double>(seconds));
+}
+} // namespace
+
+void FramePacer::History::Push(double value, size_t capacity) {
+  if (capacity == 0) {
+    return;
+  }
+  if (samples.size() != capacity) {
+    samples.assign(capacity, 0.0);
+    next = 0;
+    count = 0;
+  }
+  samples[next] = value;
+  next = (next + 1) % capacity;
+  count = std::min(count + 1, capacity);
+}
+
+FramePacer::Percentiles FramePacer::History::Compute(double *mean) const {
+  Percentiles result{};
+  if (mean) {
+    *mean = 0.0;
+  }
+  if (count == 0) {
+    return result;
+  }
+
+  // The ring is full or filled from index 0, so the first `count` entries
+  // are exactly the live samples.
+  std::vector<double> sorted(samples.begin(),
+                             samples.begin() + static_cast<ptrdiff_t>(count));
+  std::sort(sorted.begin(), sorted.end());
+  auto rank = [&](double p) {
+    const auto index = static_cast<size_t>(
+        std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(index, 1, sorted.size()) - 1];
+  };
+  result.p50 = rank(0.50);
+  result.p95 = rank(0.95);
+  result.p99 = rank(0.99);
+  result.max = sorted.back();
+  if (mean) {
+    double sum = 0.0;
+    for (double value : sorted) {
+      sum += value;
+    }
+    *mean = sum / static_cast<double>(sorted.size());
+  }
+  return result;
+}
+
+FramePacer::FramePacer() : FramePacer(Settings{}) {}
+
+FramePacer::FramePacer(const Settings &settings) : m_settings(settings) {
+#ifdef _WIN32
+  // Needs Windows 10 1803; older systems fall back to sleep_until().
+  m_waitTimer = CreateWaitableTimerExW(
+      nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+      TIMER_ALL_ACCESS);
+#endif
+}
+
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+  if (m_waitTimer) {
+    CloseHandle(static_cast<HANDLE>(m_waitTimer));
+  }
+#endif
+}
+
+void FramePacer::SetSettings(const Settings &settings) {
+  m_settings = settings;
+  m_nextDeadline = {};
+}
+
+void FramePacer::SetTargetFrameRate(double framesPerSecond) noexcept {
+  if (m_settings.targetFrameRate == framesPerSecond) {
+    return;
+  }
+  m_settings.targetFrameRate = framesPerSecond;
+  m_nextDeadline = {};
+}
+
+FramePacer::FrameTiming FramePacer::BeginFrame(Clock::time_point now) {
+  FrameTiming timing{};
+  const bool firstFrame = m_lastFrameStart == Clock::time_point{};
+  timing.frameIndex = firstFrame ? 0 : m_timing.frameIndex + 1;
+  if (!firstFrame) {
+    timing.deltaSeconds =
+        std::chrono::duration<double>(now - m_lastFrameStart).count();
+    m_frameMs.Push(timing.deltaSeconds * 1000.0, m_settings.historySize);
+  }
+  m_lastFrameStart = now;
+
+  const double step = m_settings.fixedStepSeconds;
+  if (step > 0.0) {
+    m_accumulator += timing.deltaSeconds;
+    auto steps = static_cast<uint64_t>(m_accumulator / step);
+    const uint64_t maxSteps = m_settings.maxStepsPerFrame;
+    if (steps > maxSteps) {
+      m_droppedSteps += steps - maxSteps;
+      m_accumulator -= static_cast<double>(steps - maxSteps) * step;
+      steps = maxSteps;
+    }
+    m_accumulator -= static_cast<double>(steps) * step;
+    timing.fixedSteps = static_cast<uint32_t>(steps);
+    timing.fixedStepSeconds = step;
+    timing.alpha = std::clamp(m_accumulator / step, 0.0, 1.0);
+  }
+
+  // Deadlines advance by whole intervals so rounding in the waits does not
+  // drift the cadence. A frame that ran more than an interval late, or
+  // started more than one early, re-anchors to now.
+  if (m_settings.targetFrameRate > 0.0) {
+    const auto interval = ToDuration(1.0 / m_settings.targetFrameRate);
+    if (m_nextDeadline == Clock::time_point{} ||
+        now - m_nextDeadline >= interval || m_nextDeadline - now > interval) {
+      m_nextDeadline = now + interval;
+    } else {
+      m_nextDeadline += interval;
+    }
+  } else {
+    m_nextDeadline = {};
+  }
+
+  m_timing = timing;
+  return timing;
+}
+
+void FramePacer::WaitForNextFrame() {
+  if (m_settings.targetFrameRate <= 0.0 ||
+      m_nextDeadline == Clock::time_point{}) {
+    return;
+  }
+  SleepUntil(m_nextDeadline);
+}
+
+FramePacer::Clock::duration
+FramePacer::TimeUntilNextFrame(Clock::time_point now) const noexcept {
+  if (m_settings.targetFrameRate <= 0.0 ||
+      m_nextDeadline == Clock::time_point{} || m_nextDeadline <= now) {
+    return Clock::duration::zero();
+  }
+  return m_nextDeadline - now;
+}
+
+void FramePacer::SleepUntil(Clock::time_point deadline) {
+  const auto spin = ToDuration(m_settings.spinMs / 1000.0);
+  const auto now = Clock::now();
+  if (deadline - now > spin) {
+    const auto wakeAt = deadline - spin;
+#ifdef _WIN32
+    bool waited = false;
+    if (m_waitTimer) {
+      // Relative due time in 100 ns units.
+      LARGE_INTEGER due{};
+      due.QuadPart = -static_cast<LONGLONG>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(wakeAt - now)
+              .count() /
+          100);
+      HANDLE timer = static_cast<HANDLE>(m_waitTimer);
+      if (SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE)) {
+        waited = WaitForSingleObject(timer, INFINITE) == WAIT_OBJECT_0;
+      }
+    }
+    if (!waited) {
+      std::this_thread::sleep_until(wakeAt);
+    }
+#else
+    std::this_thread::sleep_until(wakeAt);
+#endif
+  }
+  while (Clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+}
+
+void FramePacer::MarkInput(Clock::time_point when) noexcept {
+  if (!m_inputPending) {
+    m_inputPending = true;
+    m_inputTime = when;
+  }
+}
+
+void FramePacer::MarkPresented(Clock::time_point when) {
+  // Input that arrived after this frame started is shown by a later one.
+  if (!m_inputPending || m_inputTime > m_lastFrameStart) {
+    return;
+  }
+  m_inputPending = false;
+  m_latencyMs.Push(
+      std::chrono::duration<double, std::milli>(when - m_inputTime).count(),
+      m_settings.historySize);
+}
+
+FramePacer::Stats FramePacer::GetStats() const {
+  Stats stats{};
+  stats.frameMs = m_frameMs.Compute(&stats.meanFrameMs);
+  stats.frameSamples = static_cast<uint32_t>(m_frameMs.count);
+  stats.latencyMs = m_latencyMs.Compute(nullptr);
+  stats.latencySamples = static_cast<uint32_t>(m_latencyMs.count);
+  stats.droppedSteps = m_droppedSteps;
+  return stats;
+}
+
+void FramePacer::ResetStats() {
+  m_frameMs = {};
+  m_latencyMs = {};
+  m_droppedSteps = 0;
+}
+} // namespace Aetherion::Runtime
@@ -0,0 +1,147 @@
+#include "Aetherion/Runtime/TransformBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Aetherion/Core/Math.h"
+#include "Aetherion/Scene/Entity.h"
+#include "Aetherion/Scene/Scene.h"
+#include "Aetherion/Scene/TransformComponent.h"
+
+namespace Aetherion::Runtime {
+namespace {
+// Deeper chains are treated as cycles and cut at the root.
+constexpr int kMaxHierarchyDepth = 64;
+
+std::array<float, 16> Identity() {
+  std::array<float, 16> out{};
+  Core::Math::Mat4Identity(out.data());
+  return out;
+}
+
+void ComposeLocal(float out[16], const std::array<float, 3> &position,
+                  const std::array<float, 3> &rotationDegrees,
+                  const std::array<float, 3> &scale) {
+  Core::Math::Mat4Compose(out, position[0], position[1], position[2],
+                          rotationDegrees[0] * Core::Math::DegToRad,
+                          rotationDegrees[1] * Core::Math::DegToRad,
+                          rotationDegrees[2] * Core::Math::DegToRad, scale[0],
+                          scale[1], scale[2]);
+}
+
+float Lerp(float a, float b, float t) { return a + (b - a) * t; }
+
+// Euler angles blend per axis along the shorter way round; steps are small
+// enough for that to stay close to the true in-between rotation.
+float LerpDegrees(float a, float b, float t) {
+  return a + std::remainder(b - a, 360.0f) * t;
+}
+
+using WorldCache = std::unordered_map<Core::EntityId, std::array<float, 16>>;
+
+const std::array<float, 16> &WorldOf(const Scene::Scene &scene,
+                                     Core::EntityId id, WorldCache &cache,
+                                     int depth) {
+  if (auto it = cache.find(id); it != cache.end()) {
+    return it->second;
+  }
+
+  const auto entity = scene.FindEntityById(id);
+  const auto transform =
+      entity ? entity->GetComponent<Scene::TransformComponent>() : nullptr;
+  if (!transform) {
+    return cache.emplace(id, Identity()).first->second;
+  }
+
+  std::array<float, 16> world{};
+  ComposeLocal(world.data(), transform->GetPosition(),
+               transform->GetRotationDegrees(), transform->GetScale());
+  if (transform->HasParent() && depth < kMaxHierarchyDepth) {
+    const auto parent =
+        WorldOf(scene, transform->GetParentId(), cache, depth + 1);
+    Core::Math::Mat4Mul(world.data(), parent.data(), world.data());
+  }
+  return cache.emplace(id, world).first->second;
+}
+} // namespace
+
+void TransformBuffer::Advance(const Scene::Scene &scene) {
+  m_current ^= 1u;
+  Capture(scene, m_states[m_current]);
+}
+
+void TransformBuffer::Refresh(const Scene::Scene &scene) {
+  Capture(scene, m_states[m_current]);
+}
+
+void TransformBuffer::Clear() {
+  for (auto &state : m_states) {
+    state.entries.clear();
+    state.serial = 0;
+  }
+  m_current = 0;
+}
+
+void TransformBuffer::Capture(const Scene::Scene &scene, State &state) {
+  // clear() keeps the buckets, so steady-state captures do not allocate
+  // beyond the nodes themselves.
+  state.entries.clear();
+  state.serial = ++m_serial;
+
+  WorldCache worlds;
+  for (const auto &entity : scene.GetEntities()) {
+    if (!entity) {
+      continue;
+    }
+    const auto transform = entity->GetComponent<Scene::TransformComponent>();
+    if (!transform) {
+      continue;
+    }
+
+    Entry entry;
+    entry.position = transform->GetPosition();
+    entry.rotationDegrees = transform->GetRotationDegrees();
+    entry.scale = transform->GetScale();
+    entry.parentWorld = transform->HasParent()
+                            ? WorldOf(scene, transform->GetParentId(), worlds,
+                                      1)
+                            : Identity();
+    state.entries.emplace(entity->GetId(), entry);
+  }
+}
+
+bool TransformBuffer::Interpolate(Core::EntityId id, float alpha, float out[16],
+                                  float extraRotationZDegrees) const {
+  const auto &current = GetCurrent().entries;
+  const auto it = current.find(id);
+  if (it == current.end()) {
+    return false;
+  }
+
+  Entry blended = it->second;
+  const auto &previous = GetPrevious().entries;
+  const auto prev = previous.find(id);
+  if (alpha < 1.0f && prev != previous.end()) {
+    const float t = std::max(0.0f, alpha);
+    const Entry &from = prev->second;
+    for (size_t i = 0; i < 16; ++i) {
+      blended.parentWorld[i] =
+          Lerp(from.parentWorld[i], blended.parentWorld[i], t);
+    }
+    for (size_t i = 0; i < 3; ++i) {
+      blended.position[i] = Lerp(from.position[i], blended.position[i], t);
+      blended.rotationDegrees[i] =
+          LerpDegrees(from.rotationDegrees[i], blended.rotationDegrees[i], t);
+      blended.scale[i] = Lerp(from.scale[i], blended.scale[i], t);
+    }
+  }
+  blended.rotationDegrees[2] += extraRotationZDegrees;
+
+  float local[16];
+  ComposeLocal(local, blended.position, blended.rotationDegrees,
+               blended.scale);
+  Core::Math::Mat4Mul(out, blended.parentWorld.data(), local);
+  return true;
+}
+} // namespace Aetherion::Runtime
@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "Aetherion/Assets/AssetRegistry.h"
+#include "Aetherion/Assets/VirtualFileSystem.h"
 #include "Aetherion/Runtime/EngineContext.h"
 #include "Aetherion/Scene/CameraComponent.h"
 #include "Aetherion/Scene/ColliderComponent.h"
@@ -202,16 +203,28 @@ bool SceneSerializer::Save(const Scene &scene,
 
 std::shared_ptr<Scene>
 SceneSerializer::Load(const std::filesystem::path &path) const {
-  std::ifstream input(path);
-  if (!input.is_open()) {
-    return nullptr;
-  }
-
   Json root;
-  try {
-    input >> root;
-  } catch (const nlohmann::json::exception &) {
-    return nullptr;
+  if (auto fileSystem = m_context.GetFileSystem()) {
+    // Scenes of a cooked build may only exist inside an archive.
+    std::string text;
+    if (!fileSystem->ReadText(path, text)) {
+      return nullptr;
+    }
+    try {
+      root = Json::parse(text);
+    } catch (const nlohmann::json::exception &) {
+      return nullptr;
+    }
+  } else {
+    std::ifstream input(path);
+    if (!input.is_open()) {
+      return nullptr;
+    }
+    try {
+      input >> root;
+    } catch (const nlohmann::json::exception &) {
+      return nullptr;
+    }
   }
 
   auto scene = std::make_shared<Scene>(ReadString(root, "name", std::string()));
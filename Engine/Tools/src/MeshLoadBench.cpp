@@ -0,0 +1,245 @@
+// AetherionMeshBench: times cold mesh loads for every OBJ/glTF mesh under a
+// content directory three ways: importing the source (parse + post-process),
+// loading the cooked `.amesh` through AssetRegistry (one copy per stream), and
+// mapping the `.amesh` without any copy. OBJ files additionally get their
+// parse throughput measured on one thread and on all of them.
+//
+// Usage:
+//   AetherionMeshBench <content-dir> [--iterations N] [--cache DIR]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Aetherion/Assets/AssetRegistry.h"
+#include "Aetherion/Assets/MeshCooker.h"
+#include "Aetherion/Assets/ObjParser.h"
+
+namespace {
+using namespace Aetherion::Assets;
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions {
+  std::filesystem::path contentDir;
+  std::filesystem::path cacheDir;
+  int iterations{5};
+};
+
+struct MeshTimes {
+  std::filesystem::path path;
+  std::size_t vertices{0};
+  std::size_t indices{0};
+  std::vector<double> sourceMs;
+  std::vector<double> cookedMs;
+  std::vector<double> mappedMs;
+  std::vector<double> objSerialMs;
+  std::vector<double> objParallelMs;
+};
+
+void PrintUsage() {
+  std::cerr << "Usage: AetherionMeshBench <content-dir> [--iterations N] "
+               "[--cache DIR]\n";
+}
+
+bool ParseArgs(int argc, char **argv, BenchOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--iterations" || arg == "--cache") {
+      if (i + 1 >= argc) {
+        std::cerr << "Missing value for " << arg << "\n";
+        return false;
+      }
+      const std::string value = argv[++i];
+      if (arg == "--cache") {
+        options.cacheDir = value;
+      } else {
+        options.iterations = std::max(1, std::atoi(value.c_str()));
+      }
+    } else if (arg == "--help" || arg == "-h") {
+      return false;
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::cerr << "Unknown option " << arg << "\n";
+      return false;
+    } else {
+      options.contentDir = arg;
+    }
+  }
+
+  if (options.contentDir.empty()) {
+    std::cerr << "No content directory specified\n";
+    return false;
+  }
+  if (options.cacheDir.empty()) {
+    // Kept apart from the editor's cache so runs start from a known state.
+    options.cacheDir =
+        std::filesystem::temp_directory_path() / "aetherion_mesh_bench";
+  }
+  return true;
+}
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+double Median(std::vector<double> values) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+// Reads every position and index so the mapped pages are actually faulted in,
+// as an upload from the mapping would.
+float TouchView(const CookedMeshView &view) {
+  float sum = 0.0f;
+  for (const auto &position : view.positions) {
+    sum += position[0];
+  }
+  for (std::uint32_t index : view.indices) {
+    sum += static_cast<float>(index & 1u);
+  }
+  return sum;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  BenchOptions options{};
+  if (!ParseArgs(argc, argv, options)) {
+    PrintUsage();
+    return 1;
+  }
+
+  std::error_code ec;
+  std::filesystem::remove_all(options.cacheDir, ec);
+
+  // Every pass uses a fresh registry so nothing stays loaded in memory; only
+  // the cooked files carry over.
+  std::map<std::string, MeshTimes> meshes;
+  {
+    AssetRegistry registry;
+    registry.SetCacheRoot(options.cacheDir);
+    registry.Scan(options.contentDir.string());
+    for (const auto &entry : registry.GetEntries()) {
+      if (entry.type != AssetRegistry::AssetType::Mesh) {
+        continue;
+      }
+      // First load imports and writes the cooked container.
+      const auto mesh = registry.LoadMeshData(entry.id);
+      if (!mesh) {
+        std::cerr << "  failed: " << entry.path.string() << "\n";
+        continue;
+      }
+      MeshTimes &times = meshes[entry.id];
+      times.path = entry.path;
+      times.vertices = mesh->positions.size();
+      times.indices = mesh->indices.size();
+    }
+  }
+  if (meshes.empty()) {
+    std::cerr << "No loadable meshes under " << options.contentDir.string()
+              << "\n";
+    return 2;
+  }
+
+  float sink = 0.0f;
+  for (int iteration = 0; iteration < options.iterations; ++iteration) {
+    AssetRegistry source;
+    source.Scan(options.contentDir.string());
+    AssetRegistry cooked;
+    cooked.SetCacheRoot(options.cacheDir);
+    cooked.Scan(options.contentDir.string());
+
+    for (auto &[id, times] : meshes) {
+      auto start = Clock::now();
+      (void)source.LoadMeshData(id);
+      times.sourceMs.push_back(MillisecondsSince(start));
+
+      start = Clock::now();
+      (void)cooked.LoadMeshData(id);
+      times.cookedMs.push_back(MillisecondsSince(start));
+
+      const auto settings = cooked.GetMeshImportSettings(id);
+      start = Clock::now();
+      CookedMeshFile file;
+      if (file.Open(cooked.FindCookedMesh(id), times.path,
+                    HashMeshImportSettings(settings))) {
+        sink += TouchView(file.GetView());
+      }
+      times.mappedMs.push_back(MillisecondsSince(start));
+
+      if (times.path.extension() == ".obj") {
+        for (std::size_t threads : {std::size_t{1}, std::size_t{0}}) {
+          AssetRegistry::MeshData parsed;
+          start = Clock::now();
+          (void)ParseObjFile(times.path, parsed, nullptr, threads);
+          (threads == 1 ? times.objSerialMs : times.objParallelMs)
+              .push_back(MillisecondsSince(start));
+        }
+      }
+    }
+  }
+
+  double totalSource = 0.0;
+  double totalCooked = 0.0;
+  double totalMapped = 0.0;
+  std::cout << std::fixed << std::setprecision(3)
+            << "median of " << options.iterations << " cold loads (ms)\n"
+            << std::left << std::setw(32) << "mesh" << std::right
+            << std::setw(10) << "vertices" << std::setw(10) << "indices"
+            << std::setw(10) << "source" << std::setw(10) << "cooked"
+            << std::setw(10) << "mapped" << std::setw(9) << "speedup"
+            << "\n";
+  for (const auto &[id, times] : meshes) {
+    const double sourceMs = Median(times.sourceMs);
+    const double cookedMs = Median(times.cookedMs);
+    const double mappedMs = Median(times.mappedMs);
+    totalSource += sourceMs;
+    totalCooked += cookedMs;
+    totalMapped += mappedMs;
+    std::cout << std::left << std::setw(32)
+              << times.path.filename().string().substr(0, 31) << std::right
+              << std::setw(10) << times.vertices << std::setw(10)
+              << times.indices << std::setw(10) << sourceMs << std::setw(10)
+              << cookedMs << std::setw(10) << mappedMs << std::setw(8)
+              << (cookedMs > 0.0 ? sourceMs / cookedMs : 0.0) << "x\n";
+  }
+  std::cout << std::left << std::setw(52) << "total" << std::right
+            << std::setw(10) << totalSource << std::setw(10) << totalCooked
+            << std::setw(10) << totalMapped << std::setw(8)
+            << (totalCooked > 0.0 ? totalSource / totalCooked : 0.0)
+            << "x\n";
+
+  std::cout << "\nOBJ parse throughput (MB/s)\n"
+            << std::left << std::setw(32) << "mesh" << std::right
+            << std::setw(10) << "MB" << std::setw(10) << "1 thread"
+            << std::setw(10) << "all" << "\n";
+  for (const auto &[id, times] : meshes) {
+    if (times.objSerialMs.empty()) {
+      continue;
+    }
+    const double megabytes =
+        static_cast<double>(std::filesystem::file_size(times.path, ec)) /
+        (1024.0 * 1024.0);
+    auto throughput = [megabytes](const std::vector<double> &ms) {
+      const double median = Median(ms);
+      return median > 0.0 ? megabytes / (median / 1000.0) : 0.0;
+    };
+    std::cout << std::left << std::setw(32)
+              << times.path.filename().string().substr(0, 31) << std::right
+              << std::setw(10) << megabytes << std::setw(10)
+              << throughput(times.objSerialMs) << std::setw(10)
+              << throughput(times.objParallelMs) << "\n";
+  }
+  // Printed so the reads in TouchView are not optimized out.
+  std::cout << "mapped checksum " << sink << "\n";
+  return 0;
+}
@@ -0,0 +1,431 @@
+// AetherionObjFuzz: differential test of ParseObj against the stream-based
+// OBJ parser it replaced. Random OBJ texts full of edge-case tokens (signs,
+// exponents, over- and underflow, malformed and relative indices, stray
+// whitespace and CRs) are parsed by both; the results must be byte-identical
+// on 1, 3 and 8 threads, both with the default chunk size and with 16-byte
+// chunks that split every text.
+//
+// Usage:
+//   AetherionObjFuzz [--seed N] [--iterations N]
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Aetherion/Assets/AssetRegistry.h"
+#include "Aetherion/Assets/ObjParser.h"
+
+namespace {
+using namespace Aetherion::Assets;
+
+struct FuzzOptions {
+  std::uint32_t seed{1};
+  int iterations{20000};
+};
+
+struct LegacyResult {
+  AssetRegistry::MeshData mesh;
+  bool parsed{false};
+  bool hasNormals{false};
+  bool missingNormals{false};
+};
+
+void PrintUsage() {
+  std::cerr << "Usage: AetherionObjFuzz [--seed N] [--iterations N]\n";
+}
+
+bool ParseArgs(int argc, char **argv, FuzzOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--seed" || arg == "--iterations") {
+      if (i + 1 >= argc) {
+        std::cerr << "Missing value for " << arg << "\n";
+        return false;
+      }
+      const std::string value = argv[++i];
+      if (arg == "--seed") {
+        options.seed = static_cast<std::uint32_t>(std::atoll(value.c_str()));
+      } else {
+        options.iterations = std::max(1, std::atoi(value.c_str()));
+      }
+    } else {
+      if (arg != "--help" && arg != "-h") {
+        std::cerr << "Unknown option " << arg << "\n";
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+void NormalizeVector(float v[3], const float fallback[3]) {
+  const float lenSq = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+  if (lenSq > 0.0f) {
+    const float invLen = 1.0f / std::sqrt(lenSq);
+    v[0] *= invLen;
+    v[1] *= invLen;
+    v[2] *= invLen;
+  } else {
+    v[0] = fallback[0];
+    v[1] = fallback[1];
+    v[2] = fallback[2];
+  }
+}
+
+// The OBJ parser as it was before ParseObj (istringstream per line, stoi per
+// index), kept verbatim as the reference.
+LegacyResult LegacyParseObj(const std::string &text) {
+  struct ObjVertexKey {
+    int position = -1;
+    int texcoord = -1;
+    int normal = -1;
+  };
+
+  struct ObjVertexKeyHash {
+    size_t operator()(const ObjVertexKey &key) const noexcept {
+      size_t seed = std::hash<int>{}(key.position);
+      seed ^= std::hash<int>{}(key.texcoord) + 0x9e3779b9 + (seed << 6) +
+              (seed >> 2);
+      seed ^=
+          std::hash<int>{}(key.normal) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      return seed;
+    }
+  };
+
+  struct ObjVertexKeyEq {
+    bool operator()(const ObjVertexKey &lhs,
+                    const ObjVertexKey &rhs) const noexcept {
+      return lhs.position == rhs.position && lhs.texcoord == rhs.texcoord &&
+             lhs.normal == rhs.normal;
+    }
+  };
+
+  auto resolveIndex = [](int value, size_t count) -> int {
+    if (value == 0) {
+      return -1;
+    }
+    int idx = value;
+    if (idx < 0) {
+      idx = static_cast<int>(count) + idx;
+    } else {
+      idx -= 1;
+    }
+    if (idx < 0 || idx >= static_cast<int>(count)) {
+      return -1;
+    }
+    return idx;
+  };
+
+  auto parseIndex = [](const std::string &value, int &outIndex) {
+    if (value.empty()) {
+      outIndex = 0;
+      return;
+    }
+    try {
+      outIndex = std::stoi(value);
+    } catch (const std::exception &) {
+      outIndex = 0;
+    }
+  };
+
+  std::vector<std::array<float, 3>> positions;
+  std::vector<std::array<float, 4>> colors;
+  std::vector<std::array<float, 3>> normals;
+  std::vector<std::array<float, 2>> texcoords;
+
+  LegacyResult result;
+  AssetRegistry::MeshData &mesh = result.mesh;
+  std::unordered_map<ObjVertexKey, std::uint32_t, ObjVertexKeyHash,
+                     ObjVertexKeyEq>
+      vertexLookup;
+  vertexLookup.reserve(1024);
+
+  std::istringstream input(text);
+  std::string line;
+  while (std::getline(input, line)) {
+    std::istringstream stream(line);
+    std::string keyword;
+    if (!(stream >> keyword)) {
+      continue;
+    }
+    if (!keyword.empty() && keyword.front() == '#') {
+      continue;
+    }
+
+    if (keyword == "v") {
+      float x = 0.0f;
+      float y = 0.0f;
+      float z = 0.0f;
+      if (!(stream >> x >> y >> z)) {
+        continue;
+      }
+
+      float r = 1.0f;
+      float g = 1.0f;
+      float b = 1.0f;
+      float a = 1.0f;
+      if (stream >> r >> g >> b) {
+        if (!(stream >> a)) {
+          a = 1.0f;
+        }
+        colors.push_back({r, g, b, a});
+      } else {
+        colors.push_back({1.0f, 1.0f, 1.0f, 1.0f});
+      }
+      positions.push_back({x, y, z});
+    } else if (keyword == "vn") {
+      float nx = 0.0f;
+      float ny = 0.0f;
+      float nz = 0.0f;
+      if (stream >> nx >> ny >> nz) {
+        normals.push_back({nx, ny, nz});
+      }
+    } else if (keyword == "vt") {
+      float u = 0.0f;
+      float v = 0.0f;
+      if (stream >> u >> v) {
+        texcoords.push_back({u, v});
+      }
+    } else if (keyword == "f") {
+      std::vector<std::uint32_t> face;
+      std::string token;
+      while (stream >> token) {
+        if (positions.empty()) {
+          continue;
+        }
+
+        int positionValue = 0;
+        int texValue = 0;
+        int normalValue = 0;
+
+        const size_t slash = token.find('/');
+        if (slash == std::string::npos) {
+          parseIndex(token, positionValue);
+        } else {
+          parseIndex(token.substr(0, slash), positionValue);
+          const size_t slash2 = token.find('/', slash + 1);
+          if (slash2 == std::string::npos) {
+            parseIndex(token.substr(slash + 1), texValue);
+          } else {
+            parseIndex(token.substr(slash + 1, slash2 - slash - 1), texValue);
+            size_t slash3 = token.find('/', slash2 + 1);
+            if (slash3 != std::string::npos) {
+              parseIndex(token.substr(slash2 + 1, slash3 - slash2 - 1),
+                         normalValue);
+            } else {
+              parseIndex(token.substr(slash2 + 1), normalValue);
+            }
+          }
+        }
+
+        const int positionIndex = resolveIndex(positionValue, positions.size());
+        if (positionIndex < 0) {
+          continue;
+        }
+        const int texIndex = resolveIndex(texValue, texcoords.size());
+        const int normalIndex = resolveIndex(normalValue, normals.size());
+
+        const ObjVertexKey key{positionIndex, texIndex, normalIndex};
+        auto it = vertexLookup.find(key);
+        std::uint32_t vertexIndex = 0;
+        if (it == vertexLookup.end()) {
+          mesh.positions.push_back(
+              positions[static_cast<size_t>(positionIndex)]);
+          if (static_cast<size_t>(positionIndex) < colors.size()) {
+            mesh.colors.push_back(colors[static_cast<size_t>(positionIndex)]);
+          } else {
+            mesh.colors.push_back({1.0f, 1.0f, 1.0f, 1.0f});
+          }
+
+          if (texIndex >= 0 &&
+              static_cast<size_t>(texIndex) < texcoords.size()) {
+            mesh.uvs.push_back(texcoords[static_cast<size_t>(texIndex)]);
+          } else {
+            mesh.uvs.push_back({0.0f, 0.0f});
+          }
+
+          if (normalIndex >= 0 &&
+              static_cast<size_t>(normalIndex) < normals.size()) {
+            auto normal = normals[static_cast<size_t>(normalIndex)];
+            float normalValues[3] = {normal[0], normal[1], normal[2]};
+            const float defaultNormal[3] = {0.0f, 0.0f, 1.0f};
+            NormalizeVector(normalValues, defaultNormal);
+            mesh.normals.push_back(
+                {normalValues[0], normalValues[1], normalValues[2]});
+            result.hasNormals = true;
+          } else {
+            mesh.normals.push_back({0.0f, 0.0f, 1.0f});
+            result.missingNormals = true;
+          }
+
+          vertexIndex = static_cast<std::uint32_t>(mesh.positions.size() - 1);
+          vertexLookup.emplace(key, vertexIndex);
+        } else {
+          vertexIndex = it->second;
+        }
+        face.push_back(vertexIndex);
+      }
+
+      if (face.size() >= 3) {
+        for (size_t i = 1; i + 1 < face.size(); ++i) {
+          mesh.indices.push_back(face[0]);
+          mesh.indices.push_back(face[i]);
+          mesh.indices.push_back(face[i + 1]);
+        }
+      }
+    }
+  }
+
+  result.parsed = !mesh.positions.empty() && !mesh.indices.empty();
+  return result;
+}
+
+// Byte comparison, so -0.0 vs 0.0 and NaN payloads count as differences.
+template <typename T>
+bool SameBytes(const std::vector<T> &a, const std::vector<T> &b) {
+  return a.size() == b.size() &&
+         (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) ==
+                           0);
+}
+
+bool SameMesh(const AssetRegistry::MeshData &a,
+              const AssetRegistry::MeshData &b) {
+  return SameBytes(a.positions, b.positions) &&
+         SameBytes(a.colors, b.colors) && SameBytes(a.normals, b.normals) &&
+         SameBytes(a.uvs, b.uvs) && SameBytes(a.indices, b.indices);
+}
+
+constexpr const char *kNumbers[] = {
+    "1",    "-2",   "0.5",   "-.5",   "5.",     "+3",     "+-1",
+    "1e",   "1e5",  "1e-50", "1e50",  "-1e-45", "3.4e38", "3.5e38",
+    ".",    "-",    "+",     "nan",   "inf",    "0x10",   "1,5",
+    "1.5.3", "1-2", "2abc",  "00.25", "1.e2",   ".e2",    "7E+2",
+    "7e-",  "0",    "-0",    "1e+",   "12345678901234567890",
+    " ",    "\t",   "\v",    "\r",    "#"};
+constexpr const char *kIndices[] = {"1",  "2",  "3",  "-1", "-2", "0",
+                                    "+2", "-+1", "99999999999", "2abc",
+                                    "",   "4",  "5",  "-3", "10", "x"};
+
+class ObjGenerator {
+public:
+  explicit ObjGenerator(std::uint32_t seed) : m_rng(seed) {}
+
+  std::string Next() {
+    std::string text;
+    const int lines = 1 + Pick(60);
+    for (int line = 0; line < lines; ++line) {
+      if (Pick(8) == 0) {
+        text += " ";
+      }
+      const int kind = Pick(12);
+      if (kind < 4) {
+        text += Pick(20) == 0 ? "v#" : "v";
+        for (int i = Pick(9); i > 0; --i) {
+          text += Pick(3) ? " " : (Pick(2) ? "\t" : "");
+          text += Pick(3) ? std::to_string(Pick(200) - 100) + "." +
+                                std::to_string(Pick(1000))
+                          : Number();
+        }
+      } else if (kind < 5) {
+        text += "vn";
+        for (int i = Pick(5); i > 0; --i) {
+          text += " ";
+          text += Pick(2) ? std::to_string(Pick(5) - 2) : Number();
+        }
+      } else if (kind < 6) {
+        text += "vt";
+        for (int i = Pick(4); i > 0; --i) {
+          text += " ";
+          text += Pick(2) ? "0." + std::to_string(Pick(100)) : Number();
+        }
+      } else if (kind < 10) {
+        text += "f";
+        for (int i = Pick(7); i > 0; --i) {
+          text += Pick(6) ? " " : "  ";
+          text += Index();
+          const int slashes = Pick(4);
+          if (slashes >= 1) {
+            text += "/";
+            if (Pick(3)) {
+              text += Index();
+            }
+          }
+          if (slashes >= 2) {
+            text += "/";
+            text += Index();
+          }
+          if (slashes == 3 && Pick(4) == 0) {
+            text += "/";
+            text += Index();
+          }
+        }
+      } else if (kind < 11) {
+        text += "# comment 1 2 3";
+      } else if (Pick(2)) {
+        text += "o name";
+      }
+      if (Pick(10) == 0) {
+        text += "\r";
+      }
+      if (line + 1 < lines || Pick(2)) {
+        text += "\n";
+      }
+    }
+    return text;
+  }
+
+private:
+  int Pick(int count) { return static_cast<int>(m_rng() % count); }
+  const char *Number() { return kNumbers[Pick(std::size(kNumbers))]; }
+  const char *Index() { return kIndices[Pick(std::size(kIndices))]; }
+
+  std::mt19937 m_rng;
+};
+} // namespace
+
+int main(int argc, char **argv) {
+  FuzzOptions options{};
+  if (!ParseArgs(argc, argv, options)) {
+    PrintUsage();
+    return 1;
+  }
+
+  ObjGenerator generator(options.seed);
+  int mismatches = 0;
+  for (int iteration = 0; iteration < options.iterations; ++iteration) {
+    const std::string text = generator.Next();
+    const LegacyResult expected = LegacyParseObj(text);
+    for (std::size_t chunkBytes : {std::size_t{0}, std::size_t{16}}) {
+      for (std::size_t threads : {1, 3, 8}) {
+        AssetRegistry::MeshData mesh;
+        ObjParseInfo info{};
+        const bool parsed = ParseObj(text, mesh, &info, threads, chunkBytes);
+        const bool same =
+            parsed == expected.parsed &&
+            (!parsed || SameMesh(mesh, expected.mesh)) &&
+            info.hasNormals == expected.hasNormals &&
+            info.missingNormals == expected.missingNormals;
+        if (!same && ++mismatches <= 3) {
+          std::cout << "mismatch at iteration " << iteration << " ("
+                    << threads << " threads, " << info.chunks
+                    << " chunks):\n---\n"
+                    << text << "\n---\n";
+        }
+      }
+    }
+  }
+
+  std::cout << mismatches << " mismatches over " << options.iterations
+            << " inputs (seed " << options.seed << ")\n";
+  return mismatches == 0 ? 0 : 2;
+}
@@ -0,0 +1,432 @@
+// AetherionRenderBench: renders a scene offscreen for a fixed number of frames
+// and dumps the per-pass CPU/GPU timings reported by VulkanViewport as JSON.
+//
+// Usage:
+//   AetherionRenderBench <scene.json> [--frames N] [--warmup N]
+//                        [--width W] [--height H] [--out stats.json]
+//                        [--png frame.png] [--target-gpu-ms MS]
+//                        [--validation] [--verbose]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Aetherion/Rendering/RenderView.h"
+#include "Aetherion/Rendering/VulkanContext.h"
+#include "Aetherion/Rendering/VulkanViewport.h"
+#include "Aetherion/Runtime/EngineApplication.h"
+#include "Aetherion/Runtime/EngineContext.h"
+#include "Aetherion/Scene/Scene.h"
+#include "Aetherion/Scene/SceneSerializer.h"
+
+#include "nlohmann/json.hpp"
+
+namespace {
+using Aetherion::Rendering::VulkanViewport;
+
+struct BenchOptions {
+  std::filesystem::path scenePath;
+  std::filesystem::path outputPath{"render_bench.json"};
+  std::filesystem::path pngPath;
+  int frames{300};
+  int warmupFrames{30};
+  int width{1280};
+  int height{720};
+  // Enables dynamic resolution with this GPU frame time target when > 0.
+  double targetGpuMs{0.0};
+  bool depthPrepass{false};
+  bool validation{false};
+  bool verbose{false};
+};
+
+void PrintUsage() {
+  std::cerr << "Usage: AetherionRenderBench <scene.json> [--frames N] "
+               "[--warmup N] [--width W] [--height H] [--out stats.json] "
+               "[--png frame.png] [--target-gpu-ms MS] [--depth-prepass] "
+               "[--validation] [--verbose]\n";
+}
+
+bool ParseArgs(int argc, char **argv, BenchOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    auto next = [&](const char *name) -> const char * {
+      if (i + 1 >= argc) {
+        std::cerr << "Missing value for " << name << "\n";
+        return nullptr;
+      }
+      return argv[++i];
+    };
+
+    if (arg == "--frames" || arg == "--warmup" || arg == "--width" ||
+        arg == "--height") {
+      const char *value = next(arg.c_str());
+      if (!value) {
+        return false;
+      }
+      const int parsed = std::atoi(value);
+      if (arg == "--frames") {
+        options.frames = parsed;
+      } else if (arg == "--warmup") {
+        options.warmupFrames = parsed;
+      } else if (arg == "--width") {
+        options.width = parsed;
+      } else {
+        options.height = parsed;
+      }
+    } else if (arg == "--out") {
+      const char *value = next("--out");
+      if (!value) {
+        return false;
+      }
+      options.outputPath = value;
+    } else if (arg == "--png") {
+      const char *value = next("--png");
+      if (!value) {
+        return false;
+      }
+      options.pngPath = value;
+    } else if (arg == "--target-gpu-ms") {
+      const char *value = next("--target-gpu-ms");
+      if (!value) {
+        return false;
+      }
+      options.targetGpuMs = std::atof(value);
+    } else if (arg == "--depth-prepass") {
+      options.depthPrepass = true;
+    } else if (arg == "--validation") {
+      options.validation = true;
+    } else if (arg == "--verbose") {
+      options.verbose = true;
+    } else if (arg == "--help" || arg == "-h") {
+      return false;
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::cerr << "Unknown option " << arg << "\n";
+      return false;
+    } else {
+      options.scenePath = arg;
+    }
+  }
+
+  if (options.scenePath.empty()) {
+    std::cerr << "No scene specified\n";
+    return false;
+  }
+  if (options.frames <= 0 || options.warmupFrames < 0 || options.width <= 0 ||
+      options.height <= 0) {
+    std::cerr << "Frame count and resolution must be positive\n";
+    return false;
+  }
+  return true;
+}
+
+nlohmann::json Summarize(std::vector<double> samples) {
+  nlohmann::json out = nlohmann::json::object();
+  if (samples.empty()) {
+    return out;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  double sum = 0.0;
+  for (double v : samples) {
+    sum += v;
+  }
+  auto percentile = [&](double p) {
+    const size_t index = static_cast<size_t>(
+        p * static_cast<double>(samples.size() - 1) + 0.5);
+    return samples[std::min(index, samples.size() - 1)];
+  };
+
+  out["mean"] = sum / static_cast<double>(samples.size());
+  out["min"] = samples.front();
+  out["max"] = samples.back();
+  out["p50"] = percentile(0.50);
+  out["p95"] = percentile(0.95);
+  out["p99"] = percentile(0.99);
+  return out;
+}
+
+// Minimal PNG encoder using stored (uncompressed) deflate blocks. Output is
+// larger than a real encoder would produce, but it needs no dependencies and
+// is only used for eyeballing benchmark frames.
+uint32_t Crc32(const uint8_t *data, size_t size, uint32_t crc = 0) {
+  static const std::array<uint32_t, 256> table = [] {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t n = 0; n < 256; ++n) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+      }
+      t[n] = c;
+    }
+    return t;
+  }();
+
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i) {
+    crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+void AppendU32(std::vector<uint8_t> &out, uint32_t value) {
+  out.push_back(static_cast<uint8_t>(value >> 24));
+  out.push_back(static_cast<uint8_t>(value >> 16));
+  out.push_back(static_cast<uint8_t>(value >> 8));
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+void AppendChunk(std::vector<uint8_t> &out, const char *type,
+                 const std::vector<uint8_t> &payload) {
+  AppendU32(out, static_cast<uint32_t>(payload.size()));
+  const size_t typeOffset = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), payload.begin(), payload.end());
+  AppendU32(out, Crc32(out.data() + typeOffset, payload.size() + 4));
+}
+
+bool WritePng(const std::filesystem::path &path,
+              const std::vector<uint8_t> &rgba, uint32_t width,
+              uint32_t height) {
+  const size_t stride = static_cast<size_t>(width) * 4;
+  std::vector<uint8_t> raw;
+  raw.reserve((stride + 1) * height);
+  for (uint32_t y = 0; y < height; ++y) {
+    raw.push_back(0); // Filter: none.
+    const auto *row = rgba.data() + y * stride;
+    raw.insert(raw.end(), row, row + stride);
+  }
+
+  std::vector<uint8_t> zlib{0x78, 0x01};
+  constexpr size_t kMaxStoredBlock = 65535;
+  size_t offset = 0;
+  do {
+    const size_t blockSize = std::min(kMaxStoredBlock, raw.size() - offset);
+    const bool last = offset + blockSize == raw.size();
+    zlib.push_back(last ? 1 : 0);
+    zlib.push_back(static_cast<uint8_t>(blockSize & 0xFF));
+    zlib.push_back(static_cast<uint8_t>(blockSize >> 8));
+    zlib.push_back(static_cast<uint8_t>(~blockSize & 0xFF));
+    zlib.push_back(static_cast<uint8_t>((~blockSize >> 8) & 0xFF));
+    zlib.insert(zlib.end(), raw.begin() + static_cast<std::ptrdiff_t>(offset),
+                raw.begin() +
+                    static_cast<std::ptrdiff_t>(offset + blockSize));
+    offset += blockSize;
+  } while (offset < raw.size());
+
+  uint32_t a = 1;
+  uint32_t b = 0;
+  for (uint8_t byte : raw) {
+    a = (a + byte) % 65521u;
+    b = (b + a) % 65521u;
+  }
+  AppendU32(zlib, (b << 16) | a);
+
+  std::vector<uint8_t> header;
+  AppendU32(header, width);
+  AppendU32(header, height);
+  header.push_back(8); // Bit depth.
+  header.push_back(6); // Color type: RGBA.
+  header.push_back(0); // Compression.
+  header.push_back(0); // Filter.
+  header.push_back(0); // Interlace.
+
+  std::vector<uint8_t> png{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  AppendChunk(png, "IHDR", header);
+  AppendChunk(png, "IDAT", zlib);
+  AppendChunk(png, "IEND", {});
+
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  file.write(reinterpret_cast<const char *>(png.data()),
+             static_cast<std::streamsize>(png.size()));
+  return static_cast<bool>(file);
+}
+
+int RunBench(const BenchOptions &options) {
+  Aetherion::Runtime::EngineApplication app;
+  app.Initialize(options.validation, options.verbose, /*headless=*/true);
+
+  auto context = app.GetContext();
+  if (!context) {
+    std::cerr << "Engine context unavailable\n";
+    return 1;
+  }
+
+  Aetherion::Scene::SceneSerializer serializer(*context);
+  auto scene = serializer.Load(options.scenePath);
+  if (!scene) {
+    std::cerr << "Failed to load scene " << options.scenePath.string() << "\n";
+    return 1;
+  }
+  app.SetActiveScene(scene);
+
+  VulkanViewport viewport(context->GetVulkanContext(),
+                          context->GetAssetRegistry());
+  viewport.SetLoggingEnabled(options.verbose);
+  viewport.InitializeHeadless(options.width, options.height);
+  if (options.targetGpuMs > 0.0) {
+    VulkanViewport::DynamicResolutionSettings dynamicResolution;
+    dynamicResolution.enabled = true;
+    dynamicResolution.targetGpuMs = options.targetGpuMs;
+    viewport.SetDynamicResolution(dynamicResolution);
+  }
+  viewport.SetDepthPrepassEnabled(options.depthPrepass);
+
+  // Timings are collected when a frame slot is reused, so they trail the
+  // submitted frame by the frames-in-flight count. Keep rendering until the
+  // requested number of post-warmup samples has been gathered.
+  constexpr float kFixedDeltaSeconds = 1.0f / 60.0f;
+  const int maxIterations = options.warmupFrames + options.frames * 2 + 16;
+  std::vector<VulkanViewport::FrameStats> samples;
+  samples.reserve(static_cast<size_t>(options.frames));
+
+  const auto wallStart = std::chrono::steady_clock::now();
+  int iterations = 0;
+  for (; iterations < maxIterations &&
+         static_cast<int>(samples.size()) < options.frames;
+       ++iterations) {
+    app.Tick();
+
+    Aetherion::Rendering::RenderView view{};
+    if (auto source = context->GetRenderView()) {
+      view = *source;
+    }
+    view.showEditorIcons = false;
+    view.showColliders = false;
+    view.selectedEntityId = 0;
+
+    viewport.RenderFrame(kFixedDeltaSeconds, view);
+
+    if (iterations < options.warmupFrames) {
+      continue;
+    }
+    const auto stats = viewport.GetLastFrameStats();
+    if (stats.valid) {
+      samples.push_back(stats);
+    }
+  }
+  const auto wallEnd = std::chrono::steady_clock::now();
+
+  nlohmann::json report;
+  report["scene"] = options.scenePath.string();
+  report["width"] = options.width;
+  report["height"] = options.height;
+  report["depthPrepass"] = options.depthPrepass;
+  report["warmupFrames"] = options.warmupFrames;
+  report["requestedFrames"] = options.frames;
+  report["renderedFrames"] = iterations;
+  report["sampledFrames"] = samples.size();
+  report["wallMs"] =
+      std::chrono::duration<double, std::milli>(wallEnd - wallStart).count();
+
+  std::vector<double> cpuTotals;
+  std::vector<double> gpuTotals;
+  std::vector<double> renderScales;
+  std::map<std::string, std::pair<std::vector<double>, std::vector<double>>>
+      passSamples;
+  nlohmann::json frames = nlohmann::json::array();
+  for (const auto &stats : samples) {
+    cpuTotals.push_back(stats.cpuTotalMs);
+    gpuTotals.push_back(stats.gpuTotalMs);
+    renderScales.push_back(stats.renderScale);
+
+    nlohmann::json frame;
+    frame["cpuTotalMs"] = stats.cpuTotalMs;
+    frame["gpuTotalMs"] = stats.gpuTotalMs;
+    frame["renderScale"] = stats.renderScale;
+    nlohmann::json passes = nlohmann::json::array();
+    for (const auto &pass : stats.passes) {
+      const std::string name = pass.name ? pass.name : "";
+      passes.push_back(
+          {{"name", name}, {"cpuMs", pass.cpuMs}, {"gpuMs", pass.gpuMs}});
+      passSamples[name].first.push_back(pass.cpuMs);
+      passSamples[name].second.push_back(pass.gpuMs);
+    }
+    frame["passes"] = std::move(passes);
+    frames.push_back(std::move(frame));
+  }
+
+  nlohmann::json summary;
+  summary["cpuTotalMs"] = Summarize(cpuTotals);
+  summary["gpuTotalMs"] = Summarize(gpuTotals);
+  summary["renderScale"] = Summarize(renderScales);
+  for (auto &[name, values] : passSamples) {
+    summary["passes"][name] = {{"cpuMs", Summarize(values.first)},
+                               {"gpuMs", Summarize(values.second)}};
+  }
+  report["summary"] = std::move(summary);
+  report["frames"] = std::move(frames);
+
+  if (auto cache = context->GetVulkanContext()->GetResourceCache()) {
+    const auto streaming = cache->GetTextureStreamingStats();
+    report["textureStreaming"] = {
+        {"residentBytes", streaming.residentBytes},
+        {"budgetBytes", streaming.budgetBytes},
+        {"requestedBytes", streaming.requestedBytes},
+        {"textures", streaming.textures},
+        {"fullyResident", streaming.fullyResident},
+        {"pendingUpgrades", streaming.pendingUpgrades},
+        {"totalUploads", streaming.totalUploads},
+        {"totalUploadedBytes", streaming.totalUploadedBytes},
+        {"evictions", streaming.evictions}};
+  }
+
+  if (!options.pngPath.empty()) {
+    std::vector<uint8_t> rgba;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    if (viewport.ReadbackLastFrame(rgba, width, height) &&
+        WritePng(options.pngPath, rgba, width, height)) {
+      report["png"] = options.pngPath.string();
+    } else {
+      std::cerr << "Failed to write " << options.pngPath.string() << "\n";
+    }
+  }
+
+  std::ofstream out(options.outputPath);
+  if (!out) {
+    std::cerr << "Failed to open " << options.outputPath.string() << "\n";
+    return 1;
+  }
+  out << report.dump(2) << "\n";
+
+  std::cout << "Rendered " << iterations << " frames ("
+            << samples.size() << " sampled) -> "
+            << options.outputPath.string() << "\n";
+
+  viewport.Shutdown();
+  app.Shutdown();
+  return samples.empty() ? 1 : 0;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  BenchOptions options;
+  if (!ParseArgs(argc, argv, options)) {
+    PrintUsage();
+    return 2;
+  }
+
+  try {
+    return RunBench(options);
+  } catch (const std::exception &ex) {
+    std::fprintf(stderr, "Fatal error: %s\n", ex.what());
+    return 1;
+  } catch (...) {
+    std::fprintf(stderr, "Fatal error: unknown exception\n");
+    return 1;
+  }
+}
@@ -0,0 +1,169 @@
+// AetherionTextureCook: pre-cooks every texture under a content directory into
+// the derived-data cache (`.atex` mip chain + BCn blocks, keyed by the source
+// contents) so the first editor/runtime load does not pay for image decode and
+// block compression.
+//
+// Usage:
+//   AetherionTextureCook <content-dir> [--cache DIR] [--format auto|bc7|bc5]
+//                        [--rgba] [--linear] [--force]
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Aetherion/Assets/AssetRegistry.h"
+#include "Aetherion/Assets/TextureCooker.h"
+
+namespace {
+using namespace Aetherion::Assets;
+
+struct CookOptions {
+  std::filesystem::path contentDir;
+  std::filesystem::path cacheDir;
+  TextureCompression compression{TextureCompression::Auto};
+  bool alsoUncompressed{false};
+  bool srgb{true};
+  bool force{false};
+};
+
+void PrintUsage() {
+  std::cerr << "Usage: AetherionTextureCook <content-dir> [--cache DIR] "
+               "[--format auto|bc7|bc5] [--rgba] [--linear] [--force]\n";
+}
+
+bool ParseArgs(int argc, char **argv, CookOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--cache" || arg == "--format") {
+      if (i + 1 >= argc) {
+        std::cerr << "Missing value for " << arg << "\n";
+        return false;
+      }
+      const std::string value = argv[++i];
+      if (arg == "--cache") {
+        options.cacheDir = value;
+      } else if (value == "auto") {
+        options.compression = TextureCompression::Auto;
+      } else if (value == "bc7") {
+        options.compression = TextureCompression::BC7;
+      } else if (value == "bc5") {
+        options.compression = TextureCompression::BC5;
+      } else {
+        std::cerr << "Unknown format " << value << "\n";
+        return false;
+      }
+    } else if (arg == "--rgba") {
+      options.alsoUncompressed = true;
+    } else if (arg == "--linear") {
+      options.srgb = false;
+    } else if (arg == "--force") {
+      options.force = true;
+    } else if (arg == "--help" || arg == "-h") {
+      return false;
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::cerr << "Unknown option " << arg << "\n";
+      return false;
+    } else {
+      options.contentDir = arg;
+    }
+  }
+
+  if (options.contentDir.empty()) {
+    std::cerr << "No content directory specified\n";
+    return false;
+  }
+  if (options.cacheDir.empty()) {
+    // Mirrors EngineApplication: <root>/cache next to <root>/assets.
+    std::error_code ec;
+    const auto content = std::filesystem::absolute(options.contentDir, ec);
+    options.cacheDir = (ec ? options.contentDir : content).parent_path() /
+                       "cache";
+  }
+  return true;
+}
+
+bool CookOne(const std::filesystem::path &source, const CookOptions &options,
+             DerivedDataCache &cache, const TextureCookSettings &settings,
+             uint64_t &bytesOut) {
+  DerivedDataCache::Key key{};
+  if (!GetCookedTextureKey(source, cache, settings, key)) {
+    std::cerr << "  cannot read " << source.string() << "\n";
+    return false;
+  }
+  CookedTexture texture{};
+  std::filesystem::path cookedPath;
+  if (!options.force && cache.Find(key, cookedPath) &&
+      ReadCookedTexture(cookedPath, std::filesystem::path(), texture)) {
+    bytesOut += texture.data.size();
+    return true;
+  }
+
+  std::string error;
+  if (!CookTexture(source, settings, texture, &error)) {
+    std::cerr << "  failed: " << source.string() << " (" << error << ")\n";
+    return false;
+  }
+  cookedPath = cache.GetEntryPath(key);
+  if (!WriteCookedTexture(cookedPath, source, texture)) {
+    std::cerr << "  cannot write " << cookedPath.string() << "\n";
+    return false;
+  }
+  cache.Commit(key);
+  bytesOut += texture.data.size();
+  return true;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  CookOptions options{};
+  if (!ParseArgs(argc, argv, options)) {
+    PrintUsage();
+    return 1;
+  }
+
+  AssetRegistry registry;
+  registry.SetCacheRoot(options.cacheDir);
+  registry.Scan(options.contentDir.string());
+
+  std::vector<TextureCookSettings> variants;
+  TextureCookSettings settings{};
+  settings.compression = options.compression;
+  settings.srgb = options.srgb;
+  variants.push_back(settings);
+  if (options.alsoUncompressed) {
+    settings.compression = TextureCompression::None;
+    variants.push_back(settings);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  size_t cooked = 0;
+  size_t failed = 0;
+  uint64_t sourceBytes = 0;
+  uint64_t cookedBytes = 0;
+  for (const auto &entry : registry.GetEntries()) {
+    if (entry.type != AssetRegistry::AssetType::Texture) {
+      continue;
+    }
+    std::error_code ec;
+    sourceBytes += std::filesystem::file_size(entry.path, ec);
+    bool ok = true;
+    for (const auto &variant : variants) {
+      ok = CookOne(entry.path, options, *registry.GetDerivedDataCache(),
+                   variant, cookedBytes) &&
+           ok;
+    }
+    ok ? ++cooked : ++failed;
+  }
+
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  std::cout << "Cooked " << cooked << " textures (" << failed << " failed) in "
+            << seconds << " s into " << options.cacheDir.string() << "\n"
+            << "  source files: " << sourceBytes << " bytes, cooked data: "
+            << cookedBytes << " bytes\n";
+  return failed == 0 ? 0 : 2;
+}
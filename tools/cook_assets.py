@@ -1,11 +1,12 @@
 #!/usr/bin/env python3
-"""Minimal asset cook step: copy raw assets and emit a manifest."""
+"""Minimal asset cook step: copy raw assets (or pack them) and emit a manifest."""
 
 from __future__ import annotations
 
 import argparse
 import json
 import shutil
+import subprocess
 import uuid
 from pathlib import Path
 
@@ -51,6 +52,12 @@ def main() -> int:
     parser.add_argument("--assets", default="assets", help="Assets directory (repo-relative)")
     parser.add_argument("--out", default="build/cooked", help="Output directory")
     parser.add_argument("--manifest", default="asset_index.json", help="Manifest filename")
+    parser.add_argument("--pak", action="store_true",
+                        help="Pack the assets into <out>/content.apak instead of copying them")
+    parser.add_argument("--pak-tool", default="build/AetherionPak",
+                        help="AetherionPak executable (repo-relative or absolute)")
+    parser.add_argument("--compress", choices=("none", "lz4"), default="lz4",
+                        help="Compression for packed entries")
     args = parser.parse_args()
 
     repo_root = Path(__file__).resolve().parent.parent
@@ -70,6 +77,8 @@ def main() -> int:
             continue
         if asset_path.name.endswith(".asset.json"):
             continue
+        if asset_path.suffix.lower() == ".apak":
+            continue
 
         relative = asset_path.relative_to(assets_dir)
         meta_path = asset_path.with_suffix(asset_path.suffix + ".asset.json")
@@ -88,10 +97,20 @@ def main() -> int:
             "type": asset_type,
         })
 
+        if args.pak:
+            continue
         target_path = out_dir / relative
         target_path.parent.mkdir(parents=True, exist_ok=True)
         shutil.copy2(asset_path, target_path)
 
+    if args.pak:
+        pak_tool = repo_root / args.pak_tool
+        if not pak_tool.exists():
+            raise SystemExit(f"AetherionPak not found: {pak_tool} (build it or pass --pak-tool)")
+        pak_path = out_dir / "content.apak"
+        subprocess.run([str(pak_tool), str(assets_dir), str(pak_path), "--compress", args.compress],
+                       check=True)
+
     manifest_path = out_dir / args.manifest
     with manifest_path.open("w", encoding="utf-8") as handle:
         json.dump({"assets": manifest_entries}, handle, indent=2)